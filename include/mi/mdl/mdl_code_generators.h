@@ -1110,6 +1110,9 @@ class ICode_generator_jit : public
     /// The name of the option to set the optimization level of the JIT code generator.
     #define MDL_JIT_OPTION_OPT_LEVEL "jit_opt_level"
 
+    /// The name of the option to set the number of concurrently optimized partitions.
+    #define MDL_JIT_OPTION_OPT_PARTITIONS "jit_opt_partitions"
+
     /// The name of the option to inline functions aggressively.
     #define MDL_JIT_OPTION_INLINE_AGGRESSIVELY "jit_inline_aggressively"
 
@@ -1601,6 +1604,9 @@ public:
 
     /// Compile a link unit into LLVM-IR, PTX or native code using the JIT.
     ///
+    /// \param code_cache           If non-NULL, a code cache for the source code of the whole
+    ///                             unit. It is only reused if all functions of the unit and all
+    ///                             options are identical. Native code is not cached here.
     /// \param ctx                  the code generator thread context
     /// \param module_cache         the module cache if any
     /// \param unit                 the link unit to compile
@@ -1610,13 +1616,76 @@ public:
     ///
     /// \note the thread context should have the same value as in create_link_unit()
     virtual IGenerated_code_executable *compile_unit(
+        ICode_cache                    *code_cache,
         ICode_generator_thread_context *ctx,
         IModule_cache                  *module_cache,
         ILink_unit const               *unit,
         bool                           llvm_ir_output) = 0;
 
+    /// Compile a link unit into LLVM-IR, PTX or native code using the JIT without a code cache.
+    ///
+    /// \param ctx                  the code generator thread context
+    /// \param module_cache         the module cache if any
+    /// \param unit                 the link unit to compile
+    /// \param llvm_ir_output       if true generate LLVM-IR (prepared for the target language)
+    ///
+    /// \return the compiled function or NULL on compilation errors
+    ///
+    /// \note the thread context should have the same value as in create_link_unit()
+    IGenerated_code_executable *compile_unit(
+        ICode_generator_thread_context *ctx,
+        IModule_cache                  *module_cache,
+        ILink_unit const               *unit,
+        bool                           llvm_ir_output)
+    {
+        return compile_unit(/*code_cache=*/NULL, ctx, module_cache, unit, llvm_ir_output);
+    }
+
     /// Create a blank layout used for deserialization of target codes.
     virtual IGenerated_code_value_layout *create_value_layout() const = 0;
+
+    /// Compile a lambda function using the JIT into an environment (shader) of a scene and
+    /// reuse or store its native object code in a code cache.
+    ///
+    /// \param code_cache     If non-NULL, a code cache for the native object code
+    /// \param lambda         the lambda function to compile
+    /// \param module_cache   the module cache if any
+    /// \param name_resolver  the call name resolver
+    /// \param ctx            the code generator thread context
+    ///
+    /// \return the compiled function or NULL on compilation errors
+    virtual IGenerated_code_lambda_function *compile_into_environment(
+        ICode_cache                    *code_cache,
+        ILambda_function const         *lambda,
+        IModule_cache                  *module_cache,
+        ICall_name_resolver const      *name_resolver,
+        ICode_generator_thread_context *ctx) = 0;
+
+    /// Compile a lambda function into a generic function using the JIT and reuse or store its
+    /// native object code in a code cache.
+    ///
+    /// \param code_cache           If non-NULL, a code cache for the native object code
+    /// \param lambda               the lambda function to compile
+    /// \param module_cache         the module cache if any
+    /// \param name_resolver        the call name resolver
+    /// \param ctx                  the code generator thread context
+    /// \param num_texture_spaces   the number of supported texture spaces
+    /// \param num_texture_results  the number of texture result entries
+    /// \param transformer          an optional transformer for calls in the lambda expression.
+    ///                             Functions compiled with a transformer are not cached.
+    ///
+    /// \return the compiled function or NULL on compilation errors
+    ///
+    /// \note the lambda function must have only one root expression.
+    virtual IGenerated_code_lambda_function *compile_into_generic_function(
+        ICode_cache                    *code_cache,
+        ILambda_function const         *lambda,
+        IModule_cache                  *module_cache,
+        ICall_name_resolver const      *name_resolver,
+        ICode_generator_thread_context *ctx,
+        unsigned                       num_texture_spaces,
+        unsigned                       num_texture_results,
+        ILambda_call_transformer       *transformer) = 0;
 };
 
 /*!
@@ -1650,6 +1719,7 @@ These options are specific to the MDL JIT code generator:
 - \ref mdl_option_jit_llvm_renderer_module       "jit_llvm_renderer_module"
 - \ref mdl_option_jit_map_strings_to_ids         "jit_map_strings_to_ids"
 - \ref mdl_option_jit_opt_level                  "jit_opt_level"
+- \ref mdl_option_jit_opt_partitions             "jit_opt_partitions"
 - \ref mdl_option_jit_tex_lookup_call_mode       "jit_tex_lookup_call_mode"
 - \ref mdl_option_jit_lambda_return_mode         "jit_lambda_return_mode"
 - \ref mdl_option_jit_tex_runtime_with_derivs    "jit_tex_runtime_with_derivs"
@@ -1758,6 +1828,13 @@ These options are specific to the MDL JIT code generator:
 - <b>jit_opt_level</b>: The optimization level for the JIT code generator.
   Default: \c "2"
 
+\anchor mdl_option_jit_opt_partitions
+- <b>jit_opt_partitions</b>: The number of partitions the LLVM module is split into for
+  optimization. Partitions are optimized concurrently and linked back into one module in a
+  deterministic order before native or PTX code is generated, so the generated code does not
+  depend on thread scheduling. Ignored for HLSL and GLSL and if debug info is generated.
+  Default: \c "1"
+
 \anchor mdl_option_jit_tex_lookup_call_mode
 - <b>jit_tex_lookup_call_mode</b>: Specifies the call mode for texture lookup functions on GPU.
   Possible values:
@@ -160,6 +160,12 @@ public:
     /// \note Only nodes created by the same factory have unique IDs, do not
     ///       compare nodes from different factories.
     virtual size_t get_id() const = 0;
+
+    /// Get the structural hash of this DAG IR node.
+    ///
+    /// The hash is computed once by the node factory when the node is created and covers the
+    /// whole sub-DAG of this node. Temporaries have the hash of their expression.
+    virtual DAG_hash const &get_node_hash() const = 0;
 };
 
 /// A DAG IR constant.
@@ -1500,6 +1500,45 @@ public:
     ///
     /// \returns the resource index or 0 if the resource is unknown.
     virtual unsigned get_known_resource_index(unsigned tag) const = 0;
+
+    /// Run a compiled lambda function on the CPU for several states in a row.
+    ///
+    /// \param[in]  index        the index of the function to execute
+    /// \param[in]  count        the number of states
+    /// \param[out] results      the results will be written to, one every \p result_size bytes
+    /// \param[in]  result_size  the distance between two results in bytes
+    /// \param[in]  states       an array of \p count core states
+    /// \param[in]  tex_data     extra thread data for the texture handler
+    /// \param[in]  cap_args     the captured arguments block, if arguments were captured
+    ///
+    /// \returns false if execution was aborted by runtime error, true otherwise
+    ///
+    /// \note This has the same effect as calling run_generic() for every state, but checks
+    ///       the arguments and sets up the exception handling only once.
+    virtual bool run_generic_batch(
+        size_t                       index,
+        size_t                       count,
+        void                         *results,
+        size_t                       result_size,
+        Shading_state_material const *states,
+        void                         *tex_data,
+        void const                   *cap_args) = 0;
+
+    /// Run a compiled environment function on the CPU for several states in a row.
+    ///
+    /// \param[in]  index     the index of the function to execute
+    /// \param[in]  count     the number of states
+    /// \param[out] results   an array of \p count results
+    /// \param[in]  states    an array of \p count environment states
+    /// \param[in]  tex_data  extra thread data for the texture handler
+    ///
+    /// \returns false if execution was aborted by runtime error, true otherwise
+    virtual bool run_environment_batch(
+        size_t                          index,
+        size_t                          count,
+        RGB_color                       *results,
+        Shading_state_environment const *states,
+        void                            *tex_data) = 0;
 };
 
 } // mdl
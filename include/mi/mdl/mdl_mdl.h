@@ -177,6 +177,9 @@ public:
     /// The name of the option to keep resource file paths as is.
     #define MDL_OPTION_KEEP_ORIGINAL_RESOURCE_FILE_PATHS "keep_original_resource_file_paths"
 
+    /// The name of the option that enables the in-memory index of the MDL search paths.
+    #define MDL_OPTION_SEARCH_PATH_INDEX "search_path_index"
+
 public:
     /// Get the type factory of the compiler.
     ///
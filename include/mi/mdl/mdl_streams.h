@@ -55,6 +55,27 @@ public:
     virtual char const *get_filename() = 0;
 };
 
+/// The interface of an input stream whose remaining content can be accessed as one contiguous
+/// block of memory.
+///
+/// Consumers like the MDL scanner query this interface to read the content directly instead of
+/// calling #IInput_stream::read_char() for every character.
+class IInput_stream_view : public
+    mi::base::Interface_declare<0x87155a0f,0x6a7f,0x455b,0xae,0x2c,0x16,0x65,0xea,0xfd,0x5a,0x7c,
+    IInput_stream>
+{
+public:
+    /// Get the remaining content of the stream and consume it.
+    ///
+    /// After a successful call, the stream is at its end, i.e., read_char() returns -1.
+    ///
+    /// \param[out] length  the length of the returned block in bytes
+    ///
+    /// \returns    The remaining content, valid until the stream is destroyed, or NULL if it is
+    ///             not available as one block. In the latter case the stream is unchanged.
+    virtual char const *get_view(size_t &length) = 0;
+};
+
 /// The interface of an input stream from an archive.
 class IArchive_input_stream : public
     mi::base::Interface_declare<0x6cce8433,0xb727,0x4445,0x9b,0x9d,0x46,0xd8,0xa4,0x9f,0xf6,0x1e,
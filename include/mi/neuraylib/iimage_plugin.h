@@ -238,6 +238,41 @@ public:
     virtual bool write( const ITile* tile, Uint32 z, Uint32 level = 0) = 0;
 };
 
+/// Optional extension of #mi::neuraylib::IImage_file to read parts of an image.
+///
+/// Instances of #mi::neuraylib::IImage_file obtained from
+/// #mi::neuraylib::IImage_plugin::open_for_reading() may additionally implement this interface,
+/// which is queried via #mi::base::IInterface::get_interface(). It allows to load parts of large
+/// images on demand. For image files that do not implement it, entire layers are read via
+/// #mi::neuraylib::IImage_file::read().
+class IImage_file_region_reader
+  : public base::Interface_declare<0x440b8640,0x5153,0x4364,0x9a,0x2a,0xa7,0xa3,0x8d,0x6d,0x25,0x62>
+{
+public:
+    /// Read a rectangular region of pixels from the image file into a tile.
+    ///
+    /// \param x      The x coordinate of the lower left corner of the region.
+    /// \param y      The y coordinate of the lower left corner of the region.
+    /// \param width  The width of the region.
+    /// \param height The height of the region.
+    /// \param z      The z layer (for 3d textures or cubemaps).
+    /// \param level  The mipmap level (always 0 if the image is not a mipmap).
+    /// \return       The tile of size \p width x \p height with the read data, or \c nullptr in
+    ///               case of failures.
+    virtual ITile* read_region(
+        Uint32 x, Uint32 y, Uint32 width, Uint32 height, Uint32 z, Uint32 level = 0) const = 0;
+
+    /// Indicates whether the pixel data is stored in tiles.
+    ///
+    /// For tiled images, reading a region decodes only the tiles overlapping it. Otherwise, entire
+    /// rows are decoded, and callers should prefer regions spanning the full width of the image.
+    ///
+    /// \param z      The z layer (for 3d textures or cubemaps).
+    /// \param level  The mipmap level (always 0 if the image is not a mipmap).
+    /// \return       \c true if the pixel data is stored in tiles, \c false otherwise.
+    virtual bool is_tiled( Uint32 z, Uint32 level = 0) const = 0;
+};
+
 /**@}*/ // end group mi_neuray_plugins
 
 } // namespace neuraylib
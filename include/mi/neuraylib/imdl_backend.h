@@ -95,6 +95,11 @@ public:
     /// The following options are supported by the NATIVE backend only:
     /// - \c "use_builtin_resource_handler": Enables/disables the built-in texture runtime.
     ///   Possible values: \c "on", \c "off". Default: \c "on".
+    /// - \c "texture_runtime_filter": The filter used by the built-in texture runtime for 2D
+    ///   texture lookups. With \c "texture_runtime_with_derivs" enabled, \c "nearest" uses the
+    ///   nearest mipmap level while the other filters interpolate between the two nearest levels.
+    ///   Possible values: \c "nearest", \c "bilinear", \c "biquintic" (bilinear interpolation
+    ///   with smootherstep weights). Default: \c "biquintic".
     ///
     /// The following options are supported by the PTX, LLVM-IR, native and HLSL backend:
     ///
@@ -138,6 +143,12 @@ public:
     ///   Possible values:
     ///   \c "on", \c "off". Default: \c "off".
     ///
+    /// The following options are supported by the PTX, LLVM-IR and native backend:
+    /// - \c "opt_partitions": The number of partitions the code is split into for concurrent
+    ///   optimization. The optimized partitions are linked back into one module in a
+    ///   deterministic order. Ignored if debug info is generated.
+    ///   Possible values: a positive integer. Default: \c "1".
+    ///
     /// The following options are supported by the PTX and LLVM-IR only:
     /// - \c "lambda_return_mode": Selects how generated lambda functions return their results.
     ///   Possible value:
@@ -702,6 +713,21 @@ struct Target_value_layout_state {
     mi::Uint32 m_data_offs;
 };
 
+/// Structure representing an atomic element inside a target argument block.
+///
+/// A list of these elements forms a patch plan, see
+/// #mi::neuraylib::ITarget_value_layout2::get_patch_plan().
+struct Target_value_layout_patch {
+    /// The offset of the element inside the target argument block.
+    mi::Uint32 m_offset;
+
+    /// The size of the element in bytes.
+    mi::Uint32 m_size;
+
+    /// The kind of the element.
+    IValue::Kind m_kind;
+};
+
 /// Represents the layout of an #mi::neuraylib::ITarget_argument_block with support for nested
 /// elements.
 ///
@@ -776,6 +802,86 @@ public:
         Target_value_layout_state state = Target_value_layout_state()) const = 0;
 };
 
+/// Represents the layout of an #mi::neuraylib::ITarget_argument_block with support for bulk
+/// updates of many argument blocks.
+///
+/// The layouts returned by #mi::neuraylib::ITarget_code::get_argument_block_layout() support
+/// this interface, use #mi::base::IInterface::get_interface() to access it.
+class ITarget_value_layout2 : public
+    mi::base::Interface_declare<0x936afa56,0x91aa,0x481f,0xa5,0x0d,0x28,0x60,0xb9,0x66,0x3c,0x08,
+                                ITarget_value_layout>
+{
+public:
+    /// Flattens the argument / element at the given layout state into its atomic elements.
+    ///
+    /// The resulting patch plan lists the atomic elements in layout order. It can be computed
+    /// once and then be used with #set_values() to update this argument in many argument blocks,
+    /// without traversing the nested layout for every block.
+    ///
+    /// \param[out] patches      Receives up to \p max_patches atomic elements. May be \c NULL if
+    ///                          \p max_patches is 0.
+    /// \param      max_patches  The number of entries available in \p patches.
+    /// \param      state        The layout state representing the current nesting within the
+    ///                          argument value block. The default value is used for the
+    ///                          top-level.
+    ///
+    /// \return  the number of atomic elements of the argument / element, which may be larger
+    ///          than \p max_patches, or \c "~mi::Size(0)" if the state is invalid.
+    virtual Size get_patch_plan(
+        Target_value_layout_patch *patches,
+        Size max_patches,
+        Target_value_layout_state state = Target_value_layout_state()) const = 0;
+
+    /// Applies a patch plan to several argument blocks.
+    ///
+    /// The values are raw data in the representation used inside the argument block, i.e.,
+    /// \c bool values use one byte, resources use their resource index and strings their string
+    /// identifier. For the i'th block, the values of all patches are read tightly packed in patch
+    /// order starting at \p data + i * \p data_stride.
+    ///
+    /// \param[inout] blocks       The argument blocks to be modified.
+    /// \param num_blocks          The number of argument blocks.
+    /// \param patches             The patch plan.
+    /// \param num_patches         The number of entries in \p patches.
+    /// \param data                The raw values.
+    /// \param data_stride         The distance in bytes between the values of two blocks.
+    ///
+    /// \return
+    ///                      -  0: Success.
+    ///                      - -1: Invalid parameters, \c NULL pointers.
+    ///                      - -2: A patch lies outside of an argument block.
+    virtual Sint32 set_values(
+        ITarget_argument_block * const *blocks,
+        Size num_blocks,
+        Target_value_layout_patch const *patches,
+        Size num_patches,
+        void const *data,
+        Size data_stride) const = 0;
+
+    /// Gathers the values of a patch plan from several argument blocks into a contiguous
+    /// structure-of-arrays buffer, for instance a staging buffer for an upload.
+    ///
+    /// For every patch, the values of all blocks are stored consecutively, in patch order.
+    /// The buffer must provide the sum of all patch sizes times \p num_blocks bytes.
+    ///
+    /// \param blocks              The argument blocks to read.
+    /// \param num_blocks          The number of argument blocks.
+    /// \param patches             The patch plan.
+    /// \param num_patches         The number of entries in \p patches.
+    /// \param[out] buffer         The buffer receiving the values.
+    ///
+    /// \return
+    ///                      -  0: Success.
+    ///                      - -1: Invalid parameters, \c NULL pointers.
+    ///                      - -2: A patch lies outside of an argument block.
+    virtual Sint32 get_values_soa(
+        ITarget_argument_block const * const *blocks,
+        Size num_blocks,
+        Target_value_layout_patch const *patches,
+        Size num_patches,
+        void *buffer) const = 0;
+};
+
 /// Represents target code of an MDL backend.
 class ITarget_code : public
     mi::base::Interface_declare<0xefca46ae,0xd530,0x4b97,0x9d,0xab,0x3a,0xdb,0x0c,0x58,0xc3,0xac>
@@ -119,6 +119,10 @@ public:
 ///   option can be used to pass additional data from a call site of
 ///   #mi::neuraylib::IMdl_impexp_api::load_module() to a custom implementation of the entity
 ///   resolver. Default: \c NULL.
+/// - \c bool "parallel_import_loading": If \c true, the import graph of a module loaded via
+///   #mi::neuraylib::IMdl_impexp_api::load_module() is determined upfront, and imported modules
+///   are compiled concurrently, each one as soon as its own imports are loaded. Default:
+///   \c false.
 ///
 /// Options for MDL export
 /// - \c bool "bundle_resources": If \c true, referenced resources are exported into the same
@@ -246,7 +246,7 @@ mi::Sint32 Neuray_impl::start( bool blocking)
     result = m_mdl_backend_api_impl->start();        CHECK_RESULT;
     result = m_mdl_compatibility_api_impl->start();  CHECK_RESULT;
     result = m_mdl_configuration_impl->start();      CHECK_RESULT;
-    result = m_mdl_discovery_api_impl->start();      CHECK_RESULT;
+    result = m_mdl_discovery_api_impl->start( m_database); CHECK_RESULT;
     result = m_mdl_distiller_api_impl->start();      CHECK_RESULT;
     result = m_mdl_evaluator_api_impl->start();      CHECK_RESULT;
     result = m_mdl_factory_impl->start();            CHECK_RESULT;
@@ -274,6 +274,7 @@ mi::Sint32 Neuray_impl::start( bool blocking)
     mi::base::Handle<IMAGE::IMdl_container_callback> callback(
         MDL::create_mdl_container_callback());
     image_module->set_mdl_container_callback( callback.get());
+    image_module->set_database( m_database);
 
     m_status = STARTED;
 
@@ -289,6 +290,7 @@ mi::Sint32 Neuray_impl::shutdown( bool blocking)
 
     SYSTEM::Access_module<IMAGE::Image_module> image_module( false);
     image_module->set_mdl_container_callback( 0);
+    image_module->set_database( 0);
 
     NEURAY::Class_registration::unregister_structure_declarations( m_class_factory);
 
@@ -45,6 +45,8 @@
 #include <mi/mdl/mdl_modules.h>
 #include <mi/mdl/mdl_streams.h>
 
+#include <base/data/db/i_db_database.h>
+#include <base/data/db/i_db_fragmented_job.h>
 #include <base/hal/disk/disk.h>
 #include <base/hal/hal/i_hal_ospath.h>
 #include <base/lib/path/i_path.h>
@@ -54,6 +56,8 @@
 #include <io/scene/mdl_elements/i_mdl_elements_module.h>
 #include <io/scene/mdl_elements/i_mdl_elements_utilities.h>
 
+#include <ctime>
+#include <set>
 #include <string>
 
 namespace MI {
@@ -68,6 +72,10 @@ namespace
     {
         return 0 > strcmp(hp1->get_simple_name(), hp2->get_simple_name());
     }
+
+    // The maximum number of directory and archive listings kept between discover() calls.
+    const size_t max_cached_directories = 4096;
+    const size_t max_cached_archives = 256;
 }
 
 void Mdl_module_info_impl::add_shadow(Mdl_module_info_impl* shadow)
@@ -565,8 +573,11 @@ void Mdl_package_info_impl::reset_package(Mdl_package_info_impl* child, int inde
 
 Mdl_discovery_api_impl::Mdl_discovery_api_impl(mi::neuraylib::INeuray* neuray)
     : m_neuray(neuray)
+    , m_database(nullptr)
     , m_mdlc_module(true)
     , m_path_module(true)
+    , m_directory_cache(max_cached_directories)
+    , m_archive_cache(max_cached_archives)
 {
 }
 
@@ -764,17 +775,299 @@ namespace {
 
 } // end namespace
 
+struct Mdl_discovery_api_impl::Directory_listing
+{
+    enum Kind { ENTRY_OTHER, ENTRY_FILE, ENTRY_DIRECTORY };
+
+    // The time of the last modification of the directory.
+    double m_mtime = 0.0;
+
+    // The names of the entries, in the order returned by DISK::Directory.
+    std::vector<std::string> m_names;
+
+    // The kinds of the entries.
+    std::vector<Kind> m_kinds;
+};
+
+struct Mdl_discovery_api_impl::Archive_listing
+{
+    // The size and the time of the last modification of the archive.
+    mi::Sint64 m_size = 0;
+    double m_mtime = 0.0;
+
+    // True, if the archive could be read.
+    bool m_valid = false;
+
+    // The entries as returned by read_archive().
+    std::vector<std::string> m_entries;
+};
+
+// Reads one directory or archive per fragment.
+class Mdl_discovery_api_impl::Crawl_job : public DB::Fragmented_job
+{
+public:
+    struct Item {
+        std::string m_path;
+        bool m_is_archive;
+    };
+
+    Crawl_job(
+        const Mdl_discovery_api_impl* discovery,
+        const std::vector<Item>& items,
+        mi::Uint32 filter)
+      : m_discovery(discovery)
+      , m_items(items)
+      , m_filter(filter)
+      , m_directories(items.size())
+      , m_archives(items.size())
+    {
+    }
+
+    void execute_fragment(
+        DB::Transaction* transaction,
+        size_t index,
+        size_t count,
+        const mi::neuraylib::IJob_execution_context* context) override
+    {
+        const Item& item = m_items[index];
+        if (item.m_is_archive)
+            m_archives[index] = m_discovery->read_archive_cached(item.m_path, m_filter);
+        else
+            m_directories[index] = m_discovery->read_directory(item.m_path);
+    }
+
+    const std::vector<Item>& get_items() const { return m_items; }
+
+    const std::shared_ptr<const Directory_listing>& get_directory(size_t index) const
+    { return m_directories[index]; }
+
+    const std::shared_ptr<const Archive_listing>& get_archive(size_t index) const
+    { return m_archives[index]; }
+
+private:
+    const Mdl_discovery_api_impl* m_discovery;
+    std::vector<Item> m_items;
+    mi::Uint32 m_filter;
+    std::vector<std::shared_ptr<const Directory_listing>> m_directories;
+    std::vector<std::shared_ptr<const Archive_listing>> m_archives;
+};
+
+namespace {
+
+    // Listings of directories and archives modified within this number of seconds are not
+    // cached since further modifications might not change the time stamp.
+    const double racy_mtime_seconds = 2.0;
+
+    bool is_racy(double mtime)
+    {
+        return double(std::time(nullptr)) - mtime <= racy_mtime_seconds;
+    }
+
+} // end namespace
+
+std::shared_ptr<const Mdl_discovery_api_impl::Directory_listing>
+Mdl_discovery_api_impl::read_directory(const std::string& path) const
+{
+    DISK::Stat st;
+    if (!DISK::stat(path.c_str(), &st) || !st.m_is_dir)
+        return nullptr;
+
+    double mtime = st.m_modification_time.get_seconds();
+    {
+        std::lock_guard<std::mutex> lock(m_cache_mutex);
+        std::shared_ptr<const Directory_listing> cached = m_directory_cache.lookup(path);
+        if (cached && cached->m_mtime == mtime)
+            return cached;
+    }
+
+    DISK::Directory dir;
+    if (!dir.open(path.c_str()))
+        return nullptr;
+
+    auto listing = std::make_shared<Directory_listing>();
+    listing->m_mtime = mtime;
+
+    std::string entry = dir.read();
+    while (!entry.empty()) {
+        Directory_listing::Kind kind = Directory_listing::ENTRY_OTHER;
+        DISK::Stat entry_st;
+        if (DISK::stat(HAL::Ospath::join(path, entry).c_str(), &entry_st)) {
+            if (entry_st.m_is_dir)
+                kind = Directory_listing::ENTRY_DIRECTORY;
+            else if (entry_st.m_is_file)
+                kind = Directory_listing::ENTRY_FILE;
+        }
+        listing->m_names.push_back(entry);
+        listing->m_kinds.push_back(kind);
+        entry = dir.read();
+    }
+    dir.close();
+
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
+    if (is_racy(mtime))
+        m_directory_cache.erase(path);
+    else
+        m_directory_cache.enter(path, listing);
+    return listing;
+}
+
+std::shared_ptr<const Mdl_discovery_api_impl::Archive_listing>
+Mdl_discovery_api_impl::read_archive_cached(const std::string& path, mi::Uint32 filter) const
+{
+    DISK::Stat st;
+    if (!DISK::stat(path.c_str(), &st) || !st.m_is_file)
+        return nullptr;
+
+    std::string key = path + '|' + std::to_string(filter);
+    double mtime = st.m_modification_time.get_seconds();
+    {
+        std::lock_guard<std::mutex> lock(m_cache_mutex);
+        std::shared_ptr<const Archive_listing> cached = m_archive_cache.lookup(key);
+        if (cached && cached->m_size == st.m_size && cached->m_mtime == mtime)
+            return cached;
+    }
+
+    auto listing = std::make_shared<Archive_listing>();
+    listing->m_size = st.m_size;
+    listing->m_mtime = mtime;
+    listing->m_valid = read_archive(path.c_str(), listing->m_entries, filter);
+
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
+    if (is_racy(mtime))
+        m_archive_cache.erase(key);
+    else
+        m_archive_cache.enter(key, listing);
+    return listing;
+}
+
+void Mdl_discovery_api_impl::get_search_path_archives(
+    const std::string& path,
+    const Directory_listing& listing,
+    Search_path_archives& result) const
+{
+    std::map<std::string, bool> archives;
+    for (size_t j = 0; j < listing.m_names.size(); ++j) {
+        const std::string& entry = listing.m_names[j];
+        if (listing.m_kinds[j] == Directory_listing::ENTRY_FILE) {
+            std::size_t found_mdr = entry.rfind(".mdr");
+            if (found_mdr != std::string::npos && found_mdr == entry.size() - 4)
+                archives.insert(
+                    std::make_pair(entry.substr(0, found_mdr), 
+                    true));  
+        }
+    }
+
+    for (auto& archive : archives) {
+        if (validate_archive(
+            archive, 
+            archives, 
+            result.m_invalid_dirs, 
+            path)) {
+                std::string resolved_path = HAL::Ospath::join(path, archive.first);
+                resolved_path += ".mdr";
+                result.m_archives.push_back(resolved_path);
+        }
+    }
+}
+
+void Mdl_discovery_api_impl::crawl(
+    const std::vector<std::string>& search_paths,
+    mi::Uint32 filter,
+    Directory_map& directories,
+    Archive_map& archives,
+    std::vector<Search_path_archives>& search_path_archives) const
+{
+    search_path_archives.assign(search_paths.size(), Search_path_archives());
+
+    // The directories of the next depth, with the indices of the search paths they are reached
+    // from. A directory might be shadowed by an archive in one search path, but not in another.
+    std::map<std::string, std::set<size_t>> next;
+    for (size_t i = 0; i < search_paths.size(); ++i)
+        next[search_paths[i]].insert(i);
+
+    std::set<std::pair<std::string, size_t>> visited;
+    for (size_t i = 0; i < search_paths.size(); ++i)
+        visited.insert(std::make_pair(search_paths[i], i));
+
+    std::vector<Crawl_job::Item> pending_archives;
+
+    // Breadth-first, such that all directories of the same depth are read in parallel.
+    while (!next.empty() || !pending_archives.empty()) {
+        std::vector<Crawl_job::Item> level;
+        level.swap(pending_archives);
+        for (const auto& n : next)
+            if (directories.insert(std::make_pair(n.first, nullptr)).second)
+                level.push_back({n.first, false});
+
+        Crawl_job job(this, level, filter);
+        if (m_database && level.size() > 1)
+            m_database->execute_fragmented(&job, level.size());
+        else
+            for (size_t i = 0; i < level.size(); ++i)
+                job.execute_fragment(nullptr, i, level.size(), nullptr);
+
+        const std::vector<Crawl_job::Item>& items = job.get_items();
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (items[i].m_is_archive)
+                archives[items[i].m_path] = job.get_archive(i);
+            else
+                directories[items[i].m_path] = job.get_directory(i);
+        }
+
+        std::map<std::string, std::set<size_t>> current;
+        current.swap(next);
+        for (const auto& c : current) {
+            const std::string& path = c.first;
+            const std::shared_ptr<const Directory_listing>& listing = directories[path];
+            if (!listing)
+                continue;
+
+            for (size_t root : c.second) {
+                Search_path_archives& sp_archives = search_path_archives[root];
+
+                // archives are only considered directly in the search paths, they shadow
+                // directories of the same search path
+                if (path == search_paths[root]) {
+                    get_search_path_archives(path, *listing, sp_archives);
+                    for (const std::string& archive : sp_archives.m_archives)
+                        if (archives.insert(std::make_pair(archive, nullptr)).second)
+                            pending_archives.push_back({archive, true});
+                }
+
+                for (size_t j = 0; j < listing->m_names.size(); ++j) {
+                    if (listing->m_kinds[j] != Directory_listing::ENTRY_DIRECTORY)
+                        continue;
+
+                    // discover_filesystem_recursive() skips these directories
+                    const std::string& name = listing->m_names[j];
+                    if (!(filter & mi::neuraylib::IMdl_info::Kind::DK_DIRECTORY)
+                        && !is_valid_node_name(name.c_str()))
+                        continue;
+                    std::string resolved_path = HAL::Ospath::join(path, name);
+                    if (!is_valid_path(sp_archives.m_invalid_dirs, resolved_path))
+                        continue;
+
+                    if (visited.insert(std::make_pair(resolved_path, root)).second)
+                        next[resolved_path].insert(root);
+                }
+            }
+        }
+    }
+}
+
 bool Mdl_discovery_api_impl::discover_filesystem_recursive(
     const mi::base::Handle<Mdl_package_info_impl>& parent,
     const char* search_path, 
     mi::Size s_idx, 
     const char* path, 
     const std::vector<std::string>& invalid_dirs,
+    const Directory_map& directories,
     mi::Uint32 filter) const
 {
-    DISK::Directory dir;
-    if (!dir.open(path))
+    auto it = directories.find(path);
+    if (it == directories.end() || !it->second)
         return false;
+    const Directory_listing& listing = *it->second;
 
     std::string current_path(path);
     std::string package_path;
@@ -783,14 +1076,13 @@ bool Mdl_discovery_api_impl::discover_filesystem_recursive(
         package_path);
     package_path += "::";
 
-    std::string entry = dir.read();
-    while (!entry.empty()) {
+    for (size_t i = 0; i < listing.m_names.size(); ++i) {
+        std::string entry = listing.m_names[i];
         std::string resolved_path = HAL::Ospath::join(current_path, entry);
-        if (DISK::is_directory(resolved_path.c_str())) {
+        if (listing.m_kinds[i] == Directory_listing::ENTRY_DIRECTORY) {
             if (!is_valid_path( 
                 invalid_dirs, 
                 resolved_path)) {
-                entry = dir.read();
                 continue;
             }
            
@@ -808,7 +1100,6 @@ bool Mdl_discovery_api_impl::discover_filesystem_recursive(
                     child_package->set_kind(mi::neuraylib::IMdl_info::Kind::DK_DIRECTORY);
                 }
                 else {
-                    entry = dir.read();
                     continue;
                 }
             }
@@ -826,6 +1117,7 @@ bool Mdl_discovery_api_impl::discover_filesystem_recursive(
                     s_idx, 
                     resolved_path.c_str(), 
                     invalid_dirs,
+                    directories,
                     filter);
                 parent->reset_package(merge_package.get(), idx);
             }
@@ -837,6 +1129,7 @@ bool Mdl_discovery_api_impl::discover_filesystem_recursive(
                     s_idx, 
                     resolved_path.c_str(), 
                     invalid_dirs,
+                    directories,
                     filter);
                 parent->add_package(child_package.get());
             }
@@ -844,13 +1137,11 @@ bool Mdl_discovery_api_impl::discover_filesystem_recursive(
         else {
             size_t pos_e = entry.find_last_of('.');
             if (pos_e == std::string::npos) {
-                entry = dir.read();
                 continue;
             }
             else {
                 entry = entry.substr(0, pos_e);
                 if (!is_valid_node_name(entry.c_str())) {
-                    entry = dir.read();
                     continue;
                 }
             }
@@ -860,7 +1151,7 @@ bool Mdl_discovery_api_impl::discover_filesystem_recursive(
 
             size_t pos_rp = resolved_path.find_last_of('.');
             std::string short_path(resolved_path.substr(0, pos_rp));
-            if (DISK::is_file(resolved_path.c_str()) &&
+            if ((listing.m_kinds[i] == Directory_listing::ENTRY_FILE) &&
                 (is_valid_path(invalid_dirs, short_path)) &&
                 (pos_rp != std::string::npos)) {
                 std::string ext = resolved_path.substr(
@@ -937,9 +1228,7 @@ bool Mdl_discovery_api_impl::discover_filesystem_recursive(
                 }
             }
         }
-        entry = dir.read();
     }
-    dir.close();
     return true;
 }
 
@@ -951,49 +1240,58 @@ const mi::neuraylib::IMdl_discovery_result* Mdl_discovery_api_impl::discover(
     mi::base::Handle<Mdl_package_info_impl> root_package(
         new Mdl_package_info_impl("", "", "", -1, ""));
 
+    std::vector<std::string> paths(search_paths.size());
+    std::vector<std::string> valid_paths;
+    std::vector<size_t> valid_path_indices(search_paths.size());
     for (mi::Size i = 0; i < search_paths.size(); ++i) {
-        std::string path = search_paths[i]; 
+        std::string path = search_paths[i];
         if (!DISK::access(path.c_str(), false))
             continue;
 
         if (!DISK::is_path_absolute(path))
             path = HAL::Ospath::join(DISK::get_cwd(), path);
-        path = HAL::Ospath::normpath_v2(path);
+        paths[i] = HAL::Ospath::normpath_v2(path);
+        valid_path_indices[i] = valid_paths.size();
+        valid_paths.push_back(paths[i]);
+    }
+
+    // Listings below search paths that are no longer used would only take up space
+    {
+        std::lock_guard<std::mutex> lock(m_cache_mutex);
+        if (valid_paths != m_cached_search_paths) {
+            m_directory_cache.clear();
+            m_archive_cache.clear();
+            m_cached_search_paths = valid_paths;
+        }
+    }
+
+    // Read all directories and archives up front, the graph is built from the listings
+    Directory_map directories;
+    Archive_map archives_listings;
+    std::vector<Search_path_archives> search_path_archives;
+    crawl(valid_paths, filter, directories, archives_listings, search_path_archives);
 
-        DISK::Directory dir;
-        if (!dir.open(path.c_str()))
+    for (mi::Size i = 0; i < search_paths.size(); ++i) {
+        const std::string& path = paths[i];
+        if (path.empty())
             continue;
 
-        std::string entry = dir.read();
-        std::map<std::string, bool> archives;
-        while (!entry.empty()) {
-            if (DISK::is_file(HAL::Ospath::join(path, entry).c_str())) {
-                std::size_t found_mdr = entry.rfind(".mdr");
-                if (found_mdr != std::string::npos && found_mdr == entry.size() - 4)
-                    archives.insert(
-                        std::make_pair(entry.substr(0, found_mdr), 
-                        true));  
-            }
-            entry = dir.read();
-        }
+        auto it = directories.find(path);
+        if (it == directories.end() || !it->second)
+            continue;
+        const Search_path_archives& sp_archives = search_path_archives[valid_path_indices[i]];
 
         // Discover archives
-        std::vector<std::string> invalid_directies;
-        for (auto& archive : archives) {
-            if (validate_archive(
-                archive, 
-                archives, 
-                invalid_directies, 
-                path)) {
-                    std::string resolved_path = HAL::Ospath::join(path, archive.first);
-                    resolved_path += ".mdr";
-                    discover_archive(
-                        root_package, 
-                        path.c_str(), 
-                        i, 
-                        resolved_path.c_str(),
-                        filter);
-            }
+        for (const std::string& resolved_path : sp_archives.m_archives) {
+            auto a_it = archives_listings.find(resolved_path);
+            if (a_it == archives_listings.end() || !a_it->second || !a_it->second->m_valid)
+                continue;
+            discover_archive(
+                root_package, 
+                path.c_str(), 
+                i, 
+                resolved_path.c_str(),
+                a_it->second->m_entries);
         }
 
         // Discover file system
@@ -1002,7 +1300,8 @@ const mi::neuraylib::IMdl_discovery_result* Mdl_discovery_api_impl::discover(
             path.c_str(), 
             i, 
             path.c_str(), 
-            invalid_directies,
+            sp_archives.m_invalid_dirs,
+            directories,
             filter);
     }
     root_package->sort_children();
@@ -1360,12 +1659,8 @@ bool Mdl_discovery_api_impl::discover_archive(
     const char* search_path, 
     mi::Size s_idx, 
     const char* res_path,
-    mi::Uint32 filter) const
+    const std::vector<std::string>& entry_list) const
 {
-    std::vector<std::string> entry_list;
-    if (!read_archive(res_path, entry_list, filter))
-        return false;
-    
     for (mi::Size x = 0; x < entry_list.size(); ++x) {
         mi::Size p = 0;
         while (entry_list[x][p] == ':')
@@ -1392,8 +1687,9 @@ bool Mdl_discovery_api_impl::discover_archive(
     return true;
 }
 
-mi::Sint32 Mdl_discovery_api_impl::start()
+mi::Sint32 Mdl_discovery_api_impl::start( DB::Database* database)
 {
+    m_database = database;
     m_path_module.set();
     m_mdlc_module.set();
     return 0;
@@ -1403,6 +1699,12 @@ mi::Sint32 Mdl_discovery_api_impl::shutdown()
 {
     m_path_module.reset();
     m_mdlc_module.reset();
+    m_database = nullptr;
+
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
+    m_directory_cache.clear();
+    m_archive_cache.clear();
+    m_cached_search_paths.clear();
     return 0;
 }
 
@@ -41,6 +41,10 @@
 #include <mi/base/interface_implement.h>
 #include <base/system/main/access_module.h>
 
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -51,6 +55,7 @@ namespace mi { namespace neuraylib { class INeuray; } }
 
 namespace MI {
 
+    namespace DB { class Database; }
     namespace PATH { class Path_module; }
     namespace MDLC { class Mdlc_module; }
     namespace MDL { class Mdl_module; }
@@ -511,11 +516,116 @@ class Mdl_discovery_api_impl
 
         const mi::neuraylib::IMdl_discovery_result* discover(mi::Uint32 filter) const final;
 
-        mi::Sint32 start();
+        mi::Sint32 start( DB::Database* database);
 
         mi::Sint32 shutdown();
 
     private:
+        // The entries of a directory, see crawl().
+        struct Directory_listing;
+
+        // The filtered entries of an archive, see crawl().
+        struct Archive_listing;
+
+        class Crawl_job;
+
+        typedef std::map<std::string, std::shared_ptr<const Directory_listing>> Directory_map;
+        typedef std::map<std::string, std::shared_ptr<const Archive_listing>> Archive_map;
+
+        // A bounded map of listings from previous discover() calls. If the map is full, the least
+        // recently used listing is dropped. Not thread-safe, see m_cache_mutex.
+        template<typename Listing>
+        class Listing_cache {
+        public:
+            explicit Listing_cache(size_t max_entries) : m_max_entries(max_entries) { }
+
+            // Returns the listing for key (or nullptr), and marks it as most recently used.
+            std::shared_ptr<const Listing> lookup(const std::string& key)
+            {
+                auto it = m_entries.find(key);
+                if (it == m_entries.end())
+                    return nullptr;
+                m_lru.splice(m_lru.begin(), m_lru, it->second.m_lru_pos);
+                return it->second.m_listing;
+            }
+
+            // Adds or replaces the listing for key.
+            void enter(const std::string& key, const std::shared_ptr<const Listing>& listing)
+            {
+                auto it = m_entries.find(key);
+                if (it != m_entries.end()) {
+                    it->second.m_listing = listing;
+                    m_lru.splice(m_lru.begin(), m_lru, it->second.m_lru_pos);
+                    return;
+                }
+                while (!m_lru.empty() && m_entries.size() >= m_max_entries) {
+                    m_entries.erase(m_lru.back());
+                    m_lru.pop_back();
+                }
+                m_lru.push_front(key);
+                m_entries[key] = Entry{listing, m_lru.begin()};
+            }
+
+            void erase(const std::string& key)
+            {
+                auto it = m_entries.find(key);
+                if (it == m_entries.end())
+                    return;
+                m_lru.erase(it->second.m_lru_pos);
+                m_entries.erase(it);
+            }
+
+            void clear() { m_entries.clear(); m_lru.clear(); }
+
+        private:
+            typedef std::list<std::string> Lru_list;
+
+            struct Entry {
+                std::shared_ptr<const Listing> m_listing;
+                Lru_list::iterator m_lru_pos;
+            };
+
+            // The keys of all entries, most recently used first.
+            Lru_list m_lru;
+            std::unordered_map<std::string, Entry> m_entries;
+            size_t m_max_entries;
+        };
+
+        // The archives of a search path that are discovered and the directories they shadow.
+        struct Search_path_archives {
+            // The resolved paths of the archives, in the order of discovery.
+            std::vector<std::string> m_archives;
+
+            // The directories that are skipped when discovering the search path.
+            std::vector<std::string> m_invalid_dirs;
+        };
+
+        // Reads the directories below the search paths and the archives in the search paths.
+        //
+        // Directories shadowed by archives and directories that are skipped by the discovery are
+        // not read. Directories of the same depth and archives are read in parallel. Listings of
+        // unchanged directories and archives are taken from the results of previous calls.
+        void crawl(
+            const std::vector<std::string>& search_paths,
+            mi::Uint32 filter,
+            Directory_map& directories,
+            Archive_map& archives,
+            std::vector<Search_path_archives>& search_path_archives) const;
+
+        // Determines the archives of a search path that are discovered and the directories they
+        // shadow from the listing of the search path.
+        void get_search_path_archives(
+            const std::string& path,
+            const Directory_listing& listing,
+            Search_path_archives& result) const;
+
+        // Reads a directory or takes its listing from the cache.
+        std::shared_ptr<const Directory_listing> read_directory(const std::string& path) const;
+
+        // Reads an archive or takes its listing from the cache.
+        std::shared_ptr<const Archive_listing> read_archive_cached(
+            const std::string& path,
+            mi::Uint32 filter) const;
 
         // Checks if a graph item name is a valid MDL module or package name.
         bool is_valid_node_name(const char* identifier) const;
@@ -543,13 +653,13 @@ class Mdl_discovery_api_impl
             std::vector<std::string>& e_list,
             mi::Uint32 filter) const;
 
-        // Creates a graph structure out of an mdl archive file.
+        // Creates a graph structure out of the entries of an mdl archive file.
         bool discover_archive(
             const mi::base::Handle<Mdl_package_info_impl>& parent,
             const char* search_path,
             mi::Size search_idx,
             const char* dir,
-            mi::Uint32 filter) const;
+            const std::vector<std::string>& entry_list) const;
 
         // Direct recursion to create a graph out of an archive entry.
         bool discover_archive_recursive(
@@ -569,11 +679,20 @@ class Mdl_discovery_api_impl
             mi::Size search_idx,
             const char* dir,
             const std::vector<std::string>& invalid_dirs,
+            const Directory_map& directories,
             mi::Uint32 filter) const;
 
         mi::neuraylib::INeuray*                          m_neuray;
+        DB::Database*                                    m_database;
         SYSTEM::Access_module<MDLC::Mdlc_module> m_mdlc_module;
         SYSTEM::Access_module<PATH::Path_module> m_path_module;
+
+        // Listings of previous discover() calls, keyed by path (and filter for archives). Both
+        // caches are dropped if the search paths change.
+        mutable std::mutex                         m_cache_mutex;
+        mutable Listing_cache<Directory_listing>   m_directory_cache;
+        mutable Listing_cache<Archive_listing>     m_archive_cache;
+        mutable std::vector<std::string>           m_cached_search_paths;
 };
 
 /// This class implements the discover result.
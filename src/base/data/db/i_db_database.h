@@ -183,6 +183,11 @@ public:
 
     /// Sets the limits for memory usage of the database.
     ///
+    /// If the memory usage of all database elements (as reported by Element_base::get_size())
+    /// exceeds the high water mark, the database asks the least recently used elements to release
+    /// reloadable data (see Element_base::release_memory()) until the memory usage drops below the
+    /// low water mark. A high water mark of 0 disables the limits.
+    ///
     /// \see #mi::neuraylib::IDatabase_configuration::set_memory_limits().
     virtual mi::Sint32 set_memory_limits( size_t low_water, size_t high_water) = 0;
 
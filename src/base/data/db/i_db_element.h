@@ -92,6 +92,18 @@ public:
     /// Used to make decisions about garbage collection, offloading, etc.
     virtual size_t get_size() const { return sizeof( *this); }
 
+    /// Releases memory held by the element that can be reloaded or recomputed later.
+    ///
+    /// Invoked by the database if memory limits are set and the memory usage exceeds the high
+    /// water mark (see #Database::set_memory_limits()). Only data that is not in use and that is
+    /// transparently restored on the next access may be released, i.e., the observable state of
+    /// the element must not change. The default implementation does nothing.
+    ///
+    /// \note No database operations may be performed from within the callback.
+    ///
+    /// \return   The approximate number of bytes released.
+    virtual size_t release_memory() const { return 0; }
+
     /// Indicates how the database element should be distributed in the cluster.
     ///
     /// If the method returns \c true the stored or edited database element is distributed to all
@@ -39,6 +39,7 @@
 
 // After inclusion of dblight_util.h which might define the macro.
 #ifdef DBLIGHT_ENABLE_STATISTICS
+#include <algorithm>
 #include <iostream>
 #endif // DBLIGHT_ENABLE_STATISTICS
 
@@ -81,6 +82,10 @@ Database_impl::Database_impl()
     if( m_check_serialization_edit)
         LOG::mod_log->info( M_DB, LOG::Mod_log::C_DATABASE,
             "Testing of serialization for database elements after edits enabled.");
+
+    bool work_stealing = false;
+    CONFIG::update_value( registry, "thread_pool_work_stealing", work_stealing);
+    m_thread_pool->set_work_stealing_enabled( work_stealing);
 }
 
 Database_impl::~Database_impl()
@@ -118,6 +123,7 @@ void Database_impl::garbage_collection( int priority)
 {
     THREAD::Block block( &m_lock);
     m_info_manager->garbage_collection( m_transaction_manager->get_lowest_open_transaction_id());
+    enforce_memory_limits();
 }
 
 #define NOT_IMPLEMENTED { MI_ASSERT( !"Not implemented"); }
@@ -130,15 +136,23 @@ void Database_impl::check_is_locked( mi::Uint32 lock_id) NOT_IMPLEMENTED
 
 mi::Sint32 Database_impl::set_memory_limits( size_t low_water, size_t high_water)
 {
-    MI_ASSERT( !"Not implemented");
-    return -1;
+    if( high_water > 0 && low_water >= high_water)
+        return -1;
+
+    THREAD::Block block( &m_lock);
+    // Sizes are not updated on accesses without memory limits, measure them all once.
+    if( m_high_water == 0 && high_water > 0)
+        m_info_manager->update_all_sizes();
+    m_low_water  = low_water;
+    m_high_water = high_water;
+    enforce_memory_limits();
+    return 0;
 }
 
 void Database_impl::get_memory_limits( size_t& low_water, size_t& high_water) const
 {
-    MI_ASSERT( !"Not implemented");
-    low_water = 0;
-    high_water = 0;
+    low_water  = m_low_water;
+    high_water = m_high_water;
 }
 
 void Database_impl::register_status_listener( DB::Status_listener* listener) NOT_IMPLEMENTED
@@ -146,14 +160,64 @@ void Database_impl::register_status_listener( DB::Status_listener* listener) NOT
 void Database_impl::unregister_status_listener( DB::Status_listener* listener) NOT_IMPLEMENTED
 
 void Database_impl::register_transaction_listener( DB::ITransaction_listener* listener)
-NOT_IMPLEMENTED
+{
+    if( !listener)
+        return;
+
+    THREAD::Block block( m_listeners_lock);
+    m_transaction_listeners.push_back( mi::base::make_handle_dup( listener));
+}
 
 void Database_impl::unregister_transaction_listener( DB::ITransaction_listener* listener)
-NOT_IMPLEMENTED
+{
+    THREAD::Block block( m_listeners_lock);
+    auto it = std::find( m_transaction_listeners.begin(), m_transaction_listeners.end(), listener);
+    if( it != m_transaction_listeners.end())
+        m_transaction_listeners.erase( it);
+}
+
+void Database_impl::register_scope_listener( DB::IScope_listener* listener)
+{
+    if( !listener)
+        return;
+
+    THREAD::Block block( m_listeners_lock);
+    m_scope_listeners.push_back( mi::base::make_handle_dup( listener));
+}
 
-void Database_impl::register_scope_listener( DB::IScope_listener* listener) NOT_IMPLEMENTED
+void Database_impl::unregister_scope_listener( DB::IScope_listener* listener)
+{
+    THREAD::Block block( m_listeners_lock);
+    auto it = std::find( m_scope_listeners.begin(), m_scope_listeners.end(), listener);
+    if( it != m_scope_listeners.end())
+        m_scope_listeners.erase( it);
+}
 
-void Database_impl::unregister_scope_listener( DB::IScope_listener* listener) NOT_IMPLEMENTED
+void Database_impl::notify_transaction_listeners(
+    void (DB::ITransaction_listener::*method)( DB::Transaction*),
+    DB::Transaction* transaction)
+{
+    // Invoke the callbacks on a copy such that listeners can (un)register listeners.
+    std::vector<mi::base::Handle<DB::ITransaction_listener>> listeners;
+    {
+        THREAD::Block block( m_listeners_lock);
+        if( m_transaction_listeners.empty())
+            return;
+        listeners = m_transaction_listeners;
+    }
+
+    for( const auto& listener: listeners)
+        (listener.get()->*method)( transaction);
+}
+
+void Database_impl::enforce_memory_limits()
+{
+    const size_t high_water = m_high_water;
+    if( high_water == 0)
+        return;
+
+    m_info_manager->enforce_memory_limits( m_low_water, high_water);
+}
 
 mi::Sint32 Database_impl::execute_fragmented( DB::Fragmented_job* job, size_t count)
 {
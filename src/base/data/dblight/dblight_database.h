@@ -35,7 +35,11 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include <mi/base/handle.h>
+
+#include <base/hal/thread/i_thread_lock.h>
 #include <base/hal/thread/i_thread_rw_lock.h>
 
 namespace MI {
@@ -86,15 +90,17 @@ public:
     /*NI*/ bool unlock( mi::Uint32 lock_id) override;
     /*NI*/ void check_is_locked( mi::Uint32 lock_id) override;
 
-    /*NI*/ mi::Sint32 set_memory_limits( size_t low_water, size_t high_water) override;
-    /*NI*/ void get_memory_limits( size_t& low_water, size_t& high_water) const override;
+    mi::Sint32 set_memory_limits( size_t low_water, size_t high_water) override;
+    void get_memory_limits( size_t& low_water, size_t& high_water) const override;
 
     /*NI*/ void register_status_listener( DB::Status_listener* listener) override;
     /*NI*/ void unregister_status_listener( DB::Status_listener* listener) override;
-    /*NI*/ void register_transaction_listener( DB::ITransaction_listener* listener) override;
-    /*NI*/ void unregister_transaction_listener( DB::ITransaction_listener* listener) override;
-    /*NI*/ void register_scope_listener( DB::IScope_listener* listener) override;
-    /*NI*/ void unregister_scope_listener( DB::IScope_listener* listener) override;
+    void register_transaction_listener( DB::ITransaction_listener* listener) override;
+    void unregister_transaction_listener( DB::ITransaction_listener* listener) override;
+
+    /// Note that there are no scope events since DBLIGHT supports only the global scope.
+    void register_scope_listener( DB::IScope_listener* listener) override;
+    void unregister_scope_listener( DB::IScope_listener* listener) override;
 
     mi::Sint32 execute_fragmented( DB::Fragmented_job* job, size_t count) override;
     mi::Sint32 execute_fragmented_async(
@@ -114,6 +120,21 @@ public:
     /// Returns the transaction manager.
     Transaction_manager* get_transaction_manager() { return m_transaction_manager.get(); }
 
+    /// Invokes \p method on all registered transaction listeners.
+    ///
+    /// \note The caller must not hold the lock m_lock.
+    void notify_transaction_listeners(
+        void (DB::ITransaction_listener::*method)( DB::Transaction*),
+        DB::Transaction* transaction);
+
+    /// Enforces the memory limits (if set).
+    ///
+    /// \note The caller needs to hold the lock m_lock.
+    void enforce_memory_limits();
+
+    /// Indicates whether memory limits are set.
+    bool get_has_memory_limits() const { return m_high_water != 0; }
+
     /// Used by transactions to allocate new tags.
     DB::Tag allocate_tag() { return DB::Tag( m_next_tag++); }
 
@@ -172,6 +193,21 @@ private:
     /// The next tag to allocate.
     std::atomic_uint32_t m_next_tag;
 
+    /// Lock for m_transaction_listeners and m_scope_listeners.
+    THREAD::Lock m_listeners_lock;
+
+    /// The registered transaction listeners.
+    std::vector<mi::base::Handle<DB::ITransaction_listener>> m_transaction_listeners;
+
+    /// The registered scope listeners.
+    std::vector<mi::base::Handle<DB::IScope_listener>> m_scope_listeners;
+
+    /// The low water mark for the memory usage.
+    std::atomic<size_t> m_low_water = 0;
+
+    /// The high water mark for the memory usage (0 means no memory limits).
+    std::atomic<size_t> m_high_water = 0;
+
     /// The deserialization manager.
     SERIAL::Deserialization_manager* m_deserialization_manager;
 
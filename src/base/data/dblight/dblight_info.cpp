@@ -30,6 +30,7 @@
 
 #include "dblight_info.h"
 
+#include <algorithm>
 #include <numeric>
 #include <sstream>
 
@@ -60,6 +61,7 @@ Info_impl::Info_impl(
     DB::Tag tag,
     const char* name)
   : m_element( element),
+    m_last_access( transaction->get_id().get_uint()),
     m_scope_id( scope_id),
     m_transaction_id( transaction->get_id()),
     m_version( version),
@@ -82,6 +84,7 @@ Info_impl::Info_impl(
     const char* name,
     const DB::Tag_set& references)
   : m_element( element),
+    m_last_access( transaction->get_id().get_uint()),
     m_scope_id( scope_id),
     m_transaction_id( transaction->get_id()),
     m_version( version),
@@ -97,7 +100,8 @@ Info_impl::Info_impl(
     Transaction_impl* transaction,
     mi::Uint32 version,
     DB::Tag tag)
-  : m_scope_id( scope_id),
+  : m_last_access( transaction->get_id().get_uint()),
+    m_scope_id( scope_id),
     m_transaction_id( transaction->get_id()),
     m_version( version),
     m_tag( tag),
@@ -109,7 +113,8 @@ Info_impl::Info_impl(
     DB::Scope_id scope_id,
     DB::Transaction_id transaction_id,
     mi::Uint32 version)
-  : m_scope_id( scope_id),
+  : m_last_access( transaction_id.get_uint()),
+    m_scope_id( scope_id),
     m_transaction_id( transaction_id),
     m_version( version)
 {
@@ -623,6 +628,8 @@ void Info_manager::store(
     const DB::Tag_set& references = info->get_references();
     increment_pin_counts( references);
 
+    update_size( info);
+
     // Consider tag as a candidate for garbage collection.
     if( m_gc_method == GC_GENERAL_CANDIDATES_THEN_PIN_COUNT_ZERO)
         m_gc_candidates_general.insert( tag);
@@ -694,6 +701,8 @@ Info_impl* Info_manager::start_edit(
     // Record DB element references of this info.
     increment_pin_counts( references);
 
+    update_size( info);
+
     // Consider tag as a candidate for garbage collection.
     if( m_gc_method == GC_GENERAL_CANDIDATES_THEN_PIN_COUNT_ZERO)
         m_gc_candidates_general.insert( tag);
@@ -713,6 +722,8 @@ void Info_manager::finish_edit( Info_impl* info)
     const DB::Tag_set& new_references = info->get_references();
     increment_pin_counts( new_references);
 
+    update_size( info);
+
     info->unpin();
 }
 
@@ -832,6 +843,61 @@ void Info_manager::garbage_collection( DB::Transaction_id lowest_open)
     }
 }
 
+void Info_manager::enforce_memory_limits( size_t low_water, size_t high_water)
+{
+    m_database->get_lock().check_is_owned();
+
+    const size_t total_size = m_total_size;
+    if( total_size <= high_water)
+        return;
+
+    std::vector<Info_impl*> candidates;
+
+    m_infos_by_tag.apply( [&candidates]( Infos_per_tag* infos_per_tag) {
+        for( auto& info: infos_per_tag->get_infos()) {
+            // Skip removals and infos that are currently pinned by accesses or edits.
+            if( !info.get_is_removal() && info.get_pin_count() == 0)
+                candidates.push_back( &info);
+        }
+    });
+
+    std::stable_sort( candidates.begin(), candidates.end(),
+        []( const Info_impl* lhs, const Info_impl* rhs) {
+            return lhs->get_last_access() < rhs->get_last_access(); });
+
+    for( const auto& info: candidates) {
+        if( m_total_size <= low_water)
+            break;
+        info->get_element()->release_memory();
+        update_size( info);
+    }
+
+    LOG::mod_log->debug( M_DB, LOG::Mod_log::C_DATABASE,
+        "Memory usage of %zu bytes exceeds high water mark of %zu bytes, released %zu bytes.",
+        total_size, high_water, total_size - std::min( total_size, size_t( m_total_size)));
+}
+
+void Info_manager::update_size( Info_impl* info)
+{
+    if( info->get_is_removal())
+        return;
+
+    // Unsigned wrap-around makes this correct for shrinking elements, too.
+    const size_t new_size = info->get_element()->get_size();
+    const size_t old_size = info->exchange_size( new_size);
+    m_total_size += new_size - old_size;
+}
+
+void Info_manager::update_all_sizes()
+{
+    m_database->get_lock().check_is_owned();
+
+    m_infos_by_tag.apply( [this]( Infos_per_tag* infos_per_tag) {
+        for( auto& info: infos_per_tag->get_infos())
+            update_size( &info);
+    });
+}
+
 mi::Uint32 Info_manager::get_tag_reference_count( DB::Tag tag)
 {
     THREAD::Block_shared block( &m_database->get_lock());
@@ -1196,6 +1262,7 @@ Infos_per_tag::Infos_per_tag_set::iterator Info_manager::cleanup_info(
 
     const DB::Tag_set& old_references = info->get_references();
     decrement_pin_counts( old_references, /*from_gc*/ true);
+    m_total_size -= info->get_size();
     delete info;
 
     return next;
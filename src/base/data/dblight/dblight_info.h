@@ -158,11 +158,25 @@ public:
     /// Only to be used for serialization checks.
     void set_element( DB::Element_base* element);
 
+    /// Returns the ID of the last transaction that accessed this info.
+    DB::Transaction_id get_last_access() const { return DB::Transaction_id( m_last_access); }
+
+    /// Records an access from the given transaction.
+    ///
+    /// Used to release the memory of least recently used elements first.
+    void set_last_access( DB::Transaction_id id) { m_last_access = id.get_uint(); }
+
+    /// Returns the size of the DB element as last measured by the info manager.
+    size_t get_size() const { return m_size; }
+
+    /// Sets the measured size of the DB element and returns the previous one.
+    size_t exchange_size( size_t size) { return m_size.exchange( size); }
+
 private:
     // The only members that can change after construction are the element pointer (if serialization
-    /// checks for edits are enabled), the pin count, the transaction pointer (reset only), the set
-    /// of references (for edits), the name set pointer (if the info has a name) and the hooks for
-    /// the intrusive sets.
+    /// checks for edits are enabled), the pin count, the last access, the measured size, the
+    /// transaction pointer (reset only), the set of references (for edits), the name set pointer
+    /// (if the info has a name) and the hooks for the intrusive sets.
 
     /// The DB element managed (and owned) by this instance, \c NULL for removals.
     DB::Element_base* /*almost const*/ m_element = nullptr;
@@ -170,6 +184,12 @@ private:
     /// Pin count of this info.
     std::atomic_uint32_t m_pin_count = 1;
 
+    /// ID of the last transaction that accessed this info (initially the creator transaction).
+    std::atomic_uint32_t m_last_access;
+
+    /// Size of m_element as last measured, accounted in Info_manager::m_total_size.
+    std::atomic<size_t> m_size = 0;
+
     /// \name Used by the comparison operator.
     //@{
 
@@ -633,6 +653,37 @@ public:
     ///                      next transaction if there are no open transactions).
     void garbage_collection( DB::Transaction_id lowest_open);
 
+    /// Enforces the memory limits.
+    ///
+    /// If the total size of all elements exceeds \p high_water, then the elements of unpinned
+    /// infos are asked to release memory, least recently accessed first, until the total size
+    /// drops below \p low_water (or no candidates are left).
+    ///
+    /// The total size is the running sum maintained by #update_size(), only the candidates are
+    /// collected by a scan and only if the high water mark is exceeded.
+    ///
+    /// \param low_water    The low water mark for the memory usage.
+    /// \param high_water   The high water mark for the memory usage.
+    void enforce_memory_limits( size_t low_water, size_t high_water);
+
+    /// Measures the size of the DB element of \p info and updates the total size accordingly.
+    ///
+    /// Called for stores, edits and releases of memory. Accesses call it only while memory
+    /// limits are set, such that data reloaded by an element is accounted for.
+    ///
+    /// \param info   The info whose element to measure. RCS:NEU
+    void update_size( Info_impl* info);
+
+    /// Measures the sizes of all DB elements again.
+    ///
+    /// Used when memory limits are set, since sizes are not updated on accesses without limits.
+    ///
+    /// \note The caller needs to hold the database lock.
+    void update_all_sizes();
+
+    /// Returns the total size of all DB elements (see #update_size()).
+    size_t get_total_size() const { return m_total_size; }
+
     /// Returns the pin count of the corresponding Infos_per_tag set.
     mi::Uint32 get_tag_reference_count( DB::Tag tag);
 
@@ -701,6 +752,10 @@ private:
     Infos_by_tag m_infos_by_tag;
 
     //@}
+
+    /// The sum of the measured sizes of all infos.
+    std::atomic<size_t> m_total_size = 0;
+
     /// \name Garbage collection
     //@{
 
@@ -30,6 +30,8 @@
 
 #include "dblight_transaction.h"
 
+#include <algorithm>
+#include <map>
 #include <sstream>
 
 #include "dblight_database.h"
@@ -42,8 +44,11 @@
 #include <base/data/serial/serial.h>
 #include <base/hal/thread/i_thread_block.h>
 #include <base/hal/thread/i_thread_rw_lock.h>
+#include <base/lib/config/config.h>
 #include <base/lib/log/i_log_logger.h>
+#include <base/system/main/access_module.h>
 #include <base/system/main/i_assert.h>
+#include <base/util/registry/i_config_registry.h>
 
 namespace MI {
 
@@ -84,7 +89,15 @@ bool Transaction_impl::commit()
     if( m_state != OPEN)
         return false;
 
+    m_database->notify_transaction_listeners(
+        &DB::ITransaction_listener::transaction_pre_commit, this);
+
+    // Keep this instance alive for the listeners (end_transaction() decrements the pin count).
+    Transaction_impl_ptr self( this);
     m_transaction_manager->end_transaction( this, /*commit*/ true);
+
+    m_database->notify_transaction_listeners(
+        &DB::ITransaction_listener::transaction_committed, this);
     return true;
 }
 
@@ -95,7 +108,15 @@ void Transaction_impl::abort()
     if( m_state != OPEN)
         return;
 
+    m_database->notify_transaction_listeners(
+        &DB::ITransaction_listener::transaction_pre_abort, this);
+
+    // Keep this instance alive for the listeners (end_transaction() decrements the pin count).
+    Transaction_impl_ptr self( this);
     m_transaction_manager->end_transaction( this, /*commit*/ false);
+
+    m_database->notify_transaction_listeners(
+        &DB::ITransaction_listener::transaction_aborted, this);
 }
 
 bool Transaction_impl::is_open( bool closing_is_open) const
@@ -136,6 +157,10 @@ DB::Info* Transaction_impl::access_element( DB::Tag tag)
         return nullptr;
     }
 
+    info->set_last_access( m_id);
+    // Account for data the element reloaded since its size was last measured.
+    if( m_database->get_has_memory_limits())
+        m_database->get_info_manager()->update_size( info);
     return info;
 }
 
@@ -186,7 +211,10 @@ void Transaction_impl::finish_edit( DB::Info* info, DB::Journal_type journal_typ
             deserializer.deserialize( serializer.get_buffer(), serializer.get_buffer_size())));
     }
 
-    info->get_element()->prepare_store( this, info->get_tag());
+    DB::Element_base* element = info->get_element();
+    element->prepare_store( this, info->get_tag());
+    journal_type.restrict_journal( element->get_journal_flags());
+    add_journal_entry( info->get_tag(), info->get_version(), journal_type);
     m_database->get_info_manager()->finish_edit( static_cast<Info_impl*>( info));
 }
 
@@ -244,7 +272,6 @@ void Transaction_impl::store(
     }
 
     MI_ASSERT( privacy_level == 0 || privacy_level == 255);
-    MI_ASSERT( journal_type == DB::JOURNAL_NONE || journal_type == DB::JOURNAL_ALL);
     MI_ASSERT( store_level == 0 || store_level == 255);
 
     std::string name_str;
@@ -266,6 +293,8 @@ void Transaction_impl::store(
 
     mi::Uint32 version = allocate_sequence_number();
     element->prepare_store( this, tag);
+    journal_type.restrict_journal( element->get_journal_flags());
+    add_journal_entry( tag, version, journal_type);
     m_database->get_info_manager()->store( element, DB::Scope_id( 0), this, version, tag, name);
 }
 
@@ -470,8 +499,15 @@ std::unique_ptr<DB::Journal_query_result> Transaction_impl::get_journal(
     DB::Journal_type journal_type,
     bool lookup_parents)
 {
-    MI_ASSERT( !"Not implemented");
-    return {};
+    if( m_state != OPEN) {
+        LOG::mod_log->error(
+            M_DB, LOG::Mod_log::C_DATABASE, "Use of non-open transaction.");
+        return {};
+    }
+
+    // There are no parent scopes, lookup_parents can be ignored.
+    return m_transaction_manager->get_journal(
+        this, last_transaction_id, last_transaction_change_version, journal_type);
 }
 
 mi::Sint32 Transaction_impl::execute_fragmented( DB::Fragmented_job* job, size_t count)
@@ -514,6 +550,29 @@ bool Transaction_impl::is_visible_for( DB::Transaction_id id) const
     return (m_state == COMMITTED) && (m_visibility_id <= id);
 }
 
+void Transaction_impl::add_journal_entry(
+    DB::Tag tag, mi::Uint32 version, DB::Journal_type journal_type)
+{
+    if( journal_type == DB::JOURNAL_NONE)
+        return;
+
+    THREAD::Block block( m_journal_lock);
+    m_journal.push_back( Journal_entry{ m_id, m_visibility_id, version, tag, journal_type});
+}
+
+std::vector<Journal_entry> Transaction_impl::take_journal()
+{
+    THREAD::Block block( m_journal_lock);
+    return std::move( m_journal);
+}
+
+void Transaction_impl::apply_journal( const std::function<void( const Journal_entry&)>& f)
+{
+    THREAD::Block block( m_journal_lock);
+    for( const auto& entry: m_journal)
+        f( entry);
+}
+
 std::ostream& operator<<( std::ostream& s, const Transaction_impl::State& state)
 {
     switch( state) {
@@ -525,6 +584,14 @@ std::ostream& operator<<( std::ostream& s, const Transaction_impl::State& state)
     return s;
 }
 
+Transaction_manager::Transaction_manager( Database_impl* database)
+  : m_database( database)
+{
+    SYSTEM::Access_module<CONFIG::Config_module> config_module( false);
+    const CONFIG::Config_registry& registry = config_module->get_configuration();
+    CONFIG::update_value( registry, "dblight_journal_capacity", m_journal_capacity);
+}
+
 Transaction_manager::~Transaction_manager()
 {
     MI_ASSERT( m_open_transactions.empty());
@@ -540,6 +607,10 @@ Transaction_impl* Transaction_manager::start_transaction( Scope_impl* scope)
     m_all_transactions.insert( *transaction);
     m_open_transactions.insert( *transaction);
 
+    block.release();
+
+    m_database->notify_transaction_listeners(
+        &DB::ITransaction_listener::transaction_created, transaction);
     return transaction;
 }
 
@@ -555,9 +626,23 @@ void Transaction_manager::end_transaction( Transaction_impl* transaction, bool c
 
     transaction->set_visibility_id( m_next_transaction_id);
     transaction->set_state( commit ? Transaction_impl::COMMITTED : Transaction_impl::ABORTED);
+
+    if( commit) {
+        for( auto& entry: transaction->take_journal()) {
+            entry.m_visibility_id = m_next_transaction_id;
+            m_journal.push_back( entry);
+        }
+        while( m_journal.size() > m_journal_capacity) {
+            m_journal_truncated = true;
+            m_journal_truncated_visibility_id = m_journal.front().m_visibility_id;
+            m_journal.pop_front();
+        }
+    }
+
     transaction->unpin();
 
     m_database->get_info_manager()->garbage_collection( get_lowest_open_transaction_id());
+    m_database->enforce_memory_limits();
 }
 
 void Transaction_manager::remove_from_all_transactions( Transaction_impl* transaction)
@@ -577,6 +662,49 @@ DB::Transaction_id Transaction_manager::get_lowest_open_transaction_id() const
     return it == m_open_transactions.end() ? m_next_transaction_id : it->get_id();
 }
 
+std::unique_ptr<DB::Journal_query_result> Transaction_manager::get_journal(
+    Transaction_impl* transaction,
+    DB::Transaction_id last_transaction_id,
+    mi::Uint32 last_transaction_change_version,
+    DB::Journal_type journal_type)
+{
+    THREAD::Block_shared block( &m_database->get_lock());
+
+    // Dropped entries might have been relevant.
+    if( m_journal_truncated && last_transaction_id < m_journal_truncated_visibility_id)
+        return {};
+
+    const DB::Transaction_id id = transaction->get_id();
+    std::map<DB::Tag, mi::Uint32> changes;
+
+    auto add_entry = [&]( const Journal_entry& entry) {
+        // Skip changes already reported to the last query from the same transaction.
+        if(    entry.m_transaction_id == last_transaction_id
+            && entry.m_version < last_transaction_change_version)
+            return;
+        const mi::Uint32 type = entry.m_journal_type.get_type() & journal_type.get_type();
+        if( type != 0)
+            changes[entry.m_tag] |= type;
+    };
+
+    // Skip entries that were already visible to the last query (but the entries of the last
+    // transaction itself become visible to others only after its visibility ID).
+    auto it = std::partition_point( m_journal.begin(), m_journal.end(),
+        [&last_transaction_id]( const Journal_entry& entry) {
+            return entry.m_visibility_id <= last_transaction_id; });
+    for( ; it != m_journal.end() && it->m_visibility_id <= id; ++it)
+        add_entry( *it);
+
+    // Add the changes of this transaction itself.
+    transaction->apply_journal( add_entry);
+
+    auto result = std::make_unique<DB::Journal_query_result>();
+    result->reserve( changes.size());
+    for( const auto& change: changes)
+        result->emplace_back( change.first, DB::Journal_type( change.second));
+    return result;
+}
+
 void Transaction_manager::dump( std::ostream& s, bool mask_pointer_values)
 {
     m_database->get_lock().check_is_owned_shared_or_exclusive();
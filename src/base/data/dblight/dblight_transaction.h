@@ -30,6 +30,9 @@
 #define BASE_DATA_DBLIGHT_DBLIGHT_TRANSACTION_H
 
 #include <atomic>
+#include <deque>
+#include <functional>
+#include <vector>
 
 #include <boost/core/noncopyable.hpp>
 #include <boost/intrusive_ptr.hpp>
@@ -49,6 +52,21 @@ class Transaction_manager;
 
 namespace bi = boost::intrusive;
 
+/// An entry of the change journal.
+struct Journal_entry
+{
+    /// ID of the transaction that made the change.
+    DB::Transaction_id m_transaction_id;
+    /// Visibility ID of that transaction (only valid after commit).
+    DB::Transaction_id m_visibility_id;
+    /// Sequence number of the change in that transaction.
+    mi::Uint32 m_version;
+    /// The changed tag.
+    DB::Tag m_tag;
+    /// The type of the change.
+    DB::Journal_type m_journal_type;
+};
+
 /// A transaction of the database.
 ///
 /// Transactions are created with pin count 1. The pin count is decremented again in
@@ -203,7 +221,7 @@ public:
 
     bool get_tag_is_removed( DB::Tag tag) override;
 
-    /*NI*/ std::unique_ptr<DB::Journal_query_result> get_journal(
+    std::unique_ptr<DB::Journal_query_result> get_journal(
          DB::Transaction_id last_transaction_id,
          mi::Uint32 last_transaction_change_version,
          DB::Journal_type journal_type,
@@ -254,6 +272,19 @@ public:
     /// \pre Both transactions belong to the same scope.
     bool is_visible_for( DB::Transaction_id id) const;
 
+    /// Records a change in the journal of this transaction.
+    ///
+    /// \param tag            The changed tag.
+    /// \param version        The sequence number of the change.
+    /// \param journal_type   The type of the change. Changes of type DB::JOURNAL_NONE are ignored.
+    void add_journal_entry( DB::Tag tag, mi::Uint32 version, DB::Journal_type journal_type);
+
+    /// Returns the journal entries of this transaction and clears the journal.
+    std::vector<Journal_entry> take_journal();
+
+    /// Invokes \p f for all journal entries of this transaction.
+    void apply_journal( const std::function<void( const Journal_entry&)>& f);
+
 private:
     /// Instance of the database this transaction belongs to.
     Database_impl* const m_database;
@@ -273,6 +304,11 @@ private:
     /// Sequence number for the next update within this transaction.
     std::atomic_uint32_t m_next_sequence_number = 0;
 
+    /// Lock for m_journal.
+    THREAD::Lock m_journal_lock;
+    /// The changes made by this transaction (moved to the transaction manager upon commit).
+    std::vector<Journal_entry> m_journal;
+
 public:
     /// Hook for Transaction_manager::m_all_transactions.
     bi::set_member_hook<> m_all_transactions_hook;
@@ -296,7 +332,7 @@ public:
     /// Constructor.
     ///
     /// \param database   Instance of the database this manager belongs to.
-    Transaction_manager( Database_impl* database) : m_database( database) { }
+    Transaction_manager( Database_impl* database);
 
     /// Destructor.
     ///
@@ -315,7 +351,8 @@ public:
     ///
     /// Sets the state to CLOSING, removes the transaction from the set of open transactions,
     /// sets the visibility ID, sets the state to COMMITTED or ABORTED depending on \p commit,
-    /// decrements the pin count, and invokes the garbage collection.
+    /// moves the journal entries of committed transactions to the global journal, decrements the
+    /// pin count, and invokes the garbage collection.
     ///
     /// \param transaction   The transaction to end. RCS:NEU
     /// \param commit        \c true to commit, \c false to abort.
@@ -332,6 +369,16 @@ public:
     /// are no open transactions).
     DB::Transaction_id get_lowest_open_transaction_id() const;
 
+    /// Implements DB::Transaction::get_journal() for \p transaction.
+    ///
+    /// Reports all changes visible to \p transaction that were not yet visible to the transaction
+    /// \p last_transaction_id at its sequence number \p last_transaction_change_version.
+    std::unique_ptr<DB::Journal_query_result> get_journal(
+        Transaction_impl* transaction,
+        DB::Transaction_id last_transaction_id,
+        mi::Uint32 last_transaction_change_version,
+        DB::Journal_type journal_type);
+
     /// Dumps the state of the transaction manager to the stream.
     void dump( std::ostream& s, bool mask_pointer_values);
 
@@ -358,6 +405,20 @@ private:
 
     /// ID of the next transaction to be created.
     DB::Transaction_id m_next_transaction_id;
+
+    /// The journal entries of all committed transactions, sorted by visibility ID.
+    ///
+    /// Needs the database lock.
+    std::deque<Journal_entry> m_journal;
+
+    /// The maximum number of entries in m_journal.
+    size_t m_journal_capacity = 1000000;
+
+    /// Indicates whether entries have been dropped from m_journal due to its capacity.
+    bool m_journal_truncated = false;
+
+    /// Highest visibility ID of all entries dropped from m_journal.
+    DB::Transaction_id m_journal_truncated_visibility_id;
 };
 
 // Used by the Boost intrusive pointer to Transaction_impl.
@@ -62,6 +62,9 @@
 #include <base/system/main/i_assert.h>
 #include <base/util/registry/i_config_registry.h>
 
+#include <mi/base/handle.h>
+#include <mi/base/interface_implement.h>
+
 using namespace MI;
 namespace fs = boost::filesystem;
 
@@ -76,6 +79,7 @@ public:
     std::string get_class_name() const { return "My_element"; }
     void get_references( DB::Tag_set* result) const
     { result->insert( m_tag_set.begin(), m_tag_set.end()); }
+    DB::Journal_type get_journal_flags() const { return DB::Journal_type( 0x3); }
 
     My_element() : m_value( 0) { }
     explicit My_element( int value, const DB::Tag_set& tag_set = {})
@@ -90,6 +94,41 @@ private:
     DB::Tag_set m_tag_set;
 };
 
+/// Element with a reloadable cache of the given size.
+class My_cache_element : public DB::Element<My_cache_element, 0x12345679>
+{
+public:
+    const SERIAL::Serializable* serialize( SERIAL::Serializer* serializer) const
+    { serializer->write_size_t( m_cache_size); return this + 1; }
+    SERIAL::Serializable* deserialize( SERIAL::Deserializer* deserializer)
+    { deserializer->read_size_t( &m_cache_size); return this + 1; }
+    DB::Element_base* copy() const { return new My_cache_element( *this); }
+    std::string get_class_name() const { return "My_cache_element"; }
+    size_t get_size() const { return sizeof( *this) + m_cache_size; }
+    size_t release_memory() const { size_t s = m_cache_size; m_cache_size = 0; return s; }
+
+    My_cache_element() : m_cache_size( 0) { }
+    explicit My_cache_element( size_t cache_size) : m_cache_size( cache_size) { }
+    size_t get_cache_size() const { return m_cache_size; }
+    void reload( size_t cache_size) const { m_cache_size = cache_size; }
+
+private:
+    mutable size_t m_cache_size;
+};
+
+/// Records all transaction events as string.
+class My_transaction_listener : public mi::base::Interface_implement<DB::ITransaction_listener>
+{
+public:
+    void transaction_created( DB::Transaction* transaction) { m_events += "created "; }
+    void transaction_pre_commit( DB::Transaction* transaction) { m_events += "pre_commit "; }
+    void transaction_pre_abort( DB::Transaction* transaction) { m_events += "pre_abort "; }
+    void transaction_committed( DB::Transaction* transaction) { m_events += "committed "; }
+    void transaction_aborted( DB::Transaction* transaction) { m_events += "aborted "; }
+
+    std::string m_events;
+};
+
 /// Compares two streams in a very simple way.
 bool compare_files( std::ifstream& s1, std::stringstream& s2)
 {
@@ -1421,29 +1460,216 @@ void test_dump_with_pointers()
     db.dump( /*mask_pointer_values*/ false);
 }
 
-void test_not_implemented_with_assertions()
+void test_memory_limits()
 {
-    Test_db db( __func__, /*compare*/ false); // Empty dump
+    Test_db db( __func__, /*compare*/ false);
 
-    db.m_db->lock( 42);
-    bool result = db.m_db->unlock( 42);
-    MI_CHECK( !result);
-    db.m_db->check_is_locked( 42);
+    SERIAL::Deserialization_manager* manager = db.m_db_impl->get_deserialization_manager();
+    manager->register_class<My_cache_element>();
 
-    MI_CHECK_EQUAL( db.m_db->set_memory_limits( 1000, 2000), -1);
     size_t low_water = 1;
     size_t high_water = 1;
     db.m_db->get_memory_limits( low_water, high_water);
     MI_CHECK_EQUAL( low_water, 0);
     MI_CHECK_EQUAL( high_water, 0);
 
+    MI_CHECK_EQUAL( db.m_db->set_memory_limits( 2000, 1000), -1);
+    MI_CHECK_EQUAL( db.m_db->set_memory_limits( 2000, 2000), -1);
+
+    DBLIGHT::Info_manager* info_manager = db.m_db_impl->get_info_manager();
+    const size_t element_size = sizeof( My_cache_element);
+
+    DB::Transaction_ptr transaction = db.m_scope->start_transaction();
+    DB::Tag tag1 = transaction->store( new My_cache_element( 1000), "foo");
+    DB::Tag tag2 = transaction->store( new My_cache_element( 1000), "bar");
+    transaction->commit();
+    MI_CHECK_EQUAL( info_manager->get_total_size(), 2 * element_size + 2000);
+
+    // Access tag2 in a later transaction such that tag1 becomes the least recently used element.
+    transaction = db.m_scope->start_transaction();
+    {
+        DB::Access<My_cache_element> access2( tag2, transaction.get());
+        MI_CHECK_EQUAL( access2->get_cache_size(), 1000);
+    }
+    transaction->commit();
+
+    MI_CHECK_EQUAL( db.m_db->set_memory_limits( 1500, 2000), 0);
+    db.m_db->get_memory_limits( low_water, high_water);
+    MI_CHECK_EQUAL( low_water, 1500);
+    MI_CHECK_EQUAL( high_water, 2000);
+    MI_CHECK_EQUAL( info_manager->get_total_size(), 2 * element_size + 1000);
+
+    transaction = db.m_scope->start_transaction();
+    {
+        DB::Access<My_cache_element> access1( tag1, transaction.get());
+        DB::Access<My_cache_element> access2( tag2, transaction.get());
+        MI_CHECK_EQUAL( access1->get_cache_size(), 0);
+        MI_CHECK_EQUAL( access2->get_cache_size(), 1000);
+        access1->reload( 400);
+    }
+    transaction->commit();
+
+    // Reloaded data is accounted for on the next access. The total stays below the high water
+    // mark, so nothing is released.
+    MI_CHECK_EQUAL( info_manager->get_total_size(), 2 * element_size + 1000);
+    transaction = db.m_scope->start_transaction();
+    {
+        DB::Access<My_cache_element> access1( tag1, transaction.get());
+        MI_CHECK_EQUAL( info_manager->get_total_size(), 2 * element_size + 1400);
+    }
+    transaction->commit();
+    MI_CHECK_EQUAL( info_manager->get_total_size(), 2 * element_size + 1400);
+
+    // Removed elements are subtracted once the garbage collection destroys them.
+    transaction = db.m_scope->start_transaction();
+    transaction->remove( tag1);
+    transaction->commit();
+    MI_CHECK_EQUAL( info_manager->get_total_size(), element_size + 1000);
+
+    // Disable the limits again.
+    MI_CHECK_EQUAL( db.m_db->set_memory_limits( 0, 0), 0);
+    db.m_db->get_memory_limits( low_water, high_water);
+    MI_CHECK_EQUAL( low_water, 0);
+    MI_CHECK_EQUAL( high_water, 0);
+}
+
+void test_journal()
+{
+    Test_db db( __func__, /*compare*/ false);
+
+    DB::Transaction_ptr transaction0 = db.m_scope->start_transaction();
+    DB::Tag tag1 = transaction0->reserve_tag();
+    transaction0->store( tag1, new My_element( 1), "foo", 0, DB::Journal_type( 0x1));
+    DB::Tag tag2 = transaction0->store( new My_element( 2), "bar"); // uses JOURNAL_NONE
+
+    // own changes are visible
+    auto journal = transaction0->get_journal(
+        transaction0->get_id(), 0, DB::JOURNAL_ALL, /*lookup_parents*/ false);
+    MI_CHECK( journal);
+    MI_CHECK_EQUAL( journal->size(), 1);
+    MI_CHECK( (*journal)[0].first == tag1);
+    MI_CHECK( (*journal)[0].second == DB::Journal_type( 0x1));
+
+    const DB::Transaction_id last_id = transaction0->get_id();
+    const mi::Uint32 last_version = transaction0->get_next_sequence_number();
+    transaction0->commit();
+
+    // changes already reported are not reported again
+    DB::Transaction_ptr transaction1 = db.m_scope->start_transaction();
+    journal = transaction1->get_journal(
+        last_id, last_version, DB::JOURNAL_ALL, /*lookup_parents*/ false);
+    MI_CHECK( journal);
+    MI_CHECK( journal->empty());
+
+    {
+        DB::Edit<My_element> edit( tag2, transaction1.get(), DB::Journal_type( 0x2));
+        edit->set_value( 3);
+    }
+    {
+        // filtered by the journal flags of the element
+        DB::Edit<My_element> edit( tag1, transaction1.get(), DB::Journal_type( 0x4));
+        edit->set_value( 4);
+    }
+
+    journal = transaction1->get_journal(
+        last_id, last_version, DB::JOURNAL_ALL, /*lookup_parents*/ false);
+    MI_CHECK( journal);
+    MI_CHECK_EQUAL( journal->size(), 1);
+    MI_CHECK( (*journal)[0].first == tag2);
+    MI_CHECK( (*journal)[0].second == DB::Journal_type( 0x2));
+
+    // filtered by the query
+    journal = transaction1->get_journal(
+        last_id, last_version, DB::Journal_type( 0x1), /*lookup_parents*/ false);
+    MI_CHECK( journal);
+    MI_CHECK( journal->empty());
+
+    // transactions started before the commit do not see the changes, transactions started
+    // afterwards do
+    DB::Transaction_ptr transaction2 = db.m_scope->start_transaction();
+    transaction1->commit();
+    DB::Transaction_ptr transaction3 = db.m_scope->start_transaction();
+
+    journal = transaction2->get_journal(
+        last_id, last_version, DB::JOURNAL_ALL, /*lookup_parents*/ false);
+    MI_CHECK( journal);
+    MI_CHECK( journal->empty());
+
+    journal = transaction3->get_journal(
+        last_id, last_version, DB::JOURNAL_ALL, /*lookup_parents*/ false);
+    MI_CHECK( journal);
+    MI_CHECK_EQUAL( journal->size(), 1);
+    MI_CHECK( (*journal)[0].first == tag2);
+
+    transaction2->commit();
+    transaction3->commit();
+}
+
+void test_journal_capacity()
+{
+    SYSTEM::Access_module<CONFIG::Config_module> config_module( false);
+    CONFIG::Config_registry& registry = config_module->get_configuration();
+    registry.overwrite_value( "dblight_journal_capacity", std::string( "1"));
+
+    {
+        Test_db db( __func__, /*compare*/ false);
+
+        DB::Transaction_ptr transaction0 = db.m_scope->start_transaction();
+        const DB::Transaction_id last_id = transaction0->get_id();
+        DB::Tag tag = transaction0->store( new My_element( 1), "foo");
+        transaction0->commit();
+
+        for( int i = 0; i < 2; ++i) {
+            DB::Transaction_ptr transaction = db.m_scope->start_transaction();
+            DB::Edit<My_element> edit( tag, transaction.get());
+            edit->set_value( 2 + i);
+            edit.reset();
+            transaction->commit();
+        }
+
+        // the first edit has been dropped from the journal
+        DB::Transaction_ptr transaction1 = db.m_scope->start_transaction();
+        auto journal = transaction1->get_journal(
+            last_id, 0, DB::JOURNAL_ALL, /*lookup_parents*/ false);
+        MI_CHECK( !journal);
+        transaction1->commit();
+    }
+
+    registry.overwrite_value( "dblight_journal_capacity", std::string( "1000000"));
+}
+
+void test_transaction_listener()
+{
+    Test_db db( __func__, /*compare*/ false);
+
+    mi::base::Handle<My_transaction_listener> listener( new My_transaction_listener);
+    db.m_db->register_transaction_listener( listener.get());
+
+    DB::Transaction_ptr transaction = db.m_scope->start_transaction();
+    transaction->commit();
+    transaction = db.m_scope->start_transaction();
+    transaction->abort();
+
+    db.m_db->unregister_transaction_listener( listener.get());
+    transaction = db.m_scope->start_transaction();
+    transaction->commit();
+
+    MI_CHECK_EQUAL( listener->m_events,
+        std::string( "created pre_commit committed created pre_abort aborted "));
+}
+
+void test_not_implemented_with_assertions()
+{
+    Test_db db( __func__, /*compare*/ false); // Empty dump
+
+    db.m_db->lock( 42);
+    bool result = db.m_db->unlock( 42);
+    MI_CHECK( !result);
+    db.m_db->check_is_locked( 42);
+
     // artificial test arguments
     db.m_db->register_status_listener( nullptr);
     db.m_db->unregister_status_listener( nullptr);
-    db.m_db->register_transaction_listener( nullptr);
-    db.m_db->unregister_transaction_listener( nullptr);
-    db.m_db->register_scope_listener( nullptr);
-    db.m_db->unregister_scope_listener( nullptr);
 
     DB::Transaction_ptr transaction = db.m_scope->start_transaction();
 
@@ -1465,9 +1691,6 @@ void test_not_implemented_with_assertions()
     // artificial test arguments
     transaction->store_for_reference_counting( DB::Tag(), static_cast<SCHED::Job*>( nullptr));
     transaction->localize( tag, DB::Privacy_level( 0), DB::JOURNAL_NONE);
-    auto journal = transaction->get_journal(
-        DB::Transaction_id( 0), 0, DB::JOURNAL_ALL, /*lookup_parents*/ false);
-    MI_CHECK( !journal);
     transaction->cancel_fragmented_jobs();
     transaction->invalidate_job_results( tag_job);
     transaction->advise( tag_job);
@@ -1536,6 +1759,11 @@ void test( const char* explicit_gc_method)
     test_gc_explicit_call();
     test_gc_pin_count_zero();
 
+    test_memory_limits();
+    test_journal();
+    test_journal_capacity();
+    test_transaction_listener();
+
     test_use_of_closed_transaction();
     test_dump_with_pointers();
 #ifdef NDEBUG
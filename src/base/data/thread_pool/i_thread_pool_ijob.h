@@ -207,11 +207,15 @@ public:
             job_finished();
     }
 
+    /// Never accepts more worker threads than there are fragments (relevant if the thread pool
+    /// admits several worker threads before any of them started executing fragments).
+    ///
     /// Do not change/override this implementation unless you really know what you are doing.
     bool is_remaining_work_splittable() final
     {
         size_t thread_limit = get_thread_limit();
-        return (m_next_fragment+1 < m_count) && (thread_limit == 0 || m_threads < thread_limit);
+        return (m_next_fragment+1 < m_count) && (m_threads < m_count)
+            && (thread_limit == 0 || m_threads < thread_limit);
     }
 
     /// Returns 0. Can be overridden if desired.
@@ -78,8 +78,20 @@ class IJob;
 /// child jobs. This requires some care if the parent job waits for the completion of the child
 /// jobs.
 ///
-/// Last but not least the thread pool supports job priorities which can be used to influence the
-/// position of the job in the queue.
+/// The thread pool supports job priorities which can be used to influence the position of the job
+/// in the queue.
+///
+/// Last but not least the thread pool has an optional work stealing mode (disabled by default),
+/// which reduces contention on the main lock for fragmented jobs with many worker threads. When a
+/// splittable job is selected from the job queue, the thread pool admits as many additional worker
+/// threads as the job and the load limits permit in one go (instead of waking them up one after
+/// the other, each of them searching the job queue again). The admitted job is pushed onto the
+/// local job deques of these worker threads. Idle worker threads pop jobs from their own deque and
+/// steal jobs from the deques of other worker threads, starting with those next to them (which
+/// are pinned to neighboring CPUs if thread affinity is enabled), before falling back to the job
+/// queue. The thread that pops or steals a job calls IJob::pre_execute() for itself, or gives the
+/// admission back if the job does not want more parallel calls anymore. Since jobs on local
+/// deques have already been admitted, priorities and load accounting remain unaffected.
 class Thread_pool : public boost::noncopyable
 {
 public:
@@ -170,6 +182,14 @@ public:
     /// Returns the current thread affinity setting.
     bool get_thread_affinity_enabled() const;
 
+    /// Enables or disables the work stealing mode.
+    ///
+    /// Jobs already pushed onto local job deques are still executed after disabling the mode.
+    void set_work_stealing_enabled( bool value) { m_work_stealing = value; }
+
+    /// Returns the current work stealing setting.
+    bool get_work_stealing_enabled() const { return m_work_stealing; }
+
     //@}
     /// \name Jobs
     //@{
@@ -270,6 +290,19 @@ public:
     /// of sleeping worker threads.
     IJob* get_next_job( Worker_thread* thread);
 
+    /// Returns the next job from the local job deques to be executed by \p thread.
+    ///
+    /// Pops the most recent job from the local job deque of \p thread. If that deque is empty and
+    /// the work stealing mode is enabled, attempts to steal the oldest job from the local job
+    /// deques of other worker threads. The deques are accessed without the main lock. The main
+    /// lock is acquired afterwards to call IJob::pre_execute() for \p thread, or to give the
+    /// admission back if the job is no longer splittable (and to try the next job).
+    ///
+    /// Returns \c NULL if no job was found. Otherwise, the job is returned retained and assigned
+    /// to \p thread. The current load values were already increased when the job was pushed onto
+    /// the deque.
+    IJob* get_next_local_job( Worker_thread* thread);
+
     /// Notifies the thread pool that execution of a job has finished.
     ///
     /// The current load values are decreased according to the job's requirements, and the worker
@@ -360,6 +393,19 @@ private:
     /// See #resume_current_job() for details.
     void resume_current_job_internal();
 
+    /// Admits additional worker threads for a splittable job (work stealing mode only).
+    ///
+    /// Repeatedly takes a sleeping worker thread, increases the current load values and pushes the
+    /// job onto the local job deque of that worker thread, as long as the job fits the load limits.
+    /// IJob::pre_execute() is not called here, but by the thread that pops or steals the job. If
+    /// there are no sleeping worker threads, one is woken up (or created) as in the regular mode.
+    ///
+    /// The job stays in the job queue, it is removed by #get_next_job() once it is no longer
+    /// splittable.
+    ///
+    /// The callers needs to hold m_lock.
+    void distribute_job( IJob* job, mi::Float32 cpu_load, mi::Float32 gpu_load);
+
     /// Creates a new worker thread and adds it to m_all_threads and m_sleeping_threads.
     ///
     /// The callers needs to hold m_lock.
@@ -372,6 +418,11 @@ private:
     /// The callers needs to hold m_lock.
     void wake_up_worker_thread();
 
+    /// Indicates whether any local job deque is non-empty.
+    ///
+    /// The callers needs to hold m_lock.
+    bool has_local_jobs() const;
+
     /// Indicates whether a job with given CPU/GPU loads can be executed given the current CPU/GPU
     /// load and the CPU/GPU load limits.
     ///
@@ -380,32 +431,20 @@ private:
 
     /// Returns some job data for the job assigned to a running or suspended worker thread.
     ///
-    /// Acquires m_lock and calls #get_current_job_data_locked().
-    bool get_current_job_data(
-        mi::Float32& cpu_load,
-        mi::Float32& gpu_load,
-        mi::Sint8& priority,
-        mi::Uint64& thread_id,
-        bool suspended) const;
-
-    /// Returns some job data for the job assigned to a running or suspended worker thread.
-    ///
-    /// The callers needs to hold m_lock.
+    /// Does not require m_lock since only the calling thread itself changes that data.
     ///
     /// \param[out] cpu_load   The CPU load of the job, or 0.0 if the calling thread is not a
     ///                        running/suspended worker thread.
     /// \param[out] gpu_load   The GPU load of the job, or 0.0 if the calling thread is not a
     ///                        running/suspended worker thread.
     /// \param[out] priority   The priority of the job.
-    /// \param[out] thread_id  The thread ID.
     /// \param suspended       Indicates whether thread is supposed to be running or suspended.
-    /// \return                \true if the calling thread is a running/suspended worker thread,
-    ///                        and \false otherwise
-    bool get_current_job_data_locked(
+    /// \return                The calling worker thread if it is a running/suspended worker
+    ///                        thread of this thread pool, and \c NULL otherwise
+    Worker_thread* get_current_job_data(
         mi::Float32& cpu_load,
         mi::Float32& gpu_load,
         mi::Sint8& priority,
-        mi::Uint64& thread_id,
         bool suspended) const;
 
     /// Generates the admin HTTP server page for the thread pool.
@@ -460,17 +499,22 @@ private:
     /// whether the job queue is empty).
     Job_queue m_job_queue;
 
-    /// The type of the maps below.
-    typedef std::map<mi::Uint64, IJob*> Job_map;
-    /// The map that holds for each running worker thread the job that it is executing.
-    /// Protected by m_lock.
-    Job_map m_running_jobs;
-    /// The map that holds for each suspended worker thread the job that it is executing.
-    /// Protected by m_lock.
-    Job_map m_suspended_jobs;
+    /// The capacity of m_steal_victims.
+    static const mi::Uint32 s_max_steal_victims = 256;
+
+    /// The worker threads whose local job deques are visited when stealing jobs, in creation
+    /// order. Written under m_lock, read without lock.
+    ///
+    /// Fixed capacity such that readers never observe a reallocation. Worker threads beyond that
+    /// capacity still process their own local job deque, but are not visited by other worker
+    /// threads.
+    std::atomic<Worker_thread*> m_steal_victims[s_max_steal_victims];
+
+    /// The number of valid entries in m_steal_victims.
+    std::atomic_uint32_t m_nr_of_steal_victims;
 
     /// The lock that protects the current loads, the vector of all worker threads, the set of
-    /// sleeping worker threads, the job queue, and the maps for running and suspended jobs.
+    /// sleeping worker threads, and the job queue.
     mutable mi::base::Lock m_lock;
 
     /// The thread state counters.
@@ -487,6 +531,9 @@ private:
 
     /// Used by the destructor to block submitting of new jobs.
     bool m_shutdown;
+
+    /// Indicates whether the work stealing mode is enabled.
+    std::atomic_bool m_work_stealing;
 };
 
 } // namespace THREAD_POOL
@@ -32,6 +32,7 @@
 #define MI_TEST_IMPLEMENT_TEST_MAIN_INSTEAD_OF_MAIN
 
 #include <atomic>
+#include <vector>
 
 #include <base/system/test/i_test_auto_driver.h>
 #include <base/system/test/i_test_auto_case.h>
@@ -39,6 +40,7 @@
 #include <mi/base/interface_implement.h>
 #include <base/system/main/access_module.h>
 #include <base/hal/thread/i_thread_condition.h>
+#include <base/hal/thread/i_thread_thread.h>
 #include <base/hal/time/i_time.h>
 #include <base/lib/mem/mem.h>
 #include <base/lib/log/i_log_module.h>
@@ -811,6 +813,237 @@ void test_yield()
     LOG::mod_log->info( M_THREAD_POOL, LOG::Mod_log::C_MISC, " ");
 }
 
+/// Records the order in which jobs are admitted, see Order_job and Stealing_job.
+std::atomic_uint32_t g_next_start_index( 0);
+
+/// A non-splittable job that records when it was admitted.
+class Order_job : public mi::base::Interface_implement<IJob>
+{
+public:
+    Order_job( mi::Float32 cpu_load, mi::Float32 gpu_load, mi::Sint8 priority)
+      : m_cpu_load( cpu_load), m_gpu_load( gpu_load), m_priority( priority), m_start_index( ~0u)
+    {
+    }
+
+    mi::Float32 get_cpu_load() const { return m_cpu_load; }
+    mi::Float32 get_gpu_load() const { return m_gpu_load; }
+    mi::Sint8 get_priority() const { return m_priority; }
+    bool is_remaining_work_splittable() { return false; }
+    void pre_execute( const mi::neuraylib::IJob_execution_context* context)
+    { m_start_index = g_next_start_index++; }
+    void execute( const mi::neuraylib::IJob_execution_context* context) { TIME::sleep( 0.01); }
+
+    mi::Uint32 get_start_index() const { return m_start_index; }
+
+private:
+    mi::Float32 m_cpu_load;
+    mi::Float32 m_gpu_load;
+    mi::Sint8 m_priority;
+    std::atomic_uint32_t m_start_index;
+};
+
+/// The number of pre_execute() calls of the calling thread not yet followed by execute().
+thread_local mi::Uint32 g_pending_pre_execute_calls = 0;
+
+/// A splittable job that checks that each execute() call follows a pre_execute() call from the
+/// same thread with the same context, and that the load limits of the thread pool hold.
+///
+/// Failures are recorded and checked by the submitting thread, since checks must not throw from
+/// worker threads.
+class Stealing_job : public mi::base::Interface_implement<IJob>
+{
+public:
+    Stealing_job(
+        Thread_pool* thread_pool,
+        mi::Float32 cpu_load,
+        mi::Float32 gpu_load,
+        mi::Sint8 priority,
+        mi::Uint32 count)
+      : m_thread_pool( thread_pool),
+        m_cpu_load( cpu_load),
+        m_gpu_load( gpu_load),
+        m_priority( priority),
+        m_count( count),
+        m_next_fragment( 0),
+        m_threads( 0),
+        m_active( 0),
+        m_max_active( 0),
+        m_start_index( ~0u),
+        m_failures( 0)
+    {
+    }
+
+    mi::Float32 get_cpu_load() const { return m_cpu_load; }
+    mi::Float32 get_gpu_load() const { return m_gpu_load; }
+    mi::Sint8 get_priority() const { return m_priority; }
+    bool is_remaining_work_splittable()
+    {
+        return m_next_fragment+1 < m_count && m_threads < m_count;
+    }
+
+    void pre_execute( const mi::neuraylib::IJob_execution_context* context)
+    {
+        if( m_threads++ == 0)
+            m_start_index = g_next_start_index++;
+        if( context->get_thread_id() != THREAD::Thread_id().get_uint())
+            ++m_failures;
+        ++g_pending_pre_execute_calls;
+    }
+
+    void execute( const mi::neuraylib::IJob_execution_context* context)
+    {
+        if( g_pending_pre_execute_calls == 0)
+            ++m_failures;
+        else
+            --g_pending_pre_execute_calls;
+        if( context->get_thread_id() != THREAD::Thread_id().get_uint())
+            ++m_failures;
+
+        mi::Uint32 active = ++m_active;
+        mi::Uint32 max_active = m_max_active;
+        while( active > max_active && !m_max_active.compare_exchange_weak( max_active, active))
+            ;
+        if(    m_thread_pool->get_current_cpu_load() > m_thread_pool->get_cpu_load_limit() * 1.001
+            || m_thread_pool->get_current_gpu_load() > m_thread_pool->get_gpu_load_limit() * 1.001)
+            ++m_failures;
+
+        mi::Uint32 index = m_next_fragment++;
+        while( index < m_count) {
+            TIME::sleep( 0.002);
+            index = m_next_fragment++;
+        }
+
+        --m_active;
+    }
+
+    mi::Uint32 get_max_active() const { return m_max_active; }
+    mi::Uint32 get_start_index() const { return m_start_index; }
+    mi::Uint32 get_failures() const { return m_failures; }
+
+private:
+    Thread_pool* m_thread_pool;
+    mi::Float32 m_cpu_load;
+    mi::Float32 m_gpu_load;
+    mi::Sint8 m_priority;
+    mi::Uint32 m_count;
+    std::atomic_uint32_t m_next_fragment;
+    std::atomic_uint32_t m_threads;
+    std::atomic_uint32_t m_active;
+    std::atomic_uint32_t m_max_active;
+    std::atomic_uint32_t m_start_index;
+    std::atomic_uint32_t m_failures;
+};
+
+/// Waits (at most one second) until the thread pool has no load anymore.
+///
+/// Loads are released after the submitting thread has been woken up.
+void wait_for_zero_load( Thread_pool& thread_pool)
+{
+    for( mi::Uint32 i = 0; i < 100; ++i) {
+        if(    thread_pool.get_current_cpu_load() == 0.0f
+            && thread_pool.get_current_gpu_load() == 0.0f)
+            return;
+        TIME::sleep( 0.01);
+    }
+}
+
+/// Submits fragmented jobs and nested child jobs with the work stealing mode enabled.
+void test_work_stealing()
+{
+    LOG::mod_log->info( M_THREAD_POOL, LOG::Mod_log::C_MISC, "Testing work stealing ...\n ");
+
+    mi::Float32 cpu_load = 1.0f;
+    mi::Float32 gpu_load = 1.0f;
+    mi::Float32 delay    = 0.01f;
+    mi::Uint32  count    = 64;
+    mi::Uint32  levels   = 6;
+
+    Thread_pool thread_pool( 8.0, 8.0, 1);
+    thread_pool.set_work_stealing_enabled( true);
+    ASSERT( M_THREAD_POOL, thread_pool.get_work_stealing_enabled());
+    thread_pool.dump_thread_state_counters();
+    thread_pool.dump_load();
+
+    for( mi::Uint32 thread_limit = 0; thread_limit < 3; ++thread_limit) {
+        mi::base::Handle<Fragmented_job_using_mixin> job( new Fragmented_job_using_mixin(
+            &thread_pool, cpu_load, gpu_load, delay, count, thread_limit));
+        LOG::mod_log->info( M_THREAD_POOL, LOG::Mod_log::C_MISC,
+            "Submitting fragmented job using mixin with %d fragments (CPU load %.1f, GPU load "
+            "%.1f, thread limit %d), waiting for completion",
+            count, cpu_load, gpu_load, thread_limit);
+        thread_pool.submit_job_and_wait( job.get());
+    }
+
+    cpu_load = 0.5f;
+    gpu_load = 0.5f;
+    mi::base::Handle<Tree_job> job( new Tree_job(
+        &thread_pool, 0, levels, cpu_load, gpu_load, delay));
+    LOG::mod_log->info( M_THREAD_POOL, LOG::Mod_log::C_MISC,
+        "Submitting tree job level %d (CPU load %.1f, GPU load %.1f), waiting for completion",
+        0, cpu_load, gpu_load);
+    thread_pool.submit_job_and_wait( job.get());
+
+    thread_pool.dump_thread_state_counters();
+    thread_pool.dump_load();
+
+    LOG::mod_log->info( M_THREAD_POOL, LOG::Mod_log::C_MISC, " ");
+}
+
+/// Checks pre_execute()/execute() pairing, load limits and priorities with work stealing enabled.
+void test_work_stealing_limits()
+{
+    LOG::mod_log->info( M_THREAD_POOL, LOG::Mod_log::C_MISC,
+        "Testing load limits and priorities with work stealing ...\n ");
+
+    Thread_pool thread_pool( 4.0, 2.0, 1);
+    thread_pool.set_work_stealing_enabled( true);
+
+    // The first job creates the worker threads, the second one is distributed among sleeping
+    // worker threads and stolen. The CPU load limits the job to 4 threads, the GPU load to 2.
+    for( mi::Float32 gpu_load: { 0.0f, 0.0f, 1.0f}) {
+        mi::base::Handle<Stealing_job> job(
+            new Stealing_job( &thread_pool, 1.0f, gpu_load, 0, 256));
+        thread_pool.submit_job_and_wait( job.get());
+        wait_for_zero_load( thread_pool);
+        MI_CHECK_EQUAL( job->get_failures(), 0u);
+        MI_CHECK_GREATER( job->get_max_active(), 0u);
+        MI_CHECK_LESS_OR_EQUAL( job->get_max_active(), gpu_load > 0.0f ? 2u : 4u);
+        MI_CHECK_EQUAL( thread_pool.get_current_cpu_load(), 0.0f);
+        MI_CHECK_EQUAL( thread_pool.get_current_gpu_load(), 0.0f);
+    }
+
+    // Keep the thread pool busy while submitting the jobs, then check that the jobs were admitted
+    // by priority, the splittable low-priority job last.
+    mi::base::Handle<Block_job> job0( new Block_job( &thread_pool, 0, 4.0f, 0.0f));
+    thread_pool.submit_job( job0.get());
+
+    g_next_start_index = 0;
+    mi::base::Handle<Stealing_job> low( new Stealing_job( &thread_pool, 1.0f, 0.0f, 10, 64));
+    thread_pool.submit_job( low.get());
+    std::vector<mi::base::Handle<Order_job>> jobs;
+    for( mi::Sint8 priority = 3; priority > 0; --priority) {
+        jobs.push_back( mi::base::make_handle( new Order_job( 1.0f, 0.0f, priority)));
+        thread_pool.submit_job( jobs.back().get());
+    }
+
+    job0->continue_job();
+
+    mi::base::Handle<Order_job> last( new Order_job( 1.0f, 0.0f, 127));
+    thread_pool.submit_job_and_wait( last.get());
+    wait_for_zero_load( thread_pool);
+
+    // jobs[2] has priority 1, jobs[0] has priority 3.
+    MI_CHECK_EQUAL( jobs[2]->get_start_index(), 0u);
+    MI_CHECK_EQUAL( jobs[1]->get_start_index(), 1u);
+    MI_CHECK_EQUAL( jobs[0]->get_start_index(), 2u);
+    MI_CHECK_EQUAL( low->get_start_index(), 3u);
+    MI_CHECK_EQUAL( last->get_start_index(), 4u);
+    MI_CHECK_EQUAL( low->get_failures(), 0u);
+    MI_CHECK_LESS_OR_EQUAL( low->get_max_active(), 4u);
+
+    LOG::mod_log->info( M_THREAD_POOL, LOG::Mod_log::C_MISC, " ");
+}
+
 MI_TEST_AUTO_FUNCTION( test_thread_pool )
 {
     SYSTEM::Access_module<MEM::Mem_module> mem_module( false);
@@ -824,6 +1057,8 @@ MI_TEST_AUTO_FUNCTION( test_thread_pool )
     test_expensive_jobs();
     test_priorities();
     test_yield();
+    test_work_stealing();
+    test_work_stealing_limits();
 }
 
 MI_TEST_MAIN_CALLING_TEST_MAIN();
@@ -67,12 +67,17 @@ Thread_pool::Thread_pool(
     m_current_cpu_load( 0.0f),
     m_current_gpu_load( 0.0f),
     m_thread_affinity( false),
+    m_nr_of_steal_victims( 0),
     m_next_cpu_id( 0),
-    m_shutdown( false)
+    m_shutdown( false),
+    m_work_stealing( false)
 {
     for( mi::Size i = 0; i < N_THREAD_STATES; ++i)
         m_thread_state_counter[i] = 0;
 
+    for( mi::Size i = 0; i < s_max_steal_victims; ++i)
+        m_steal_victims[i] = nullptr;
+
     for( mi::Size i = 0; i < nr_of_worker_threads; ++i)
         create_worker_thread();
 
@@ -85,8 +90,8 @@ Thread_pool::~Thread_pool()
     mi::base::Lock::Block block( &m_lock);
     m_shutdown = true;
 
-    // Wait until job queue is empty.
-    while( !m_job_queue.empty()) {
+    // Wait until job queue and local job deques are empty.
+    while( !m_job_queue.empty() || has_local_jobs()) {
         block.release();
         TIME::sleep( 0.01);
         block.set( &m_lock);
@@ -107,8 +112,6 @@ Thread_pool::~Thread_pool()
     block.set( &m_lock);
 
     ASSERT( M_THREAD_POOL, m_job_queue.empty());
-    ASSERT( M_THREAD_POOL, m_running_jobs.empty());
-    ASSERT( M_THREAD_POOL, m_suspended_jobs.empty());
 
     ASSERT( M_THREAD_POOL, m_thread_state_counter[THREAD_STARTING]  == 0);
     ASSERT( M_THREAD_POOL, m_thread_state_counter[THREAD_SLEEPING]  == 0);
@@ -121,6 +124,7 @@ Thread_pool::~Thread_pool()
         delete m_all_threads[i];
     m_all_threads.clear();
     m_sleeping_threads.clear();
+    m_nr_of_steal_victims = 0;
 
     ASSERT( M_THREAD_POOL, m_thread_state_counter[THREAD_SHUTDOWN]  == 0);
 }
@@ -208,9 +212,8 @@ void Thread_pool::submit_job( IJob* job)
     mi::Float32 cpu_load;
     mi::Float32 gpu_load;
     mi::Sint8 priority;
-    mi::Uint64 thread_id;
-    bool suspended_worker_thread
-        = get_current_job_data( cpu_load, gpu_load, priority, thread_id, true);
+    Worker_thread* suspended_worker_thread
+        = get_current_job_data( cpu_load, gpu_load, priority, true);
     ASSERT( M_THREAD_POOL, !suspended_worker_thread);
 #endif // ENABLE_ASSERT
 
@@ -225,9 +228,8 @@ void Thread_pool::submit_job_and_wait( IJob* job)
     mi::Float32 cpu_load;
     mi::Float32 gpu_load;
     mi::Sint8 priority;
-    mi::Uint64 thread_id;
-    bool suspended_worker_thread
-        = get_current_job_data( cpu_load, gpu_load, priority, thread_id, true);
+    Worker_thread* suspended_worker_thread
+        = get_current_job_data( cpu_load, gpu_load, priority, true);
     ASSERT( M_THREAD_POOL, !suspended_worker_thread);
 #endif // ENABLE_ASSERT
 
@@ -361,31 +363,85 @@ IJob* Thread_pool::get_next_job( Worker_thread* thread)
     // notify job about upcoming execute() call (might affect is_remaining_work_splittable() below)
     job->pre_execute( thread);
 
-    // remove job from queue if the job does no want more parallel calls
+    // adjust current load
+    m_current_cpu_load += requested_cpu_load;
+    m_current_gpu_load += requested_gpu_load;
+
+    // In work stealing mode, admit further worker threads for jobs that want more parallel calls
+    // right away. Otherwise, wake up another worker thread for such jobs (after removing this
+    // thread from the set of sleeping threads).
     bool dequeue_job = !job->is_remaining_work_splittable();
+    if( !dequeue_job) {
+        if( m_work_stealing)
+            distribute_job( job, requested_cpu_load, requested_gpu_load);
+        else
+            wake_up_worker_thread();
+    }
+
+    // remove job from queue if the job does no want more parallel calls
     if( dequeue_job) {
         it_map->second.erase( it_list);
         if( it_map->second.empty())
             m_job_queue.erase( it_map);
     }
 
-    // adjust current load
-    m_current_cpu_load += requested_cpu_load;
-    m_current_gpu_load += requested_gpu_load;
-
-    // wake up another worker thread for jobs that want more parallel calls (after removing this
-    // thread from the set of sleeping threads)
-    if( !dequeue_job)
-       wake_up_worker_thread();
-
     // map thread to the job
-    mi::Uint64 thread_id = thread->get_thread_id();
-    ASSERT( M_THREAD_POOL, m_running_jobs.find( thread_id) == m_running_jobs.end());
-    m_running_jobs[thread_id] = job;
+    ASSERT( M_THREAD_POOL, !thread->get_current_job());
+    thread->set_current_job( job);
 
     return job;
 }
 
+IJob* Thread_pool::get_next_local_job( Worker_thread* thread)
+{
+    ASSERT( M_THREAD_POOL, thread->get_state() == THREAD_IDLE);
+
+    while( true) {
+
+        IJob* job = thread->pop_local_job();
+
+        // Visit the other worker threads starting with the next one in creation order.
+        // Consecutively created worker threads use consecutive CPU IDs, i.e., neighbors are
+        // visited first.
+        if( !job && m_work_stealing) {
+            mi::Uint32 n = m_nr_of_steal_victims;
+            mi::Uint32 index = thread->get_index();
+            for( mi::Uint32 i = 1; !job && i < n; ++i) {
+                Worker_thread* victim = m_steal_victims[(index+i) % n];
+                if( victim != thread)
+                    job = victim->steal_local_job();
+            }
+        }
+
+        if( !job)
+            return nullptr;
+
+        mi::base::Lock::Block block( &m_lock);
+
+        // The job was admitted for some worker thread, but only the thread that executes it calls
+        // pre_execute(). Give the admission back if the job does not want more parallel calls
+        // anymore.
+        if( !job->is_remaining_work_splittable()) {
+            mi::Float32 requested_cpu_load = job->get_cpu_load();
+            mi::Float32 requested_gpu_load = job->get_gpu_load();
+            adjust_load( requested_cpu_load, requested_gpu_load);
+            m_current_cpu_load -= requested_cpu_load;
+            m_current_gpu_load -= requested_gpu_load;
+            job->release();
+            continue;
+        }
+
+        // notify job about upcoming execute() call
+        job->pre_execute( thread);
+
+        // map thread to the job
+        ASSERT( M_THREAD_POOL, !thread->get_current_job());
+        thread->set_current_job( job);
+
+        return job;
+    }
+}
+
 void Thread_pool::job_execution_finished( Worker_thread* thread, IJob* job)
 {
     mi::base::Lock::Block block( &m_lock);
@@ -411,10 +467,9 @@ void Thread_pool::job_execution_finished( Worker_thread* thread, IJob* job)
     }
 
     // unmap job from thread
-    mi::Uint64 thread_id = thread->get_thread_id();
-    Job_map::iterator it = m_running_jobs.find( thread_id);
-    ASSERT( M_THREAD_POOL, it != m_running_jobs.end());
-    m_running_jobs.erase( it); //-V783 PVS
+    ASSERT( M_THREAD_POOL, thread->get_current_job() == job);
+    ASSERT( M_THREAD_POOL, !thread->is_current_job_suspended());
+    thread->set_current_job( nullptr);
 }
 
 void Thread_pool::dump_load() const
@@ -450,9 +505,10 @@ void Thread_pool::submit_job_internal( IJob* job, bool log_asynchronous)
 
     // Put top-level jobs at the end of the job queue, put child jobs and resume jobs at the
     // beginning of the queue.
-    mi::Uint64 thread_id = THREAD::Thread_id().get_uint();
-    bool resume_job = m_running_jobs.find( thread_id) != m_running_jobs.end();
-    bool child_job  = m_suspended_jobs.find( thread_id) != m_suspended_jobs.end();
+    Worker_thread* thread = Worker_thread::get_current_worker_thread();
+    bool worker_thread = thread && thread->get_thread_pool() == this && thread->get_current_job();
+    bool resume_job = worker_thread && !thread->is_current_job_suspended();
+    bool child_job  = worker_thread &&  thread->is_current_job_suspended();
 
     mi::Sint8 priority = job->get_priority();
 
@@ -505,14 +561,13 @@ bool Thread_pool::suspend_current_job_internal( bool only_for_higher_priority)
     mi::Float32 cpu_load;
     mi::Float32 gpu_load;
     mi::Sint8 priority;
-    mi::Uint64 thread_id;
-    bool running_worker_thread
-        = get_current_job_data_locked( cpu_load, gpu_load, priority, thread_id, false);
+    Worker_thread* running_worker_thread
+        = get_current_job_data( cpu_load, gpu_load, priority, false);
     if( !running_worker_thread) {
 #ifdef ENABLE_ASSERT
         // detect nested suspend calls
-        bool suspended_worker_thread
-            = get_current_job_data_locked( cpu_load, gpu_load, priority, thread_id, true);
+        Worker_thread* suspended_worker_thread
+            = get_current_job_data( cpu_load, gpu_load, priority, true);
         ASSERT( M_THREAD_POOL, !suspended_worker_thread);
 #endif // ENABLE_ASSERT
         return false;
@@ -532,12 +587,8 @@ bool Thread_pool::suspend_current_job_internal( bool only_for_higher_priority)
     m_current_cpu_load -= cpu_load;
     m_current_gpu_load -= gpu_load;
 
-    // move job from map of running threads to map of suspended threads
-    Job_map::iterator it = m_running_jobs.find( thread_id);
-    ASSERT( M_THREAD_POOL, it != m_running_jobs.end());
-    ASSERT( M_THREAD_POOL, m_suspended_jobs.find( thread_id) == m_suspended_jobs.end());
-    m_suspended_jobs[thread_id] = it->second; //-V783 PVS
-    m_running_jobs.erase( it);
+    // mark job as suspended
+    running_worker_thread->set_current_job_suspended( true);
 
     // wake up some worker thread if there are jobs in the queue
     if( !m_job_queue.empty())
@@ -552,14 +603,13 @@ void Thread_pool::resume_current_job_internal()
     mi::Float32 cpu_load;
     mi::Float32 gpu_load;
     mi::Sint8 priority;
-    mi::Uint64 thread_id;
-    bool suspended_worker_thread
-        = get_current_job_data( cpu_load, gpu_load, priority, thread_id, true);
+    Worker_thread* suspended_worker_thread
+        = get_current_job_data( cpu_load, gpu_load, priority, true);
     if( !suspended_worker_thread) {
 #ifdef ENABLE_ASSERT
         // detect nested resume calls
-        bool running_worker_thread
-            = get_current_job_data( cpu_load, gpu_load, priority, thread_id, false);
+        Worker_thread* running_worker_thread
+            = get_current_job_data( cpu_load, gpu_load, priority, false);
         ASSERT( M_THREAD_POOL, !running_worker_thread);
 #endif // ENABLE_ASSERT
         return;
@@ -577,13 +627,36 @@ void Thread_pool::resume_current_job_internal()
     --m_thread_state_counter[THREAD_SUSPENDED];
     ++m_thread_state_counter[THREAD_RUNNING];
 
-    // move job from map of suspended threads to map of running threads
-    mi::base::Lock::Block block( &m_lock);
-    Job_map::iterator it = m_suspended_jobs.find( thread_id);
-    ASSERT( M_THREAD_POOL, it != m_suspended_jobs.end());
-    ASSERT( M_THREAD_POOL, m_running_jobs.find( thread_id) == m_running_jobs.end());
-    m_running_jobs[thread_id] = it->second; //-V783 PVS
-    m_suspended_jobs.erase( it);
+    // mark job as running again
+    suspended_worker_thread->set_current_job_suspended( false);
+}
+
+void Thread_pool::distribute_job( IJob* job, mi::Float32 cpu_load, mi::Float32 gpu_load)
+{
+    // The caller is supposed to hold m_lock.
+
+    // The job learns about additional threads only when they call pre_execute() themselves, so it
+    // cannot tell here how many it still wants. Admit the sleeping worker threads as far as the
+    // load limits permit, surplus admissions are given back in get_next_local_job().
+    bool admitted = false;
+    while( !m_sleeping_threads.empty() && job_fits_load_limits( cpu_load, gpu_load)) {
+
+        // remove thread from the set of sleeping threads
+        Worker_thread* thread = *m_sleeping_threads.begin();
+        ASSERT( M_THREAD_POOL, thread->get_state() == THREAD_SLEEPING);
+        m_sleeping_threads.erase( m_sleeping_threads.begin());
+
+        // admit the thread for the job and hand the job over via its local job deque
+        m_current_cpu_load += cpu_load;
+        m_current_gpu_load += gpu_load;
+        thread->push_local_job( job);
+        thread->wake_up();
+        admitted = true;
+    }
+
+    // Without sleeping worker threads, wake up (i.e., create) one that searches the job queue.
+    if( !admitted)
+        wake_up_worker_thread();
 }
 
 void Thread_pool::create_worker_thread()
@@ -595,11 +668,16 @@ void Thread_pool::create_worker_thread()
         return;
 
     // The caller is supposed to hold m_lock.
-    Worker_thread* thread = new Worker_thread( this, m_next_cpu_id);
+    mi::Uint32 index = static_cast<mi::Uint32>( m_all_threads.size());
+    Worker_thread* thread = new Worker_thread( this, m_next_cpu_id, index);
     m_next_cpu_id = (m_next_cpu_id+1) % THREAD::Thread::get_nr_of_cpus();
     thread->set_thread_affinity_enabled( m_thread_affinity);
     thread->start();
     m_all_threads.push_back( thread);
+    if( index < s_max_steal_victims) {
+        m_steal_victims[index] = thread;
+        m_nr_of_steal_victims = index+1;
+    }
     ASSERT( M_THREAD_POOL, thread->get_state() == THREAD_SLEEPING);
     m_sleeping_threads.insert( thread);
 }
@@ -620,6 +698,15 @@ void Thread_pool::wake_up_worker_thread()
     boost::ignore_unused( result);
 }
 
+bool Thread_pool::has_local_jobs() const
+{
+    // The caller is supposed to hold m_lock.
+    for( mi::Size i = 0; i < m_all_threads.size(); ++i)
+        if( m_all_threads[i]->has_local_jobs())
+            return true;
+    return false;
+}
+
 bool Thread_pool::job_fits_load_limits( mi::Float32 cpu_load, mi::Float32 gpu_load) const
 {
     // The caller is supposed to hold m_lock.
@@ -633,50 +720,30 @@ bool Thread_pool::job_fits_load_limits( mi::Float32 cpu_load, mi::Float32 gpu_lo
         && m_current_gpu_load + gpu_load <= m_gpu_load_limit * 1.001;
 }
 
-bool Thread_pool::get_current_job_data(
+Worker_thread* Thread_pool::get_current_job_data(
     mi::Float32& cpu_load,
     mi::Float32& gpu_load,
     mi::Sint8& priority,
-    mi::Uint64& thread_id,
     bool suspended) const
 {
-    mi::base::Lock::Block block( &m_lock);
-    return get_current_job_data_locked( cpu_load, gpu_load, priority, thread_id, suspended);
-}
-
-bool Thread_pool::get_current_job_data_locked(
-    mi::Float32& cpu_load,
-    mi::Float32& gpu_load,
-    mi::Sint8& priority,
-    mi::Uint64& thread_id,
-    bool suspended) const
-{
-    // The caller is supposed to hold m_lock.
-    thread_id = THREAD::Thread_id().get_uint();
-    Job_map::const_iterator it;
-    if( suspended) {
-        it = m_suspended_jobs.find( thread_id);
-        if( it == m_suspended_jobs.end()) {
-            cpu_load = 0.0;
-            gpu_load = 0.0;
-            priority = 0;
-            return false;
-        }
-    } else {
-        it = m_running_jobs.find( thread_id);
-        if( it == m_running_jobs.end()) {
-            cpu_load = 0.0;
-            gpu_load = 0.0;
-            priority = 0;
-            return false;
-        }
+    // Only the calling thread itself changes its current job and suspended flag.
+    Worker_thread* thread = Worker_thread::get_current_worker_thread();
+    if(    !thread
+        || thread->get_thread_pool() != this
+        || !thread->get_current_job()
+        || thread->is_current_job_suspended() != suspended) {
+        cpu_load = 0.0;
+        gpu_load = 0.0;
+        priority = 0;
+        return nullptr;
     }
 
-    cpu_load = it->second->get_cpu_load();
-    gpu_load = it->second->get_gpu_load();
+    IJob* job = thread->get_current_job();
+    cpu_load = job->get_cpu_load();
+    gpu_load = job->get_gpu_load();
     adjust_load( cpu_load, gpu_load);
-    priority = it->second->get_priority();
-    return true;
+    priority = job->get_priority();
+    return thread;
 }
 
 bool Thread_pool::generate_admin_http_server_page( HTTP::Connection* connection)
@@ -35,6 +35,7 @@
 #include "thread_pool_worker_thread.h"
 
 #include <mi/base/config.h>
+#include <mi/base/handle.h>
 #include <boost/core/ignore_unused.hpp>
 #include <base/lib/log/i_log_assert.h>
 #include <base/lib/log/i_log_logger.h>
@@ -46,13 +47,23 @@ namespace MI {
 
 namespace THREAD_POOL {
 
-Worker_thread::Worker_thread( Thread_pool* thread_pool, mi::Uint32 cpu_id)
+namespace {
+
+/// The worker thread executing the calling thread (if any).
+thread_local Worker_thread* g_current_worker_thread = nullptr;
+
+} // namespace
+
+Worker_thread::Worker_thread( Thread_pool* thread_pool, mi::Uint32 cpu_id, mi::Uint32 index)
   : m_thread_pool( thread_pool),
     m_state( THREAD_STARTING),
     m_shutdown( false),
     m_thread_id( 0),
     m_cpu_id( cpu_id),
-    m_thread_affinity_enabled( false)
+    m_thread_affinity_enabled( false),
+    m_index( index),
+    m_current_job( nullptr),
+    m_current_job_suspended( false)
 {
     m_thread_pool->increase_thread_state_counter( m_state);
 }
@@ -60,6 +71,7 @@ Worker_thread::Worker_thread( Thread_pool* thread_pool, mi::Uint32 cpu_id)
 Worker_thread::~Worker_thread()
 {
     ASSERT( M_THREAD_POOL, m_state == THREAD_SHUTDOWN);
+    ASSERT( M_THREAD_POOL, m_local_jobs.empty());
     m_thread_pool->decrease_thread_state_counter( m_state);
 
 }
@@ -92,6 +104,43 @@ void Worker_thread::set_thread_affinity_enabled( bool value)
     m_thread_affinity_enabled = value;
 }
 
+Worker_thread* Worker_thread::get_current_worker_thread()
+{
+    return g_current_worker_thread;
+}
+
+void Worker_thread::push_local_job( IJob* job)
+{
+    mi::base::Lock::Block block( &m_local_jobs_lock);
+    m_local_jobs.push_back( make_handle_dup( job));
+}
+
+IJob* Worker_thread::pop_local_job()
+{
+    mi::base::Lock::Block block( &m_local_jobs_lock);
+    if( m_local_jobs.empty())
+        return nullptr;
+    IJob* job = m_local_jobs.back().extract();
+    m_local_jobs.pop_back();
+    return job;
+}
+
+IJob* Worker_thread::steal_local_job()
+{
+    mi::base::Lock::Block block;
+    if( !block.try_set( &m_local_jobs_lock) || m_local_jobs.empty())
+        return nullptr;
+    IJob* job = m_local_jobs.front().extract();
+    m_local_jobs.pop_front();
+    return job;
+}
+
+bool Worker_thread::has_local_jobs() const
+{
+    mi::base::Lock::Block block( &m_local_jobs_lock);
+    return !m_local_jobs.empty();
+}
+
 void Worker_thread::set_state( Thread_state state)
 {
     m_thread_pool->decrease_thread_state_counter( m_state);
@@ -102,6 +151,7 @@ void Worker_thread::set_state( Thread_state state)
 void Worker_thread::run()
 {
     m_thread_id = static_cast<mi::Uint64>( THREAD::Thread_id().get_uint());
+    g_current_worker_thread = this;
 
     ASSERT( M_THREAD_POOL, m_state == THREAD_STARTING);
     set_state( THREAD_SLEEPING);
@@ -119,6 +169,7 @@ void Worker_thread::run()
     ASSERT( M_THREAD_POOL, m_state == THREAD_SLEEPING);
     set_state( THREAD_SHUTDOWN);
 
+    g_current_worker_thread = nullptr;
     m_thread_id = 0;
 }
 
@@ -136,7 +187,9 @@ void Worker_thread::process_jobs()
 bool Worker_thread::process_job()
 {
     // LOG::mod_log->vdebug( M_THREAD_POOL, LOG::Mod_log::C_MISC, "Entering process_job()");
-    IJob* job = m_thread_pool->get_next_job( this);
+    IJob* job = m_thread_pool->get_next_local_job( this);
+    if( !job)
+        job = m_thread_pool->get_next_job( this);
     if( !job) {
         // LOG::mod_log->vdebug( M_THREAD_POOL, LOG::Mod_log::C_MISC,
         //     "Leaving process_job() (got no job)");
@@ -33,7 +33,11 @@
 #ifndef BASE_DATA_THREAD_POOL_THREAD_POOL_WORKER_THREAD_H
 #define BASE_DATA_THREAD_POOL_THREAD_POOL_WORKER_THREAD_H
 
+#include <deque>
+
 #include <mi/base/condition.h>
+#include <mi/base/handle.h>
+#include <mi/base/lock.h>
 #include <mi/neuraylib/iserializer.h> // IJob_execution_context
 #include <base/system/main/i_module_id.h>
 #include <base/hal/thread/i_thread_thread.h>
@@ -43,6 +47,7 @@ namespace MI {
 
 namespace THREAD_POOL {
 
+class IJob;
 class Thread_pool;
 
 /// The various states for worker threads.
@@ -77,7 +82,11 @@ public:
     /// Constructor.
     ///
     /// Sets the thread state to THREAD_STARTING.
-    Worker_thread( Thread_pool* thread_pool, mi::Uint32 cpu_id);
+    ///
+    /// \param thread_pool   The thread pool this worker thread belongs to.
+    /// \param cpu_id        The CPU ID (used if thread affinity is enabled).
+    /// \param index         The index of this worker thread in creation order.
+    Worker_thread( Thread_pool* thread_pool, mi::Uint32 cpu_id, mi::Uint32 index);
 
     /// Destructor.
     ///
@@ -122,6 +131,62 @@ public:
     /// are updated correctly, though.
     Thread_state get_state() const { return m_state; }
 
+    /// Returns the thread pool this worker thread belongs to.
+    Thread_pool* get_thread_pool() const { return m_thread_pool; }
+
+    /// Returns the CPU ID (used if thread affinity is enabled).
+    mi::Uint32 get_cpu_id() const { return m_cpu_id; }
+
+    /// Returns the index of this worker thread in creation order.
+    mi::Uint32 get_index() const { return m_index; }
+
+    /// Returns the worker thread executing the calling thread, or \c NULL if the calling thread
+    /// is not a worker thread.
+    static Worker_thread* get_current_worker_thread();
+
+    /// \name Job currently assigned to this worker thread
+    ///
+    /// These methods are only to be used by the worker thread itself (or while it is not running).
+    //@{
+
+    /// Sets the job currently assigned to this worker thread (or \c NULL).
+    void set_current_job( IJob* job) { m_current_job = job; m_current_job_suspended = false; }
+
+    /// Returns the job currently assigned to this worker thread (or \c NULL).
+    IJob* get_current_job() const { return m_current_job; }
+
+    /// Marks the current job as suspended or running again.
+    void set_current_job_suspended( bool value) { m_current_job_suspended = value; }
+
+    /// Indicates whether the current job is suspended.
+    bool is_current_job_suspended() const { return m_current_job_suspended; }
+
+    //@}
+    /// \name Local job deque (work stealing mode)
+    //@{
+
+    /// Pushes a job onto the local job deque.
+    ///
+    /// Jobs on the local deque have already been admitted by the thread pool, i.e., the current
+    /// load has been increased. IJob::pre_execute() is called by the thread that pops or steals
+    /// the job.
+    void push_local_job( IJob* job);
+
+    /// Pops the most recently pushed job from the local job deque (used by the thread itself).
+    ///
+    /// Returns a retained job, or \c NULL if the local job deque is empty.
+    IJob* pop_local_job();
+
+    /// Steals the oldest job from the local job deque (used by other worker threads).
+    ///
+    /// Returns a retained job, or \c NULL if the local job deque is empty.
+    IJob* steal_local_job();
+
+    /// Indicates whether the local job deque is non-empty.
+    bool has_local_jobs() const;
+
+    //@}
+
 private:
     /// The main method of the thread.
     ///
@@ -170,6 +235,21 @@ private:
 
     /// Indicates whether thread affinity is enabled.
     bool m_thread_affinity_enabled;
+
+    /// The index of this worker thread in creation order.
+    mi::Uint32 m_index;
+
+    /// The job currently assigned to this worker thread (or \c NULL).
+    IJob* m_current_job;
+
+    /// Indicates whether the current job is suspended.
+    bool m_current_job_suspended;
+
+    /// The local job deque. Protected by m_local_jobs_lock.
+    std::deque<mi::base::Handle<IJob> > m_local_jobs;
+
+    /// The lock that protects m_local_jobs. Only contended if other threads steal jobs.
+    mutable mi::base::Lock m_local_jobs_lock;
 };
 
 } // namespace THREAD_POOL
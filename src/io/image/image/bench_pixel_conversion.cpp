@@ -0,0 +1,117 @@
+/******************************************************************************
+ * Copyright (c) 2024, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include "pch.h"
+
+#include "i_image.h"
+#include "image_pixel_conversion.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <base/hal/time/time_stopwatch.h>
+
+using namespace MI;
+
+// Reports the throughput of the kernels of each instruction set supported by this CPU for a
+// 4096x2160 image. This is not a unit test, see test_pixel_conversion_simd.cpp for the
+// correctness checks.
+
+const mi::Size W = 4096;
+const mi::Size H = 2160;
+
+const int g_runs = 5;
+
+std::mt19937 g_prng;
+
+template <typename T>
+void fill_random( std::vector<T>& data)
+{
+    for( auto& x: data)
+        x = static_cast<T>( g_prng());
+}
+
+void fill_random( std::vector<mi::Float32>& data)
+{
+    for( auto& x: data)
+        x = static_cast<float>( static_cast<double>( g_prng()) / g_prng.max()) * 1.2f - 0.1f;
+}
+
+/// Reports the best throughput of \p kernel over several runs.
+template <IMAGE::Pixel_type Source, IMAGE::Pixel_type Dest>
+void bench_conversion(
+    const char* isa,
+    void (*kernel)(
+        const typename IMAGE::Pixel_type_traits<Source>::Base_type*,
+        typename IMAGE::Pixel_type_traits<Dest>::Base_type*,
+        mi::Size))
+{
+    typedef typename IMAGE::Pixel_type_traits<Source>::Base_type Source_base_type;
+    typedef typename IMAGE::Pixel_type_traits<Dest>::Base_type   Dest_base_type;
+    const mi::Size source_cpp = IMAGE::Pixel_type_traits<Source>::s_components_per_pixel;
+    const mi::Size dest_cpp   = IMAGE::Pixel_type_traits<Dest>::s_components_per_pixel;
+
+    std::vector<Source_base_type> source( W * H * source_cpp);
+    std::vector<Dest_base_type> dest( W * H * dest_cpp);
+    fill_random( source);
+
+    double best = 0.0;
+    for( int i = 0; i < g_runs; ++i) {
+        TIME::Stopwatch stopwatch;
+        stopwatch.start();
+        kernel( source.data(), dest.data(), source.size());
+        stopwatch.stop();
+        if( i == 0 || stopwatch.elapsed() < best)
+            best = stopwatch.elapsed();
+    }
+
+    const double bytes = double(
+        source.size() * sizeof( Source_base_type) + dest.size() * sizeof( Dest_base_type));
+    std::cout << "conversion from " << IMAGE::convert_pixel_type_enum_to_string( Source)
+              << " to " << IMAGE::convert_pixel_type_enum_to_string( Dest) << " (" << isa
+              << "): " << bytes / best / 1e9 << " GB/s" << std::endl;
+}
+
+int main( int /*argc*/, char* /*argv*/[])
+{
+    using namespace MI::IMAGE;
+
+    for( const auto& k: get_all_pixel_conversion_kernels()) {
+        bench_conversion<PT_RGB,     PT_RGB_FP >( k.m_isa, k.m_uint8_to_float32);
+        bench_conversion<PT_RGBA,    PT_COLOR  >( k.m_isa, k.m_uint8_to_float32);
+        bench_conversion<PT_RGB_16,  PT_RGB_FP >( k.m_isa, k.m_uint16_to_float32);
+        bench_conversion<PT_RGBA_16, PT_COLOR  >( k.m_isa, k.m_uint16_to_float32);
+        bench_conversion<PT_RGB_FP,  PT_RGB    >( k.m_isa, k.m_float32_to_uint8);
+        bench_conversion<PT_COLOR,   PT_RGBA   >( k.m_isa, k.m_float32_to_uint8);
+        bench_conversion<PT_RGB_FP,  PT_RGB_16 >( k.m_isa, k.m_float32_to_uint16);
+        bench_conversion<PT_COLOR,   PT_RGBA_16>( k.m_isa, k.m_float32_to_uint16);
+    }
+
+    return 0;
+}
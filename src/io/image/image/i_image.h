@@ -100,6 +100,7 @@ namespace MI {
 
 namespace SYSTEM { class Module_registration_entry; }
 namespace SERIAL { class Serializer; class Deserializer; }
+namespace DB { class Database; }
 
 namespace IMAGE {
 
@@ -702,6 +703,20 @@ public:
     /// ... or \c NULL if no callback is set.
     virtual IMdl_container_callback* get_mdl_container_callback() const = 0;
 
+    /// Sets the database whose thread pool is used to compute large miplevels concurrently.
+    ///
+    /// Pass \c NULL to clear the database. Without database, miplevels are computed on the
+    /// calling thread. Not thread-safe.
+    virtual void set_database( DB::Database* database) = 0;
+
+    /// Indicates whether miplevels stored in image files are used instead of computing them.
+    ///
+    /// Controlled by the registry key "image_use_file_miplevels" (defaults to \c false), which is
+    /// read once during module initialization. Callers pass the negated value as
+    /// \c only_first_level to the file-, container-, and memory-based variants of
+    /// #create_mipmap().
+    virtual bool get_use_file_miplevels() const = 0;
+
     /// Creates the next miplevel from the given canvas.
     ///
     /// \param prev_canvas      The canvas to create a miplevel from.
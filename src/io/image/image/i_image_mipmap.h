@@ -85,6 +85,18 @@ public:
     ///
     /// Used to implement DB::Element_base::get_size() for DBIMAGE::Image.
     virtual mi::Size get_size() const = 0;
+
+    /// Releases memory that is not in use and can be recreated lazily.
+    ///
+    /// Computed miplevels are released (and recomputed when needed), unused tiles of miplevels
+    /// that support lazy loading are released (and reloaded when needed). Miplevels that are
+    /// referenced from elsewhere or that have been handed out via the mutable variant of
+    /// #get_level() are kept.
+    ///
+    /// Used to implement DB::Element_base::release_memory() for DBIMAGE::Image.
+    ///
+    /// \return   The number of bytes released.
+    virtual mi::Size release_memory() const = 0;
 };
 
 } // namespace IMAGE
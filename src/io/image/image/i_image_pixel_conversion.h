@@ -1784,84 +1784,106 @@ MI_FORCE_INLINE void quantize_unsigned_sse(__m128i* const dest, const float* con
 #endif
 
 
-// ---------- source PT_RGB_FP, target PT_RGB ------------------------------------------------------
+// ---------- vectorized conversions between 8-/16-bit and float components ------------------------
 
-template <>
-MI_HOST_DEVICE_INLINE void Pixel_converter<PT_RGB_FP,PT_RGB>::convert(
-    const Source_base_type* const source, Dest_base_type* const dest, const mi::Size count)
-{
-    // use source2 and dest2 instead of source and dest for easier pointer arithmetic
-    const float* __restrict source2 = reinterpret_cast<const float*>( source);
-    char* __restrict dest2          = reinterpret_cast<char*>(        dest);
+/// Converts \p count 8-bit components to floats, see Pixel_converter<PT_RGBA,PT_COLOR>.
+///
+/// The kernels of this and the following three functions are selected once at runtime based on
+/// the CPU features (AVX2 if supported, otherwise SSE2 on x86-64 or NEON on ARM64, or scalar
+/// code). All kernels produce the same results as the scalar per-pixel conversions.
+void convert_uint8_to_float32( const mi::Uint8* source, mi::Float32* dest, mi::Size count);
 
-    mi::Size i = 0;
+/// Converts \p count 16-bit components to floats, see Pixel_converter<PT_RGBA_16,PT_COLOR>.
+void convert_uint16_to_float32( const mi::Uint16* source, mi::Float32* dest, mi::Size count);
 
-#if defined(HAS_SSE) || defined(SSE_INTRINSICS)
-    const mi::Size w16_3 = count/16*3;
+/// Converts \p count float components to 8 bit, see Pixel_converter<PT_COLOR,PT_RGBA>.
+void convert_float32_to_uint8( const mi::Float32* source, mi::Uint8* dest, mi::Size count);
 
-    // convert 16 components in each iteration, i.e., 16/3 pixels
-    // _mm_packs_epi32() and _mm_packus_epi16() saturate the result
-    for( ; i < w16_3; ++i) {
+/// Converts \p count float components to 16 bit, see Pixel_converter<PT_COLOR,PT_RGBA_16>.
+void convert_float32_to_uint16( const mi::Float32* source, mi::Uint16* dest, mi::Size count);
 
-        quantize_unsigned_sse((__m128i*)dest2,source2);
+/// Returns the instruction set of the kernels used by the functions above ("avx2", "sse2",
+/// "neon", or "scalar").
+const char* get_pixel_conversion_isa();
 
-        source2 += 16;
-        dest2   += 16;
-    }
+// ---------- source PT_RGB, target PT_RGB_FP ------------------------------------------------------
 
-    i = count/16*16; // for falling through to the tail handling/non-SSE case below
-#endif
+template <>
+MI_HOST_DEVICE_INLINE void Pixel_converter<PT_RGB,PT_RGB_FP>::convert(
+    const Source_base_type* const source, Dest_base_type* const dest, const mi::Size count)
+{
+    convert_uint8_to_float32(
+        source, dest, count * Pixel_type_traits<PT_RGB>::s_components_per_pixel);
+}
 
-    // use source3 and dest3 instead of source2 and dest2 inside a row
-    const Source_base_type* __restrict source3
-        = reinterpret_cast<const Source_base_type*>( source2);
-    Dest_base_type* __restrict dest3
-        = reinterpret_cast<Dest_base_type*>( dest2);
+// ---------- source PT_RGBA, target PT_COLOR ------------------------------------------------------
 
-    for( ; i < count; ++i) {
-        convert( source3, dest3);
-        source3 += Pixel_type_traits<PT_RGB_FP>::s_components_per_pixel;
-        dest3   += Pixel_type_traits<PT_RGB>::s_components_per_pixel;
-    }
+template <>
+MI_HOST_DEVICE_INLINE void Pixel_converter<PT_RGBA,PT_COLOR>::convert(
+    const Source_base_type* const source, Dest_base_type* const dest, const mi::Size count)
+{
+    convert_uint8_to_float32(
+        source, dest, count * Pixel_type_traits<PT_RGBA>::s_components_per_pixel);
 }
 
-// ---------- source PT_RGBA_FP, target PT_COLOR --------------------------------------------------
+// ---------- source PT_RGB_16, target PT_RGB_FP ---------------------------------------------------
 
 template <>
-MI_HOST_DEVICE_INLINE void Pixel_converter<PT_COLOR,PT_RGBA>::convert(
+MI_HOST_DEVICE_INLINE void Pixel_converter<PT_RGB_16,PT_RGB_FP>::convert(
     const Source_base_type* const source, Dest_base_type* const dest, const mi::Size count)
 {
-    const float* __restrict source2 = reinterpret_cast<const float*>( source);
-    char* __restrict dest2          = reinterpret_cast<char*>(        dest);
+    convert_uint16_to_float32(
+        source, dest, count * Pixel_type_traits<PT_RGB_16>::s_components_per_pixel);
+}
 
-    mi::Size i = 0;
+// ---------- source PT_RGBA_16, target PT_COLOR ---------------------------------------------------
 
-#if defined(HAS_SSE) || defined(SSE_INTRINSICS)
-    const mi::Size w4 = count/4;
+template <>
+MI_HOST_DEVICE_INLINE void Pixel_converter<PT_RGBA_16,PT_COLOR>::convert(
+    const Source_base_type* const source, Dest_base_type* const dest, const mi::Size count)
+{
+    convert_uint16_to_float32(
+        source, dest, count * Pixel_type_traits<PT_RGBA_16>::s_components_per_pixel);
+}
 
-    // convert 16 components in each iteration, i.e., 16/4 = 4 pixels
-    // _mm_packs_epi32() and _mm_packus_epi16() saturate the result
-    for( ; i < w4; ++i) {
+// ---------- source PT_RGB_FP, target PT_RGB ------------------------------------------------------
 
-        quantize_unsigned_sse((__m128i*)dest2,source2);
+template <>
+MI_HOST_DEVICE_INLINE void Pixel_converter<PT_RGB_FP,PT_RGB>::convert(
+    const Source_base_type* const source, Dest_base_type* const dest, const mi::Size count)
+{
+    convert_float32_to_uint8(
+        source, dest, count * Pixel_type_traits<PT_RGB_FP>::s_components_per_pixel);
+}
 
-        source2 += 16;
-        dest2   += 16;
-    }
+// ---------- source PT_COLOR, target PT_RGBA ------------------------------------------------------
 
-    i = count/4*4; // for falling through to the tail handling/non-SSE case below
-#endif
+template <>
+MI_HOST_DEVICE_INLINE void Pixel_converter<PT_COLOR,PT_RGBA>::convert(
+    const Source_base_type* const source, Dest_base_type* const dest, const mi::Size count)
+{
+    convert_float32_to_uint8(
+        source, dest, count * Pixel_type_traits<PT_COLOR>::s_components_per_pixel);
+}
 
-    const Source_base_type* __restrict source3
-        = reinterpret_cast<const Source_base_type*>( source2);
-    Dest_base_type* __restrict dest3
-        = reinterpret_cast<Dest_base_type*>( dest2);
+// ---------- source PT_RGB_FP, target PT_RGB_16 ---------------------------------------------------
 
-    for( ; i < count; ++i) {
-        convert( source3, dest3);
-        source3 += Pixel_type_traits<PT_COLOR>::s_components_per_pixel;
-        dest3   += Pixel_type_traits<PT_RGBA>::s_components_per_pixel;
-    }
+template <>
+MI_HOST_DEVICE_INLINE void Pixel_converter<PT_RGB_FP,PT_RGB_16>::convert(
+    const Source_base_type* const source, Dest_base_type* const dest, const mi::Size count)
+{
+    convert_float32_to_uint16(
+        source, dest, count * Pixel_type_traits<PT_RGB_FP>::s_components_per_pixel);
+}
+
+// ---------- source PT_COLOR, target PT_RGBA_16 ---------------------------------------------------
+
+template <>
+MI_HOST_DEVICE_INLINE void Pixel_converter<PT_COLOR,PT_RGBA_16>::convert(
+    const Source_base_type* const source, Dest_base_type* const dest, const mi::Size count)
+{
+    convert_float32_to_uint16(
+        source, dest, count * Pixel_type_traits<PT_COLOR>::s_components_per_pixel);
 }
 
 #endif
@@ -44,6 +44,12 @@
 #include <base/hal/disk/disk_memory_reader_writer_impl.h>
 #include <base/hal/hal/i_hal_ospath.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <thread>
+
 namespace MI {
 
 namespace IMAGE {
@@ -58,6 +64,473 @@ std::string get_selector_string( const char* selector)
     return std::string( "selector \"") + selector + '\"';
 }
 
+/// Layers of file-based canvases larger than this number of bytes are paged in on demand if the
+/// image plugin supports region reads, see Canvas_impl::set_paged_tile_threshold().
+std::atomic<mi::Size> g_paged_tile_threshold( 64 * 1024 * 1024);
+
+/// Width and height of the blocks in which layers are paged in.
+const mi::Uint32 paged_tile_block_size = 256;
+
+/// Opens a reader for a file-based or container-based image.
+///
+/// Either \p filename or \p container_filename and \p member_filename need to be set.
+mi::neuraylib::IReader* get_reader(
+    const std::string& filename,
+    const std::string& container_filename,
+    const std::string& member_filename,
+    std::string& log_identifier)
+{
+    log_identifier.clear();
+
+    // file-based
+    if( !filename.empty()) {
+
+        log_identifier = filename;
+
+        mi::base::Handle<DISK::File_reader_impl> reader( new DISK::File_reader_impl);
+        if( !reader->open( filename.c_str())) {
+            LOG::mod_log->error( M_IMAGE, LOG::Mod_log::C_IO,
+                 "Failed to open image file \"%s\".", log_identifier.c_str());
+            return nullptr;
+        }
+
+        reader->retain();
+        return reader.get();
+
+    }
+
+    // container-based
+    if( !container_filename.empty() && !member_filename.empty()) {
+
+        log_identifier = container_filename + "\" in \"" + member_filename;
+
+        SYSTEM::Access_module<Image_module> image_module( false);
+        mi::base::Handle<IMdl_container_callback> callback(
+            image_module->get_mdl_container_callback());
+        mi::base::Handle<mi::neuraylib::IReader> reader(
+            callback->get_reader( container_filename.c_str(), member_filename.c_str()));
+        if( !reader) {
+            LOG::mod_log->error( M_IMAGE, LOG::Mod_log::C_IO,
+                 "Failed to open image file \"%s\".", log_identifier.c_str());
+            return nullptr;
+        }
+
+        reader->retain();
+        return reader.get();
+    }
+
+    ASSERT( M_IMAGE, false);
+    return nullptr;
+}
+
+/// Opens a file-based or container-based image for reading.
+///
+/// \param filename                    The file name of file-based images.
+/// \param container_filename          The container file name of container-based images.
+/// \param member_filename             The member file name of container-based images.
+/// \param selector                    The selector, or empty.
+/// \param[out] log_identifier         Identifies the image in log messages.
+/// \param[out] plugin                 The plugin that handles the image.
+/// \param[out] plugin_applies_selector Indicates whether the plugin applies the selector itself.
+/// \return                            The image file, or \c nullptr in case of failures.
+mi::neuraylib::IImage_file* open_image_file(
+    const std::string& filename,
+    const std::string& container_filename,
+    const std::string& member_filename,
+    const std::string& selector,
+    std::string& log_identifier,
+    mi::neuraylib::IImage_plugin*& plugin,
+    bool& plugin_applies_selector)
+{
+    mi::base::Handle<mi::neuraylib::IReader> reader(
+        get_reader( filename, container_filename, member_filename, log_identifier));
+    if( !reader)
+        return nullptr;
+
+    std::string extension = HAL::Ospath::get_ext( !filename.empty() ? filename : member_filename);
+    if( !extension.empty() && extension[0] == '.' )
+        extension = extension.substr( 1);
+
+    SYSTEM::Access_module<Image_module> image_module( false);
+    plugin = image_module->find_plugin_for_import( extension.c_str(), reader.get());
+    if( !plugin) {
+        LOG::mod_log->error( M_IMAGE, LOG::Mod_log::C_IO,
+            "No image plugin found to handle \"%s\".", log_identifier.c_str());
+        return nullptr;
+    }
+
+    plugin_applies_selector = plugin->supports_selectors();
+    const char* plugin_selector
+        = plugin_applies_selector && !selector.empty() ? selector.c_str() : nullptr;
+    mi::neuraylib::IImage_file* image_file
+        = plugin->open_for_reading( reader.get(), plugin_selector);
+    if( !image_file) {
+        LOG::mod_log->error( M_IMAGE, LOG::Mod_log::C_IO,
+            "The image plugin \"%s\" failed to import \"%s\".",
+            plugin->get_name(), log_identifier.c_str());
+        return nullptr;
+    }
+
+    return image_file;
+}
+
+/// A tile that represents one layer of an image file and reads fixed-size blocks of it on demand.
+///
+/// get_pixel() reads the block containing the pixel via IImage_file_region_reader::read_region()
+/// on first access. For images that are not tiled, entire bands of full-width rows are read at
+/// once, such that each row is decoded only once. The image file is opened for each read and not
+/// kept open in between.
+///
+/// get_data() and set_pixel() need the entire layer in contiguous memory, they read it once via
+/// IImage_file::read() and release the blocks afterwards.
+class Paged_tile final
+  : public mi::base::Interface_implement<ITile>,
+    public boost::noncopyable
+{
+public:
+    /// Constructor.
+    ///
+    /// \param filename             The file name of file-based images.
+    /// \param container_filename   The container file name of container-based images.
+    /// \param member_filename      The member file name of container-based images.
+    /// \param selector             The selector, or empty.
+    /// \param plugin_applies_selector Indicates whether the plugin applies the selector itself.
+    /// \param pixel_type           The pixel type of the tile (after applying the selector).
+    /// \param width                The width of the tile.
+    /// \param height               The height of the tile.
+    /// \param z                    The layer of the image file.
+    /// \param miplevel             The miplevel of the image file.
+    /// \param tiled                Indicates whether the image file stores the layer in tiles.
+    /// \param log_identifier       Identifies the image in log messages.
+    Paged_tile(
+        const std::string& filename,
+        const std::string& container_filename,
+        const std::string& member_filename,
+        const std::string& selector,
+        bool plugin_applies_selector,
+        Pixel_type pixel_type,
+        mi::Uint32 width,
+        mi::Uint32 height,
+        mi::Uint32 z,
+        mi::Uint32 miplevel,
+        bool tiled,
+        const std::string& log_identifier)
+      : m_filename( filename),
+        m_container_filename( container_filename),
+        m_member_filename( member_filename),
+        m_selector( selector),
+        m_plugin_applies_selector( plugin_applies_selector),
+        m_pixel_type( pixel_type),
+        m_width( width),
+        m_height( height),
+        m_z( z),
+        m_miplevel( miplevel),
+        m_tiled( tiled),
+        m_log_identifier( log_identifier),
+        m_blocks_x( (width + paged_tile_block_size - 1) / paged_tile_block_size),
+        m_blocks_y( (height + paged_tile_block_size - 1) / paged_tile_block_size),
+        m_blocks( new std::atomic<mi::neuraylib::ITile*>[m_blocks_x * m_blocks_y]),
+        m_full( nullptr),
+        m_block_readers( 0)
+    {
+        for( mi::Size i = 0, n = m_blocks_x * m_blocks_y; i < n; ++i)
+            m_blocks[i] = nullptr;
+    }
+
+    ~Paged_tile()
+    {
+        release_blocks();
+        if( m_full)
+            m_full.load()->release();
+    }
+
+    // methods of mi::neuraylib::ITile
+
+    void set_pixel( mi::Uint32 x_offset, mi::Uint32 y_offset, const mi::Float32* floats)
+    {
+        get_full()->set_pixel( x_offset, y_offset, floats);
+    }
+
+    void get_pixel( mi::Uint32 x_offset, mi::Uint32 y_offset, mi::Float32* floats) const
+    {
+        if( mi::neuraylib::ITile* full = m_full.load( std::memory_order_acquire)) {
+            full->get_pixel( x_offset, y_offset, floats);
+            return;
+        }
+
+        // Announce the use of the blocks, such that get_full() does not release them concurrently.
+        // The entire layer needs to be checked again afterwards, see get_full().
+        m_block_readers.fetch_add( 1);
+
+        const mi::Uint32 bx = x_offset / paged_tile_block_size;
+        const mi::Uint32 by = y_offset / paged_tile_block_size;
+        mi::neuraylib::ITile* b = m_full.load() ? nullptr : get_block( bx, by);
+        if( b)
+            b->get_pixel(
+                x_offset - bx * paged_tile_block_size,
+                y_offset - by * paged_tile_block_size,
+                floats);
+        else
+            m_full.load()->get_pixel( x_offset, y_offset, floats);
+
+        m_block_readers.fetch_sub( 1);
+    }
+
+    const char* get_type() const { return convert_pixel_type_enum_to_string( m_pixel_type); }
+
+    mi::Uint32 get_resolution_x() const { return m_width; }
+
+    mi::Uint32 get_resolution_y() const { return m_height; }
+
+    const void* get_data() const { return get_full()->get_data(); }
+
+    void* get_data() { return get_full()->get_data(); }
+
+    // methods of IMAGE::ITile
+
+    mi::Size get_size() const
+    {
+        mi::Size size = sizeof( *this)
+            + m_blocks_x * m_blocks_y * sizeof( std::atomic<mi::neuraylib::ITile*>);
+
+        mi::base::Lock::Block block( &m_lock);
+        for( mi::Size i = 0, n = m_blocks_x * m_blocks_y; i < n; ++i)
+            if( mi::neuraylib::ITile* b = m_blocks[i].load( std::memory_order_relaxed))
+                size += get_tile_size( b);
+        if( mi::neuraylib::ITile* full = m_full.load( std::memory_order_relaxed))
+            size += get_tile_size( full);
+        return size;
+    }
+
+    /// Reads the block at (0,0), or the first band for images that are not tiled, from an image
+    /// file that is already open.
+    ///
+    /// Used to test whether region reads work for the image file. Does not log errors.
+    ///
+    /// \return   \c true in case of success, \c false otherwise.
+    bool read_first_blocks( const mi::neuraylib::IImage_file_region_reader* region_reader)
+    {
+        mi::base::Lock::Block block( &m_lock);
+        return read_blocks( region_reader, 0, 0);
+    }
+
+private:
+    /// Returns the block (bx,by), reads it if necessary.
+    ///
+    /// Returns \c nullptr if the entire layer is available in the meantime.
+    mi::neuraylib::ITile* get_block( mi::Uint32 bx, mi::Uint32 by) const
+    {
+        std::atomic<mi::neuraylib::ITile*>& slot = m_blocks[by * m_blocks_x + bx];
+        if( mi::neuraylib::ITile* b = slot.load( std::memory_order_acquire))
+            return b;
+
+        // The image file is not thread-safe, serialize the reads.
+        mi::base::Lock::Block block( &m_lock);
+        if( mi::neuraylib::ITile* b = slot.load( std::memory_order_relaxed))
+            return b;
+        if( m_full.load())
+            return nullptr;
+
+        std::string log_identifier;
+        mi::neuraylib::IImage_plugin* plugin = nullptr;
+        bool plugin_applies_selector = false;
+        mi::base::Handle<mi::neuraylib::IImage_file> image_file( open_image_file(
+            m_filename,
+            m_container_filename,
+            m_member_filename,
+            m_selector,
+            log_identifier,
+            plugin,
+            plugin_applies_selector));
+        mi::base::Handle<const mi::neuraylib::IImage_file_region_reader> region_reader(
+            image_file ? image_file->get_interface<mi::neuraylib::IImage_file_region_reader>()
+                       : nullptr);
+
+        if(    !region_reader
+            || plugin_applies_selector != m_plugin_applies_selector
+            || !read_blocks( region_reader.get(), bx, by)) {
+            LOG::mod_log->error( M_IMAGE, LOG::Mod_log::C_IO,
+                "Failed to read region at (%u,%u) of \"%s\".",
+                bx * paged_tile_block_size, by * paged_tile_block_size, m_log_identifier.c_str());
+            slot.store( create_tile( m_pixel_type,
+                    std::min( paged_tile_block_size, m_width  - bx * paged_tile_block_size),
+                    std::min( paged_tile_block_size, m_height - by * paged_tile_block_size)),
+                std::memory_order_release);
+        }
+
+        return slot.load( std::memory_order_relaxed);
+    }
+
+    /// Reads the block (bx,by), or the band of blocks in row \p by for images that are not tiled.
+    ///
+    /// Needs to be called with \c m_lock held. Blocks that are already present are kept.
+    ///
+    /// \return   \c true in case of success, \c false otherwise.
+    bool read_blocks(
+        const mi::neuraylib::IImage_file_region_reader* region_reader,
+        mi::Uint32 bx,
+        mi::Uint32 by) const
+    {
+        const mi::Uint32 x = m_tiled ? bx * paged_tile_block_size : 0;
+        const mi::Uint32 y = by * paged_tile_block_size;
+        const mi::Uint32 width  = m_tiled ? std::min( paged_tile_block_size, m_width - x) : m_width;
+        const mi::Uint32 height = std::min( paged_tile_block_size, m_height - y);
+
+        mi::base::Handle<mi::neuraylib::ITile> tile(
+            region_reader->read_region( x, y, width, height, m_z, m_miplevel));
+        if( tile && !m_plugin_applies_selector && !m_selector.empty()) {
+            SYSTEM::Access_module<Image_module> image_module( false);
+            tile = image_module->extract_channel( tile.get(), m_selector.c_str());
+        }
+
+        if(    !tile
+            || convert_pixel_type_string_to_enum( tile->get_type()) != m_pixel_type
+            || tile->get_resolution_x() != width
+            || tile->get_resolution_y() != height)
+            return false;
+
+        if( m_tiled) {
+            std::atomic<mi::neuraylib::ITile*>& slot = m_blocks[by * m_blocks_x + bx];
+            if( !slot.load( std::memory_order_relaxed)) {
+                tile->retain();
+                slot.store( tile.get(), std::memory_order_release);
+            }
+            return true;
+        }
+
+        // Split the band into blocks.
+        const mi::Size bytes_per_pixel = get_bytes_per_pixel( m_pixel_type);
+        const mi::Uint8* src = static_cast<const mi::Uint8*>( tile->get_data());
+        for( mi::Uint32 i = 0; i < m_blocks_x; ++i) {
+            std::atomic<mi::neuraylib::ITile*>& slot = m_blocks[by * m_blocks_x + i];
+            if( slot.load( std::memory_order_relaxed))
+                continue;
+
+            const mi::Uint32 block_x = i * paged_tile_block_size;
+            const mi::Uint32 block_width = std::min( paged_tile_block_size, m_width - block_x);
+            mi::neuraylib::ITile* b = create_tile( m_pixel_type, block_width, height);
+            mi::Uint8* dst = static_cast<mi::Uint8*>( b->get_data());
+            const mi::Size row_size = block_width * bytes_per_pixel;
+            for( mi::Uint32 row = 0; row < height; ++row)
+                memcpy( dst + row * row_size,
+                        src + (static_cast<mi::Size>( row) * m_width + block_x) * bytes_per_pixel,
+                        row_size);
+            slot.store( b, std::memory_order_release);
+        }
+        return true;
+    }
+
+    /// Returns the entire layer in contiguous memory, reads it if necessary.
+    mi::neuraylib::ITile* get_full() const
+    {
+        if( mi::neuraylib::ITile* full = m_full.load( std::memory_order_acquire))
+            return full;
+
+        mi::neuraylib::ITile* full = nullptr;
+        {
+            mi::base::Lock::Block block( &m_lock);
+            full = m_full.load( std::memory_order_relaxed);
+            if( full)
+                return full;
+
+            full = read_full();
+            m_full.store( full);
+        }
+
+        // Release the blocks once no get_pixel() call uses them anymore. New calls use the entire
+        // layer.
+        while( m_block_readers.load() > 0)
+            std::this_thread::yield();
+
+        mi::base::Lock::Block block( &m_lock);
+        release_blocks();
+        return full;
+    }
+
+    /// Reads the entire layer, or returns a black tile in case of failures.
+    mi::neuraylib::ITile* read_full() const
+    {
+        std::string log_identifier;
+        mi::neuraylib::IImage_plugin* plugin = nullptr;
+        bool plugin_applies_selector = false;
+        mi::base::Handle<mi::neuraylib::IImage_file> image_file( open_image_file(
+            m_filename,
+            m_container_filename,
+            m_member_filename,
+            m_selector,
+            log_identifier,
+            plugin,
+            plugin_applies_selector));
+
+        mi::base::Handle<mi::neuraylib::ITile> tile(
+            image_file ? image_file->read( m_z, m_miplevel) : nullptr);
+        if( tile && !plugin_applies_selector && !m_selector.empty()) {
+            SYSTEM::Access_module<Image_module> image_module( false);
+            tile = image_module->extract_channel( tile.get(), m_selector.c_str());
+        }
+
+        if(    !tile
+            || convert_pixel_type_string_to_enum( tile->get_type()) != m_pixel_type
+            || tile->get_resolution_x() != m_width
+            || tile->get_resolution_y() != m_height) {
+            LOG::mod_log->error( M_IMAGE, LOG::Mod_log::C_IO,
+                "Failed to read \"%s\".", m_log_identifier.c_str());
+            return create_tile( m_pixel_type, m_width, m_height);
+        }
+
+        tile->retain();
+        return tile.get();
+    }
+
+    /// Releases all blocks.
+    void release_blocks() const
+    {
+        for( mi::Size i = 0, n = m_blocks_x * m_blocks_y; i < n; ++i)
+            if( mi::neuraylib::ITile* b = m_blocks[i].exchange( nullptr))
+                b->release();
+    }
+
+    /// Returns the memory used by a tile.
+    mi::Size get_tile_size( const mi::neuraylib::ITile* tile) const
+    {
+        mi::base::Handle<const ITile> tile_internal( tile->get_interface<ITile>());
+        if( tile_internal)
+            return tile_internal->get_size();
+        return   static_cast<mi::Size>( tile->get_resolution_x())
+               * tile->get_resolution_y()
+               * get_bytes_per_pixel( m_pixel_type);
+    }
+
+    std::string m_filename;
+    std::string m_container_filename;
+    std::string m_member_filename;
+    std::string m_selector;
+    bool m_plugin_applies_selector;
+    Pixel_type m_pixel_type;
+    mi::Uint32 m_width;
+    mi::Uint32 m_height;
+    mi::Uint32 m_z;
+    mi::Uint32 m_miplevel;
+    bool m_tiled;
+    std::string m_log_identifier;
+
+    /// Number of blocks in x and y direction.
+    mi::Uint32 m_blocks_x;
+    mi::Uint32 m_blocks_y;
+
+    /// The blocks (retained, or \c NULL if not yet read or already released), row by row.
+    std::unique_ptr<std::atomic<mi::neuraylib::ITile*>[]> m_blocks;
+
+    /// The entire layer (retained, or \c NULL if not yet read).
+    mutable std::atomic<mi::neuraylib::ITile*> m_full;
+
+    /// The number of get_pixel() calls that might access the blocks.
+    mutable std::atomic<mi::Uint32> m_block_readers;
+
+    /// The lock for reading blocks and the entire layer.
+    mutable mi::base::Lock m_lock;
+};
+
 } // namespace
 
 Canvas_impl::Canvas_impl(
@@ -717,6 +1190,8 @@ mi::neuraylib::ITile* Canvas_impl::get_tile( mi::Uint32 layer)
 
     mi::base::Lock::Block block( &m_lock);
 
+    m_tiles_modified = true;
+
     if( m_tiles[layer] == nullptr) {
 
         ASSERT( M_IMAGE, supports_lazy_loading());
@@ -740,16 +1215,8 @@ mi::Size Canvas_impl::get_size() const
 
     size += m_nr_of_layers * sizeof( mi::base::Handle<mi::neuraylib::ITile>); // m_tiles
 
-    for( mi::Uint32 i = 0; i < m_nr_of_layers; ++i)          // m_tiles[i]
-        if( m_tiles[i]) {
-            mi::base::Handle<ITile> tile_internal( m_tiles[i]->get_interface<ITile>());
-            if( tile_internal)         // exact memory usage
-                size += tile_internal->get_size();
-            else                                            // approximate memory usage
-                size +=   static_cast<size_t>( m_width)
-                        * static_cast<size_t>( m_height)
-                        * get_bytes_per_pixel( m_pixel_type);
-        }
+    mi::base::Lock::Block block( &m_lock);
+    size += get_tiles_size();                                                 // m_tiles[i]
 
     return size;
 }
@@ -766,6 +1233,55 @@ bool Canvas_impl::release_tiles() const
     return true;
 }
 
+mi::Size Canvas_impl::release_memory() const
+{
+    if( !supports_lazy_loading())
+        return 0;
+
+    // Do not wait for a concurrent (lazy) load of the tiles.
+    mi::base::Lock::Block block;
+    if( !block.try_set( &m_lock))
+        return 0;
+
+    if( m_tiles_modified)
+        return 0;
+
+    // Release all tiles or none (get_tile() loads all tiles at once). Tiles that are referenced
+    // from elsewhere are still in use. Since new references can only be obtained while holding
+    // m_lock, the reference count can not increase concurrently.
+    for( mi::Uint32 z = 0; z < m_nr_of_layers; ++z) {
+        if( !m_tiles[z])
+            continue;
+        m_tiles[z]->retain();
+        if( m_tiles[z]->release() > 1)
+            return 0;
+    }
+
+    const mi::Size size = get_tiles_size();
+    for( mi::Uint32 z = 0; z < m_nr_of_layers; ++z)
+        m_tiles[z] = nullptr;
+
+    return size;
+}
+
+mi::Size Canvas_impl::get_tiles_size() const
+{
+    mi::Size size = 0;
+
+    for( mi::Uint32 i = 0; i < m_nr_of_layers; ++i)
+        if( m_tiles[i]) {
+            mi::base::Handle<ITile> tile_internal( m_tiles[i]->get_interface<ITile>());
+            if( tile_internal)         // exact memory usage
+                size += tile_internal->get_size();
+            else                                            // approximate memory usage
+                size +=   static_cast<size_t>( m_width)
+                        * static_cast<size_t>( m_height)
+                        * get_bytes_per_pixel( m_pixel_type);
+        }
+
+    return size;
+}
+
 bool Canvas_impl::supports_lazy_loading() const
 {
     // either both m_container_filename or m_member_filename are set or none
@@ -796,34 +1312,46 @@ mi::neuraylib::ITile* Canvas_impl::do_load_tile( mi::Uint32 z) const
     ASSERT( M_IMAGE, supports_lazy_loading());
 
     std::string log_identifier;
-    mi::base::Handle<mi::neuraylib::IReader> reader( get_reader( log_identifier));
-    if( !reader)
+    mi::neuraylib::IImage_plugin* plugin = nullptr;
+    bool plugin_supports_selectors = false;
+    mi::base::Handle<mi::neuraylib::IImage_file> image_file( open_image_file(
+        m_filename,
+        m_container_filename,
+        m_member_filename,
+        m_selector,
+        log_identifier,
+        plugin,
+        plugin_supports_selectors));
+    if( !image_file)
         return nullptr;
 
-    std::string extension
-        = HAL::Ospath::get_ext( !m_filename.empty() ? m_filename : m_member_filename);
-    if( !extension.empty() && extension[0] == '.' )
-        extension = extension.substr( 1);
-
     SYSTEM::Access_module<Image_module> image_module( false);
-    mi::neuraylib::IImage_plugin* plugin
-        = image_module->find_plugin_for_import( extension.c_str(), reader.get());
-    if( !plugin) {
-        LOG::mod_log->error( M_IMAGE, LOG::Mod_log::C_IO,
-            "No image plugin found to handle \"%s\".", log_identifier.c_str());
-        return nullptr;
-    }
 
-    bool plugin_supports_selectors = plugin->supports_selectors();
-    const char* plugin_selector
-        = plugin_supports_selectors && !m_selector.empty() ? m_selector.c_str() : nullptr;
-    mi::base::Handle<mi::neuraylib::IImage_file> image_file(
-        plugin->open_for_reading( reader.get(), plugin_selector));
-    if( !image_file) {
-        LOG::mod_log->error( M_IMAGE, LOG::Mod_log::C_IO,
-            "The image plugin \"%s\" failed to import \"%s\".",
-            plugin->get_name(), log_identifier.c_str());
-        return nullptr;
+    // Page in large layers on demand if the plugin supports region reads.
+    const mi::Size layer_size = static_cast<mi::Size>( m_width) * m_height
+        * get_bytes_per_pixel( m_pixel_type);
+    mi::base::Handle<const mi::neuraylib::IImage_file_region_reader> region_reader(
+        image_file->get_interface<mi::neuraylib::IImage_file_region_reader>());
+    if( region_reader && layer_size > g_paged_tile_threshold) {
+        mi::base::Handle<Paged_tile> paged_tile( new Paged_tile(
+            m_filename,
+            m_container_filename,
+            m_member_filename,
+            m_selector,
+            plugin_supports_selectors,
+            m_pixel_type,
+            m_width,
+            m_height,
+            z,
+            m_miplevel,
+            region_reader->is_tiled( z, m_miplevel),
+            log_identifier));
+        // Read the first blocks to test whether region reads work for this image (checks pixel
+        // type and resolution). The image file is not kept open.
+        if( paged_tile->read_first_blocks( region_reader.get())) {
+            paged_tile->retain();
+            return paged_tile.get();
+        }
     }
 
     mi::base::Handle<mi::neuraylib::ITile> tile( image_file->read( z, m_miplevel));
@@ -884,51 +1412,9 @@ mi::neuraylib::ITile* Canvas_impl::do_load_tile( mi::Uint32 z) const
     return tile.get();
 }
 
-mi::neuraylib::IReader* Canvas_impl::get_reader( std::string& log_identifier) const
+void Canvas_impl::set_paged_tile_threshold( mi::Size threshold)
 {
-    ASSERT( M_IMAGE, supports_lazy_loading());
-
-    log_identifier.clear();
-
-    // file-based
-    if( !m_filename.empty()) {
-
-        log_identifier = m_filename;
-
-        mi::base::Handle<DISK::File_reader_impl> reader( new DISK::File_reader_impl);
-        if( !reader->open( m_filename.c_str())) {
-            LOG::mod_log->error( M_IMAGE, LOG::Mod_log::C_IO,
-                 "Failed to open image file \"%s\".", log_identifier.c_str());
-            return nullptr;
-        }
-
-        reader->retain();
-        return reader.get();
-
-    }
-
-    // container-based
-    if( !m_container_filename.empty() && !m_member_filename.empty()) {
-
-        log_identifier = m_container_filename + "\" in \"" + m_member_filename;
-
-        SYSTEM::Access_module<Image_module> image_module( false);
-        mi::base::Handle<IMdl_container_callback> callback(
-            image_module->get_mdl_container_callback());
-        mi::base::Handle<mi::neuraylib::IReader> reader(
-            callback->get_reader( m_container_filename.c_str(), m_member_filename.c_str()));
-        if( !reader) {
-            LOG::mod_log->error( M_IMAGE, LOG::Mod_log::C_IO,
-                 "Failed to open image file \"%s\".", log_identifier.c_str());
-            return nullptr;
-        }
-
-        reader->retain();
-        return reader.get();
-    }
-
-    ASSERT( M_IMAGE, false);
-    return nullptr;
+    g_paged_tile_threshold = threshold;
 }
 
 void Canvas_impl::set_default_pink_dummy_canvas()
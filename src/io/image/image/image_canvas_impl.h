@@ -69,6 +69,16 @@ public:
     /// \return   \c true on success, \c false, if the canvas does not support lazy loading and
     ///           therefore cannot simply free its data.
     virtual bool release_tiles() const = 0;
+
+    /// Releases tile memory that is not in use and can be reloaded lazily.
+    ///
+    /// In contrast to #release_tiles(), tiles are only released if they are not referenced from
+    /// elsewhere and have not been handed out via the mutable variant of #get_tile().
+    ///
+    /// Used to implement DB::Element_base::release_memory() for DBIMAGE::Image.
+    ///
+    /// \return   The number of bytes released.
+    virtual mi::Size release_memory() const = 0;
 };
 
 /// A simple implementation of the ICanvas interface.
@@ -78,8 +88,12 @@ public:
 /// pixel type, width, height, etc.). File-based or container-based canvases load the tile data
 /// lazily when needed. Memory-based canvases create all tiles right in the constructor.
 ///
-/// File-based or container-based canvases could flush unused tiles if memory gets tight (not yet
-/// implemented).
+/// File-based or container-based canvases flush unused tiles if memory gets tight, see
+/// #release_memory().
+///
+/// Large layers of file-based or container-based canvases are paged in on demand in fixed-size
+/// blocks if the image file supports IImage_file_region_reader. Pixel lookups read only the
+/// blocks they touch, access to the entire pixel data reads the layer once.
 class Canvas_impl final // constructor invokes virtual method calls
   : public mi::base::Interface_implement<ICanvas>,
     public boost::noncopyable
@@ -293,6 +307,15 @@ public:
 
     bool release_tiles() const;
 
+    mi::Size release_memory() const;
+
+    // internal methods
+
+    /// Sets the size of layers in bytes above which layers are paged in on demand.
+    ///
+    /// Defaults to 64 MiB. Affects only canvases loaded afterwards. Used by unit tests.
+    static void set_paged_tile_threshold( mi::Size threshold);
+
 private:
     /// See constructors #Canvas_impl(File_based,...),
     void do_init(
@@ -349,8 +372,10 @@ private:
     /// \note The caller needs to hold the lock m_lock.
      mi::neuraylib::ITile* do_load_tile( mi::Uint32 z) const;
 
-    /// Returns the reader used by #load_tile();
-    mi::neuraylib::IReader* get_reader( std::string& log_identifier) const;
+    /// Returns the memory used by the tiles in bytes.
+    ///
+    /// \note The caller needs to hold the lock m_lock.
+    mi::Size get_tiles_size() const;
 
     /// Sets the canvas to a dummy canvas with a 1x1 tile with a pink pixel.
     void set_default_pink_dummy_canvas();
@@ -381,6 +406,13 @@ private:
     /// The lock that protects m_tiles;
     mutable mi::base::Lock m_lock;
 
+    /// Indicates whether tiles have been handed out via the mutable variant of #get_tile().
+    ///
+    /// Such tiles might have been modified and are never released by #release_memory().
+    ///
+    /// \note Any access needs to be protected by m_lock.
+    bool m_tiles_modified = false;
+
     /// The file used to load this canvas.
     ///
     /// Non-empty for file-based canvases, empty for memory-based canvases (including containers).
@@ -51,6 +51,23 @@ namespace MI {
 
 namespace IMAGE {
 
+namespace {
+
+/// Returns the memory used by a canvas in bytes.
+mi::Size get_canvas_size( const mi::neuraylib::ICanvas* canvas)
+{
+    mi::base::Handle<const ICanvas> canvas_internal( canvas->get_interface<ICanvas>());
+    if( canvas_internal)                                         // exact memory usage
+        return canvas_internal->get_size();
+
+    const mi::Size width  = canvas->get_resolution_x();        // approximate memory usage
+    const mi::Size height = canvas->get_resolution_y();
+    const Pixel_type pixel_type = convert_pixel_type_string_to_enum( canvas->get_type());
+    return width * height * get_bytes_per_pixel( pixel_type);
+}
+
+} // namespace
+
 Mipmap_impl::Mipmap_impl()
 {
     m_nr_of_levels = 1;
@@ -439,6 +456,7 @@ mi::neuraylib::ICanvas* Mipmap_impl::get_level( mi::Uint32 level) //-V659 PVS
     for( mi::Uint32 i = first_level_to_destroy; i <= m_last_created_level; ++i)
         m_levels[i] = nullptr;
     m_last_created_level = first_level_to_destroy - 1;
+    m_nr_of_kept_levels = level+1;
 
     ASSERT( M_IMAGE, m_last_created_level >= level);
     ASSERT( M_IMAGE, m_levels[level]);
@@ -454,17 +472,41 @@ mi::Size Mipmap_impl::get_size() const
 
     size += m_nr_of_levels * sizeof( mi::neuraylib::ICanvas*);   // m_levels
 
-    for( mi::Uint32 i = 0; i <= m_last_created_level; ++i) {     // m_level[i]
-        mi::base::Handle<ICanvas> canvas_internal( m_levels[i]->get_interface<ICanvas>());
-        if( canvas_internal)                // exact memory usage
-            size += canvas_internal->get_size();
-        else  {                                                  // approximate memory usage
-            const mi::Size width  = m_levels[i]->get_resolution_x();
-            const mi::Size height = m_levels[i]->get_resolution_y();
-            const Pixel_type pixel_type
-                = convert_pixel_type_string_to_enum( m_levels[i]->get_type());
-            size += width * height * get_bytes_per_pixel( pixel_type);
-        }
+    for( mi::Uint32 i = 0; i <= m_last_created_level; ++i)       // m_level[i]
+        size += get_canvas_size( m_levels[i].get());
+
+    return size;
+}
+
+mi::Size Mipmap_impl::release_memory() const
+{
+    // Do not wait for a concurrent computation of miplevels.
+    mi::base::Lock::Block block;
+    if( !block.try_set( &m_lock))
+        return 0;
+
+    mi::Size size = 0;
+
+    // Release computed miplevels from the top as long as they are not referenced from elsewhere.
+    // Since new references can only be obtained while holding m_lock, the reference count can not
+    // increase concurrently.
+    const mi::Uint32 first_level_to_release
+        = std::max( std::max( m_nr_of_provided_levels, m_nr_of_kept_levels), 1u);
+    while( m_last_created_level >= first_level_to_release) {
+        mi::neuraylib::ICanvas* canvas = m_levels[m_last_created_level].get();
+        canvas->retain();
+        if( canvas->release() > 1)
+            break;
+        size += get_canvas_size( canvas);
+        m_levels[m_last_created_level] = nullptr;
+        --m_last_created_level;
+    }
+
+    // Release unused tiles of the provided miplevels.
+    for( mi::Uint32 i = 0; i < m_nr_of_provided_levels; ++i) {
+        mi::base::Handle<const ICanvas> canvas_internal( m_levels[i]->get_interface<ICanvas>());
+        if( canvas_internal)
+            size += canvas_internal->release_memory();
     }
 
     return size;
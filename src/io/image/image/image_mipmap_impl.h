@@ -58,8 +58,8 @@ namespace IMAGE {
 /// Construction for higher-level mipmaps is done lazily, but when a certain level is requested
 /// all tiles of it are computed (and hence all tiles from the previous level are needed).
 ///
-/// File-based or container-based mipmaps could flush unused tiles if memory gets tight (not yet
-/// implemented).
+/// If memory gets tight, computed miplevels and unused tiles of file-based or container-based
+/// miplevels can be flushed, see #release_memory().
 class Mipmap_impl
   : public mi::base::Interface_implement<IMipmap>,
     public boost::noncopyable
@@ -195,6 +195,8 @@ public:
 
     mi::Size get_size() const;
 
+    mi::Size release_memory() const;
+
 private:
 
     /// The number of miplevels of this mipmap.
@@ -225,6 +227,14 @@ private:
     /// \note Any access needs to be protected by m_lock.
     mutable std::vector<mi::base::Handle<mi::neuraylib::ICanvas> > m_levels;
 
+    /// The number of miplevels that are never released by #release_memory().
+    ///
+    /// Covers at least the miplevels handed out via the mutable variant of #get_level() since they
+    /// might have been modified (higher miplevels are destroyed by that method anyway).
+    ///
+    /// \note Any access needs to be protected by m_lock.
+    mi::Uint32 m_nr_of_kept_levels = 0;
+
     /// Flag for cubemaps.
     bool m_is_cubemap;
 };
@@ -35,21 +35,27 @@
 #include <mi/neuraylib/iplugin_api.h>
 #include <mi/math/color.h>
 
+#include <algorithm>
 #include <cstring>
 #include <iomanip>
 #include <limits>
+#include <memory>
 #include <sstream>
 #include <queue>
 
 #include <base/system/main/module_registration.h>
 #include <base/system/main/access_module.h>
+#include <base/lib/config/config.h>
 #include <base/lib/log/i_log_assert.h>
 #include <base/lib/log/i_log_logger.h>
 #include <base/lib/plug/i_plug.h>
+#include <base/util/registry/i_config_registry.h>
 #include <base/util/string_utils/i_string_utils.h>
 #include <base/hal/disk/disk_file_reader_writer_impl.h>
 #include <base/hal/disk/disk_memory_reader_writer_impl.h>
 #include <base/hal/hal/i_hal_ospath.h>
+#include <base/data/db/i_db_database.h>
+#include <base/data/db/i_db_fragmented_job.h>
 #include <base/data/serial/i_serializer.h>
 
 #include "i_image_pixel_conversion.h"
@@ -85,6 +91,11 @@ Module_registration_entry* Image_module::get_instance()
 
 bool Image_module_impl::init()
 {
+    SYSTEM::Access_module<CONFIG::Config_module> config_module( false);
+    const CONFIG::Config_registry& registry = config_module->get_configuration();
+    m_use_file_miplevels = false;
+    CONFIG::update_value( registry, "image_use_file_miplevels", m_use_file_miplevels);
+
     m_plug_module.set();
 
     mi::base::Handle<mi::neuraylib::IPlugin_api> plugin_api( m_plug_module->get_plugin_api());
@@ -1304,6 +1315,16 @@ IMdl_container_callback* Image_module_impl::get_mdl_container_callback() const
     return m_mdl_container_callback.get();
 }
 
+void Image_module_impl::set_database( DB::Database* database)
+{
+    m_database = database;
+}
+
+bool Image_module_impl::get_use_file_miplevels() const
+{
+    return m_use_file_miplevels;
+}
+
 void Image_module_impl::dump() const
 {
     mi::Size i = 0;
@@ -1552,14 +1573,335 @@ void apply_gamma(mi::math::Color& c, mi::Float32 gamma)
 #endif
 }
 
+/// Lookup tables for decoding and encoding 8-bit gamma-compressed data.
+///
+/// Decoding uses one table entry per 8-bit value. Encoding uses the 255 thresholds in linear space
+/// at which the quantized encoded value changes, which gives the same result as quantizing the
+/// result of pow(x, 1/gamma), without evaluating pow() per component.
+class Gamma_lut_8
+{
+public:
+    explicit Gamma_lut_8(mi::Float32 gamma)
+    {
+        for (mi::Uint32 i = 0; i < 256; ++i)
+            m_decode[i] = powf(mi::Float32(i) * mi::Float32(1.0/255.0), gamma);
+        // quantize_unsigned<Uint8>(y) returns k iff y >= k/256 (for k < 256)
+        for (mi::Uint32 k = 1; k < 256; ++k)
+            m_thresholds[k-1] = powf(mi::Float32(k) * mi::Float32(1.0/256.0), gamma);
+    }
+
+    mi::Float32 decode(mi::Uint8 value) const { return m_decode[value]; }
+
+    mi::Uint8 encode(mi::Float32 value) const
+    {
+        return mi::Uint8(
+            std::upper_bound(m_thresholds, m_thresholds + 255, value) - m_thresholds);
+    }
+
+private:
+    mi::Float32 m_decode[256];
+    mi::Float32 m_thresholds[255];
+};
+
+/// Converts a row of components into linear floating-point values.
+///
+/// \p lut is only used for 8-bit data and is \c nullptr if gamma is 1.0.
+void decode_row(
+    const mi::Uint8* __restrict src,
+    mi::Float32* __restrict dest,
+    mi::Size count,
+    mi::Float32 /*gamma*/,
+    const Gamma_lut_8* lut)
+{
+    if (lut)
+        for (mi::Size i = 0; i < count; ++i)
+            dest[i] = lut->decode(src[i]);
+    else
+        for (mi::Size i = 0; i < count; ++i)
+            dest[i] = mi::Float32(src[i]) * mi::Float32(1.0/255.0);
+}
+
+void decode_row(
+    const mi::Uint16* __restrict src,
+    mi::Float32* __restrict dest,
+    mi::Size count,
+    mi::Float32 gamma,
+    const Gamma_lut_8* /*lut*/)
+{
+    for (mi::Size i = 0; i < count; ++i)
+        dest[i] = mi::Float32(src[i]) * mi::Float32(1.0/65535.0);
+    if (gamma != 1.0f)
+        adjust_gamma(dest, count, 1, gamma);
+}
+
+void decode_row(
+    const mi::Float32* __restrict src,
+    mi::Float32* __restrict dest,
+    mi::Size count,
+    mi::Float32 gamma,
+    const Gamma_lut_8* /*lut*/)
+{
+    memcpy(dest, src, count * sizeof(mi::Float32));
+    if (gamma != 1.0f)
+        adjust_gamma(dest, count, 1, gamma);
+}
+
+/// Converts a row of linear floating-point values back into components.
+///
+/// \p src may be modified. \p lut is only used for 8-bit data and is \c nullptr if gamma is 1.0.
+void encode_row(
+    mi::Float32* __restrict src,
+    mi::Uint8* __restrict dest,
+    mi::Size count,
+    mi::Float32 /*inv_gamma*/,
+    const Gamma_lut_8* lut)
+{
+    if (lut)
+        for (mi::Size i = 0; i < count; ++i)
+            dest[i] = lut->encode(src[i]);
+    else
+        for (mi::Size i = 0; i < count; ++i)
+            quantize_u(dest[i], src[i]);
+}
+
+void encode_row(
+    mi::Float32* __restrict src,
+    mi::Uint16* __restrict dest,
+    mi::Size count,
+    mi::Float32 inv_gamma,
+    const Gamma_lut_8* /*lut*/)
+{
+    if (inv_gamma != 1.0f)
+        adjust_gamma(src, count, 1, inv_gamma);
+    for (mi::Size i = 0; i < count; ++i)
+        quantize_u(dest[i], src[i]);
+}
+
+void encode_row(
+    mi::Float32* __restrict src,
+    mi::Float32* __restrict dest,
+    mi::Size count,
+    mi::Float32 inv_gamma,
+    const Gamma_lut_8* /*lut*/)
+{
+    if (inv_gamma != 1.0f)
+        adjust_gamma(src, count, 1, inv_gamma);
+    memcpy(dest, src, count * sizeof(mi::Float32));
+}
+
+/// Averages 2x2 blocks of pixels from two linear rows into one row of \p width pixels.
+template <mi::Uint32 C>
+void reduce_2x2(
+    const mi::Float32* __restrict l0,
+    const mi::Float32* __restrict l1,
+    mi::Float32* __restrict r,
+    mi::Uint32 width)
+{
+    for (mi::Uint32 x = 0; x < width; ++x) {
+        const mi::Size i0 = mi::Size(2 * x) * C;
+        const mi::Size i1 = i0 + C;
+        for (mi::Uint32 c = 0; c < C; ++c)
+            r[x*C+c] = (l0[i0+c] + l0[i1+c] + l1[i0+c] + l1[i1+c]) * 0.25f;
+    }
+}
+
+#if defined(HAS_SSE) || defined(SSE_INTRINSICS)
+template <>
+void reduce_2x2<4>(
+    const mi::Float32* __restrict l0,
+    const mi::Float32* __restrict l1,
+    mi::Float32* __restrict r,
+    mi::Uint32 width)
+{
+    const __m128 quarter = _mm_set1_ps(0.25f);
+    for (mi::Uint32 x = 0; x < width; ++x) {
+        const __m128 a = _mm_add_ps(_mm_loadu_ps(l0 + 8*x), _mm_loadu_ps(l0 + 8*x + 4));
+        const __m128 b = _mm_add_ps(_mm_loadu_ps(l1 + 8*x), _mm_loadu_ps(l1 + 8*x + 4));
+        _mm_storeu_ps(r + 4*x, _mm_mul_ps(_mm_add_ps(a, b), quarter));
+    }
+}
+#endif
+
+/// Computes rows [y_begin, y_end) of a miplevel from the raw data of the previous miplevel using
+/// a 2x2 box filter in linear space.
+///
+/// \tparam T   The component type.
+/// \tparam C   The number of components per pixel.
+template <typename T, mi::Uint32 C>
+void reduce_rows(
+    const T* prev_data,
+    mi::Uint32 prev_width,
+    mi::Uint32 prev_height,
+    T* data,
+    mi::Uint32 width,
+    mi::Uint32 y_begin,
+    mi::Uint32 y_end,
+    mi::Float32 gamma,
+    const Gamma_lut_8* lut)
+{
+    const mi::Size prev_row = mi::Size(prev_width) * C;
+    const mi::Size row      = mi::Size(width) * C;
+    const mi::Float32 inv_gamma = 1.0f / gamma;
+
+    std::vector<mi::Float32> line0(prev_row);
+    std::vector<mi::Float32> line1(prev_row);
+    std::vector<mi::Float32> result(row);
+
+    for (mi::Uint32 y = y_begin; y < y_end; ++y) {
+
+        const mi::Uint32 prev_y0 = 2 * y;
+        const mi::Uint32 prev_y1 = std::min(2 * y + 1, prev_height - 1);
+
+        decode_row(prev_data + prev_y0 * prev_row, line0.data(), prev_row, gamma, lut);
+        decode_row(prev_data + prev_y1 * prev_row, line1.data(), prev_row, gamma, lut);
+
+        const mi::Float32* __restrict l0 = line0.data();
+        const mi::Float32* __restrict l1 = line1.data();
+        mi::Float32* __restrict r = result.data();
+
+        if (prev_width >= 2 && prev_y0 != prev_y1) {
+            // the common case, each destination pixel covers 2x2 source pixels
+            reduce_2x2<C>(l0, l1, r, width);
+        } else if (prev_width >= 2) {
+            for (mi::Uint32 x = 0; x < width; ++x)
+                for (mi::Uint32 c = 0; c < C; ++c)
+                    r[x*C+c] = (l0[2*x*C+c] + l0[(2*x+1)*C+c]) * 0.5f;
+        } else {
+            const mi::Float32 scale = prev_y0 != prev_y1 ? 0.5f : 1.0f;
+            for (mi::Uint32 c = 0; c < C; ++c)
+                r[c] = (prev_y0 != prev_y1 ? l0[c] + l1[c] : l0[c]) * scale;
+        }
+
+        encode_row(result.data(), data + y * row, row, inv_gamma, lut);
+    }
+}
+
+/// Computes a miplevel from the previous miplevel for a fixed pixel type.
+///
+/// Only a subset of the rows is computed, such that the work can be distributed over several
+/// fragments.
+class Miplevel_rows
+{
+public:
+    Miplevel_rows(
+        const mi::neuraylib::ITile* prev_tile,
+        mi::neuraylib::ITile* tile,
+        Pixel_type pixel_type,
+        mi::Float32 gamma,
+        const Gamma_lut_8* lut)
+      : m_prev_tile(prev_tile),
+        m_tile(tile),
+        m_pixel_type(pixel_type),
+        m_gamma(gamma),
+        m_lut(lut)
+    {
+    }
+
+    /// Indicates whether the pixel type is handled by #run(). Other pixel types need to use
+    /// the generic code based on ITile::get_pixel() and ITile::set_pixel().
+    static bool is_supported(Pixel_type pixel_type)
+    {
+        return pixel_type != PT_RGBE && pixel_type != PT_RGBEA && pixel_type != PT_UNDEF;
+    }
+
+    void run(mi::Uint32 y_begin, mi::Uint32 y_end) const
+    {
+        const mi::Uint32 prev_width  = m_prev_tile->get_resolution_x();
+        const mi::Uint32 prev_height = m_prev_tile->get_resolution_y();
+        const mi::Uint32 width       = m_tile->get_resolution_x();
+
+#define MI_IMAGE_REDUCE(T, C) \
+        reduce_rows<T, C>( \
+            static_cast<const T*>(m_prev_tile->get_data()), prev_width, prev_height, \
+            static_cast<T*>(m_tile->get_data()), width, y_begin, y_end, m_gamma, m_lut)
+
+        switch (m_pixel_type) {
+            case PT_SINT8:     MI_IMAGE_REDUCE(mi::Uint8,   1); break;
+            case PT_SINT32:    MI_IMAGE_REDUCE(mi::Uint8,   4); break; // treated as PT_RGBA
+            case PT_RGB:       MI_IMAGE_REDUCE(mi::Uint8,   3); break;
+            case PT_RGBA:      MI_IMAGE_REDUCE(mi::Uint8,   4); break;
+            case PT_RGB_16:    MI_IMAGE_REDUCE(mi::Uint16,  3); break;
+            case PT_RGBA_16:   MI_IMAGE_REDUCE(mi::Uint16,  4); break;
+            case PT_FLOAT32:   MI_IMAGE_REDUCE(mi::Float32, 1); break;
+            case PT_FLOAT32_2: MI_IMAGE_REDUCE(mi::Float32, 2); break;
+            case PT_FLOAT32_3:
+            case PT_RGB_FP:    MI_IMAGE_REDUCE(mi::Float32, 3); break;
+            case PT_FLOAT32_4:
+            case PT_COLOR:     MI_IMAGE_REDUCE(mi::Float32, 4); break;
+            default:           ASSERT(M_IMAGE, false); break;
+        }
+
+#undef MI_IMAGE_REDUCE
+    }
+
+private:
+    const mi::neuraylib::ITile* m_prev_tile;
+    mi::neuraylib::ITile* m_tile;
+    Pixel_type m_pixel_type;
+    mi::Float32 m_gamma;
+    const Gamma_lut_8* m_lut;
+};
+
+/// Computes the rows of a miplevel in bands of rows, one band per fragment.
+class Miplevel_job : public DB::Fragmented_job
+{
+public:
+    Miplevel_job(const Miplevel_rows* rows, mi::Uint32 height)
+      : m_rows(rows), m_height(height) { }
+
+    void execute_fragment(
+        DB::Transaction* transaction,
+        size_t index,
+        size_t count,
+        const mi::neuraylib::IJob_execution_context* context) override
+    {
+        const mi::Uint32 y_begin = static_cast<mi::Uint32>(mi::Uint64(m_height) * index / count);
+        const mi::Uint32 y_end
+            = static_cast<mi::Uint32>(mi::Uint64(m_height) * (index+1) / count);
+        m_rows->run(y_begin, y_end);
+    }
+
+private:
+    const Miplevel_rows* m_rows;
+    mi::Uint32 m_height;
+};
+
+/// The minimum number of pixels per fragment when computing a miplevel.
+///
+/// Smaller miplevels are computed on the calling thread since the scheduling costs would
+/// dominate.
+const mi::Size s_min_pixels_per_fragment = 256 * 1024;
+
+/// Computes all rows of a miplevel.
+///
+/// Large miplevels are split into bands of rows that are computed as fragmented job on the
+/// thread pool of \p database (if not \c NULL). The thread pool also accounts for callers that
+/// already run on one of its worker threads.
+void reduce_tile(
+    const Miplevel_rows& rows, mi::Uint32 width, mi::Uint32 height, DB::Database* database)
+{
+    const mi::Size pixels = mi::Size(width) * height;
+    const size_t nr_of_bands = static_cast<size_t>(
+        std::max<mi::Size>(1, std::min<mi::Size>(pixels / s_min_pixels_per_fragment, height)));
+
+    if (database && nr_of_bands > 1) {
+        Miplevel_job job(&rows, height);
+        if (database->execute_fragmented(&job, nr_of_bands) == 0)
+            return;
+    }
+
+    rows.run(0, height);
+}
+
 } // namespace
 
 mi::neuraylib::ICanvas* Image_module_impl::create_miplevel(
     const mi::neuraylib::ICanvas* prev_canvas, float gamma_override) const
 {
-    // NOTE: This implementation creates the new miplevel tile by tile. For each tile, it retrieves
-    // the at most four needed tiles from the previous miplevel *once* (and not for every pixel).
-    // Remember that tile lookups require locks (and reference counts).
+    // NOTE: This implementation creates the new miplevel layer by layer. For all pixel types
+    // except PT_RGBE and PT_RGBEA it operates directly on the raw tile data, splitting large
+    // miplevels into bands of rows that are computed concurrently on the thread pool of the
+    // database. The remaining pixel types use the slower ITile::get_pixel()/set_pixel() methods.
     ASSERT(M_IMAGE, prev_canvas);
 
     // Get properties of previous miplevel
@@ -1583,6 +1925,25 @@ mi::neuraylib::ICanvas* Image_module_impl::create_miplevel(
         pixel_type, width, height, layers,
         get_canvas_is_cubemap(prev_canvas), prev_canvas->get_gamma());
 
+    // Use the typed and possibly multi-threaded code path on the raw tile data if possible.
+    if (Miplevel_rows::is_supported(pixel_type)) {
+
+        const bool is_8bit = pixel_type == PT_SINT8 || pixel_type == PT_RGB
+                          || pixel_type == PT_RGBA  || pixel_type == PT_SINT32;
+        std::unique_ptr<Gamma_lut_8> lut(
+            is_8bit && gamma != 1.0f ? new Gamma_lut_8(gamma) : nullptr);
+
+        for (mi::Uint32 tile_z = 0; tile_z < layers; ++tile_z) {
+            mi::base::Handle<mi::neuraylib::ITile> tile(canvas->get_tile(tile_z));
+            mi::base::Handle<const mi::neuraylib::ITile> prev_tile(prev_canvas->get_tile(tile_z));
+            ASSERT(M_IMAGE, prev_tile);
+
+            Miplevel_rows rows(prev_tile.get(), tile.get(), pixel_type, gamma, lut.get());
+            reduce_tile(rows, width, height, m_database);
+        }
+        return canvas;
+    }
+
     constexpr mi::Uint32 offsets_x[4] = { 0, 1, 0, 1 };
     constexpr mi::Uint32 offsets_y[4] = { 0, 0, 1, 1 };
 
@@ -1597,11 +1958,11 @@ mi::neuraylib::ICanvas* Image_module_impl::create_miplevel(
         const mi::Uint32 y_end = height;
 
         // Lookup tile for this miplevel
-        mi::base::Handle<mi::neuraylib::ITile> tile(canvas->get_tile());
+        mi::base::Handle<mi::neuraylib::ITile> tile(canvas->get_tile(tile_z));
 
         // Lookup involved tiles from the previous miplevel (note that these tiles are not
         // necessarily distinct).
-        mi::base::Handle<const mi::neuraylib::ITile> prev_tile( prev_canvas->get_tile());
+        mi::base::Handle<const mi::neuraylib::ITile> prev_tile( prev_canvas->get_tile(tile_z));
         ASSERT(M_IMAGE, prev_tile);
 
         // Loop over the pixels of this tile and compute the value for each pixel
@@ -230,6 +230,10 @@ public:
 
     IMdl_container_callback* get_mdl_container_callback() const;
 
+    void set_database( DB::Database* database);
+
+    bool get_use_file_miplevels() const;
+
     mi::neuraylib::ICanvas* create_miplevel(
         const mi::neuraylib::ICanvas* prev_canvas, float gamma_override) const;
 
@@ -283,6 +287,12 @@ private:
 
     /// Callback to support lazy loading of images in MDL containers.
     mi::base::Handle<IMdl_container_callback> m_mdl_container_callback;
+
+    /// The database used to execute fragmented jobs, or \c NULL.
+    DB::Database* m_database = nullptr;
+
+    /// Value of the registry key "image_use_file_miplevels" at module initialization.
+    bool m_use_file_miplevels = false;
 };
 
 } // namespace IMAGE
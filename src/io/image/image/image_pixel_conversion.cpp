@@ -0,0 +1,448 @@
+/***************************************************************************************************
+ * Copyright (c) 2024, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************************************/
+
+#include "pch.h"
+
+#include "image_pixel_conversion.h"
+#include "i_image_pixel_conversion.h"
+
+#if defined(MI_ARCH_X86_64) && (defined(HAS_SSE) || defined(SSE_INTRINSICS))
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define MI_IMAGE_TARGET_AVX2
+#else
+#define MI_IMAGE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#define MI_IMAGE_HAS_SSE2
+#define MI_IMAGE_HAS_AVX2
+#elif defined(MI_ARCH_ARM_64)
+#include <arm_neon.h>
+#define MI_IMAGE_HAS_NEON
+#endif
+
+namespace MI {
+
+namespace IMAGE {
+
+namespace {
+
+// ---------- scalar kernels -----------------------------------------------------------------------
+
+void convert_uint8_to_float32_scalar(
+    const mi::Uint8* const source, mi::Float32* const dest, const mi::Size count)
+{
+    for( mi::Size i = 0; i < count; ++i)
+        dest[i] = mi::Float32( source[i]) * mi::Float32( 1.0/255.0);
+}
+
+void convert_uint16_to_float32_scalar(
+    const mi::Uint16* const source, mi::Float32* const dest, const mi::Size count)
+{
+    for( mi::Size i = 0; i < count; ++i)
+        dest[i] = mi::Float32( source[i]) * mi::Float32( 1.0/65535.0);
+}
+
+void convert_float32_to_uint8_scalar(
+    const mi::Float32* const source, mi::Uint8* const dest, const mi::Size count)
+{
+    for( mi::Size i = 0; i < count; ++i)
+        quantize_u( dest[i], source[i]);
+}
+
+void convert_float32_to_uint16_scalar(
+    const mi::Float32* const source, mi::Uint16* const dest, const mi::Size count)
+{
+    for( mi::Size i = 0; i < count; ++i)
+        quantize_u( dest[i], source[i]);
+}
+
+// ---------- SSE2 kernels (x86-64 only) -----------------------------------------------------------
+
+#ifdef MI_IMAGE_HAS_SSE2
+
+void convert_uint8_to_float32_sse2(
+    const mi::Uint8* const source, mi::Float32* const dest, const mi::Size count)
+{
+    const __m128i zero  = _mm_setzero_si128();
+    const __m128  scale = _mm_set1_ps( mi::Float32( 1.0/255.0));
+
+    mi::Size i = 0;
+    for( ; i + 16 <= count; i += 16) {
+        const __m128i b  = _mm_loadu_si128( reinterpret_cast<const __m128i*>( source + i));
+        const __m128i s0 = _mm_unpacklo_epi8( b, zero);
+        const __m128i s1 = _mm_unpackhi_epi8( b, zero);
+        const __m128i i0 = _mm_unpacklo_epi16( s0, zero);
+        const __m128i i1 = _mm_unpackhi_epi16( s0, zero);
+        const __m128i i2 = _mm_unpacklo_epi16( s1, zero);
+        const __m128i i3 = _mm_unpackhi_epi16( s1, zero);
+        _mm_storeu_ps( dest+i,    _mm_mul_ps( _mm_cvtepi32_ps( i0), scale));
+        _mm_storeu_ps( dest+i+4,  _mm_mul_ps( _mm_cvtepi32_ps( i1), scale));
+        _mm_storeu_ps( dest+i+8,  _mm_mul_ps( _mm_cvtepi32_ps( i2), scale));
+        _mm_storeu_ps( dest+i+12, _mm_mul_ps( _mm_cvtepi32_ps( i3), scale));
+    }
+
+    convert_uint8_to_float32_scalar( source+i, dest+i, count-i);
+}
+
+void convert_uint16_to_float32_sse2(
+    const mi::Uint16* const source, mi::Float32* const dest, const mi::Size count)
+{
+    const __m128i zero  = _mm_setzero_si128();
+    const __m128  scale = _mm_set1_ps( mi::Float32( 1.0/65535.0));
+
+    mi::Size i = 0;
+    for( ; i + 8 <= count; i += 8) {
+        const __m128i s = _mm_loadu_si128( reinterpret_cast<const __m128i*>( source + i));
+        const __m128i i0 = _mm_unpacklo_epi16( s, zero);
+        const __m128i i1 = _mm_unpackhi_epi16( s, zero);
+        _mm_storeu_ps( dest+i,   _mm_mul_ps( _mm_cvtepi32_ps( i0), scale));
+        _mm_storeu_ps( dest+i+4, _mm_mul_ps( _mm_cvtepi32_ps( i1), scale));
+    }
+
+    convert_uint16_to_float32_scalar( source+i, dest+i, count-i);
+}
+
+void convert_float32_to_uint8_sse2(
+    const mi::Float32* const source, mi::Uint8* const dest, const mi::Size count)
+{
+    // _mm_packs_epi32() and _mm_packus_epi16() saturate the result
+    mi::Size i = 0;
+    for( ; i + 16 <= count; i += 16)
+        quantize_unsigned_sse( reinterpret_cast<__m128i*>( dest + i), source + i);
+
+    convert_float32_to_uint8_scalar( source+i, dest+i, count-i);
+}
+
+MI_FORCE_INLINE __m128i quantize_unsigned_16_sse2( const float* const source)
+{
+    // see quantize_unsigned(), need to mul by 65536 and clamp instead of 65535
+    __m128 fp0 = _mm_max_ps( _mm_loadu_ps( source), _mm_setzero_ps());
+    fp0 = _mm_mul_ps( _mm_min_ps( fp0, _mm_set1_ps( mi::base::binary_cast<float>( 0x3f800000u-1))),
+        _mm_set1_ps( 65536.0f));
+    // bias into the signed range since there is no _mm_packus_epi32() in SSE2
+    return _mm_sub_epi32( _mm_cvttps_epi32( fp0), _mm_set1_epi32( 32768));
+}
+
+void convert_float32_to_uint16_sse2(
+    const mi::Float32* const source, mi::Uint16* const dest, const mi::Size count)
+{
+    const __m128i bias = _mm_set1_epi16( static_cast<short>( 0x8000));
+
+    mi::Size i = 0;
+    for( ; i + 8 <= count; i += 8) {
+        const __m128i i0 = quantize_unsigned_16_sse2( source+i);
+        const __m128i i1 = quantize_unsigned_16_sse2( source+i+4);
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( dest + i),
+            _mm_xor_si128( _mm_packs_epi32( i0, i1), bias));
+    }
+
+    convert_float32_to_uint16_scalar( source+i, dest+i, count-i);
+}
+
+#endif // MI_IMAGE_HAS_SSE2
+
+// ---------- NEON kernels (ARM64 only) ------------------------------------------------------------
+
+#ifdef MI_IMAGE_HAS_NEON
+
+MI_FORCE_INLINE float32x4_t dequantize_neon( const uint16x4_t x, const float32x4_t scale)
+{
+    return vmulq_f32( vcvtq_f32_u32( vmovl_u16( x)), scale);
+}
+
+void convert_uint8_to_float32_neon(
+    const mi::Uint8* const source, mi::Float32* const dest, const mi::Size count)
+{
+    const float32x4_t scale = vdupq_n_f32( mi::Float32( 1.0/255.0));
+
+    mi::Size i = 0;
+    for( ; i + 16 <= count; i += 16) {
+        const uint8x16_t b  = vld1q_u8( source + i);
+        const uint16x8_t s0 = vmovl_u8( vget_low_u8( b));
+        const uint16x8_t s1 = vmovl_u8( vget_high_u8( b));
+        vst1q_f32( dest+i,    dequantize_neon( vget_low_u16( s0), scale));
+        vst1q_f32( dest+i+4,  dequantize_neon( vget_high_u16( s0), scale));
+        vst1q_f32( dest+i+8,  dequantize_neon( vget_low_u16( s1), scale));
+        vst1q_f32( dest+i+12, dequantize_neon( vget_high_u16( s1), scale));
+    }
+
+    convert_uint8_to_float32_scalar( source+i, dest+i, count-i);
+}
+
+void convert_uint16_to_float32_neon(
+    const mi::Uint16* const source, mi::Float32* const dest, const mi::Size count)
+{
+    const float32x4_t scale = vdupq_n_f32( mi::Float32( 1.0/65535.0));
+
+    mi::Size i = 0;
+    for( ; i + 8 <= count; i += 8) {
+        const uint16x8_t s = vld1q_u16( source + i);
+        vst1q_f32( dest+i,   dequantize_neon( vget_low_u16( s), scale));
+        vst1q_f32( dest+i+4, dequantize_neon( vget_high_u16( s), scale));
+    }
+
+    convert_uint16_to_float32_scalar( source+i, dest+i, count-i);
+}
+
+MI_FORCE_INLINE uint16x4_t quantize_unsigned_neon( const float* const source, const float factor)
+{
+    // see quantize_unsigned(), need to mul by 2^bits and clamp instead of 2^bits-1, the results
+    // are in [0,2^bits-1] and the narrowing below does not need to saturate
+    float32x4_t fp0 = vmaxq_f32( vld1q_f32( source), vdupq_n_f32( 0.0f));
+    fp0 = vminq_f32( fp0, vdupq_n_f32( mi::base::binary_cast<float>( 0x3f800000u-1)));
+    return vmovn_u32( vcvtq_u32_f32( vmulq_f32( fp0, vdupq_n_f32( factor))));
+}
+
+void convert_float32_to_uint8_neon(
+    const mi::Float32* const source, mi::Uint8* const dest, const mi::Size count)
+{
+    mi::Size i = 0;
+    for( ; i + 16 <= count; i += 16) {
+        const uint16x8_t s0 = vcombine_u16(
+            quantize_unsigned_neon( source+i,   256.0f),
+            quantize_unsigned_neon( source+i+4, 256.0f));
+        const uint16x8_t s1 = vcombine_u16(
+            quantize_unsigned_neon( source+i+8,  256.0f),
+            quantize_unsigned_neon( source+i+12, 256.0f));
+        vst1q_u8( dest + i, vcombine_u8( vmovn_u16( s0), vmovn_u16( s1)));
+    }
+
+    convert_float32_to_uint8_scalar( source+i, dest+i, count-i);
+}
+
+void convert_float32_to_uint16_neon(
+    const mi::Float32* const source, mi::Uint16* const dest, const mi::Size count)
+{
+    mi::Size i = 0;
+    for( ; i + 8 <= count; i += 8)
+        vst1q_u16( dest + i, vcombine_u16(
+            quantize_unsigned_neon( source+i,   65536.0f),
+            quantize_unsigned_neon( source+i+4, 65536.0f)));
+
+    convert_float32_to_uint16_scalar( source+i, dest+i, count-i);
+}
+
+#endif // MI_IMAGE_HAS_NEON
+
+// ---------- AVX2 kernels (x86-64 only, selected at runtime) --------------------------------------
+
+#ifdef MI_IMAGE_HAS_AVX2
+
+MI_IMAGE_TARGET_AVX2 void convert_uint8_to_float32_avx2(
+    const mi::Uint8* const source, mi::Float32* const dest, const mi::Size count)
+{
+    const __m256 scale = _mm256_set1_ps( mi::Float32( 1.0/255.0));
+
+    mi::Size i = 0;
+    for( ; i + 16 <= count; i += 16) {
+        const __m128i b = _mm_loadu_si128( reinterpret_cast<const __m128i*>( source + i));
+        const __m256i i0 = _mm256_cvtepu8_epi32( b);
+        const __m256i i1 = _mm256_cvtepu8_epi32( _mm_srli_si128( b, 8));
+        _mm256_storeu_ps( dest+i,   _mm256_mul_ps( _mm256_cvtepi32_ps( i0), scale));
+        _mm256_storeu_ps( dest+i+8, _mm256_mul_ps( _mm256_cvtepi32_ps( i1), scale));
+    }
+
+    convert_uint8_to_float32_scalar( source+i, dest+i, count-i);
+}
+
+MI_IMAGE_TARGET_AVX2 void convert_uint16_to_float32_avx2(
+    const mi::Uint16* const source, mi::Float32* const dest, const mi::Size count)
+{
+    const __m256 scale = _mm256_set1_ps( mi::Float32( 1.0/65535.0));
+
+    mi::Size i = 0;
+    for( ; i + 16 <= count; i += 16) {
+        const __m128i s0 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( source + i));
+        const __m128i s1 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( source + i + 8));
+        const __m256i i0 = _mm256_cvtepu16_epi32( s0);
+        const __m256i i1 = _mm256_cvtepu16_epi32( s1);
+        _mm256_storeu_ps( dest+i,   _mm256_mul_ps( _mm256_cvtepi32_ps( i0), scale));
+        _mm256_storeu_ps( dest+i+8, _mm256_mul_ps( _mm256_cvtepi32_ps( i1), scale));
+    }
+
+    convert_uint16_to_float32_scalar( source+i, dest+i, count-i);
+}
+
+MI_IMAGE_TARGET_AVX2 MI_FORCE_INLINE __m256i quantize_unsigned_avx2(
+    const float* const source, const float factor)
+{
+    // see quantize_unsigned(), need to mul by 2^bits and clamp instead of 2^bits-1
+    const __m256 fp0 = _mm256_min_ps( _mm256_loadu_ps( source),
+        _mm256_set1_ps( mi::base::binary_cast<float>( 0x3f800000u-1)));
+    return _mm256_cvttps_epi32( _mm256_mul_ps( fp0, _mm256_set1_ps( factor)));
+}
+
+MI_IMAGE_TARGET_AVX2 void convert_float32_to_uint8_avx2(
+    const mi::Float32* const source, mi::Uint8* const dest, const mi::Size count)
+{
+    // the pack instructions work per 128-bit lane, this permutation restores the order
+    const __m256i order = _mm256_setr_epi32( 0, 4, 1, 5, 2, 6, 3, 7);
+
+    // _mm256_packs_epi32() and _mm256_packus_epi16() saturate the result
+    mi::Size i = 0;
+    for( ; i + 32 <= count; i += 32) {
+        const __m256i i0 = quantize_unsigned_avx2( source+i,    256.0f);
+        const __m256i i1 = quantize_unsigned_avx2( source+i+8,  256.0f);
+        const __m256i i2 = quantize_unsigned_avx2( source+i+16, 256.0f);
+        const __m256i i3 = quantize_unsigned_avx2( source+i+24, 256.0f);
+        const __m256i b  = _mm256_packus_epi16(
+            _mm256_packs_epi32( i0, i1), _mm256_packs_epi32( i2, i3));
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>( dest + i),
+            _mm256_permutevar8x32_epi32( b, order));
+    }
+
+    convert_float32_to_uint8_scalar( source+i, dest+i, count-i);
+}
+
+MI_IMAGE_TARGET_AVX2 void convert_float32_to_uint16_avx2(
+    const mi::Float32* const source, mi::Uint16* const dest, const mi::Size count)
+{
+    // _mm256_packus_epi32() saturates the result, the permutation restores the order
+    mi::Size i = 0;
+    for( ; i + 16 <= count; i += 16) {
+        const __m256i i0 = quantize_unsigned_avx2( source+i,   65536.0f);
+        const __m256i i1 = quantize_unsigned_avx2( source+i+8, 65536.0f);
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>( dest + i),
+            _mm256_permute4x64_epi64( _mm256_packus_epi32( i0, i1), 0xd8));
+    }
+
+    convert_float32_to_uint16_scalar( source+i, dest+i, count-i);
+}
+
+bool has_avx2()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid( info, 0);
+    if( info[0] < 7)
+        return false;
+    __cpuid( info, 1);
+    const bool uses_xsave = (info[2] & (1 << 27)) != 0;
+    const bool has_avx    = (info[2] & (1 << 28)) != 0;
+    if( !uses_xsave || !has_avx || (_xgetbv( 0) & 0x6) != 0x6)
+        return false;
+    __cpuidex( info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports( "avx2") != 0;
+#endif
+}
+
+#endif // MI_IMAGE_HAS_AVX2
+
+// ---------- runtime dispatch ---------------------------------------------------------------------
+
+std::vector<Pixel_conversion_kernels> select_pixel_conversion_kernels()
+{
+    std::vector<Pixel_conversion_kernels> result;
+
+    result.push_back( Pixel_conversion_kernels{
+        convert_uint8_to_float32_scalar,
+        convert_uint16_to_float32_scalar,
+        convert_float32_to_uint8_scalar,
+        convert_float32_to_uint16_scalar,
+        "scalar" });
+
+#ifdef MI_IMAGE_HAS_SSE2
+    result.push_back( Pixel_conversion_kernels{
+        convert_uint8_to_float32_sse2,
+        convert_uint16_to_float32_sse2,
+        convert_float32_to_uint8_sse2,
+        convert_float32_to_uint16_sse2,
+        "sse2" });
+#endif
+
+#ifdef MI_IMAGE_HAS_NEON
+    result.push_back( Pixel_conversion_kernels{
+        convert_uint8_to_float32_neon,
+        convert_uint16_to_float32_neon,
+        convert_float32_to_uint8_neon,
+        convert_float32_to_uint16_neon,
+        "neon" });
+#endif
+
+#ifdef MI_IMAGE_HAS_AVX2
+    if( has_avx2())
+        result.push_back( Pixel_conversion_kernels{
+            convert_uint8_to_float32_avx2,
+            convert_uint16_to_float32_avx2,
+            convert_float32_to_uint8_avx2,
+            convert_float32_to_uint16_avx2,
+            "avx2" });
+#endif
+
+    return result;
+}
+
+/// The kernels selected for the CPU this process runs on.
+const Pixel_conversion_kernels& get_conversion_kernels()
+{
+    return get_all_pixel_conversion_kernels().back();
+}
+
+} // namespace
+
+void convert_uint8_to_float32(
+    const mi::Uint8* const source, mi::Float32* const dest, const mi::Size count)
+{
+    get_conversion_kernels().m_uint8_to_float32( source, dest, count);
+}
+
+void convert_uint16_to_float32(
+    const mi::Uint16* const source, mi::Float32* const dest, const mi::Size count)
+{
+    get_conversion_kernels().m_uint16_to_float32( source, dest, count);
+}
+
+void convert_float32_to_uint8(
+    const mi::Float32* const source, mi::Uint8* const dest, const mi::Size count)
+{
+    get_conversion_kernels().m_float32_to_uint8( source, dest, count);
+}
+
+void convert_float32_to_uint16(
+    const mi::Float32* const source, mi::Uint16* const dest, const mi::Size count)
+{
+    get_conversion_kernels().m_float32_to_uint16( source, dest, count);
+}
+
+const char* get_pixel_conversion_isa()
+{
+    return get_conversion_kernels().m_isa;
+}
+
+const std::vector<Pixel_conversion_kernels>& get_all_pixel_conversion_kernels()
+{
+    static const std::vector<Pixel_conversion_kernels> kernels = select_pixel_conversion_kernels();
+    return kernels;
+}
+
+} // namespace IMAGE
+
+} // namespace MI
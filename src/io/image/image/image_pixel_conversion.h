@@ -0,0 +1,61 @@
+/***************************************************************************************************
+ * Copyright (c) 2011-2024, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************************************/
+
+#ifndef IO_IMAGE_IMAGE_IMAGE_PIXEL_CONVERSION_H
+#define IO_IMAGE_IMAGE_IMAGE_PIXEL_CONVERSION_H
+
+#include <mi/base/types.h>
+
+#include <vector>
+
+namespace MI {
+
+namespace IMAGE {
+
+/// A set of kernels for one instruction set used by convert_uint8_to_float32() and friends.
+struct Pixel_conversion_kernels
+{
+    void (*m_uint8_to_float32)( const mi::Uint8*, mi::Float32*, mi::Size);
+    void (*m_uint16_to_float32)( const mi::Uint16*, mi::Float32*, mi::Size);
+    void (*m_float32_to_uint8)( const mi::Float32*, mi::Uint8*, mi::Size);
+    void (*m_float32_to_uint16)( const mi::Float32*, mi::Uint16*, mi::Size);
+    /// The instruction set ("avx2", "sse2", "neon", or "scalar").
+    const char* m_isa;
+};
+
+/// Returns all kernel sets compiled in and supported by the CPU this process runs on.
+///
+/// The scalar kernels come first. The last entry is the one selected for the public conversion
+/// functions. Exposed for unit tests and benchmarks.
+const std::vector<Pixel_conversion_kernels>& get_all_pixel_conversion_kernels();
+
+} // namespace IMAGE
+
+} // namespace MI
+
+#endif // IO_IMAGE_IMAGE_IMAGE_PIXEL_CONVERSION_H
@@ -0,0 +1,182 @@
+/******************************************************************************
+ * Copyright (c) 2011-2024, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include "pch.h"
+
+#define MI_TEST_AUTO_SUITE_NAME "Regression Test Suite for io/image/image"
+#define MI_TEST_IMPLEMENT_TEST_MAIN_INSTEAD_OF_MAIN
+
+#include <base/system/test/i_test_auto_driver.h>
+#include <base/system/test/i_test_auto_case.h>
+
+#include "i_image.h"
+#include "i_image_utilities.h"
+
+#include <mi/base/handle.h>
+#include <mi/math/color.h>
+#include <mi/neuraylib/icanvas.h>
+#include <mi/neuraylib/itile.h>
+
+#include <cmath>
+#include <random>
+
+#include <base/system/main/access_module.h>
+#include <base/lib/mem/mem.h>
+#include <base/lib/log/i_log_module.h>
+
+using namespace MI;
+
+// Checks that Image_module::create_miplevel() matches a straightforward 2x2 box filter in linear
+// space, based on ITile::get_pixel()/set_pixel() and exact pow() calls.
+
+std::mt19937 g_prng;
+
+// Fills the canvas with random pixel data (including alpha).
+void fill_random( mi::neuraylib::ICanvas* canvas)
+{
+    std::uniform_real_distribution<mi::Float32> dist( 0.0f, 1.0f);
+    mi::base::Handle<mi::neuraylib::ITile> tile( canvas->get_tile());
+    for( mi::Uint32 y = 0; y < tile->get_resolution_y(); ++y)
+        for( mi::Uint32 x = 0; x < tile->get_resolution_x(); ++x) {
+            mi::math::Color color( dist( g_prng), dist( g_prng), dist( g_prng), dist( g_prng));
+            tile->set_pixel( x, y, &color.r);
+        }
+}
+
+// Computes the expected miplevel of prev_canvas.
+mi::neuraylib::ICanvas* create_reference_miplevel(
+    const IMAGE::Image_module* image_module, const mi::neuraylib::ICanvas* prev_canvas)
+{
+    const mi::Uint32 prev_width  = prev_canvas->get_resolution_x();
+    const mi::Uint32 prev_height = prev_canvas->get_resolution_y();
+    const mi::Uint32 width       = std::max( prev_width / 2, 1u);
+    const mi::Uint32 height      = std::max( prev_height / 2, 1u);
+    const mi::Float32 gamma      = prev_canvas->get_gamma();
+
+    mi::neuraylib::ICanvas* canvas = image_module->create_canvas(
+        IMAGE::convert_pixel_type_string_to_enum( prev_canvas->get_type()),
+        width, height, 1, false, gamma);
+
+    mi::base::Handle<const mi::neuraylib::ITile> prev_tile( prev_canvas->get_tile());
+    mi::base::Handle<mi::neuraylib::ITile> tile( canvas->get_tile());
+
+    for( mi::Uint32 y = 0; y < height; ++y)
+        for( mi::Uint32 x = 0; x < width; ++x) {
+            mi::Float32 sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f};
+            mi::Uint32 n = 0;
+            for( mi::Uint32 prev_y = 2*y; prev_y < std::min( 2*y+2, prev_height); ++prev_y)
+                for( mi::Uint32 prev_x = 2*x; prev_x < std::min( 2*x+2, prev_width); ++prev_x) {
+                    mi::Float32 prev[4];
+                    prev_tile->get_pixel( prev_x, prev_y, prev);
+                    for( mi::Uint32 c = 0; c < 4; ++c)
+                        sum[c] += std::pow( prev[c], gamma);
+                    ++n;
+                }
+            for( mi::Uint32 c = 0; c < 4; ++c)
+                sum[c] = std::pow( sum[c] / n, 1.0f / gamma);
+            tile->set_pixel( x, y, sum);
+        }
+
+    return canvas;
+}
+
+// Compares the pixel data of both canvases (as obtained via ITile::get_pixel()).
+void compare_canvases(
+    const mi::neuraylib::ICanvas* canvas,
+    const mi::neuraylib::ICanvas* reference,
+    mi::Float32 tolerance)
+{
+    MI_CHECK_EQUAL( canvas->get_resolution_x(), reference->get_resolution_x());
+    MI_CHECK_EQUAL( canvas->get_resolution_y(), reference->get_resolution_y());
+    MI_CHECK_EQUAL_CSTR( canvas->get_type(), reference->get_type());
+
+    mi::base::Handle<const mi::neuraylib::ITile> tile( canvas->get_tile());
+    mi::base::Handle<const mi::neuraylib::ITile> reference_tile( reference->get_tile());
+
+    mi::Float32 max_error = 0.0f;
+    for( mi::Uint32 y = 0; y < tile->get_resolution_y(); ++y)
+        for( mi::Uint32 x = 0; x < tile->get_resolution_x(); ++x) {
+            mi::Float32 a[4], b[4];
+            tile->get_pixel( x, y, a);
+            reference_tile->get_pixel( x, y, b);
+            for( mi::Uint32 c = 0; c < 4; ++c)
+                max_error = std::max( max_error, std::abs( a[c] - b[c]));
+        }
+
+    MI_CHECK_LESS_OR_EQUAL( max_error, tolerance);
+}
+
+void check_miplevel(
+    const IMAGE::Image_module* image_module,
+    IMAGE::Pixel_type pixel_type,
+    mi::Uint32 width,
+    mi::Uint32 height,
+    mi::Float32 gamma)
+{
+    mi::base::Handle<mi::neuraylib::ICanvas> canvas(
+        image_module->create_canvas( pixel_type, width, height, 1, false, gamma));
+    fill_random( canvas.get());
+
+    mi::base::Handle<mi::neuraylib::ICanvas> miplevel(
+        image_module->create_miplevel( canvas.get(), 0.0f));
+    mi::base::Handle<mi::neuraylib::ICanvas> reference(
+        create_reference_miplevel( image_module, canvas.get()));
+
+    // One quantization step for integer data (the order of the additions differs). Except for
+    // 8-bit data (which uses exact lookup tables), gamma is applied via mi::math::fast_pow().
+    const bool is_8bit = pixel_type == IMAGE::PT_RGB || pixel_type == IMAGE::PT_RGBA;
+    const bool is_16bit = pixel_type == IMAGE::PT_RGB_16 || pixel_type == IMAGE::PT_RGBA_16;
+    mi::Float32 tolerance
+        = is_8bit ? 1.0f/255.0f : is_16bit ? 1.0f/65535.0f : 0.0f;
+    tolerance += gamma != 1.0f && !is_8bit ? 0.03f : 1e-5f;
+
+    compare_canvases( miplevel.get(), reference.get(), tolerance);
+}
+
+MI_TEST_AUTO_FUNCTION( test_create_miplevel )
+{
+    SYSTEM::Access_module<MEM::Mem_module> mem_module( false);
+    SYSTEM::Access_module<LOG::Log_module> log_module( false);
+    SYSTEM::Access_module<IMAGE::Image_module> image_module( false);
+
+    const IMAGE::Pixel_type pixel_types[] = {
+        IMAGE::PT_RGB, IMAGE::PT_RGBA, IMAGE::PT_RGB_16, IMAGE::PT_RGBA_16,
+        IMAGE::PT_FLOAT32, IMAGE::PT_RGB_FP, IMAGE::PT_COLOR };
+
+    // even and odd sizes, including degenerate ones
+    const mi::Uint32 sizes[][2] = { { 64, 32}, { 37, 21}, { 1, 9}, { 8, 1}, { 3, 3} };
+
+    const mi::Float32 gammas[] = { 1.0f, 2.2f };
+
+    for( auto pixel_type: pixel_types)
+        for( const auto& size: sizes)
+            for( mi::Float32 gamma: gammas)
+                check_miplevel( image_module.get(), pixel_type, size[0], size[1], gamma);
+}
+
+MI_TEST_MAIN_CALLING_TEST_MAIN();
@@ -96,6 +96,20 @@ MI_TEST_AUTO_FUNCTION( test_mipmap )
         reference_path << root_path << "reference/export_of_test_mipmap_level_" << level << ".png";
         MI_CHECK_IMG_DIFF( output_path.str(), reference_path.str());
     }
+
+    // Release computed miplevels and unused tiles, and check that they are restored lazily
+    mi::base::Handle<const IMAGE::IMipmap> const_mipmap( image_module->create_mipmap(
+        IMAGE::File_based(), root_path + "test_mipmap.png", /*selector*/ nullptr));
+    const mi::Uint32 last_level = const_mipmap->get_nlevels() - 1;
+    mi::base::Handle<const mi::neuraylib::ICanvas> canvas( const_mipmap->get_level( last_level));
+    canvas.reset();
+    const mi::Size size = const_mipmap->get_size();
+    MI_CHECK( const_mipmap->release_memory() > 0);
+    MI_CHECK( const_mipmap->get_size() < size);
+    MI_CHECK_EQUAL( 0, const_mipmap->release_memory());
+
+    canvas = const_mipmap->get_level( last_level);
+    MI_CHECK_EQUAL( size, const_mipmap->get_size());
 }
 
 MI_TEST_MAIN_CALLING_TEST_MAIN();
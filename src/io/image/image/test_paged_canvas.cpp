@@ -0,0 +1,221 @@
+/******************************************************************************
+ * Copyright (c) 2011-2024, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include "pch.h"
+
+#define MI_TEST_AUTO_SUITE_NAME "Regression Test Suite for io/image/image"
+#define MI_TEST_IMPLEMENT_TEST_MAIN_INSTEAD_OF_MAIN
+
+#include <base/system/test/i_test_auto_driver.h>
+#include <base/system/test/i_test_auto_case.h>
+
+#include "i_image.h"
+#include "image_canvas_impl.h"
+#include "image_tile_impl.h"
+
+#include <mi/base/handle.h>
+#include <mi/neuraylib/itile.h>
+
+#include <base/system/main/access_module.h>
+#include <base/lib/mem/mem.h>
+#include <base/lib/log/i_log_module.h>
+#include <base/lib/plug/i_plug.h>
+
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include <prod/lib/neuray/test_shared.h>
+
+using namespace MI;
+
+const mi::Uint32 width  = 600;
+const mi::Uint32 height = 520;
+
+/// Returns the test pattern for pixel (x,y) (top-down) and channel c.
+mi::Uint8 pattern( mi::Uint32 x, mi::Uint32 y, mi::Uint32 c)
+{
+    return static_cast<mi::Uint8>( (x * 7 + y * 13 + c * 101) ^ (x / 32 + y / 32));
+}
+
+/// Writes an uncompressed 8-bit RGB TIFF file with the test pattern, stored in 64x64 tiles.
+void write_tiled_tiff( const char* filename)
+{
+    const mi::Uint32 tile_size = 64;
+    const mi::Uint32 tiles_x = (width  + tile_size - 1) / tile_size;
+    const mi::Uint32 tiles_y = (height + tile_size - 1) / tile_size;
+    const mi::Uint32 tiles = tiles_x * tiles_y;
+    const mi::Uint32 tile_bytes = tile_size * tile_size * 3;
+
+    const mi::Uint32 entries = 11;
+    const mi::Uint32 bps_offset = 8 + 2 + entries * 12 + 4;
+    const mi::Uint32 offsets_offset = bps_offset + 8;
+    const mi::Uint32 counts_offset = offsets_offset + tiles * 4;
+    const mi::Uint32 data_offset = counts_offset + tiles * 4;
+
+    std::vector<mi::Uint8> buffer;
+    auto put16 = [&buffer]( mi::Uint32 v) {
+        buffer.push_back( v & 0xff);
+        buffer.push_back( (v >> 8) & 0xff);
+    };
+    auto put32 = [&put16]( mi::Uint32 v) { put16( v & 0xffff); put16( v >> 16); };
+    auto entry = [&]( mi::Uint32 tag, mi::Uint32 type, mi::Uint32 count, mi::Uint32 value) {
+        put16( tag); put16( type); put32( count);
+        if( type == 3 && count == 1) { put16( value); put16( 0); } else put32( value);
+    };
+
+    buffer.push_back( 'I'); buffer.push_back( 'I'); put16( 42); put32( 8);
+    put16( entries);
+    entry( 256, 4, 1, width);                   // ImageWidth
+    entry( 257, 4, 1, height);                  // ImageLength
+    entry( 258, 3, 3, bps_offset);              // BitsPerSample
+    entry( 259, 3, 1, 1);                       // Compression: none
+    entry( 262, 3, 1, 2);                       // PhotometricInterpretation: RGB
+    entry( 277, 3, 1, 3);                       // SamplesPerPixel
+    entry( 284, 3, 1, 1);                       // PlanarConfiguration: contiguous
+    entry( 322, 4, 1, tile_size);               // TileWidth
+    entry( 323, 4, 1, tile_size);               // TileLength
+    entry( 324, 4, tiles, offsets_offset);      // TileOffsets
+    entry( 325, 4, tiles, counts_offset);       // TileByteCounts
+    put32( 0);
+    MI_CHECK_EQUAL( buffer.size(), bps_offset);
+    put16( 8); put16( 8); put16( 8); put16( 0);
+    for( mi::Uint32 i = 0; i < tiles; ++i)
+        put32( data_offset + i * tile_bytes);
+    for( mi::Uint32 i = 0; i < tiles; ++i)
+        put32( tile_bytes);
+    MI_CHECK_EQUAL( buffer.size(), data_offset);
+
+    for( mi::Uint32 ty = 0; ty < tiles_y; ++ty)
+        for( mi::Uint32 tx = 0; tx < tiles_x; ++tx)
+            for( mi::Uint32 y = ty * tile_size; y < (ty+1) * tile_size; ++y)
+                for( mi::Uint32 x = tx * tile_size; x < (tx+1) * tile_size; ++x)
+                    for( mi::Uint32 c = 0; c < 3; ++c)
+                        buffer.push_back( x < width && y < height ? pattern( x, y, c) : 0);
+
+    std::ofstream file( filename, std::ios::binary);
+    file.write( reinterpret_cast<const char*>( buffer.data()), buffer.size());
+    MI_CHECK( file.good());
+}
+
+/// Writes a PNG file (stored in scanlines) with the test pattern.
+void write_png( IMAGE::Image_module* image_module, const char* filename)
+{
+    mi::base::Handle<mi::neuraylib::ICanvas> canvas(
+        image_module->create_canvas( IMAGE::PT_RGB, width, height));
+    mi::base::Handle<mi::neuraylib::ITile> tile( canvas->get_tile());
+    mi::Uint8* data = static_cast<mi::Uint8*>( tile->get_data());
+    for( mi::Uint32 y = 0; y < height; ++y)
+        for( mi::Uint32 x = 0; x < width; ++x)
+            for( mi::Uint32 c = 0; c < 3; ++c)
+                data[((height-1-y) * width + x) * 3 + c] = pattern( x, y, c);
+
+    MI_CHECK( image_module->export_canvas( canvas.get(), filename));
+}
+
+mi::Size get_tile_size( const mi::neuraylib::ITile* tile)
+{
+    mi::base::Handle<const IMAGE::ITile> tile_internal( tile->get_interface<IMAGE::ITile>());
+    MI_CHECK( tile_internal);
+    return tile_internal->get_size();
+}
+
+/// Compares a canvas loaded with paging against one loaded without.
+void check_paged_canvas(
+    IMAGE::Image_module* image_module, const char* filename, const char* selector)
+{
+    IMAGE::Canvas_impl::set_paged_tile_threshold( 64 * 1024 * 1024);
+    mi::base::Handle<const mi::neuraylib::ICanvas> reference(
+        image_module->create_canvas( IMAGE::File_based(), filename, selector));
+    MI_CHECK( reference);
+    mi::base::Handle<const mi::neuraylib::ITile> reference_tile( reference->get_tile());
+    const mi::Size bytes = static_cast<mi::Size>( width) * height
+        * IMAGE::get_bytes_per_pixel(
+            IMAGE::convert_pixel_type_string_to_enum( reference_tile->get_type()));
+
+    IMAGE::Canvas_impl::set_paged_tile_threshold( 0);
+    mi::base::Handle<const mi::neuraylib::ICanvas> canvas(
+        image_module->create_canvas( IMAGE::File_based(), filename, selector));
+    MI_CHECK( canvas);
+    mi::base::Handle<const mi::neuraylib::ITile> tile( canvas->get_tile());
+    MI_CHECK_EQUAL_CSTR( tile->get_type(), reference_tile->get_type());
+    MI_CHECK_EQUAL( tile->get_resolution_x(), width);
+    MI_CHECK_EQUAL( tile->get_resolution_y(), height);
+
+    // Only the first block or band has been read so far.
+    MI_CHECK_LESS( get_tile_size( tile.get()), bytes);
+
+    // Look up pixels concurrently, while the entire layer is requested.
+    std::atomic<mi::Uint32> mismatches( 0);
+    std::vector<std::thread> threads;
+    for( mi::Uint32 t = 0; t < 4; ++t)
+        threads.emplace_back( [&, t]() {
+            for( mi::Uint32 y = t; y < height; y += 4)
+                for( mi::Uint32 x = 0; x < width; ++x) {
+                    mi::Float32 a[4], b[4];
+                    tile->get_pixel( x, y, a);
+                    reference_tile->get_pixel( x, y, b);
+                    if( memcmp( a, b, sizeof( a)) != 0)
+                        ++mismatches;
+                }
+        });
+
+    MI_CHECK_EQUAL( 0, memcmp( tile->get_data(), reference_tile->get_data(), bytes));
+
+    for( auto& thread: threads)
+        thread.join();
+    MI_CHECK_EQUAL( mismatches, 0);
+
+    // The blocks have been released after reading the entire layer.
+    MI_CHECK_LESS( get_tile_size( tile.get()), bytes + bytes / 2);
+
+    IMAGE::Canvas_impl::set_paged_tile_threshold( 64 * 1024 * 1024);
+}
+
+MI_TEST_AUTO_FUNCTION( test_paged_canvas )
+{
+    SYSTEM::Access_module<MEM::Mem_module> mem_module( false);
+    SYSTEM::Access_module<LOG::Log_module> log_module( false);
+
+    SYSTEM::Access_module<PLUG::Plug_module> plug_module( false);
+    MI_CHECK( plug_module->load_library( plugin_path_openimageio));
+
+    SYSTEM::Access_module<IMAGE::Image_module> image_module( false);
+
+    write_png( image_module.get(), "test_paged_canvas.png");
+    check_paged_canvas( image_module.get(), "test_paged_canvas.png", nullptr);
+    check_paged_canvas( image_module.get(), "test_paged_canvas.png", "G");
+
+    write_tiled_tiff( "test_paged_canvas.tif");
+    check_paged_canvas( image_module.get(), "test_paged_canvas.tif", nullptr);
+    check_paged_canvas( image_module.get(), "test_paged_canvas.tif", "R");
+}
+
+MI_TEST_MAIN_CALLING_TEST_MAIN();
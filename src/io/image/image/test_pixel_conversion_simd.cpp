@@ -0,0 +1,171 @@
+/******************************************************************************
+ * Copyright (c) 2024, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include "pch.h"
+
+#define MI_TEST_AUTO_SUITE_NAME "Regression Test Suite for io/image/image"
+#define MI_TEST_IMPLEMENT_TEST_MAIN_INSTEAD_OF_MAIN
+
+#include <base/system/test/i_test_auto_driver.h>
+#include <base/system/test/i_test_auto_case.h>
+
+#include "i_image.h"
+#include "i_image_pixel_conversion.h"
+#include "image_pixel_conversion.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace MI;
+
+// Checks that the kernels of each instruction set supported by this CPU, as well as the dispatched
+// conversions, produce the same results as the scalar per-pixel conversions. See
+// bench_pixel_conversion.cpp for the throughput.
+
+// pixel counts around the vector widths to exercise the tail handling
+const mi::Size g_counts[] = { 0, 1, 2, 3, 5, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 4099 };
+
+mi::Size g_failures = 0;
+
+std::mt19937 g_prng;
+
+template <typename T>
+void fill_random( std::vector<T>& data)
+{
+    for( auto& x: data)
+        x = static_cast<T>( g_prng());
+}
+
+void fill_random( std::vector<mi::Float32>& data)
+{
+    // include values outside of [0,1] to test clamping
+    for( auto& x: data)
+        x = static_cast<float>( static_cast<double>( g_prng()) / g_prng.max()) * 1.2f - 0.1f;
+
+    // include the boundaries of the clamping
+    const mi::Float32 special[] = { 0.0f, 1.0f, -0.0f, -1.0f, 2.0f, 0.99999994f };
+    for( mi::Size i = 0; i < std::min( data.size(), sizeof( special) / sizeof( special[0])); ++i)
+        data[i] = special[i];
+}
+
+/// Converts \p count pixels via \p kernel (or the dispatched conversion if \p kernel is \c nullptr)
+/// and compares the result with the per-pixel conversion.
+template <IMAGE::Pixel_type Source, IMAGE::Pixel_type Dest>
+void test_conversion(
+    const char* isa,
+    void (*kernel)(
+        const typename IMAGE::Pixel_type_traits<Source>::Base_type*,
+        typename IMAGE::Pixel_type_traits<Dest>::Base_type*,
+        mi::Size))
+{
+    const char* source_type = IMAGE::convert_pixel_type_enum_to_string( Source);
+    const char* dest_type   = IMAGE::convert_pixel_type_enum_to_string( Dest);
+
+    typedef typename IMAGE::Pixel_type_traits<Source>::Base_type Source_base_type;
+    typedef typename IMAGE::Pixel_type_traits<Dest>::Base_type   Dest_base_type;
+    const mi::Size source_cpp = IMAGE::Pixel_type_traits<Source>::s_components_per_pixel;
+    const mi::Size dest_cpp   = IMAGE::Pixel_type_traits<Dest>::s_components_per_pixel;
+
+    for( const mi::Size count: g_counts) {
+
+        std::vector<Source_base_type> source( count * source_cpp);
+        std::vector<Dest_base_type> dest( count * dest_cpp);
+        std::vector<Dest_base_type> expected( count * dest_cpp);
+        fill_random( source);
+
+        if( kernel)
+            kernel( source.data(), dest.data(), count * source_cpp);
+        else
+            IMAGE::Pixel_converter<Source, Dest>::convert( source.data(), dest.data(), count);
+
+        for( mi::Size i = 0; i < count; ++i)
+            IMAGE::Pixel_converter<Source, Dest>::convert(
+                &source[i * source_cpp], &expected[i * dest_cpp]);
+
+        if( dest != expected) {
+            g_failures++;
+            std::cout << "conversion from " << source_type << " to " << dest_type << " ("
+                      << isa << ", " << count << " pixels) differs from scalar conversion"
+                      << std::endl;
+        }
+    }
+}
+
+void test_kernels( const IMAGE::Pixel_conversion_kernels& k)
+{
+    using namespace MI::IMAGE;
+
+    std::cout << "testing " << k.m_isa << " kernels" << std::endl;
+
+    test_conversion<PT_RGB,     PT_RGB_FP >( k.m_isa, k.m_uint8_to_float32);
+    test_conversion<PT_RGBA,    PT_COLOR  >( k.m_isa, k.m_uint8_to_float32);
+    test_conversion<PT_RGB_16,  PT_RGB_FP >( k.m_isa, k.m_uint16_to_float32);
+    test_conversion<PT_RGBA_16, PT_COLOR  >( k.m_isa, k.m_uint16_to_float32);
+    test_conversion<PT_RGB_FP,  PT_RGB    >( k.m_isa, k.m_float32_to_uint8);
+    test_conversion<PT_COLOR,   PT_RGBA   >( k.m_isa, k.m_float32_to_uint8);
+    test_conversion<PT_RGB_FP,  PT_RGB_16 >( k.m_isa, k.m_float32_to_uint16);
+    test_conversion<PT_COLOR,   PT_RGBA_16>( k.m_isa, k.m_float32_to_uint16);
+}
+
+MI_TEST_AUTO_FUNCTION( test_pixel_conversion_kernels )
+{
+    const std::vector<IMAGE::Pixel_conversion_kernels>& kernels
+        = IMAGE::get_all_pixel_conversion_kernels();
+    MI_CHECK( !kernels.empty());
+    MI_CHECK_EQUAL_CSTR( kernels.front().m_isa, "scalar");
+
+    for( const auto& k: kernels)
+        test_kernels( k);
+
+    MI_CHECK_EQUAL( g_failures, 0);
+}
+
+MI_TEST_AUTO_FUNCTION( test_pixel_conversion_dispatch )
+{
+    using namespace MI::IMAGE;
+
+    // the dispatched conversions use the last (best) kernels
+    const char* isa = get_pixel_conversion_isa();
+    MI_CHECK_EQUAL_CSTR( isa, get_all_pixel_conversion_kernels().back().m_isa);
+
+    const mi::Size failures = g_failures;
+
+    test_conversion<PT_RGB,     PT_RGB_FP >( isa, nullptr);
+    test_conversion<PT_RGBA,    PT_COLOR  >( isa, nullptr);
+    test_conversion<PT_RGB_16,  PT_RGB_FP >( isa, nullptr);
+    test_conversion<PT_RGBA_16, PT_COLOR  >( isa, nullptr);
+    test_conversion<PT_RGB_FP,  PT_RGB    >( isa, nullptr);
+    test_conversion<PT_COLOR,   PT_RGBA   >( isa, nullptr);
+    test_conversion<PT_RGB_FP,  PT_RGB_16 >( isa, nullptr);
+    test_conversion<PT_COLOR,   PT_RGBA_16>( isa, nullptr);
+
+    MI_CHECK_EQUAL( g_failures, failures);
+}
+
+MI_TEST_MAIN_CALLING_TEST_MAIN();
@@ -42,6 +42,7 @@
 #include <base/lib/path/i_path.h>
 #include <base/data/serial/i_serializer.h>
 #include <base/data/db/i_db_access.h>
+#include <base/data/db/i_db_fragmented_job.h>
 #include <base/data/db/i_db_transaction.h>
 #include <base/util/string_utils/i_string_utils.h>
 #include <io/image/image/i_image.h>
@@ -97,7 +98,7 @@ IMAGE::IMipmap* Image_set::create_mipmap( mi::Size f, mi::Size i, mi::Sint32& er
             container_filename,
             container_membername,
             selector,
-            /*only_first_level*/ true,
+            /*only_first_level*/ !image_module->get_use_file_miplevels(),
             &errors);
     }
 
@@ -109,7 +110,7 @@ IMAGE::IMipmap* Image_set::create_mipmap( mi::Size f, mi::Size i, mi::Sint32& er
             IMAGE::File_based(),
             resolved_filename,
             selector,
-            /*only_first_level*/ true,
+            /*only_first_level*/ !image_module->get_use_file_miplevels(),
             &errors);
     }
 
@@ -134,7 +135,7 @@ IMAGE::IMipmap* Image_set::create_mipmap( mi::Size f, mi::Size i, mi::Sint32& er
             image_format,
             selector,
             mdl_file_path && (mdl_file_path[0] != '\0') ? mdl_file_path : nullptr,
-            /*only_first_level*/ true,
+            /*only_first_level*/ !image_module->get_use_file_miplevels(),
             &errors);
     }
 
@@ -481,7 +482,7 @@ mi::Sint32 Image::reset_reader(
         image_format,
         selector,
         /*mdl_file_path*/ nullptr,
-        /*only_first_level*/ true,
+        /*only_first_level*/ !image_module->get_use_file_miplevels(),
         &errors));
     if( errors != 0)
         return errors;
@@ -510,6 +511,103 @@ mi::Sint32 Image::reset_reader(
     return 0;
 }
 
+namespace {
+
+/// Identifies a uvtile of an image set by frame index and uvtile index.
+using Uvtile_index = std::pair<mi::Size, mi::Size>;
+
+/// Creates the mipmaps of file-based uvtiles concurrently, one uvtile per fragment.
+///
+/// Each fragment opens its own file, probes just the image header via the image plugin, and
+/// closes the file again before the fragment ends (the pixel data is loaded lazily later). Hence
+/// the number of open files is bounded by the number of worker threads, not by the number of
+/// uvtiles.
+class Create_mipmaps_job : public DB::Fragmented_job
+{
+public:
+    /// Constructor.
+    ///
+    /// \param image_set   The image set providing the uvtiles.
+    /// \param indices     The uvtiles to create the mipmaps for.
+    Create_mipmaps_job( const Image_set* image_set, const std::vector<Uvtile_index>& indices)
+      : m_image_set( image_set)
+      , m_indices( indices)
+      , m_mipmaps( indices.size())
+      , m_errors( indices.size(), 0)
+    {
+    }
+
+    void execute_fragment(
+        DB::Transaction* transaction,
+        size_t index,
+        size_t count,
+        const mi::neuraylib::IJob_execution_context* context) override
+    {
+        const Uvtile_index& uvtile = m_indices[index];
+        m_mipmaps[index] = m_image_set->create_mipmap(
+            uvtile.first, uvtile.second, m_errors[index]);
+    }
+
+    /// Returns the mipmap of the uvtile \p index (in the order passed to the constructor).
+    const mi::base::Handle<IMAGE::IMipmap>& get_mipmap( size_t index) const
+    { return m_mipmaps[index]; }
+
+    /// Returns the error code for the uvtile \p index (in the order passed to the constructor).
+    mi::Sint32 get_errors( size_t index) const { return m_errors[index]; }
+
+private:
+    const Image_set* m_image_set;
+    const std::vector<Uvtile_index>& m_indices;
+    std::vector<mi::base::Handle<IMAGE::IMipmap>> m_mipmaps;
+    std::vector<mi::Sint32> m_errors;
+};
+
+/// Creates the mipmaps for the given uvtiles of \p image_set and stores them in \p frames.
+///
+/// The uvtiles of file-based image sets are created concurrently via #Create_mipmaps_job. All
+/// other image sets are handled serially since readers for containers or user-provided buffers
+/// are not required to support concurrent access.
+///
+/// Returns the error code of the first failing uvtile in the order of \p indices (independent of
+/// the order of execution), or 0 if all mipmaps were created successfully.
+mi::Sint32 create_mipmaps(
+    DB::Transaction* transaction,
+    const Image_set* image_set,
+    const std::vector<Uvtile_index>& indices,
+    Frames& frames)
+{
+    bool is_file_based = !image_set->is_mdl_container();
+    for( size_t k = 0, n = indices.size(); is_file_based && k < n; ++k) {
+        const char* resolved_filename
+            = image_set->get_resolved_filename( indices[k].first, indices[k].second);
+        is_file_based = resolved_filename && (resolved_filename[0] != '\0');
+    }
+
+    if( !transaction || !is_file_based || indices.size() < 2) {
+        for( const auto& uvtile: indices) {
+            mi::Sint32 errors = 0;
+            frames[uvtile.first].m_uvtiles[uvtile.second].m_mipmap
+                = image_set->create_mipmap( uvtile.first, uvtile.second, errors);
+            if( errors != 0)
+                return errors;
+        }
+        return 0;
+    }
+
+    Create_mipmaps_job job( image_set, indices);
+    transaction->execute_fragmented( &job, indices.size());
+
+    for( size_t k = 0, n = indices.size(); k < n; ++k) {
+        mi::Sint32 errors = job.get_errors( k);
+        if( errors != 0)
+            return errors;
+        frames[indices[k].first].m_uvtiles[indices[k].second].m_mipmap = job.get_mipmap( k);
+    }
+    return 0;
+}
+
+} // namespace
+
 mi::Sint32 Image::reset_image_set(
     DB::Transaction* transaction, const Image_set* image_set, const mi::base::Uuid& impl_hash)
 {
@@ -530,17 +628,26 @@ mi::Sint32 Image::reset_image_set(
     Frames_filenames tmp_frames_filenames;
     Frame_to_id tmp_frame_to_id;
 
+    // The uvtiles whose mipmaps are created after the loop (in this order), and the first error
+    // in the layout of the image set. Mipmaps are still created for the uvtiles before that
+    // error such that their errors take precedence, as with a sequential traversal.
+    std::vector<Uvtile_index> tmp_uvtile_indices;
+    mi::Sint32 layout_errors = 0;
+
     // Convert data from image set into temporary variables
-    for( mi::Size f = 0; f < number_of_frames; ++f) {
+    for( mi::Size f = 0; f < number_of_frames && layout_errors == 0; ++f) {
 
         const mi::Size number_of_tiles = image_set->get_frame_length( f);
-        if( number_of_tiles == 0)
-            return -1;
+        if( number_of_tiles == 0) {
+            layout_errors = -1;
+            break;
+        }
 
         const mi::Size frame_number = image_set->get_frame_number( f);
         if( (f > 0) && (frame_number <= tmp_frames.back().m_frame_number)) {
             ASSERT( M_SCENE, !"wrong frame order");
-            return -99;
+            layout_errors = -99;
+            break;
         }
 
         // Compute min/max u/v value of all tiles for this frame.
@@ -570,16 +677,15 @@ mi::Sint32 Image::reset_image_set(
         for( mi::Size i = 0; i < number_of_tiles; ++i) {
 
             image_set->get_uvtile_uv( f, i, u, v);
-            if( !frame.m_uv_to_id.set( u, v, static_cast<mi::Uint32>( i)))
-                return -12;
+            if( !frame.m_uv_to_id.set( u, v, static_cast<mi::Uint32>( i))) {
+                layout_errors = -12;
+                break;
+            }
 
             Uvtile& tile = frame.m_uvtiles[i];
             tile.m_u = u;
             tile.m_v = v;
-            mi::Sint32 errors = 0;
-            tile.m_mipmap = image_set->create_mipmap( f, i, errors);
-            if( errors != 0)
-                return errors;
+            tmp_uvtile_indices.emplace_back( f, i);
 
             Uvfilenames& filenames = frame_filenames[i];
             filenames.m_resolved_filename    = image_set->get_resolved_filename( f, i);
@@ -597,6 +703,13 @@ mi::Sint32 Image::reset_image_set(
         tmp_frame_to_id[frame_number] = f;
     }
 
+    const mi::Sint32 errors
+        = create_mipmaps( transaction, image_set, tmp_uvtile_indices, tmp_frames);
+    if( errors != 0)
+        return errors;
+    if( layout_errors != 0)
+        return layout_errors;
+
     reset_shared(
         transaction, tmp_is_animated, tmp_is_uvtile, tmp_frames, tmp_frame_to_id, impl_hash);
 
@@ -1818,6 +1931,17 @@ size_t Image_impl::get_size() const
     return s;
 }
 
+size_t Image_impl::release_memory() const
+{
+    size_t s = 0;
+
+    for( const auto& frame: m_frames)
+        for( const auto& uvtile: frame.m_uvtiles)
+            s += uvtile.m_mipmap->release_memory();
+
+    return s;
+}
+
 DB::Journal_type Image_impl::get_journal_flags() const
 {
     return DB::Journal_type(
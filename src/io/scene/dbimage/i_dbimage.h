@@ -746,6 +746,8 @@ public:
 
     size_t get_size() const;
 
+    size_t release_memory() const;
+
     DB::Journal_type get_journal_flags() const;
 
     Uint bundle( DB::Tag* results, Uint size) const { return 0; }
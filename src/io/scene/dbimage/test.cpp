@@ -31,11 +31,14 @@
 #define MI_TEST_AUTO_SUITE_NAME "Regression Test Suite for io/scene/dbimage"
 #define MI_TEST_IMPLEMENT_TEST_MAIN_INSTEAD_OF_MAIN
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
 #include <base/system/test/i_test_auto_driver.h>
 #include <base/system/test/i_test_auto_case.h>
 
 #include <mi/base/handle.h>
+#include <mi/math/color.h>
 #include <mi/neuraylib/icanvas.h>
 #include <mi/neuraylib/itile.h>
 
@@ -129,6 +132,68 @@ private:
     const std::vector<mi::base::Handle<const mi::neuraylib::ICanvas>>& m_canvases;
 };
 
+// A uvtile of Test_file_image_set.
+struct Test_file_uvtile
+{
+    mi::Sint32 u;
+    mi::Sint32 v;
+    std::string filename;
+};
+
+// A frame of Test_file_image_set.
+struct Test_file_frame
+{
+    mi::Size frame_number;
+    std::vector<Test_file_uvtile> uvtiles;
+};
+
+// Implementation of Image_set for (possibly animated) file-based uvtiles.
+class Test_file_image_set : public DBIMAGE::Image_set
+{
+public:
+    Test_file_image_set( const std::vector<Test_file_frame>& frames) : m_frames( frames) { }
+
+    bool is_mdl_container() const { return false; }
+
+    const char* get_original_filename() const { return ""; }
+
+    const char* get_container_filename() const { return ""; }
+
+    const char* get_mdl_file_path() const { return ""; }
+
+    const char* get_selector() const { return nullptr; }
+
+    const char* get_image_format() const { return ""; }
+
+    bool is_animated() const { return true; }
+
+    bool is_uvtile() const { return true; }
+
+    mi::Size get_length() const { return m_frames.size(); }
+
+    mi::Size get_frame_number( mi::Size f) const { return m_frames[f].frame_number; }
+
+    mi::Size get_frame_length( mi::Size f) const { return m_frames[f].uvtiles.size(); }
+
+    void get_uvtile_uv( mi::Size f, mi::Size i, mi::Sint32 &u, mi::Sint32 &v) const
+    {
+        u = m_frames[f].uvtiles[i].u;
+        v = m_frames[f].uvtiles[i].v;
+    }
+
+    const char* get_resolved_filename( mi::Size f, mi::Size i) const
+    { return m_frames[f].uvtiles[i].filename.c_str(); }
+
+    const char* get_container_membername( mi::Size f, mi::Size i) const { return ""; }
+
+    mi::neuraylib::IReader* open_reader( mi::Size f, mi::Size i) const { return nullptr; }
+
+    mi::neuraylib::ICanvas* get_canvas( mi::Size f, mi::Size i) const { return nullptr; }
+
+private:
+    const std::vector<Test_file_frame>& m_frames;
+};
+
 
 // Checks whether \p image represents $MI_DATA/io/image/image/test_mipmap.png.
 //
@@ -149,6 +214,94 @@ void check_mipmap( DB::Transaction* transaction, const DBIMAGE::Image* image)
         "mipmap_level_2.png", (root_path + "reference/export_of_test_mipmap_level_2.png").c_str());
 }
 
+// Checks that the canvases \p canvas1 and \p canvas2 have the same resolution and pixel data.
+void check_canvas_equal(
+    const mi::neuraylib::ICanvas* canvas1, const mi::neuraylib::ICanvas* canvas2)
+{
+    MI_CHECK_EQUAL( canvas1->get_resolution_x(), canvas2->get_resolution_x());
+    MI_CHECK_EQUAL( canvas1->get_resolution_y(), canvas2->get_resolution_y());
+    MI_CHECK_EQUAL_CSTR( canvas1->get_type(), canvas2->get_type());
+
+    mi::base::Handle<const mi::neuraylib::ITile> tile1( canvas1->get_tile());
+    mi::base::Handle<const mi::neuraylib::ITile> tile2( canvas2->get_tile());
+    mi::Uint32 width  = canvas1->get_resolution_x();
+    mi::Uint32 height = canvas1->get_resolution_y();
+    for( mi::Uint32 y = 0; y < height; ++y)
+        for( mi::Uint32 x = 0; x < width; ++x) {
+            mi::math::Color color1, color2;
+            tile1->get_pixel( x, y, &color1.r);
+            tile2->get_pixel( x, y, &color2.r);
+            MI_CHECK( color1 == color2);
+        }
+}
+
+// Checks that the pixel (\p x, \p y) of \p canvas matches \p expected (up to quantization).
+void check_pixel(
+    const mi::neuraylib::ICanvas* canvas,
+    mi::Uint32 x,
+    mi::Uint32 y,
+    const mi::math::Color& expected)
+{
+    mi::base::Handle<const mi::neuraylib::ITile> tile( canvas->get_tile());
+    mi::math::Color color;
+    tile->get_pixel( x, y, &color.r);
+    MI_CHECK_LESS( std::abs( color.r - expected.r), 0.02f);
+    MI_CHECK_LESS( std::abs( color.g - expected.g), 0.02f);
+    MI_CHECK_LESS( std::abs( color.b - expected.b), 0.02f);
+    MI_CHECK_LESS( std::abs( color.a - expected.a), 0.02f);
+}
+
+// Checks the miplevels of $MI_DATA/io/image/image/tests/test_dds_dxt1_alpha.dds, which stores a
+// complete chain of 7 miplevels.
+//
+// Depending on \p use_file_miplevels the miplevels are expected to be the ones stored in the
+// file, or to be computed from the base level.
+void check_file_miplevels( DB::Transaction* transaction, bool use_file_miplevels)
+{
+    MI_CHECK_EQUAL( g_image_module->get_use_file_miplevels(), use_file_miplevels);
+
+    std::string file_path = TEST::mi_src_path( "io/image/image/tests/test_dds_dxt1_alpha.dds");
+    mi::base::Uuid unknown_hash{0,0,0,0};
+
+    DBIMAGE::Image* image = new DBIMAGE::Image();
+    mi::Sint32 result = image->reset_file(
+        transaction, file_path, /*selector*/ nullptr, unknown_hash);
+    MI_CHECK_EQUAL( result, 0);
+
+    mi::base::Handle<const IMAGE::IMipmap> mipmap( image->get_mipmap( transaction, 0, 0));
+    MI_CHECK_EQUAL( 7, mipmap->get_nlevels());
+
+    mi::base::Handle<const mi::neuraylib::ICanvas> previous_level( mipmap->get_level( 0));
+    for( mi::Uint32 i = 1; i < 7; ++i) {
+
+        mi::base::Handle<const mi::neuraylib::ICanvas> level( mipmap->get_level( i));
+        MI_CHECK_EQUAL( level->get_resolution_x(), std::max( 100u >> i, 1u));
+        MI_CHECK_EQUAL( level->get_resolution_y(), std::max( 100u >> i, 1u));
+
+        mi::Sint32 errors = 0;
+        mi::base::Handle<const mi::neuraylib::ICanvas> expected( use_file_miplevels
+            ? g_image_module->create_canvas(
+                IMAGE::File_based(), file_path, /*selector*/ nullptr, i, &errors)
+            : g_image_module->create_miplevel( previous_level.get(), 0.0f));
+        MI_CHECK_EQUAL( errors, 0);
+        check_canvas_equal( level.get(), expected.get());
+
+        previous_level = level;
+    }
+
+    if( use_file_miplevels) {
+        // Miplevel 1 has partial DXT blocks at its right border, miplevel 5 is a single partial
+        // DXT block.
+        mi::base::Handle<const mi::neuraylib::ICanvas> level1( mipmap->get_level( 1));
+        check_pixel( level1.get(),  0, 49, mi::math::Color( 0.0f, 0.0f, 0.969f, 1.0f));
+        check_pixel( level1.get(), 48, 49, mi::math::Color( 0.969f, 0.0f, 0.0f, 1.0f));
+        mi::base::Handle<const mi::neuraylib::ICanvas> level5( mipmap->get_level( 5));
+        check_pixel( level5.get(),  0,  2, mi::math::Color( 0.161f, 0.271f, 0.482f, 1.0f));
+    }
+
+    transaction->store( image);
+}
+
 // Checks the uvtiles of frame \p frame_id against \p expected_tiles (indexed by filename).
 void check_uvtile(
     const DBIMAGE::Image* image,
@@ -791,6 +944,116 @@ void check_animated_uvtiles( DB::Transaction* transaction)
     }
 }
 
+// Checks reset_image_set() for file-based image sets with several frames and uvtiles, whose
+// mipmaps are created concurrently.
+void check_reset_image_set( DB::Transaction* transaction)
+{
+    mi::base::Uuid unknown_hash{0,0,0,0};
+
+    std::string root_path = TEST::mi_src_path( "io/image/image/tests/");
+    std::string missing   = root_path + "test_not_existing.png";  // fails with -5
+    std::string no_plugin = root_path + "CMakeLists.txt";         // fails with -3
+
+    // Frame numbers with gaps, uvtiles in no particular u/v order, and files of different
+    // resolutions and pixel types such that swapped mipmaps are detected.
+    std::vector<Test_file_frame> frames = {
+        { 2, { {  1, 0, root_path + "test_pt_rgb.tif"     },
+               {  0, 0, root_path + "test_simple.png"     },
+               { -1, 2, root_path + "test_pt_float32.tif" } } },
+        { 5, { {  0, 0, root_path + "test_frame_1.png"    } } },
+        { 7, { {  0, 1, root_path + "test_pt_rgba.tif"    },
+               {  3, 1, root_path + "test_pt_color.tif"   },
+               {  0, 0, root_path + "test_simple.jpg"     } } }
+    };
+
+    {
+        Test_file_image_set image_set( frames);
+        DBIMAGE::Image image;
+        mi::Sint32 result = image.reset_image_set( transaction, &image_set, unknown_hash);
+        MI_CHECK_EQUAL( result, 0);
+
+        MI_CHECK_EQUAL( image.get_length(), frames.size());
+        MI_CHECK_EQUAL( image.get_frame_id( 0), static_cast<mi::Size>( -1));
+        MI_CHECK_EQUAL( image.get_frame_id( 6), static_cast<mi::Size>( -1));
+
+        for( mi::Size f = 0; f < frames.size(); ++f) {
+
+            const Test_file_frame& frame = frames[f];
+            MI_CHECK_EQUAL( image.get_frame_number( f), frame.frame_number);
+            MI_CHECK_EQUAL( image.get_frame_id( frame.frame_number), f);
+            MI_CHECK_EQUAL( image.get_frame_length( f), frame.uvtiles.size());
+
+            for( mi::Size i = 0; i < frame.uvtiles.size(); ++i) {
+
+                const Test_file_uvtile& uvtile = frame.uvtiles[i];
+                MI_CHECK_EQUAL( image.get_filename( f, i), uvtile.filename);
+
+                mi::Sint32 u, v;
+                MI_CHECK_EQUAL( image.get_uvtile_uv( f, i, u, v), 0);
+                MI_CHECK_EQUAL( u, uvtile.u);
+                MI_CHECK_EQUAL( v, uvtile.v);
+                MI_CHECK_EQUAL( image.get_uvtile_id( f, u, v), i);
+
+                mi::base::Handle<const IMAGE::IMipmap> mipmap(
+                    image.get_mipmap( transaction, f, i));
+                mi::base::Handle<const mi::neuraylib::ICanvas> canvas( mipmap->get_level( 0));
+                mi::base::Handle<const IMAGE::IMipmap> expected_mipmap(
+                    g_image_module->create_mipmap(
+                        IMAGE::File_based(), uvtile.filename, /*selector*/ nullptr,
+                        /*only_first_level*/ true));
+                mi::base::Handle<const mi::neuraylib::ICanvas> expected_canvas(
+                    expected_mipmap->get_level( 0));
+                check_canvas_equal( canvas.get(), expected_canvas.get());
+            }
+        }
+    }
+
+    // A failing uvtile reports the error of the first failing uvtile in the order of the image
+    // set, independent of the order in which the uvtiles are processed.
+    std::vector<Test_file_frame> frames_5_3 = frames;
+    frames_5_3[0].uvtiles[2].filename = missing;
+    frames_5_3[2].uvtiles[1].filename = no_plugin;
+
+    std::vector<Test_file_frame> frames_3_5 = frames;
+    frames_3_5[0].uvtiles[1].filename = no_plugin;
+    frames_3_5[2].uvtiles[0].filename = missing;
+
+    for( int k = 0; k < 10; ++k) {
+
+        Test_file_image_set image_set_5_3( frames_5_3);
+        DBIMAGE::Image image_5_3;
+        mi::Sint32 result
+            = image_5_3.reset_image_set( transaction, &image_set_5_3, unknown_hash);
+        MI_CHECK_EQUAL( result, -5);
+        check_default_pink_dummy_mipmap( transaction, &image_5_3);
+
+        Test_file_image_set image_set_3_5( frames_3_5);
+        DBIMAGE::Image image_3_5;
+        result = image_3_5.reset_image_set( transaction, &image_set_3_5, unknown_hash);
+        MI_CHECK_EQUAL( result, -3);
+        check_default_pink_dummy_mipmap( transaction, &image_3_5);
+    }
+
+    // Errors of mipmaps take precedence over errors in the layout of later frames.
+    std::vector<Test_file_frame> frames_layout = frames_5_3;
+    frames_layout[2].uvtiles[1].u = 0;
+    frames_layout[2].uvtiles[1].v = 1;
+    {
+        Test_file_image_set image_set( frames_layout);
+        DBIMAGE::Image image;
+        mi::Sint32 result = image.reset_image_set( transaction, &image_set, unknown_hash);
+        MI_CHECK_EQUAL( result, -5);
+    }
+
+    frames_layout[0].uvtiles[2].filename = frames[0].uvtiles[2].filename;
+    {
+        Test_file_image_set image_set( frames_layout);
+        DBIMAGE::Image image;
+        mi::Sint32 result = image.reset_image_set( transaction, &image_set, unknown_hash);
+        MI_CHECK_EQUAL( result, -12);
+    }
+}
+
 void check_mdle( DB::Transaction* transaction)
 {
     // test loading images from MDLE files
@@ -931,8 +1194,16 @@ MI_TEST_AUTO_FUNCTION( test_dbimage )
     check_animated_textures( transaction);
     check_uvtiles( transaction);
     check_animated_uvtiles( transaction);
+    check_reset_image_set( transaction);
     check_mdle( transaction);
     check_sharing( transaction, "test_simple.png");
+    check_file_miplevels( transaction, /*use_file_miplevels*/ false);
+
+    // The registry key "image_use_file_miplevels" is read during module initialization.
+    g_image_module.reset();
+    config_module->override( "image_use_file_miplevels=1");
+    g_image_module.set();
+    check_file_miplevels( transaction, /*use_file_miplevels*/ true);
 
     transaction->commit();
 }
@@ -332,7 +332,11 @@ public:
     ///                                from the compiler.
     /// \param[out] module_tag_ident   The identifier of the already existing or just created DB
     ///                                element (only valid if the return value is 0 or 1).
-
+    /// \param precompiled_code_dag    The DAG representation of \p module taken from the
+    ///                                precompiled module store (before binding resources), or
+    ///                                \c NULL to compile \p module.
+    /// \param source_digests          The source digests of the current module load used for
+    ///                                the precompiled module store, or \c NULL.
     /// \return
     ///
     ///           -  1: Success (module exists already, was not created from \p module).
@@ -346,7 +350,9 @@ public:
         mi::mdl::IMDL* mdl,
         const mi::mdl::IModule* module,
         Execution_context* context,
-        Mdl_tag_ident* module_tag_ident = nullptr);
+        Mdl_tag_ident* module_tag_ident = nullptr,
+        mi::mdl::IGenerated_code_dag* precompiled_code_dag = nullptr,
+        Module_source_digests* source_digests = nullptr);
 
 private:
     /// Constructor.
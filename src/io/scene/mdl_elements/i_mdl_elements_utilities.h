@@ -70,6 +70,7 @@ class ISerialized_function_name;
 } }
 
 namespace mi { namespace mdl {
+class IEntity_resolver;
 class IGenerated_code_dag;
 class IInput_stream;
 class IMDL;
@@ -610,6 +611,7 @@ private:
 #define MDL_CTX_OPTION_DEPRECATED_REPLACE_EXISTING         "replace_existing"
 #define MDL_CTX_OPTION_TARGET_MATERIAL_MODEL_MODE          "target_material_model_mode"
 #define MDL_CTX_OPTION_USER_DATA                           "user_data"
+#define MDL_CTX_OPTION_PARALLEL_IMPORT_LOADING             "parallel_import_loading"
 // Not documented in the API (used by the module transformer, but not for general use).
 #define MDL_CTX_OPTION_KEEP_ORIGINAL_RESOURCE_FILE_PATHS   "keep_original_resource_file_paths"
 
@@ -1317,6 +1319,129 @@ private:
     bool m_is_processing;
 };
 
+// ********** Precompiled_module_store ************************************************************
+
+/// Memoizes the MD5 digests of module sources used by #Precompiled_module_store.
+///
+/// One instance is used for the duration of a module load (including all its imports), such that
+/// each source is read and hashed at most once. Changes of the sources during the load are not
+/// noticed. Not thread-safe.
+class Module_source_digests
+{
+public:
+    /// Returns the MD5 digest of the source of module \p core_name as hex string.
+    ///
+    /// Returns the empty string if the module cannot be resolved or opened.
+    const std::string& get(
+        mi::mdl::IEntity_resolver* resolver,
+        mi::mdl::IThread_context* ctx,
+        const char* core_name);
+
+private:
+    /// Computes the MD5 digest of the source of module \p core_name as hex string.
+    static std::string compute(
+        mi::mdl::IEntity_resolver* resolver,
+        mi::mdl::IThread_context* ctx,
+        const char* core_name);
+
+    /// The digests computed so far, keyed by core name.
+    std::map<std::string, std::string> m_digests;
+};
+
+/// Persistent store for precompiled modules.
+///
+/// Each entry holds a serialized module together with its serialized DAG representation before
+/// resources are bound to DB elements. The entries are keyed by the module name, the MD5 digest
+/// of the module source, and the compiler options that affect the result. Each entry also records
+/// the source digests of all transitively imported modules, the entry is only used if all of
+/// them still match. Entries are written atomically, i.e., several processes can share a store.
+///
+/// The store is enabled by setting the registry value "mdl_precompiled_module_path" to a
+/// directory.
+class Precompiled_module_store
+{
+public:
+    /// A module and its DAG representation read from the store.
+    struct Entry
+    {
+        mi::base::Handle<const mi::mdl::IModule> m_module;
+        mi::base::Handle<const mi::mdl::IGenerated_code_dag> m_code_dag;
+    };
+
+    /// Constructor.
+    ///
+    /// \param path   The directory holding the entries. Created on demand.
+    explicit Precompiled_module_store( const std::string& path);
+
+    /// Indicates whether the store can be used with the options in \p context.
+    static bool is_supported( const Execution_context* context);
+
+    /// Looks up the entry for a module.
+    ///
+    /// \param resolver       The entity resolver used to locate the module sources.
+    /// \param ctx            The thread context used for the module resolution.
+    /// \param core_name      The core name of the module.
+    /// \param context        The execution context with the compiler options.
+    /// \param[out] entry     The deserialized module and its DAG representation.
+    /// \param digests        The source digests of the current module load, or \c NULL.
+    /// \return               \c true in case of success, \c false if there is no valid entry.
+    bool load(
+        mi::mdl::IEntity_resolver* resolver,
+        mi::mdl::IThread_context* ctx,
+        const char* core_name,
+        const Execution_context* context,
+        Entry& entry,
+        Module_source_digests* digests = nullptr) const;
+
+    /// Writes the entry for a module. Failures are ignored.
+    ///
+    /// \param mdl            The IMDL instance.
+    /// \param module         The module to store.
+    /// \param code_dag_data  The serialized DAG representation of the module, see
+    ///                       #serialize_code_dag().
+    /// \param imports        The core names of all transitively imported modules.
+    /// \param context        The execution context with the compiler options.
+    /// \param digests        The source digests of the current module load, or \c NULL.
+    void store(
+        mi::mdl::IMDL* mdl,
+        const mi::mdl::IModule* module,
+        const std::vector<mi::Uint8>& code_dag_data,
+        const std::vector<std::string>& imports,
+        const Execution_context* context,
+        Module_source_digests* digests = nullptr) const;
+
+    /// Serializes a DAG representation for #store().
+    static std::vector<mi::Uint8> serialize_code_dag( const mi::mdl::IGenerated_code_dag* code_dag);
+
+private:
+    /// Returns the file name of the entry for a module with the given source digest.
+    std::string get_entry_filename(
+        const char* core_name,
+        const std::string& source_digest,
+        const Execution_context* context) const;
+
+    /// The directory holding the entries.
+    std::string m_path;
+    /// Counter for unique names of temporary files.
+    mutable std::atomic<mi::Uint32> m_tmp_counter;
+};
+
+/// Used by the module cache to obtain modules from the precompiled module store.
+class Precompiled_module_loader
+{
+public:
+    virtual ~Precompiled_module_loader() = default;
+
+    /// Creates the DB element for the module \p core_name from the precompiled module store.
+    ///
+    /// Called by the thread responsible for loading the module. In case of success, the waiting
+    /// threads are notified by the loader.
+    ///
+    /// \return   \c true if the module is in the DB afterwards, \c false if it needs to be
+    ///           compiled.
+    virtual bool load_precompiled_module( const char* core_name) = 0;
+};
+
 // ********** Module_cache ************************************************************************
 
 /// Adapts the DB (or rather a transaction) to the IModule_cache interface.
@@ -1427,12 +1552,16 @@ public:
     /// \return                 The identifier.
     size_t get_loading_context_id() const { return m_context_id; }
 
+    /// Set the loader for precompiled modules (or \c NULL to always compile modules).
+    void set_precompiled_module_loader(Precompiled_module_loader* loader);
+
 private:
 
     size_t m_context_id;
     DB::Transaction* m_transaction;
     Mdl_module_wait_queue* m_queue;
     mi::mdl::IModule_loaded_callback* m_module_load_callback;
+    Precompiled_module_loader* m_precompiled_module_loader;
     mi::base::Handle<const mi::neuraylib::IMdl_loading_wait_handle_factory>
         m_default_wait_handle_factory;
     mi::base::Handle<const mi::neuraylib::IMdl_loading_wait_handle_factory>
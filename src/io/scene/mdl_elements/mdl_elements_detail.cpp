@@ -1016,6 +1016,24 @@ const char* Input_stream_impl::get_filename()
     return !m_filename.empty() ? m_filename.c_str() : nullptr;
 }
 
+const char* Input_stream_impl::get_view( size_t& length)
+{
+    // Reserve the remaining size if known, but read until the end in any case.
+    if( m_reader->supports_absolute_access()) {
+        mi::Sint64 remaining = m_reader->get_file_size() - m_reader->tell_absolute();
+        if( remaining > 0)
+            m_view.reserve( static_cast<size_t>( remaining));
+    }
+
+    char chunk[4096];
+    mi::Sint64 result;
+    while( (result = m_reader->read( chunk, sizeof( chunk))) > 0)
+        m_view.append( chunk, static_cast<size_t>( result));
+
+    length = m_view.size();
+    return m_view.c_str();
+}
+
 Mdle_input_stream_impl::Mdle_input_stream_impl(
     mi::neuraylib::IReader* reader, const std::string& filename)
   : Input_stream_impl( reader, filename)
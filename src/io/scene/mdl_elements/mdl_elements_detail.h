@@ -526,7 +526,10 @@ private:
 };
 
 /// Adapts mi::neuraylib::IReader to mi::mdl::Input_stream.
-class Input_stream_impl : public mi::base::Interface_implement<mi::mdl::IInput_stream>
+///
+/// Implements mi::mdl::IInput_stream_view such that the MDL scanner reads the module source in
+/// one block instead of calling IReader::read() for every character.
+class Input_stream_impl : public mi::base::Interface_implement<mi::mdl::IInput_stream_view>
 {
 public:
     Input_stream_impl( mi::neuraylib::IReader* reader, const std::string& filename);
@@ -537,9 +540,13 @@ public:
 
     const char* get_filename();
 
+    /// Reads the rest of the reader into a buffer owned by this stream.
+    const char* get_view( size_t& length);
+
 private:
     mi::base::Handle<mi::neuraylib::IReader> m_reader;
     std::string m_filename;
+    std::string m_view;
 };
 
 /// Adapts mi::neuraylib::IWriter to MDL::Output_stream.
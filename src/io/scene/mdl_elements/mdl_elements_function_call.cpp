@@ -795,8 +795,9 @@ mi::mdl::IGenerated_code_lambda_function* Mdl_function_call::create_jitted_funct
         jitted_func = generator_jit->compile_into_switch_function(
             lambda_func.get(), &module_cache, &resolver, /*ctx=*/nullptr, 1, 0);
     } else {
+        mi::base::Handle<mi::mdl::ICode_cache> code_cache(mdlc_module->get_code_cache());
         jitted_func = generator_jit->compile_into_environment(
-            lambda_func.get(), &module_cache, &resolver, /*ctx=*/nullptr);
+            code_cache.get(), lambda_func.get(), &module_cache, &resolver, /*ctx=*/nullptr);
     }
     if( !jitted_func) {
         *errors = -4;
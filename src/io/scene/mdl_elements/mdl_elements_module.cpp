@@ -42,6 +42,10 @@
 #include "mdl_elements_expression.h"
 #include "mdl_elements_utilities.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
 #include <mutex>
 #include <sstream>
 #include <thread>
@@ -50,7 +54,10 @@
 #include <mi/mdl/mdl_generated_dag.h>
 #include <mi/mdl/mdl_mdl.h>
 #include <mi/mdl/mdl_modules.h>
+#include <mi/mdl/mdl_declarations.h>
 #include <mi/mdl/mdl_definitions.h>
+#include <mi/mdl/mdl_entity_resolver.h>
+#include <mi/mdl/mdl_streams.h>
 #include <mi/mdl/mdl_thread_context.h>
 #include <mi/neuraylib/istring.h>
 #include <base/system/main/access_module.h>
@@ -58,6 +65,7 @@
 #include <boost/core/ignore_unused.hpp>
 #include <base/lib/log/i_log_logger.h>
 #include <base/data/db/i_db_access.h>
+#include <base/data/db/i_db_fragmented_job.h>
 #include <base/data/db/i_db_transaction.h>
 #include <base/data/serial/i_serial_buffer_serializer.h>
 #include <base/data/serial/i_serializer.h>
@@ -94,7 +102,8 @@ private:
     mi::base::Handle<const mi::mdl::IModule> m_module;
 };
 
-class Module_loaded_callback : public mi::mdl::IModule_loaded_callback
+class Module_loaded_callback
+  : public mi::mdl::IModule_loaded_callback, public Precompiled_module_loader
 {
 public:
     using Register_internal_func = Sint32 (*)(
@@ -102,7 +111,9 @@ public:
         mi::mdl::IMDL*,
         const mi::mdl::IModule*,
         Execution_context*,
-        Mdl_tag_ident*);
+        Mdl_tag_ident*,
+        mi::mdl::IGenerated_code_dag*,
+        Module_source_digests*);
 
     Module_loaded_callback(
         Register_internal_func func,
@@ -128,7 +139,8 @@ public:
         if (m_mdl->is_builtin_module(core_name))
         {
             // no notify call here, just registering
-            int res = int(m_register_internal(m_transaction, m_mdl, module, m_context, nullptr));
+            int res = int(m_register_internal(
+                m_transaction, m_mdl, module, m_context, nullptr, nullptr, nullptr));
             if (res < 0)
             {
                 return int(add_error_message(m_context,
@@ -160,7 +172,8 @@ public:
         ASSERT(M_SCENE, module->is_valid() && "The module to register is invalid");
 
         // add the module and its content to the database
-        int res = int(m_register_internal(m_transaction, m_mdl, module, m_context, nullptr));
+        int res = int(m_register_internal(
+            m_transaction, m_mdl, module, m_context, nullptr, nullptr, &m_source_digests));
 
         // inform the waiting threads in case of success and case of failure
         m_cache->notify(core_name, res);
@@ -190,6 +203,49 @@ public:
         return m_transaction->name_to_tag(db_name.c_str()).is_valid();
     }
 
+    /// Called by the module cache before compiling a module on this thread.
+    bool load_precompiled_module(const char* core_name) override
+    {
+        if (m_mdl->is_builtin_module(core_name) || is_mdle(core_name))
+            return false;
+
+        SYSTEM::Access_module<MDLC::Mdlc_module> mdlc_module(false);
+        Precompiled_module_store* store = mdlc_module->get_precompiled_module_store();
+        if (!store)
+            return false;
+
+        mi::base::Handle<mi::mdl::IThread_context> ctx(create_thread_context(m_mdl, m_context));
+        mi::base::Handle<mi::mdl::IEntity_resolver> resolver(m_mdl->get_entity_resolver(m_cache));
+
+        Precompiled_module_store::Entry entry;
+        if (!store->load(resolver.get(), ctx.get(), core_name, m_context, entry,
+                &m_source_digests))
+            return false;
+
+        // the imported modules need to be in the DB before the module can be registered, load
+        // them via the regular mechanism (which might use the store again)
+        for (mi::Uint32 i = 0, n = entry.m_code_dag->get_import_count(); i < n; ++i)
+        {
+            mi::base::Handle<const mi::mdl::IModule> import(
+                m_mdl->load_module(ctx.get(), entry.m_code_dag->get_import(i), m_cache));
+            if (!import || !import->is_valid())
+                return false;
+        }
+
+        // the deserialized DAG is not shared, binding its resources is the only modification
+        mi::base::Handle<mi::mdl::IGenerated_code_dag> code_dag(
+            const_cast<mi::mdl::IGenerated_code_dag*>(entry.m_code_dag.get()),
+            mi::base::DUP_INTERFACE);
+        int res = int(m_register_internal(m_transaction, m_mdl, entry.m_module.get(), m_context,
+            nullptr, code_dag.get(), &m_source_digests));
+        if (res < 0)
+            return false;
+
+        // inform the waiting threads, failures are handled by the regular loading instead
+        m_cache->notify(core_name, res);
+        return true;
+    }
+
 private:
     Register_internal_func m_register_internal;
     DB::Transaction* m_transaction;
@@ -197,8 +253,420 @@ private:
     Module_cache* m_cache;
     Execution_context* m_context;
     std::set<std::string> m_registered_builtins;
+    /// Source digests for the precompiled module store, shared by all modules of this load.
+    Module_source_digests m_source_digests;
+};
+
+/// Name of a module imported by another module, as used in the import declaration.
+struct Import_name
+{
+    /// The (possibly relative) module name.
+    std::string m_name;
+    /// Indicates a weak relative name that is tried as absolute name if it cannot be resolved.
+    bool m_is_weak = false;
 };
 
+/// Computes the name of a module imported by \p module.
+///
+/// Namespace aliases are substituted and weak relative names are converted in the same way as by
+/// the analysis of the MDL compiler. Returns \c false for invalid names, which are reported by the
+/// MDL compiler later.
+///
+/// \param module        The (parsed) importing module.
+/// \param aliases       The namespace aliases declared by \p module so far.
+/// \param name          The qualified name from the import declaration.
+/// \param ignore_last   Indicates whether the last component names an entity (or "*") instead of
+///                      a package or module.
+/// \param[out] result   The name of the imported module.
+bool get_import_name(
+    const mi::mdl::Module* module,
+    const std::map<std::string, std::string>& aliases,
+    const mi::mdl::IQualified_name* name,
+    bool ignore_last,
+    Import_name& result)
+{
+    bool is_absolute = name->is_absolute();
+    std::string import_name = is_absolute ? "::" : "";
+
+    int n = name->get_component_count() - (ignore_last ? 1 : 0);
+    if( n <= 0)
+        return false;
+
+    for( int i = 0; i < n; ++i) {
+        // absolute aliases already end with a separator
+        if( i > 0 && import_name.back() != ':')
+            import_name += "::";
+
+        std::string component = name->get_component( i)->get_symbol()->get_name();
+        auto it = aliases.find( component);
+        if( it != aliases.end()) {
+            component = it->second;
+            if( component[0] == ':') {
+                if( is_absolute || i > 0)
+                    return false;
+                is_absolute = true;
+            }
+        }
+        import_name += component;
+    }
+
+    result.m_is_weak = false;
+    if( !is_absolute && import_name[0] != '.') {
+        // weak relative names are relative names, prior to MDL 1.6 they fall back to absolute
+        // names, and in string-based modules they are always absolute
+        bool is_mdl_16 = module->get_mdl_version() >= mi::mdl::IMDL::MDL_VERSION_1_6;
+        const char* file_name = module->get_filename();
+        if( !is_mdl_16 && (!file_name || !file_name[0])) {
+            import_name = "::" + import_name;
+        } else {
+            import_name = ".::" + import_name;
+            result.m_is_weak = !is_mdl_16;
+        }
+    }
+
+    result.m_name = import_name;
+    return true;
+}
+
+/// Computes the names of the modules imported by a module.
+///
+/// The module source is parsed by the MDL compiler, but not analyzed. Only the import
+/// declarations and namespace aliases at the beginning of the module are considered, they precede
+/// all other declarations. Syntax errors are ignored, they are reported when the module is
+/// actually loaded.
+///
+/// \param mdl           The MDL compiler.
+/// \param ctx           The thread context.
+/// \param module        The resolved module.
+/// \param[out] names    The names of the imported modules.
+void get_import_names(
+    mi::mdl::IMDL* mdl,
+    mi::mdl::IThread_context* ctx,
+    mi::mdl::IMDL_import_result* module,
+    std::vector<Import_name>& names)
+{
+    mi::base::Handle<mi::mdl::IInput_stream> stream( module->open( ctx));
+    if( !stream)
+        return;
+
+    mi::mdl::MDL* mdl_impl = mi::mdl::impl_cast<mi::mdl::MDL>( mdl);
+    mi::base::Handle<mi::mdl::Module> parsed_module( mdl_impl->parse_module(
+        ctx, module->get_absolute_name(), stream.get(), mi::mdl::Module::MF_STANDARD));
+    if( !parsed_module)
+        return;
+
+    std::map<std::string, std::string> aliases;
+    Import_name name;
+
+    for( int i = 0, n = parsed_module->get_declaration_count(); i < n; ++i) {
+        const mi::mdl::IDeclaration* decl = parsed_module->get_declaration( i);
+        switch( decl->get_kind()) {
+
+            case mi::mdl::IDeclaration::DK_IMPORT: {
+                const auto* import_decl = mi::mdl::cast<mi::mdl::IDeclaration_import>( decl);
+                const mi::mdl::IQualified_name* module_name = import_decl->get_module_name();
+                if( module_name) {
+                    // "using M import ..."
+                    if( get_import_name( parsed_module.get(), aliases, module_name, false, name))
+                        names.push_back( name);
+                    break;
+                }
+                for( int j = 0, m = import_decl->get_name_count(); j < m; ++j)
+                    if( get_import_name(
+                        parsed_module.get(), aliases, import_decl->get_name( j), true, name))
+                        names.push_back( name);
+                break;
+            }
+
+            case mi::mdl::IDeclaration::DK_NAMESPACE_ALIAS: {
+                const auto* alias_decl
+                    = mi::mdl::cast<mi::mdl::IDeclaration_namespace_alias>( decl);
+                const mi::mdl::IQualified_name* ns = alias_decl->get_namespace();
+                std::string ns_name = ns->is_absolute() ? "::" : "";
+                for( int j = 0, m = ns->get_component_count(); j < m; ++j) {
+                    if( j > 0)
+                        ns_name += "::";
+                    ns_name += ns->get_component( j)->get_symbol()->get_name();
+                }
+                aliases.emplace(
+                    alias_decl->get_alias()->get_symbol()->get_name(), std::move( ns_name));
+                break;
+            }
+
+            default:
+                return;
+        }
+    }
+}
+
+/// Loads the modules of an import graph concurrently.
+///
+/// All fragments take modules from a shared queue of ready modules. A module becomes ready as soon
+/// as all its imports are loaded, independent of other modules on the same depth of the import
+/// graph. If a module fails to load, all modules (transitively) importing it are skipped.
+///
+/// Each module is loaded with its own execution context. The messages of successfully loaded
+/// modules are merged into the context of the caller afterwards.
+class Load_modules_job : public DB::Fragmented_job
+{
+public:
+    /// Constructor.
+    ///
+    /// \param mdl_names   The MDL names of the modules to load, imported modules precede
+    ///                    importing modules.
+    /// \param imports     The indices of the imported modules of each module in \p mdl_names.
+    /// \param context     The execution context of the caller, used as template for the
+    ///                    contexts of the modules.
+    Load_modules_job(
+        const std::vector<std::string>& mdl_names,
+        const std::vector<std::vector<size_t>>& imports,
+        const Execution_context* context)
+      : m_mdl_names( mdl_names)
+      , m_contexts( mdl_names.size(), *context)
+      , m_results( mdl_names.size(), 0)
+      , m_pending_imports( mdl_names.size(), 0)
+      , m_importers( mdl_names.size())
+      , m_remaining( mdl_names.size())
+    {
+        for( auto& module_context : m_contexts) {
+            module_context.clear_messages();
+            module_context.set_result( 0);
+            module_context.set_option( MDL_CTX_OPTION_PARALLEL_IMPORT_LOADING, false);
+        }
+
+        for( size_t i = 0, n = mdl_names.size(); i < n; ++i) {
+            m_pending_imports[i] = imports[i].size();
+            for( size_t import: imports[i])
+                m_importers[import].push_back( i);
+            if( imports[i].empty())
+                m_ready.push_back( i);
+        }
+    }
+
+    void execute_fragment(
+        DB::Transaction* transaction,
+        size_t index,
+        size_t count,
+        const mi::neuraylib::IJob_execution_context* context) override
+    {
+        std::unique_lock<std::mutex> lock( m_mutex);
+
+        for( ;;) {
+            m_condition.wait( lock, [this]() { return !m_ready.empty() || m_remaining == 0; });
+            if( m_ready.empty())
+                return;
+
+            size_t module_index = m_ready.front();
+            m_ready.pop_front();
+
+            lock.unlock();
+            mi::Sint32 result = Mdl_module::create_module(
+                transaction, m_mdl_names[module_index].c_str(), &m_contexts[module_index]);
+            lock.lock();
+
+            finish_module( module_index, result);
+            m_condition.notify_all();
+        }
+    }
+
+    /// Merges the messages of the successfully loaded modules into \p context.
+    ///
+    /// The messages are merged in the order of the modules passed to the constructor, independent
+    /// of the order in which the modules were loaded. Messages of failed modules are dropped since
+    /// loading of the importing module reports them again.
+    void merge_messages( Execution_context* context) const
+    {
+        for( size_t i = 0, n = m_contexts.size(); i < n; ++i) {
+            if( m_results[i] < 0)
+                continue;
+            for( mi::Size j = 0, m = m_contexts[i].get_messages_count(); j < m; ++j)
+                context->add_message( m_contexts[i].get_message( j));
+        }
+    }
+
+private:
+    /// Records the result of a module and schedules or skips the modules importing it.
+    ///
+    /// Needs to be called with #m_mutex locked.
+    void finish_module( size_t module_index, mi::Sint32 result)
+    {
+        m_results[module_index] = result;
+        --m_remaining;
+
+        for( size_t importer: m_importers[module_index]) {
+            if( result < 0)
+                m_results[importer] = -1;
+            if( --m_pending_imports[importer] > 0)
+                continue;
+            if( m_results[importer] < 0)
+                finish_module( importer, m_results[importer]);
+            else
+                m_ready.push_back( importer);
+        }
+    }
+
+    std::vector<std::string> m_mdl_names;
+    std::vector<Execution_context> m_contexts;
+    std::vector<mi::Sint32> m_results;
+    /// The number of not yet loaded imports of each module.
+    std::vector<size_t> m_pending_imports;
+    /// The indices of the importing modules of each module.
+    std::vector<std::vector<size_t>> m_importers;
+
+    /// Protects the members below and the members above after construction.
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    /// The modules whose imports have been loaded, but which are not yet loaded themselves.
+    std::deque<size_t> m_ready;
+    /// The number of modules neither loaded nor skipped yet.
+    size_t m_remaining;
+};
+
+/// Node of the import graph built by #load_imports_in_parallel().
+struct Import_node
+{
+    /// The core names of the imported modules that are not in the DB yet.
+    std::vector<std::string> m_imports;
+    /// Indicates that the node is currently being visited by #sort_import_graph().
+    bool m_visiting = false;
+    /// Indicates that the node has been visited by #sort_import_graph().
+    bool m_visited = false;
+};
+
+using Import_graph = std::map<std::string, Import_node>;
+
+/// Sorts the import graph topologically, i.e., the core names of all imported modules are
+/// appended to \p order before \p core_name itself. Import loops are broken by removing the
+/// corresponding edges, they are reported by the MDL compiler.
+void sort_import_graph(
+    Import_graph& graph, const std::string& core_name, std::vector<std::string>& order)
+{
+    Import_node& node = graph[core_name];
+    if( node.m_visited)
+        return;
+
+    node.m_visiting = true;
+    for( auto it = node.m_imports.begin(); it != node.m_imports.end(); ) {
+        if( graph[*it].m_visiting) {
+            it = node.m_imports.erase( it);
+            continue;
+        }
+        sort_import_graph( graph, *it, order);
+        ++it;
+    }
+    node.m_visiting = false;
+    node.m_visited = true;
+    order.push_back( core_name);
+}
+
+/// Loads the transitively imported modules of a module concurrently.
+///
+/// The import graph is built upfront by parsing the modules and extracting their import
+/// declarations. The imported modules are then loaded via a fragmented job which schedules each
+/// module as soon as its own imports are in the DB. The module itself is not loaded.
+///
+/// All errors are ignored here. The graph is only a scheduling hint: the regular loading of the
+/// module afterwards picks up all modules loaded here from the DB, loads modules missed here,
+/// and reports any failures. Duplicate work with other threads is avoided by the module wait
+/// queue.
+void load_imports_in_parallel(
+    DB::Transaction* transaction,
+    mi::mdl::IMDL* mdl,
+    Module_cache* module_cache,
+    const std::string& core_module_name,
+    Execution_context* context)
+{
+    mi::base::Handle<mi::mdl::IThread_context> ctx( create_thread_context( mdl, context));
+    mi::base::Handle<mi::mdl::IEntity_resolver> resolver( mdl->get_entity_resolver( module_cache));
+
+    auto is_pending = [&]( const char* core_name) {
+        if( mdl->is_builtin_module( core_name))
+            return false;
+        std::string db_name = get_db_name( encode_module_name( core_name));
+        std::unique_lock<std::mutex> lock( DETAIL::g_transaction_mutex);
+        return transaction->name_to_tag( db_name.c_str()).is_invalid();
+    };
+
+    mi::base::Handle<mi::mdl::IMDL_import_result> top( resolver->resolve_module(
+        core_module_name.c_str(), /*owner_file_path*/ nullptr, /*owner_name*/ nullptr,
+        /*pos*/ nullptr, ctx.get()));
+    if( !top)
+        return;
+
+    // Build the import graph.
+    Import_graph graph;
+    std::vector<mi::base::Handle<mi::mdl::IMDL_import_result>> worklist;
+    std::string top_name = top->get_absolute_name();
+    graph[top_name];
+    worklist.push_back( top);
+
+    while( !worklist.empty()) {
+        mi::base::Handle<mi::mdl::IMDL_import_result> result( worklist.back());
+        worklist.pop_back();
+
+        std::vector<Import_name> names;
+        get_import_names( mdl, ctx.get(), result.get(), names);
+
+        std::string owner_name = result->get_absolute_name();
+        const char* owner_file_name = result->get_file_name();
+
+        for( const auto& name: names) {
+            mi::base::Handle<mi::mdl::IMDL_import_result> import( resolver->resolve_module(
+                name.m_name.c_str(), owner_file_name, owner_name.c_str(),
+                /*pos*/ nullptr, ctx.get()));
+            if( !import && name.m_is_weak)
+                import = resolver->resolve_module(
+                    name.m_name.c_str() + 1, owner_file_name, owner_name.c_str(),
+                    /*pos*/ nullptr, ctx.get());
+            if( !import)
+                continue;
+
+            std::string core_import_name = import->get_absolute_name();
+            if( !is_pending( core_import_name.c_str()))
+                continue;
+
+            std::vector<std::string>& imports = graph[owner_name].m_imports;
+            if( std::find( imports.begin(), imports.end(), core_import_name) != imports.end())
+                continue;
+            imports.push_back( core_import_name);
+
+            if( graph.find( core_import_name) == graph.end()) {
+                graph[core_import_name];
+                worklist.push_back( import);
+            }
+        }
+    }
+
+    if( graph.size() < 2)
+        return;
+
+    // Sort the imported modules topologically. The top module comes last and is dropped.
+    std::vector<std::string> order;
+    sort_import_graph( graph, top_name, order);
+    ASSERT( M_SCENE, !order.empty() && order.back() == top_name);
+    order.pop_back();
+
+    std::map<std::string, size_t> indices;
+    for( size_t i = 0, n = order.size(); i < n; ++i)
+        indices[order[i]] = i;
+
+    std::vector<std::string> mdl_names;
+    std::vector<std::vector<size_t>> imports( order.size());
+    for( size_t i = 0, n = order.size(); i < n; ++i) {
+        mdl_names.push_back( encode_module_name( order[i]));
+        for( const auto& import: graph[order[i]].m_imports)
+            imports[i].push_back( indices[import]);
+    }
+
+    LOG::mod_log->debug( M_SCENE, LOG::Mod_log::C_DATABASE,
+        "Loading %zu imported modules of \"%s\".", order.size(), core_module_name.c_str());
+
+    Load_modules_job job( mdl_names, imports, context);
+    size_t thread_count = std::max( 1u, std::thread::hardware_concurrency());
+    transaction->execute_fragmented( &job, std::min( order.size(), thread_count));
+    job.merge_messages( context);
+}
+
 }  // anonymous
 
 mi::Sint32 Mdl_module::create_module(
@@ -298,6 +766,18 @@ mi::Sint32 Mdl_module::create_module(
         &create_module_internal, transaction, mdl.get(), &module_cache, context);
     module_cache.set_module_loading_callback( &cb);
 
+    // Take modules from the precompiled module store if possible
+    if(    !mdle_module
+        && mdlc_module->get_precompiled_module_store()
+        && Precompiled_module_store::is_supported( context))
+        module_cache.set_precompiled_module_loader( &cb);
+
+    // Load the imported modules concurrently if requested. The sequential loading below then
+    // finds them in the DB.
+    if( !mdle_module && context->get_option<bool>( MDL_CTX_OPTION_PARALLEL_IMPORT_LOADING))
+        load_imports_in_parallel(
+            transaction, mdl.get(), &module_cache, core_load_module_arg, context);
+
     mi::base::Handle<mi::mdl::IThread_context> ctx( create_thread_context( mdl.get(), context));
 
     mi::base::Handle<const mi::mdl::IModule> module(
@@ -417,8 +897,8 @@ bool Mdl_module::supports_reload() const
 
 namespace {
 
-mi::mdl::IGenerated_code_dag* generate_dag(
-    DB::Transaction* transaction,
+/// Compiles \p module into its DAG representation. The imports of \p module need to be restored.
+mi::mdl::IGenerated_code_dag* compile_dag(
     mi::mdl::IMDL* mdl,
     const mi::mdl::IModule* module,
     Execution_context* context)
@@ -452,18 +932,6 @@ mi::mdl::IGenerated_code_dag* generate_dag(
         options.set_option(MDL_CG_DAG_OPTION_TARGET_MATERIAL_MODE, "true");
     }
 
-    {
-        std::unique_lock<std::mutex> lock(DETAIL::g_transaction_mutex);
-        Module_cache module_cache(transaction, mdlc_module->get_module_wait_queue(), {});
-        if (!module->restore_import_entries(&module_cache)) {
-            LOG::mod_log->error(M_SCENE, LOG::Mod_log::C_DATABASE,
-                "Failed to restore imports of module \"%s\".", module->get_name());
-            context->set_result(-4);
-            return nullptr;
-        }
-    }
-
-    Drop_import_scope scope(module);
     mi::base::Handle<mi::mdl::IGenerated_code> code(generator_dag->compile(module));
     if (!code.is_valid_interface()) {
         context->set_result(-2);
@@ -480,8 +948,50 @@ mi::mdl::IGenerated_code_dag* generate_dag(
     }
 
     ASSERT(M_SCENE, code->get_kind() == mi::mdl::IGenerated_code::CK_DAG);
-    mi::base::Handle<mi::mdl::IGenerated_code_dag> code_dag(
-        code->get_interface<mi::mdl::IGenerated_code_dag>());
+    return code->get_interface<mi::mdl::IGenerated_code_dag>();
+}
+
+/// Computes the DAG representation of \p module and binds its resources to DB elements (if
+/// requested by the context).
+///
+/// If \p precompiled_code_dag is given, it is used instead of compiling the module. Otherwise, if
+/// \p code_dag_data is given, the DAG representation is serialized into it before the resources
+/// are bound (see #Precompiled_module_store).
+mi::mdl::IGenerated_code_dag* generate_dag(
+    DB::Transaction* transaction,
+    mi::mdl::IMDL* mdl,
+    const mi::mdl::IModule* module,
+    Execution_context* context,
+    mi::mdl::IGenerated_code_dag* precompiled_code_dag = nullptr,
+    std::vector<mi::Uint8>* code_dag_data = nullptr)
+{
+    SYSTEM::Access_module<MDLC::Mdlc_module> mdlc_module(false);
+
+    {
+        std::unique_lock<std::mutex> lock(DETAIL::g_transaction_mutex);
+        Module_cache module_cache(transaction, mdlc_module->get_module_wait_queue(), {});
+        if (!module->restore_import_entries(&module_cache)) {
+            LOG::mod_log->error(M_SCENE, LOG::Mod_log::C_DATABASE,
+                "Failed to restore imports of module \"%s\".", module->get_name());
+            context->set_result(-4);
+            return nullptr;
+        }
+    }
+
+    Drop_import_scope scope(module);
+
+    mi::base::Handle<mi::mdl::IGenerated_code_dag> code_dag;
+    if (precompiled_code_dag) {
+        // replay the messages of the original compilation
+        code_dag = mi::base::make_handle_dup(precompiled_code_dag);
+        convert_and_log_messages(code_dag->access_messages(), context);
+    } else {
+        code_dag = compile_dag(mdl, module, context);
+        if (!code_dag)
+            return nullptr;
+        if (code_dag_data)
+            *code_dag_data = Precompiled_module_store::serialize_code_dag(code_dag.get());
+    }
 
     if (context->get_option<bool>(MDL_CTX_OPTION_RESOLVE_RESOURCES)) {
 
@@ -504,6 +1014,36 @@ mi::mdl::IGenerated_code_dag* generate_dag(
     return code_dag.get();
 }
 
+/// Collects the core names of all (direct and indirect) imports in the DB that are loaded from
+/// files.
+void collect_transitive_imports(
+    DB::Transaction* transaction,
+    const std::vector<Mdl_tag_ident>& imports,
+    std::vector<std::string>& names)
+{
+    std::set<DB::Tag> visited;
+    std::vector<DB::Tag> worklist;
+    for( const auto& import: imports)
+        worklist.push_back( import.first);
+
+    while( !worklist.empty()) {
+        DB::Tag tag = worklist.back();
+        worklist.pop_back();
+        if( !visited.insert( tag).second)
+            continue;
+
+        // Built-in modules do not have sources that could change.
+        DB::Access<Mdl_module> module( tag, transaction);
+        mi::base::Handle<const mi::mdl::IModule> mdl_module( module->get_mdl_module());
+        if( mdl_module->get_filename()[0] == '\0')
+            continue;
+
+        names.push_back( mdl_module->get_name());
+        for( mi::Size i = 0, n = module->get_import_count(); i < n; ++i)
+            worklist.push_back( module->get_import( i));
+    }
+}
+
 } // namespace
 
 mi::Sint32 Mdl_module::create_module_internal(
@@ -511,7 +1051,9 @@ mi::Sint32 Mdl_module::create_module_internal(
     mi::mdl::IMDL* mdl,
     const mi::mdl::IModule* module,
     Execution_context* context,
-    Mdl_tag_ident* module_tag_ident)
+    Mdl_tag_ident* module_tag_ident,
+    mi::mdl::IGenerated_code_dag* precompiled_code_dag,
+    Module_source_digests* source_digests)
 {
     std::unique_lock<std::mutex> lock( DETAIL::g_transaction_mutex);
 
@@ -556,9 +1098,20 @@ mi::Sint32 Mdl_module::create_module_internal(
     LOG::mod_log->debug( M_SCENE, LOG::Mod_log::C_DATABASE,
         "  Module (core module name): \"%s\"", core_module_name);
 
+    // Modules loaded from files are added to the precompiled module store (if enabled), unless
+    // they have been taken from there.
+    SYSTEM::Access_module<MDLC::Mdlc_module> mdlc_module( false);
+    Precompiled_module_store* store = mdlc_module->get_precompiled_module_store();
+    if(    precompiled_code_dag
+        || !module_filename
+        || is_mdle( core_module_name)
+        || !Precompiled_module_store::is_supported( context))
+        store = nullptr;
+
     // Compile the module.
-    mi::base::Handle<mi::mdl::IGenerated_code_dag> code_dag(
-        generate_dag( transaction, mdl, module, context));
+    std::vector<mi::Uint8> code_dag_data;
+    mi::base::Handle<mi::mdl::IGenerated_code_dag> code_dag( generate_dag(
+        transaction, mdl, module, context, precompiled_code_dag, store ? &code_dag_data : nullptr));
     if( context->get_result() != 0)
         return context->get_result();
 
@@ -738,6 +1291,13 @@ mi::Sint32 Mdl_module::create_module_internal(
         module_tag_ident->second = module_ident;
     }
 
+    if( store) {
+        std::vector<std::string> transitive_imports;
+        collect_transitive_imports( transaction, imports, transitive_imports);
+        lock.unlock();
+        store->store( mdl, module, code_dag_data, transitive_imports, context, source_digests);
+    }
+
     return 0;
 }
 
@@ -41,6 +41,7 @@
 #include "mdl_elements_detail.h"
 #include "mdl_elements_type.h"
 
+#include <chrono>
 #include <regex>
 
 #include <boost/core/ignore_unused.hpp>
@@ -56,6 +57,7 @@
 #include <mi/neuraylib/imdl_execution_context.h>
 #include <mi/neuraylib/imdl_impexp_api.h>
 #include <mi/neuraylib/istring.h>
+#include <mi/neuraylib/version.h>
 #include <mi/mdl/mdl.h>
 #include <mi/mdl/mdl_messages.h>
 #include <mi/mdl/mdl_encapsulator.h>
@@ -74,7 +76,9 @@
 #include <base/data/db/i_db_access.h>
 #include <base/data/db/i_db_tag.h>
 #include <base/data/db/i_db_transaction.h>
+#include <base/data/serial/i_serial_buffer_serializer.h>
 #include <base/data/serial/i_serializer.h>
+#include <mdl/compiler/compilercore/compilercore_hash.h>
 #include <mdl/compiler/compilercore/compilercore_tools.h>
 #include <mdl/compiler/compilercore/compilercore_visitor.h>
 #include <mdl/codegenerators/generator_code/generator_code.h>
@@ -6944,6 +6948,313 @@ void Module_cache_lookup_handle::set_is_processing(bool value)
     m_is_processing = value;
 }
 
+// ********** Precompiled_module_store ************************************************************
+
+namespace {
+
+/// Magic number of precompiled module store entries ("MDLP").
+const mi::Uint32 precompiled_module_magic = 0x504c444d;
+
+/// Format version of precompiled module store entries.
+const mi::Uint32 precompiled_module_version = 1;
+
+/// Extension of precompiled module store entries.
+const char precompiled_module_ext[] = ".mdlp";
+
+/// Converts an MD5 digest into a hex string.
+std::string md5_to_string( const unsigned char digest[16])
+{
+    static const char hex[] = "0123456789abcdef";
+
+    std::string result( 32, '0');
+    for( size_t i = 0; i < 16; ++i) {
+        result[2*i]   = hex[digest[i] >> 4];
+        result[2*i+1] = hex[digest[i] & 15];
+    }
+    return result;
+}
+
+/// Returns a string representing the compiler options that affect the precompiled modules.
+std::string get_precompiled_options_key( const Execution_context* context)
+{
+    SYSTEM::Access_module<MDLC::Mdlc_module> mdlc_module( false);
+
+    std::string key = MI_NEURAYLIB_PRODUCT_VERSION_STRING;
+    key += '|' + context->get_option<std::string>( MDL_CTX_OPTION_WARNING);
+    key += '|' + std::to_string(
+        context->get_option<mi::Sint32>( MDL_CTX_OPTION_OPTIMIZATION_LEVEL));
+    key += '|' + context->get_option<std::string>( MDL_CTX_OPTION_INTERNAL_SPACE);
+
+    for( const char* option: {
+        MDL_CTX_OPTION_RESOLVE_RESOURCES,
+        MDL_CTX_OPTION_MDL_NEXT,
+        MDL_CTX_OPTION_EXPERIMENTAL,
+        MDL_CTX_OPTION_KEEP_ORIGINAL_RESOURCE_FILE_PATHS,
+        MDL_CTX_OPTION_TARGET_MATERIAL_MODEL_MODE})
+        key += context->get_option<bool>( option) ? "|1" : "|0";
+
+    key += mdlc_module->get_expose_names_of_let_expressions() ? "|1" : "|0";
+    key += mdlc_module->get_implicit_cast_enabled() ? "|1" : "|0";
+    return key;
+}
+
+/// Reads a whole file. Returns \c false in case of failure.
+bool read_file( const std::string& filename, std::vector<mi::Uint8>& data)
+{
+    FILE* file = DISK::fopen( filename.c_str(), "rb");
+    if( !file)
+        return false;
+
+    data.clear();
+    mi::Uint8 buffer[64 * 1024];
+    size_t n;
+    while( (n = fread( buffer, 1, sizeof( buffer), file)) > 0)
+        data.insert( data.end(), buffer, buffer + n);
+
+    bool success = ferror( file) == 0;
+    fclose( file);
+    return success;
+}
+
+} // namespace
+
+const std::string& Module_source_digests::get(
+    mi::mdl::IEntity_resolver* resolver,
+    mi::mdl::IThread_context* ctx,
+    const char* core_name)
+{
+    auto it = m_digests.find( core_name);
+    if( it == m_digests.end())
+        it = m_digests.emplace( core_name, compute( resolver, ctx, core_name)).first;
+    return it->second;
+}
+
+std::string Module_source_digests::compute(
+    mi::mdl::IEntity_resolver* resolver,
+    mi::mdl::IThread_context* ctx,
+    const char* core_name)
+{
+    mi::base::Handle<mi::mdl::IMDL_import_result> result( resolver->resolve_module(
+        core_name, /*owner_file_path*/ nullptr, /*owner_name*/ nullptr, /*pos*/ nullptr, ctx));
+    if( !result)
+        return std::string();
+
+    mi::base::Handle<mi::mdl::IInput_stream> stream( result->open( ctx));
+    if( !stream)
+        return std::string();
+
+    mi::mdl::MD5_hasher hasher;
+    hasher.update( result->get_file_name());
+    hasher.update( '\0');
+
+    unsigned char buffer[4096];
+    size_t n = 0;
+    for( int c = stream->read_char(); c != -1; c = stream->read_char()) {
+        buffer[n++] = static_cast<unsigned char>( c);
+        if( n == sizeof( buffer)) {
+            hasher.update( buffer, n);
+            n = 0;
+        }
+    }
+    hasher.update( buffer, n);
+
+    unsigned char digest[16];
+    hasher.final( digest);
+    return md5_to_string( digest);
+}
+
+Precompiled_module_store::Precompiled_module_store( const std::string& path)
+  : m_path( path),
+    m_tmp_counter( 0)
+{
+}
+
+bool Precompiled_module_store::is_supported( const Execution_context* context)
+{
+    // User data might affect the entity resolution, and hence, the module sources.
+    mi::base::Handle<const mi::base::IInterface> user_data(
+        context->get_interface_option<const mi::base::IInterface>( MDL_CTX_OPTION_USER_DATA));
+    return !user_data;
+}
+
+bool Precompiled_module_store::load(
+    mi::mdl::IEntity_resolver* resolver,
+    mi::mdl::IThread_context* ctx,
+    const char* core_name,
+    const Execution_context* context,
+    Entry& entry,
+    Module_source_digests* digests) const
+{
+    Module_source_digests local_digests;
+    if( !digests)
+        digests = &local_digests;
+
+    std::string source_digest = digests->get( resolver, ctx, core_name);
+    if( source_digest.empty())
+        return false;
+
+    std::string filename = get_entry_filename( core_name, source_digest, context);
+    std::vector<mi::Uint8> data;
+    if( !read_file( filename, data) || data.size() < 16)
+        return false;
+
+    // Reject truncated or otherwise damaged entries before deserializing anything.
+    mi::mdl::MD5_hasher hasher;
+    hasher.update( data.data() + 16, data.size() - 16);
+    unsigned char digest[16];
+    hasher.final( digest);
+    if( memcmp( digest, data.data(), 16) != 0) {
+        LOG::mod_log->warning( M_SCENE, LOG::Mod_log::C_IO,
+            "Ignoring damaged precompiled module \"%s\".", filename.c_str());
+        return false;
+    }
+
+    SERIAL::Buffer_deserializer deserializer;
+    deserializer.reset( data.data() + 16, data.size() - 16);
+
+    mi::Uint32 magic = 0, version = 0;
+    deserializer.read( &magic);
+    deserializer.read( &version);
+    if( magic != precompiled_module_magic || version != precompiled_module_version)
+        return false;
+
+    std::string stored_name;
+    SERIAL::read( &deserializer, &stored_name);
+    if( stored_name != core_name)
+        return false;
+
+    // Check that none of the imported modules changed.
+    mi::Uint32 import_count = 0;
+    deserializer.read( &import_count);
+    for( mi::Uint32 i = 0; i < import_count && deserializer.is_valid(); ++i) {
+        std::string import_name, import_digest;
+        SERIAL::read( &deserializer, &import_name);
+        SERIAL::read( &deserializer, &import_digest);
+        if( digests->get( resolver, ctx, import_name.c_str()) != import_digest) {
+            LOG::mod_log->debug( M_SCENE, LOG::Mod_log::C_IO,
+                "Precompiled module \"%s\" is outdated, import \"%s\" changed.",
+                core_name, import_name.c_str());
+            return false;
+        }
+    }
+    if( !deserializer.is_valid())
+        return false;
+
+    SYSTEM::Access_module<MDLC::Mdlc_module> mdlc_module( false);
+    entry.m_module = mdlc_module->deserialize_module( &deserializer);
+    entry.m_code_dag = mdlc_module->deserialize_code_dag( &deserializer);
+    if( !deserializer.is_valid() || !entry.m_module || !entry.m_code_dag) {
+        entry.m_module.reset();
+        entry.m_code_dag.reset();
+        return false;
+    }
+
+    LOG::mod_log->debug( M_SCENE, LOG::Mod_log::C_IO,
+        "Loaded precompiled module \"%s\" from \"%s\".", core_name, filename.c_str());
+    return true;
+}
+
+void Precompiled_module_store::store(
+    mi::mdl::IMDL* mdl,
+    const mi::mdl::IModule* module,
+    const std::vector<mi::Uint8>& code_dag_data,
+    const std::vector<std::string>& imports,
+    const Execution_context* context,
+    Module_source_digests* digests) const
+{
+    const char* core_name = module->get_name();
+
+    mi::base::Handle<mi::mdl::IThread_context> ctx( mdl->create_thread_context());
+    mi::base::Handle<mi::mdl::IEntity_resolver> resolver( mdl->get_entity_resolver( nullptr));
+
+    Module_source_digests local_digests;
+    if( !digests)
+        digests = &local_digests;
+
+    std::string source_digest = digests->get( resolver.get(), ctx.get(), core_name);
+    if( source_digest.empty())
+        return;
+
+    SERIAL::Buffer_serializer serializer;
+    serializer.write( precompiled_module_magic);
+    serializer.write( precompiled_module_version);
+    SERIAL::write( &serializer, std::string( core_name));
+
+    serializer.write( static_cast<mi::Uint32>( imports.size()));
+    for( const auto& import: imports) {
+        const std::string& import_digest = digests->get( resolver.get(), ctx.get(), import.c_str());
+        if( import_digest.empty())
+            return;
+        SERIAL::write( &serializer, import);
+        SERIAL::write( &serializer, import_digest);
+    }
+
+    SYSTEM::Access_module<MDLC::Mdlc_module> mdlc_module( false);
+    mdlc_module->serialize_module( &serializer, module);
+    serializer.write( reinterpret_cast<const char*>( code_dag_data.data()), code_dag_data.size());
+
+    mi::mdl::MD5_hasher hasher;
+    hasher.update( serializer.get_buffer(), serializer.get_buffer_size());
+    unsigned char digest[16];
+    hasher.final( digest);
+
+    if( !DISK::is_directory( m_path.c_str()) && !DISK::mkdir( m_path.c_str())
+        && !DISK::is_directory( m_path.c_str()))
+        return;
+
+    // Write into a file private to this thread and rename it into place, such that concurrent
+    // readers (in this or other processes) never see partially written entries.
+    std::string filename = get_entry_filename( core_name, source_digest, context);
+    size_t unique_id = std::hash<std::thread::id>()( std::this_thread::get_id())
+        ^ static_cast<size_t>( std::chrono::steady_clock::now().time_since_epoch().count());
+    std::string tmp_filename = filename + "." + std::to_string( unique_id) + "."
+        + std::to_string( m_tmp_counter++) + ".tmp";
+
+    FILE* file = DISK::fopen( tmp_filename.c_str(), "wb");
+    if( !file)
+        return;
+    bool success = fwrite( digest, 1, 16, file) == 16;
+    success = success && fwrite( serializer.get_buffer(), 1, serializer.get_buffer_size(), file)
+        == serializer.get_buffer_size();
+    success = (fclose( file) == 0) && success;
+
+    if( !success || !DISK::rename( tmp_filename.c_str(), filename.c_str())) {
+        DISK::file_remove( tmp_filename.c_str());
+        return;
+    }
+
+    LOG::mod_log->debug( M_SCENE, LOG::Mod_log::C_IO,
+        "Stored precompiled module \"%s\" in \"%s\".", core_name, filename.c_str());
+}
+
+std::vector<mi::Uint8> Precompiled_module_store::serialize_code_dag(
+    const mi::mdl::IGenerated_code_dag* code_dag)
+{
+    SYSTEM::Access_module<MDLC::Mdlc_module> mdlc_module( false);
+
+    SERIAL::Buffer_serializer serializer;
+    mdlc_module->serialize_code_dag( &serializer, code_dag);
+    return serializer.takeover_buffer();
+}
+
+std::string Precompiled_module_store::get_entry_filename(
+    const char* core_name,
+    const std::string& source_digest,
+    const Execution_context* context) const
+{
+    mi::mdl::MD5_hasher hasher;
+    hasher.update( precompiled_module_version);
+    for( const std::string& s: {
+        get_precompiled_options_key( context), std::string( core_name), source_digest}) {
+        hasher.update( s.c_str());
+        hasher.update( '\0');
+    }
+
+    unsigned char digest[16];
+    hasher.final( digest);
+    return HAL::Ospath::join( m_path, md5_to_string( digest) + precompiled_module_ext);
+}
+
 // ********** Module_cache ************************************************************************
 
 Module_cache::Wait_handle::Wait_handle()
@@ -6991,6 +7302,7 @@ Module_cache::Module_cache(
     , m_transaction(transaction)
     , m_queue(queue)
     , m_module_load_callback(nullptr)
+    , m_precompiled_module_loader(nullptr)
     , m_default_wait_handle_factory(new Wait_handle_factory())
     , m_user_wait_handle_factory(nullptr)
     , m_ignore_list(module_ignore_list)
@@ -7062,6 +7374,15 @@ const mi::mdl::IModule* Module_cache::lookup(
         // printf_s("[info] loading module on this thread \"%s\"\n", module_name);
         handle_internal->set_lookup_name(module_name);
         handle_internal->set_is_processing(true);
+
+        // try the precompiled module store before compiling the module
+        if (m_precompiled_module_loader
+            && m_precompiled_module_loader->load_precompiled_module(module_name))
+        {
+            dep = lookup_db(module_name);
+            assert(dep && "Module should be in the DB, as it was loaded from the store.");
+            return dep;
+        }
         return nullptr;
     }
 
@@ -7131,6 +7452,12 @@ void Module_cache::set_module_loading_callback(mi::mdl::IModule_loaded_callback*
     m_module_load_callback = callback;
 }
 
+/// Set the loader for precompiled modules.
+void Module_cache::set_precompiled_module_loader(Precompiled_module_loader* loader)
+{
+    m_precompiled_module_loader = loader;
+}
+
 
 const mi::neuraylib::IMdl_loading_wait_handle_factory* Module_cache::get_wait_handle_factory() const
 {
@@ -7862,6 +8189,7 @@ Execution_context::Execution_context( bool add_defaults)
     ADD3( MDL_CTX_OPTION_TARGET_MATERIAL_MODEL_MODE, false, false);
     ADD3( MDL_CTX_OPTION_KEEP_ORIGINAL_RESOURCE_FILE_PATHS, false, false);
     ADD3( MDL_CTX_OPTION_USER_DATA, empty_handle, true);
+    ADD3( MDL_CTX_OPTION_PARALLEL_IMPORT_LOADING, false, false);
 
 #undef ADD3
 #undef ADD4
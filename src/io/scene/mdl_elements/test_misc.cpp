@@ -38,6 +38,12 @@
 #include <base/system/test/i_test_auto_driver.h>
 #include <base/system/test/i_test_auto_case.h>
 
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
 #include <tuple>
 
 #include "i_mdl_elements_compiled_material.h"
@@ -49,11 +55,13 @@
 #include "mdl_elements_utilities.h"
 #include "test_shared.h"
 
+#include <mi/base/default_allocator.h>
 #include <mi/base/handle.h>
 #include <mi/neuraylib/istring.h>
 #include <mi/mdl/mdl_mdl.h>
 #include <mi/mdl/mdl_modules.h>
 #include <mi/mdl/mdl_distiller_rules.h>
+#include <base/hal/disk/disk.h>
 #include <base/hal/hal/i_hal_ospath.h>
 #include <base/hal/time/i_time.h>
 #include <base/hal/thread/i_thread_thread.h>
@@ -66,7 +74,9 @@
 #include <base/data/db/i_db_database.h>
 #include <base/data/db/i_db_scope.h>
 #include <base/data/db/i_db_transaction.h>
+#include <mdl/compiler/compilercore/compilercore_code_cache.h>
 #include <mdl/compiler/compilercore/compilercore_comparator.h>
+#include <mdl/compiler/compilercore/compilercore_file_index_cache.h>
 #include <io/scene/bsdf_measurement/i_bsdf_measurement.h>
 #include <io/scene/dbimage/i_dbimage.h>
 #include <io/scene/lightprofile/i_lightprofile.h>
@@ -528,6 +538,84 @@ void test_resources_and_hashes_modify_image( DB::Transaction* transaction,
     MI_CHECK( hash_cc == hash_cc2);
 }
 
+// Creates the DAG material instance for the material instance \p mi_name.
+const mi::mdl::IGenerated_code_dag::IMaterial_instance* create_dag_material_instance(
+    DB::Transaction* transaction,
+    const char* mi_name,
+    bool use_temporaries,
+    bool class_compilation,
+    MDL::Execution_context* context)
+{
+    DB::Tag mi_tag = transaction->name_to_tag( mi_name);
+    DB::Access<MDL::Mdl_function_call> mi( mi_tag, transaction);
+    return mi->create_dag_material_instance(
+        transaction, use_temporaries, class_compilation, context);
+}
+
+// Check that node and instance hashes do not depend on parameter renumbering or temporaries, and
+// that they differ for different materials.
+void test_node_and_instance_hashes( DB::Transaction* transaction, MDL::Execution_context* context)
+{
+    using Instance = mi::mdl::IGenerated_code_dag::IMaterial_instance;
+
+    mi::mdl::DAG_hash class_hash, instance_hash;
+
+    for( int class_compilation = 0; class_compilation < 2; ++class_compilation) {
+
+        mi::base::Handle<const Instance> dead_param( create_dag_material_instance(
+            transaction, "mdl::mdl_elements::test_misc::mi_hash_dead_param",
+            /*use_temporaries*/ true, class_compilation != 0, context));
+        mi::base::Handle<const Instance> no_dead_param( create_dag_material_instance(
+            transaction, "mdl::mdl_elements::test_misc::mi_hash_no_dead_param",
+            /*use_temporaries*/ true, class_compilation != 0, context));
+        mi::base::Handle<const Instance> no_temporaries( create_dag_material_instance(
+            transaction, "mdl::mdl_elements::test_misc::mi_hash_no_dead_param",
+            /*use_temporaries*/ false, class_compilation != 0, context));
+        mi::base::Handle<const Instance> swapped( create_dag_material_instance(
+            transaction, "mdl::mdl_elements::test_misc::mi_hash_swapped",
+            /*use_temporaries*/ true, class_compilation != 0, context));
+        MI_CHECK( dead_param);
+        MI_CHECK( no_dead_param);
+        MI_CHECK( no_temporaries);
+        MI_CHECK( swapped);
+
+        // class compilation removes "unused" and renumbers "b" from 2 to 1
+        size_t parameter_count = class_compilation != 0 ? 2 : 0;
+        MI_CHECK_EQUAL( dead_param->get_parameter_count(), parameter_count);
+        MI_CHECK_EQUAL( no_dead_param->get_parameter_count(), parameter_count);
+
+        // identical after renumbering
+        MI_CHECK( dead_param->get_constructor()->get_node_hash()
+            == no_dead_param->get_constructor()->get_node_hash());
+        MI_CHECK( *dead_param->get_hash() == *no_dead_param->get_hash());
+        for( int i = 0; i <= Instance::MS_LAST; ++i) {
+            Instance::Slot slot = Instance::Slot( i);
+            MI_CHECK( *dead_param->get_slot_hash( slot) == *no_dead_param->get_slot_hash( slot));
+        }
+
+        // temporaries do not change hashes
+        MI_CHECK( no_temporaries->get_constructor()->get_node_hash()
+            == no_dead_param->get_constructor()->get_node_hash());
+        MI_CHECK( *no_temporaries->get_hash() == *no_dead_param->get_hash());
+
+        // swapped surface and backface change the instance hash, but not the slot hashes
+        MI_CHECK( swapped->get_constructor()->get_node_hash()
+            != no_dead_param->get_constructor()->get_node_hash());
+        MI_CHECK( *swapped->get_hash() != *no_dead_param->get_hash());
+        MI_CHECK( *swapped->get_slot_hash( Instance::MS_SURFACE_BSDF_SCATTERING)
+            != *no_dead_param->get_slot_hash( Instance::MS_SURFACE_BSDF_SCATTERING));
+        MI_CHECK( *swapped->get_slot_hash( Instance::MS_SURFACE_BSDF_SCATTERING)
+            == *no_dead_param->get_slot_hash( Instance::MS_BACKFACE_BSDF_SCATTERING));
+        MI_CHECK( *swapped->get_slot_hash( Instance::MS_BACKFACE_BSDF_SCATTERING)
+            == *no_dead_param->get_slot_hash( Instance::MS_SURFACE_BSDF_SCATTERING));
+
+        (class_compilation != 0 ? class_hash : instance_hash) = *no_dead_param->get_hash();
+    }
+
+    // parameters and constants differ
+    MI_CHECK( class_hash != instance_hash);
+}
+
 void test_module_names( DB::Transaction* transaction, MDL::Execution_context* context)
 {
     // check forbidden module names
@@ -1408,6 +1496,540 @@ void test_module_comparator( DB::Transaction* transaction, MDL::Execution_contex
     MI_CHECK( mi::mdl::equal( mdl_module.get(), mdl_module.get()));
 }
 
+void test_parallel_import_loading( DB::Transaction* transaction, MDL::Execution_context* context)
+{
+    context->clear_messages();
+    context->set_result( 0);
+    context->set_option( MDL_CTX_OPTION_PARALLEL_IMPORT_LOADING, true);
+    mi::Sint32 result = MDL::Mdl_module::create_module(
+        transaction, "::mdl_elements::test_parallel_imports", context);
+    context->set_option( MDL_CTX_OPTION_PARALLEL_IMPORT_LOADING, false);
+    MI_CHECK_EQUAL( 0, result);
+    MI_CHECK_EQUAL( 0, context->get_error_messages_count());
+
+    // all modules of the diamond-shaped import graph are in the DB
+    const char* names[] = {
+        "mdl::mdl_elements::test_parallel_imports",
+        "mdl::mdl_elements::test_parallel_imports_a",
+        "mdl::mdl_elements::test_parallel_imports_b",
+        "mdl::mdl_elements::test_parallel_imports_c"
+    };
+    for( const char* name: names)
+        MI_CHECK( transaction->name_to_tag( name));
+
+    // loading the module again is a no-op
+    result = MDL::Mdl_module::create_module(
+        transaction, "::mdl_elements::test_parallel_imports", context);
+    MI_CHECK_EQUAL( 1, result);
+}
+
+/// Loads a module with or without parallel loading of its imports and returns the messages.
+mi::Sint32 load_module_with_messages(
+    DB::Transaction* transaction,
+    const char* module_name,
+    bool parallel,
+    MDL::Execution_context* context,
+    std::vector<std::pair<mi::base::Message_severity, std::string>>& messages)
+{
+    context->clear_messages();
+    context->set_result( 0);
+    context->set_option( MDL_CTX_OPTION_PARALLEL_IMPORT_LOADING, parallel);
+    mi::Sint32 result = MDL::Mdl_module::create_module( transaction, module_name, context);
+    context->set_option( MDL_CTX_OPTION_PARALLEL_IMPORT_LOADING, false);
+
+    messages.clear();
+    for( mi::Size i = 0, n = context->get_messages_count(); i < n; ++i) {
+        const MDL::Message& message = context->get_message( i);
+        messages.emplace_back( message.m_severity, message.m_message);
+    }
+    return result;
+}
+
+void test_parallel_import_loading_failure(
+    DB::Transaction* transaction, MDL::Execution_context* context)
+{
+    const char* module_name = "::mdl_elements::test_parallel_imports_fail";
+    std::vector<std::pair<mi::base::Message_severity, std::string>> messages;
+
+    // loading fails due to the failing import
+    mi::Sint32 result = load_module_with_messages(
+        transaction, module_name, /*parallel*/ true, context, messages);
+    MI_CHECK_EQUAL( -2, result);
+    MI_CHECK( context->get_error_messages_count() > 0);
+
+    // only the import without dependency on the failing module is in the DB
+    MI_CHECK( !transaction->name_to_tag( "mdl::mdl_elements::test_parallel_imports_fail"));
+    MI_CHECK( !transaction->name_to_tag( "mdl::mdl_elements::test_parallel_imports_fail_a"));
+    MI_CHECK( transaction->name_to_tag( "mdl::mdl_elements::test_parallel_imports_fail_b"));
+    MI_CHECK( !transaction->name_to_tag( "mdl::mdl_elements::test_parallel_imports_fail_c"));
+
+    // messages are deterministic
+    for( int i = 0; i < 5; ++i) {
+        std::vector<std::pair<mi::base::Message_severity, std::string>> other_messages;
+        mi::Sint32 other_result = load_module_with_messages(
+            transaction, module_name, /*parallel*/ true, context, other_messages);
+        MI_CHECK_EQUAL( result, other_result);
+        MI_CHECK( messages == other_messages);
+    }
+
+    // messages are the same as for sequential loading
+    std::vector<std::pair<mi::base::Message_severity, std::string>> sequential_messages;
+    mi::Sint32 sequential_result = load_module_with_messages(
+        transaction, module_name, /*parallel*/ false, context, sequential_messages);
+    MI_CHECK_EQUAL( result, sequential_result);
+    MI_CHECK( messages == sequential_messages);
+}
+
+void test_precompiled_module_store( DB::Transaction* transaction, MDL::Execution_context* context)
+{
+    const std::string path = "output_test_misc_precompiled_modules";
+    DISK::rmdir_r( path.c_str());
+
+    SYSTEM::Access_module<MDLC::Mdlc_module> mdlc_module( false);
+    mi::base::Handle<mi::mdl::IMDL> mdl( mdlc_module->get_mdl());
+    mi::base::Handle<mi::mdl::IThread_context> ctx( mdl->create_thread_context());
+    mi::base::Handle<mi::mdl::IEntity_resolver> resolver( mdl->get_entity_resolver( nullptr));
+    const char* core_name = "::mdl_elements::test_parallel_imports_a";
+
+    DB::Tag tag = transaction->name_to_tag( "mdl::mdl_elements::test_parallel_imports_a");
+    MI_CHECK( tag);
+    DB::Access<MDL::Mdl_module> db_module( tag, transaction);
+    mi::base::Handle<const mi::mdl::IModule> module( db_module->get_mdl_module());
+    mi::base::Handle<const mi::mdl::IGenerated_code_dag> code_dag( db_module->get_code_dag());
+
+    // no entry yet
+    MDL::Precompiled_module_store store( path);
+    MDL::Precompiled_module_store::Entry entry;
+    MI_CHECK( !store.load( resolver.get(), ctx.get(), core_name, context, entry));
+
+    // round-trip
+    store.store( mdl.get(), module.get(),
+        MDL::Precompiled_module_store::serialize_code_dag( code_dag.get()),
+        { "::mdl_elements::test_parallel_imports_c"}, context);
+    MI_CHECK( store.load( resolver.get(), ctx.get(), core_name, context, entry));
+    MI_CHECK_EQUAL_CSTR( core_name, entry.m_module->get_name());
+    MI_CHECK( entry.m_module->is_valid());
+    MI_CHECK_EQUAL( code_dag->get_function_count(), entry.m_code_dag->get_function_count());
+    MI_CHECK_EQUAL( code_dag->get_material_count(), entry.m_code_dag->get_material_count());
+
+    // entries depend on the compiler options
+    MDL::Execution_context other_context;
+    other_context.set_option( MDL_CTX_OPTION_OPTIMIZATION_LEVEL, 0);
+    MI_CHECK( !store.load( resolver.get(), ctx.get(), core_name, &other_context, entry));
+
+    DISK::rmdir_r( path.c_str());
+}
+
+/// Returns the full paths of all files in the disk tier of a code cache.
+std::set<std::string> get_code_cache_files( const std::string& path)
+{
+    std::set<std::string> result;
+
+    DISK::Directory root;
+    if( !root.open( path.c_str()))
+        return result;
+
+    for( std::string subdir = root.read(); !subdir.empty(); subdir = root.read()) {
+        std::string subdir_path = HAL::Ospath::join( path, subdir);
+        DISK::Directory dir;
+        if( !dir.open( subdir_path.c_str()))
+            continue;
+        for( std::string name = dir.read(); !name.empty(); name = dir.read())
+            result.insert( HAL::Ospath::join( subdir_path, name));
+    }
+    return result;
+}
+
+/// Creates a code cache with the given build identity, optionally with a disk tier.
+mi::mdl::Code_cache* create_code_cache( const std::string& path, const char* build_id)
+{
+    mi::base::IAllocator* alloc = mi::base::Default_allocator::get_instance();
+    mi::mdl::Allocator_builder builder( alloc);
+    return builder.create<mi::mdl::Code_cache>(
+        alloc, 1024*1024, path.c_str(), 1024*1024, build_id);
+}
+
+/// Checks that a code cache entry matches the entry created by test_code_cache().
+void check_code_cache_entry( const mi::mdl::ICode_cache::Entry* entry)
+{
+    MI_CHECK( entry);
+    if( !entry)
+        return;
+
+    MI_CHECK_EQUAL( entry->code_size, 5);
+    MI_CHECK_EQUAL( memcmp( entry->code, "code", 5), 0);
+    MI_CHECK_EQUAL( entry->const_seg_size, 3);
+    MI_CHECK_EQUAL( memcmp( entry->const_seg, "\0\1\2", 3), 0);
+    MI_CHECK_EQUAL( entry->arg_layout_size, 0);
+    MI_CHECK_EQUAL( entry->render_state_usage, 42);
+
+    MI_CHECK_EQUAL( entry->mapped_string_size, 2);
+    MI_CHECK_EQUAL_CSTR( entry->mapped_strings[0], "texture.png");
+    MI_CHECK_EQUAL_CSTR( entry->mapped_strings[1], "");
+
+    MI_CHECK_EQUAL( entry->func_info_size, 1);
+    const mi::mdl::ICode_cache::Entry::Func_info& info = entry->func_infos[0];
+    MI_CHECK_EQUAL_CSTR( info.name, "init");
+    MI_CHECK_EQUAL( info.dist_kind, mi::mdl::IGenerated_code_executable::DK_BSDF);
+    MI_CHECK_EQUAL( info.func_kind, mi::mdl::IGenerated_code_executable::FK_DF_INIT);
+    MI_CHECK_EQUAL_CSTR( info.prototypes[0], "void init();");
+    MI_CHECK_EQUAL( info.arg_block_index, 7);
+    MI_CHECK_EQUAL( info.num_df_handles, 2);
+    MI_CHECK_EQUAL_CSTR( info.df_handles[0], "a");
+    MI_CHECK_EQUAL_CSTR( info.df_handles[1], "b");
+    MI_CHECK_EQUAL( info.state_usage, 3);
+}
+
+void test_code_cache()
+{
+    const std::string path = "output_test_misc_code_cache";
+    DISK::rmdir_r( path.c_str());
+
+    const char* mapped_strings[] = { "texture.png", "" };
+    const char* df_handles[] = { "a", "b" };
+
+    mi::mdl::ICode_cache::Entry::Func_info info;
+    info.name = "init";
+    info.dist_kind = mi::mdl::IGenerated_code_executable::DK_BSDF;
+    info.func_kind = mi::mdl::IGenerated_code_executable::FK_DF_INIT;
+    for( int i = 0; i < int( mi::mdl::IGenerated_code_executable::PL_NUM_LANGUAGES); ++i)
+        info.prototypes[i] = i == 0 ? "void init();" : "";
+    info.arg_block_index = 7;
+    info.num_df_handles = 2;
+    info.df_handles = df_handles;
+    info.state_usage = 3;
+
+    mi::mdl::ICode_cache::Entry entry(
+        "code", 5, "\0\1\2", 3, nullptr, 0, mapped_strings, 2, 42, &info, 1);
+
+    unsigned char key[16];
+    for( unsigned char i = 0; i < 16; ++i)
+        key[i] = i;
+    unsigned char other_key[16];
+    for( unsigned char i = 0; i < 16; ++i)
+        other_key[i] = 255 - i;
+
+    // store
+    {
+        mi::base::Handle<mi::mdl::Code_cache> cache( create_code_cache( path, "build 1"));
+        MI_CHECK( !cache->lookup( key));
+        MI_CHECK( cache->enter( key, entry));
+        check_code_cache_entry( cache->lookup( key));
+    }
+    std::set<std::string> files = get_code_cache_files( path);
+    MI_CHECK_EQUAL( files.size(), 1);
+    const std::string file = *files.begin();
+
+    // reload in a fresh cache of the same build
+    {
+        mi::base::Handle<mi::mdl::Code_cache> cache( create_code_cache( path, "build 1"));
+        check_code_cache_entry( cache->lookup( key));
+        MI_CHECK( !cache->lookup( other_key));
+    }
+
+    // a different build neither sees nor removes the entry, its own entry uses a different file
+    std::string other_file;
+    {
+        mi::base::Handle<mi::mdl::Code_cache> cache( create_code_cache( path, "build 2"));
+        MI_CHECK( !cache->lookup( key));
+        MI_CHECK( cache->enter( key, entry));
+
+        files = get_code_cache_files( path);
+        MI_CHECK_EQUAL( files.size(), 2);
+        MI_CHECK_EQUAL( files.count( file), 1);
+        files.erase( file);
+        other_file = *files.begin();
+    }
+
+    // files written by a different build are rejected and removed, even under the expected name
+    MI_CHECK( DISK::file_copy( file.c_str(), other_file.c_str()));
+    {
+        mi::base::Handle<mi::mdl::Code_cache> cache( create_code_cache( path, "build 2"));
+        MI_CHECK( !cache->lookup( key));
+        MI_CHECK( !DISK::is_file( other_file.c_str()));
+    }
+
+    // corrupted files are rejected and removed
+    {
+        FILE* f = DISK::fopen( file.c_str(), "r+b");
+        MI_CHECK( f);
+        fseek( f, -1, SEEK_END);
+        int c = fgetc( f);
+        fseek( f, -1, SEEK_END);
+        fputc( c ^ 0xff, f);
+        fclose( f);
+
+        mi::base::Handle<mi::mdl::Code_cache> cache( create_code_cache( path, "build 1"));
+        MI_CHECK( !cache->lookup( key));
+        MI_CHECK( !DISK::is_file( file.c_str()));
+    }
+
+    // truncated files are rejected and removed
+    {
+        mi::base::Handle<mi::mdl::Code_cache> cache( create_code_cache( path, "build 1"));
+        MI_CHECK( cache->enter( key, entry));
+        MI_CHECK( DISK::is_file( file.c_str()));
+
+        FILE* f = DISK::fopen( file.c_str(), "wb");
+        MI_CHECK( f);
+        fputs( "MDLCCE", f);
+        fclose( f);
+    }
+    {
+        mi::base::Handle<mi::mdl::Code_cache> cache( create_code_cache( path, "build 1"));
+        MI_CHECK( !cache->lookup( key));
+        MI_CHECK( !DISK::is_file( file.c_str()));
+    }
+
+    DISK::rmdir_r( path.c_str());
+}
+
+/// A search path consisting of a single directory.
+class Single_search_path : public mi::base::Interface_implement<mi::mdl::IMDL_search_path>
+{
+public:
+    Single_search_path( const std::string& path) : m_path( path) { }
+
+    size_t get_search_path_count( Path_set set) const final
+    { return set == MDL_SEARCH_PATH ? 1 : 0; }
+
+    const char* get_search_path( Path_set set, size_t i) const final
+    { return m_path.c_str(); }
+
+private:
+    std::string m_path;
+};
+
+/// Sets the time of the last modification of a file or directory to the given age in seconds.
+void set_file_age( const std::string& path, int age)
+{
+    std::filesystem::last_write_time(
+        path, std::filesystem::file_time_type::clock::now() - std::chrono::seconds( age));
+}
+
+/// Writes a small file.
+void write_file( const std::string& path, const char* content)
+{
+    std::ofstream file( path.c_str(), std::ios::binary);
+    file << content;
+}
+
+/// Checks whether a module name can be resolved.
+bool resolves_module(
+    mi::mdl::IEntity_resolver* resolver, mi::mdl::IThread_context* ctx, const char* name)
+{
+    mi::base::Handle<mi::mdl::IMDL_import_result> result(
+        resolver->resolve_module( name, nullptr, nullptr, nullptr, ctx));
+    return result.is_valid_interface();
+}
+
+void test_file_index_cache()
+{
+    const std::string path = "output_test_misc_file_index_cache";
+    DISK::rmdir_r( path.c_str());
+    MI_CHECK( DISK::mkdir( path.c_str()));
+
+    const std::string dir1 = HAL::Ospath::join( path, "dir1");
+    const std::string dir2 = HAL::Ospath::join( path, "dir2");
+    const std::string dir3 = HAL::Ospath::join( path, "dir3");
+    const std::string new_dir = HAL::Ospath::join( path, "new_dir");
+    const std::string missing_dir = HAL::Ospath::join( path, "missing_dir");
+    for( const std::string& dir: { dir1, dir2, dir3, new_dir}) {
+        MI_CHECK( DISK::mkdir( dir.c_str()));
+        if( dir != new_dir)
+            set_file_age( dir, 3600);
+    }
+
+    {
+        mi::base::IAllocator* alloc = mi::base::Default_allocator::get_instance();
+        mi::mdl::File_index_cache cache( alloc, /*max_entries*/ 2);
+
+        size_t reads = 0;
+        auto read = [&reads]( mi::mdl::File_index& index, const char* p) {
+            ++reads;
+            index.set_valid( true);
+            index.add_name( "A.mdl", "a.mdl");
+        };
+
+        // miss, then hit
+        mi::base::Handle<const mi::mdl::File_index> index(
+            cache.get( "dir1", dir1.c_str(), read));
+        MI_CHECK( index);
+        MI_CHECK( index->is_valid());
+        MI_CHECK( index->contains( "a.mdl"));
+        MI_CHECK( !index->contains( "A.mdl"));
+        MI_CHECK_EQUAL_CSTR( index->get_names()[0].c_str(), "A.mdl");
+        MI_CHECK_EQUAL( reads, 1);
+        index = cache.get( "dir1", dir1.c_str(), read);
+        MI_CHECK( index);
+        MI_CHECK_EQUAL( reads, 1);
+
+        // non-existing paths are neither read nor cached
+        MI_CHECK( !cache.get( "missing_dir", missing_dir.c_str(), read));
+        MI_CHECK_EQUAL( reads, 1);
+
+        // recently modified directories are not cached
+        MI_CHECK( cache.get( "new_dir", new_dir.c_str(), read));
+        MI_CHECK( cache.get( "new_dir", new_dir.c_str(), read));
+        MI_CHECK_EQUAL( reads, 3);
+        MI_CHECK_EQUAL( cache.size(), 1);
+
+        // a modification invalidates the cached index
+        set_file_age( dir1, 1800);
+        MI_CHECK( cache.get( "dir1", dir1.c_str(), read));
+        MI_CHECK_EQUAL( reads, 4);
+        MI_CHECK( cache.get( "dir1", dir1.c_str(), read));
+        MI_CHECK_EQUAL( reads, 4);
+
+        // the least recently used index is dropped if the cache is full
+        MI_CHECK( cache.get( "dir2", dir2.c_str(), read));
+        MI_CHECK( cache.get( "dir1", dir1.c_str(), read));
+        MI_CHECK( cache.get( "dir3", dir3.c_str(), read));
+        MI_CHECK_EQUAL( reads, 6);
+        MI_CHECK_EQUAL( cache.size(), 2);
+        MI_CHECK( cache.get( "dir1", dir1.c_str(), read));
+        MI_CHECK_EQUAL( reads, 6);
+        MI_CHECK( cache.get( "dir2", dir2.c_str(), read));
+        MI_CHECK_EQUAL( reads, 7);
+
+        cache.clear();
+        MI_CHECK_EQUAL( cache.size(), 0);
+    }
+
+    DISK::rmdir_r( path.c_str());
+}
+
+void test_search_path_index()
+{
+    const std::string root = "output_test_misc_search_path_index";
+    DISK::rmdir_r( root.c_str());
+    MI_CHECK( DISK::mkdir( root.c_str()));
+    const std::string module_a = HAL::Ospath::join( root, "a.mdl");
+    const std::string module_b = HAL::Ospath::join( root, "b.mdl");
+    write_file( module_a, "mdl 1.0;\n");
+    set_file_age( root, 3600);
+
+    {
+        mi::base::Handle<mi::mdl::IMDL> mdl( mi::mdl::initialize());
+        mdl->access_options().set_option( MDL_OPTION_SEARCH_PATH_INDEX, "true");
+        mdl->install_search_path( new Single_search_path( root));
+        mi::base::Handle<mi::mdl::IThread_context> ctx( mdl->create_thread_context());
+        mi::base::Handle<mi::mdl::IEntity_resolver> resolver( mdl->get_entity_resolver( nullptr));
+
+        // miss and hit
+        MI_CHECK( resolves_module( resolver.get(), ctx.get(), "::a"));
+        MI_CHECK( resolves_module( resolver.get(), ctx.get(), "::a"));
+        MI_CHECK( !resolves_module( resolver.get(), ctx.get(), "::b"));
+
+        // the cached index is used as long as the directory time stamp does not change
+        std::filesystem::file_time_type mtime = std::filesystem::last_write_time( root);
+        MI_CHECK( DISK::file_remove( module_a.c_str()));
+        std::filesystem::last_write_time( root, mtime);
+        MI_CHECK( resolves_module( resolver.get(), ctx.get(), "::a"));
+
+        // invalidation by adding and removing files
+        set_file_age( root, 1800);
+        MI_CHECK( !resolves_module( resolver.get(), ctx.get(), "::a"));
+        write_file( module_b, "mdl 1.0;\n");
+        MI_CHECK( resolves_module( resolver.get(), ctx.get(), "::b"));
+        set_file_age( root, 900);
+        MI_CHECK( resolves_module( resolver.get(), ctx.get(), "::b"));
+        MI_CHECK( DISK::file_remove( module_b.c_str()));
+        set_file_age( root, 600);
+        MI_CHECK( !resolves_module( resolver.get(), ctx.get(), "::b"));
+    }
+
+    DISK::rmdir_r( root.c_str());
+}
+
+/// The directory of the precompiled module store used by all module loads of this test, see the
+/// test driver below.
+const char precompiled_module_loads_path[] = "output_test_misc_precompiled_module_loads";
+
+/// Returns the last modification times of the entries in the precompiled module store.
+std::map<std::string, std::filesystem::file_time_type> get_precompiled_entries()
+{
+    std::map<std::string, std::filesystem::file_time_type> result;
+    for( const auto& entry: std::filesystem::directory_iterator( precompiled_module_loads_path))
+        if( entry.path().extension() == ".mdlp")
+            result[entry.path().string()] = entry.last_write_time();
+    return result;
+}
+
+/// Loads a module into a new database, i.e., neither the module nor its imports are in the DB.
+mi::Sint32 load_module_into_new_database(
+    const char* module_name,
+    std::vector<std::pair<mi::base::Message_severity, std::string>>& messages)
+{
+    DB::Database* database = DBLIGHT::factory();
+    SCENE::register_db_elements( database);
+    DB::Transaction* transaction = database->get_global_scope()->start_transaction();
+
+    MDL::Execution_context context;
+    mi::Sint32 result = load_module_with_messages(
+        transaction, module_name, /*parallel*/ false, &context, messages);
+
+    transaction->commit();
+    database->close();
+    return result;
+}
+
+void test_precompiled_module_loads()
+{
+    const std::string root = "output_test_misc_precompiled_module_sources";
+    DISK::rmdir_r( root.c_str());
+    MI_CHECK( DISK::mkdir( root.c_str()));
+    const std::string module_top = HAL::Ospath::join( root, "precompiled_top.mdl");
+    const std::string module_import = HAL::Ospath::join( root, "precompiled_import.mdl");
+    write_file( module_top,
+        "mdl 1.6;\n"
+        "import ::precompiled_import::*;\n"
+        "export int fd_top( int unused_parameter) { return fd_import(); }\n");
+    write_file( module_import, "mdl 1.6;\nexport int fd_import() { return 1; }\n");
+
+    SYSTEM::Access_module<PATH::Path_module> path_module( false);
+    MI_CHECK_EQUAL(
+        0, path_module->add_path( PATH::MDL, std::filesystem::absolute( root).string()));
+
+    // compiling the modules adds entries for both of them
+    std::map<std::string, std::filesystem::file_time_type> entries = get_precompiled_entries();
+    std::vector<std::pair<mi::base::Message_severity, std::string>> messages;
+    MI_CHECK_EQUAL( 0, load_module_into_new_database( "::precompiled_top", messages));
+    MI_CHECK( std::any_of( messages.begin(), messages.end(), []( const auto& message) {
+        return message.first == mi::base::MESSAGE_SEVERITY_WARNING; }));
+    std::map<std::string, std::filesystem::file_time_type> compiled_entries
+        = get_precompiled_entries();
+    MI_CHECK_EQUAL( entries.size() + 2, compiled_entries.size());
+
+    // backdate the entries such that rewritten entries can be detected
+    for( const auto& entry: compiled_entries)
+        set_file_age( entry.first, 3600);
+    compiled_entries = get_precompiled_entries();
+
+    // a store hit neither adds nor rewrites entries, and replays the compiler messages
+    std::vector<std::pair<mi::base::Message_severity, std::string>> hit_messages;
+    MI_CHECK_EQUAL( 0, load_module_into_new_database( "::precompiled_top", hit_messages));
+    MI_CHECK( messages == hit_messages);
+    MI_CHECK( compiled_entries == get_precompiled_entries());
+
+    // changing the source of the imported module invalidates the entry of the importing module,
+    // which is rewritten, and adds a new entry for the imported module
+    write_file( module_import, "mdl 1.6;\nexport int fd_import() { return 2; }\n");
+    std::vector<std::pair<mi::base::Message_severity, std::string>> changed_messages;
+    MI_CHECK_EQUAL( 0, load_module_into_new_database( "::precompiled_top", changed_messages));
+    MI_CHECK( messages == changed_messages);
+    std::map<std::string, std::filesystem::file_time_type> changed_entries
+        = get_precompiled_entries();
+    MI_CHECK_EQUAL( compiled_entries.size() + 1, changed_entries.size());
+    size_t rewritten_count = 0;
+    for( const auto& entry: compiled_entries)
+        if( changed_entries[entry.first] != entry.second)
+            ++rewritten_count;
+    MI_CHECK_EQUAL( 1, rewritten_count);
+
+    DISK::rmdir_r( root.c_str());
+}
+
 void test_create_value_with_range_annotation(
     DB::Transaction* transaction, MDL::Execution_context* context)
 {
@@ -2129,7 +2751,13 @@ void test_main( DB::Scope* global_scope)
         "mdl::mdl_elements::test_misc::md_textured(texture_2d)",
             "mdl::mdl_elements::test_misc::mi_textured",
         "mdl::mdl_elements::test_misc::md_body(color)",
-            "mdl::mdl_elements::test_misc::mi_body"
+            "mdl::mdl_elements::test_misc::mi_body",
+        "mdl::mdl_elements::test_misc::md_hash_dead_param(color,float,color)",
+            "mdl::mdl_elements::test_misc::mi_hash_dead_param",
+        "mdl::mdl_elements::test_misc::md_hash_no_dead_param(color,color)",
+            "mdl::mdl_elements::test_misc::mi_hash_no_dead_param",
+        "mdl::mdl_elements::test_misc::md_hash_swapped(color,color)",
+            "mdl::mdl_elements::test_misc::mi_hash_swapped"
     };
 
     for( mi::Size i = 0; i < sizeof( definitions) / sizeof( const char*); i += 2)
@@ -2145,6 +2773,7 @@ void test_main( DB::Scope* global_scope)
     test_resources_and_hashes_clear_mdl_file_path( transaction, &context);
     test_resources_and_hashes_modify_texture( transaction, &context);
     test_resources_and_hashes_modify_image( transaction, &context);
+    test_node_and_instance_hashes( transaction, &context);
 
     test_module_names( transaction, &context);
 
@@ -2166,6 +2795,17 @@ void test_main( DB::Scope* global_scope)
 
     test_module_comparator( transaction, &context);
 
+    test_parallel_import_loading( transaction, &context);
+    test_parallel_import_loading_failure( transaction, &context);
+
+    test_precompiled_module_store( transaction, &context);
+
+    test_code_cache();
+
+    test_file_index_cache();
+    test_search_path_index();
+    test_precompiled_module_loads();
+
     test_create_value_with_range_annotation( transaction, &context);
 
     test_factory_compare_deep_call_comparisons( transaction, &context);
@@ -2198,9 +2838,14 @@ void test_multithreading( DB::Database* database, DB::Scope* global_scope)
 
 MI_TEST_AUTO_FUNCTION( test )
 {
+    // The precompiled module store needs to be configured before the MDLC module is initialized.
+    DISK::rmdir_r( precompiled_module_loads_path);
+    SYSTEM::Access_module<CONFIG::Config_module> config_module( false);
+    config_module->override( (std::string( "STR_mdl_precompiled_module_path=\"")
+        + precompiled_module_loads_path + "\"").c_str());
+
     Unified_database_access db_access;
 
-    SYSTEM::Access_module<CONFIG::Config_module> config_module( false);
     config_module->override( "check_serializer_store=1");
     config_module->override( "check_serializer_edit=1");
 
@@ -4384,38 +4384,45 @@ void Generated_code_dag::Material_instance::build_temporaries()
 // Calculate the hash values for this instance.
 void Generated_code_dag::Material_instance::calc_hashes()
 {
-    MD5_hasher md5_hasher;
-    // Feed all parameter names (in order) into the hasher that is used for slot
-    // and instance hashes. This is required for compiled materials that only 
-    // differ in parameter order. They are different materials and we want to prevent 
-    // users to re-use target code in that case, therefore we include the parameters in
-    // the hashes so that misuse is avoided.
-    for (int i = 0; i < m_param_names.size(); ++i) {
-        md5_hasher.update(m_param_names[i].c_str());
-    }
+    // The hashes are derived from the node hashes computed by the node factory, so no
+    // traversal of the DAG is necessary here.
+    Fast_hasher hasher;
 
-    Dag_hasher dag_hasher(get_allocator(), md5_hasher);
+    // Feed all parameter names (in order) into the slot and instance hashes. This is required
+    // for compiled materials that only differ in parameter order. They are different materials
+    // and we want to prevent users to re-use target code in that case, therefore we include the
+    // parameters in the hashes so that misuse is avoided.
+    for (size_t i = 0, n = m_param_names.size(); i < n; ++i) {
+        hasher.update(m_param_names[i].c_str());
+    }
+    unsigned char param_hash[16];
+    hasher.final(param_hash);
 
     if ((m_properties & IP_TARGET_MATERIAL_MODEL) != 0) {
         // we are in target material model mode, no slot hashes
         for (int i = 0; i <= MS_LAST; ++i) {
             m_slot_hashes[i] = DAG_hash();
         }
-        dag_hasher.hash_instance(this);
-        md5_hasher.final(m_hash.data());
+        DAG_hash const &root_hash = get_constructor()->get_node_hash();
+        hasher.update(param_hash, sizeof(param_hash));
+        hasher.update(root_hash.data(), root_hash.size());
+        hasher.final(m_hash.data());
     } else {
         // normal mode: we have slot hashes
         for (int i = 0; i <= MS_LAST; ++i) {
-            dag_hasher.hash_instance_slot(this, Slot(i));
+            DAG_node const *node = get_instance_slot_node(this, Slot(i));
+            DAG_hash const &node_hash = node->get_node_hash();
 
-            md5_hasher.final(m_slot_hashes[i].data());
+            hasher.update(param_hash, sizeof(param_hash));
+            hasher.update(node_hash.data(), node_hash.size());
+            hasher.final(m_slot_hashes[i].data());
         }
 
         for (int i = 0; i <= MS_LAST; ++i) {
-            md5_hasher.update(m_slot_hashes[i].data(), m_slot_hashes[i].size());
+            hasher.update(m_slot_hashes[i].data(), m_slot_hashes[i].size());
         }
 
-        md5_hasher.final(m_hash.data());
+        hasher.final(m_hash.data());
     }
 }
 
@@ -5280,13 +5287,17 @@ Generated_code_dag::Material_instance::Instantiate_helper::renumber_parameter(
     }
 
     // do the renumbering
+    bool renumbered = false;
     m_params = 0;
     for (size_t i = 0; i < n_params; ++i) {
         if (DAG_parameter *param = live_params[i]) {
             // any live parameter will survive
             int param_idx = m_params++;
 
-            set_parameter_index(param, param_idx);
+            if (param->get_index() != param_idx) {
+                set_parameter_index(param, param_idx);
+                renumbered = true;
+            }
             m_default_param_values[param_idx] = m_default_param_values[i];
             m_param_names[param_idx]          = m_param_names[i];
         } else if (!remove_dead_params && inline_params[i] == NULL) {
@@ -5300,6 +5311,11 @@ Generated_code_dag::Material_instance::Instantiate_helper::renumber_parameter(
     m_default_param_values.resize(m_params);
     m_param_names.resize(m_params, string("", get_allocator()));
 
+    if (renumbered) {
+        // the node hashes of all nodes depending on renumbered parameters are outdated
+        update_node_hashes(get_allocator(), node);
+    }
+
     return node;
 }
 
@@ -41,6 +41,7 @@
 #include "generator_dag_ir.h"
 #include "generator_dag_builder.h"
 #include "generator_dag_tools.h"
+#include "generator_dag_walker.h"
 
 namespace mi {
 namespace mdl {
@@ -76,18 +77,30 @@ public:
     /// Get the ID of this DAG IR node.
     size_t get_id() const MDL_FINAL { return m_id; }
 
+    /// Get the structural hash of this DAG IR node.
+    DAG_hash const &get_node_hash() const MDL_FINAL { return m_node_hash; }
+
+    // non-interface methods
+
+    /// Set the structural hash of this DAG IR node.
+    void set_node_hash(DAG_hash const &hash) { m_node_hash = hash; }
+
 protected:
     /// Constructor.
     ///
     /// \param id  The unique ID of this node.
     explicit Expression_impl(size_t id)
     : m_id(id)
+    , m_node_hash()
     {
     }
 
 private:
     /// The unique id.
     size_t const m_id;
+
+    /// The structural hash, computed by the factory.
+    DAG_hash m_node_hash;
 };
 
 /// A constant.
@@ -313,6 +326,26 @@ private:
     Uint32 m_index;
 };
 
+/// Set the node hash of a DAG IR node.
+static void set_node_hash(DAG_node *node, DAG_hash const &hash)
+{
+    switch (node->get_kind()) {
+    case DAG_node::EK_CONSTANT:
+        static_cast<Constant_impl *>(node)->set_node_hash(hash);
+        return;
+    case DAG_node::EK_TEMPORARY:
+        static_cast<Temporary_impl *>(node)->set_node_hash(hash);
+        return;
+    case DAG_node::EK_CALL:
+        static_cast<Call_impl *>(node)->set_node_hash(hash);
+        return;
+    case DAG_node::EK_PARAMETER:
+        static_cast<Parameter_impl *>(node)->set_node_hash(hash);
+        return;
+    }
+    MDL_ASSERT(!"Unsupported DAG node kind");
+}
+
 // -------------------------- Expression factory --------------------------
 
 // A hash functor for Expressions.
@@ -4558,11 +4591,15 @@ DAG_node const *DAG_node_factory_impl::remove_clamped_components(
 DAG_node *DAG_node_factory_impl::identify_remember(
     DAG_node *node)
 {
-    if (!m_cse_enabled)
+    if (!m_cse_enabled) {
+        set_node_hash(node, calc_node_hash(node));
         return node;
+    }
 
     Value_table::iterator it = m_value_table.find(node);
     if (it == m_value_table.end()) {
+        // a new node: compute its hash once, the hashes of its arguments are already known
+        set_node_hash(node, calc_node_hash(node));
         m_value_table.insert(node);
         return node;
     }
@@ -4625,6 +4662,38 @@ void set_parameter_index(DAG_parameter *param, Uint32 param_idx)
 {
     Parameter_impl *p = static_cast<Parameter_impl *>(param);
     p->set_index(param_idx);
+    p->set_node_hash(calc_node_hash(p));
+}
+
+namespace {
+
+typedef ptr_hash_set<DAG_node const>::Type Visited_node_set;
+
+/// Recompute the node hashes of a DAG bottom-up.
+void do_update_node_hashes(Visited_node_set &marker, DAG_node const *node)
+{
+    if (!marker.insert(node).second) {
+        // already visited
+        return;
+    }
+
+    if (DAG_temporary const *tmp = as<DAG_temporary>(node)) {
+        do_update_node_hashes(marker, tmp->get_expr());
+    } else if (DAG_call const *call = as<DAG_call>(node)) {
+        for (int i = 0, n = call->get_argument_count(); i < n; ++i) {
+            do_update_node_hashes(marker, call->get_argument(i));
+        }
+    }
+    set_node_hash(const_cast<DAG_node *>(node), calc_node_hash(node));
+}
+
+}  // anonymous
+
+// Recompute the node hashes of all DAG IR nodes reachable from a root.
+void update_node_hashes(IAllocator *alloc, DAG_node const *root)
+{
+    Visited_node_set marker(0, Visited_node_set::hasher(), Visited_node_set::key_equal(), alloc);
+    do_update_node_hashes(marker, root);
 }
 
 // Skip DAG temporaries if necessary.
@@ -710,6 +710,15 @@ private:
 /// Set the index of an parameter.
 void set_parameter_index(DAG_parameter *param, Uint32 param_idx);
 
+/// Recompute the node hashes of all DAG IR nodes reachable from a root.
+///
+/// Node hashes are computed when a node is created, so they must be updated after parameters
+/// were renumbered by set_parameter_index().
+///
+/// \param alloc  an allocator for temporary memory
+/// \param root   the root of the DAG
+void update_node_hashes(IAllocator *alloc, DAG_node const *root);
+
 /// Skip DAG temporaries if necessary.
 DAG_node const *skip_temporaries(DAG_node const *node);
 
@@ -370,26 +370,229 @@ void DAG_ir_walker::do_walk_node(
     MDL_ASSERT(!"Unsupported DAG node kind");
 }
 
-// Constructor.
-Dag_hasher::Dag_hasher(
-    IAllocator *alloc,
-    MD5_hasher &hasher)
-: m_alloc(alloc)
-, m_node_counter(0)
-, m_marker(0, Visited_node_map::hasher(), Visited_node_map::key_equal(), m_alloc)
-, m_hasher(hasher)
+/// Hash a type.
+template<typename Hasher>
+static void hash_type(Hasher &hasher, IType const *tp)
 {
+    IType::Kind kind = tp->get_kind();
+    hasher.update(kind);
+
+    switch (kind) {
+    case IType::TK_ALIAS:
+        {
+            IType_alias const *a_tp = cast<IType_alias>(tp);
+            hasher.update(a_tp->get_type_modifiers());
+            if (ISymbol const *sym = a_tp->get_symbol())
+                hasher.update(sym->get_name());
+            hash_type(hasher, a_tp->get_aliased_type());
+        }
+        break;
+    case IType::TK_BOOL:
+    case IType::TK_INT:
+        break;
+    case IType::TK_ENUM:
+        {
+            IType_enum const *et = cast<IType_enum>(tp);
+
+            hasher.update(et->get_symbol()->get_name());
+        }
+        break;
+    case IType::TK_FLOAT:
+    case IType::TK_DOUBLE:
+    case IType::TK_STRING:
+    case IType::TK_LIGHT_PROFILE:
+    case IType::TK_BSDF:
+    case IType::TK_HAIR_BSDF:
+    case IType::TK_EDF:
+    case IType::TK_VDF:
+        break;
+    case IType::TK_VECTOR:
+        {
+            IType_vector const *vt = cast<IType_vector>(tp);
+
+            hasher.update(vt->get_size());
+            hash_type(hasher, vt->get_element_type());
+        }
+        break;
+    case IType::TK_MATRIX:
+        {
+            IType_matrix const *mt = cast<IType_matrix>(tp);
+
+            hasher.update(mt->get_columns());
+            hash_type(hasher, mt->get_element_type());
+        }
+        break;
+    case IType::TK_ARRAY:
+        {
+            IType_array const *at = cast<IType_array>(tp);
+
+            if (at->is_immediate_sized()) {
+                hasher.update(at->get_size());
+            } else {
+                IType_array_size const *sz = at->get_deferred_size();
+
+                hasher.update(sz->get_name()->get_name());
+            }
+            hash_type(hasher, at->get_element_type());
+        }
+        break;
+    case IType::TK_COLOR:
+        break;
+    case IType::TK_FUNCTION:
+        {
+            IType_function const *ft = cast<IType_function>(tp);
+
+            if (IType const *ret_type = ft->get_return_type()) {
+                hasher.update('R');
+                hash_type(hasher, ret_type);
+            } else {
+                hasher.update('N');
+            }
+
+            int n_params = ft->get_parameter_count();
+            hasher.update(n_params);
+
+            for (int i = 0; i < n_params; ++i) {
+                IType const *p_tp;
+                ISymbol const *p_sym;
+
+                ft->get_parameter(i, p_tp, p_sym);
+
+                hasher.update(p_sym->get_name());
+                hash_type(hasher, p_tp);
+            }
+        }
+        break;
+    case IType::TK_STRUCT:
+        {
+            IType_struct const *st = cast<IType_struct>(tp);
+
+            hasher.update(st->get_symbol()->get_name());
+        }
+        break;
+    case IType::TK_TEXTURE:
+        {
+            IType_texture const *tt = cast<IType_texture>(tp);
+
+            hasher.update(tt->get_shape());
+        }
+        break;
+    case IType::TK_BSDF_MEASUREMENT:
+    case IType::TK_AUTO:
+    case IType::TK_ERROR:
+        break;
+    }
 }
 
-// Hash the expressions of an instance.
-void Dag_hasher::hash_instance(
-    Generated_code_dag::Material_instance const *instance)
+/// Hash a value.
+template<typename Hasher>
+static void hash_value(Hasher &hasher, IValue const *v)
 {
-    do_hash_dag(instance->get_constructor());
+    IValue::Kind kind = v->get_kind();
+    hasher.update(kind);
+
+    switch (kind) {
+    case IValue::VK_BAD:
+        break;
+    case IValue::VK_BOOL:
+        {
+            IValue_bool const *bv = cast<IValue_bool>(v);
+            hasher.update(bv->get_value() ? 'T' : 'F');
+        }
+        break;
+    case IValue::VK_INT:
+        {
+            IValue_int const *iv = cast<IValue_int>(v);
+            hasher.update(iv->get_value());
+        }
+        break;
+    case IValue::VK_ENUM:
+        {
+            IValue_enum const *ev = cast<IValue_enum>(v);
+            IType_enum const  *et = ev->get_type();
+
+            hasher.update(et->get_symbol()->get_name());
+            hasher.update(ev->get_value());
+        }
+        break;
+    case IValue::VK_FLOAT:
+        {
+            IValue_float const *fv = cast<IValue_float>(v);
+            hasher.update(fv->get_value());
+        }
+        break;
+    case IValue::VK_DOUBLE:
+        {
+            IValue_double const *dv = cast<IValue_double>(v);
+            hasher.update(dv->get_value());
+        }
+        break;
+    case IValue::VK_STRING:
+        {
+            IValue_string const *sv = cast<IValue_string>(v);
+            hasher.update(sv->get_value());
+        }
+        break;
+    case IValue::VK_STRUCT:
+        {
+            IValue_struct const *sv = cast<IValue_struct>(v);
+            IType_struct const  *st = sv->get_type();
+
+            hasher.update(st->get_symbol()->get_name());
+        }
+        // fallthrough
+    case IValue::VK_VECTOR:
+    case IValue::VK_MATRIX:
+    case IValue::VK_ARRAY:
+    case IValue::VK_RGB_COLOR:
+        {
+            IValue_compound const *cv = cast<IValue_compound>(v);
+
+            for (int i = 0, n = cv->get_component_count(); i < n; ++i) {
+                IValue const *child = cv->get_value(i);
+                hash_value(hasher, child);
+            }
+        }
+        break;
+    case IValue::VK_INVALID_REF:
+        {
+            IValue_invalid_ref const *iv = cast<IValue_invalid_ref>(v);
+            IType_reference const    *it = iv->get_type();
+
+            int tkind = it->get_kind();
+            hasher.update(tkind);
+        }
+        break;
+    case IValue::VK_TEXTURE:
+        {
+            IValue_texture const *tv = cast<IValue_texture>(v);
+            hasher.update(tv->get_string_value());
+            hasher.update(tv->get_gamma_mode());
+            hasher.update(tv->get_tag_value());
+            hasher.update(tv->get_tag_version());
+        }
+        break;
+    case IValue::VK_LIGHT_PROFILE:
+        {
+            IValue_light_profile const *lv = cast<IValue_light_profile>(v);
+            hasher.update(lv->get_string_value());
+            hasher.update(lv->get_tag_value());
+            hasher.update(lv->get_tag_version());
+        }
+        break;
+    case IValue::VK_BSDF_MEASUREMENT:
+        {
+            IValue_bsdf_measurement const *lv = cast<IValue_bsdf_measurement>(v);
+            hasher.update(lv->get_string_value());
+            hasher.update(lv->get_tag_value());
+            hasher.update(lv->get_tag_version());
+        }
+        break;
+    }
 }
 
-// Hash the IR nodes of an instance material slot.
-void Dag_hasher::hash_instance_slot(
+// Get the root node of an instance material slot.
+DAG_node const *get_instance_slot_node(
     Generated_code_dag::Material_instance       *instance,
     Generated_code_dag::Material_instance::Slot slot)
 {
@@ -492,13 +695,75 @@ void Dag_hasher::hash_instance_slot(
     MDL_ASSERT((node != NULL || v != NULL) && "material component could not be located");
 
     if (v != NULL) {
-        // create a temporary Const node, so we can visit it.
+        // create a temporary Const node, so it has a node hash
         node = instance->create_temp_constant(v);
     }
+    return node;
+}
 
-    m_node_counter = 0;
-    m_marker.clear();
-    do_hash_dag(node);
+// Compute the node hash of a DAG IR node from the node hashes of its arguments.
+DAG_hash calc_node_hash(DAG_node const *node)
+{
+    Fast_hasher hasher;
+
+    switch (node->get_kind()) {
+    case DAG_node::EK_CONSTANT:
+        hasher.update('C');
+        hash_value(hasher, cast<DAG_constant>(node)->get_value());
+        break;
+    case DAG_node::EK_TEMPORARY:
+        // temporaries are transparent, so inserting them does not change any hash
+        return cast<DAG_temporary>(node)->get_expr()->get_node_hash();
+    case DAG_node::EK_CALL:
+        {
+            DAG_call const *call = cast<DAG_call>(node);
+            int n_args = call->get_argument_count();
+
+            hasher.update('F');
+            hasher.update(n_args);
+            for (int i = 0; i < n_args; ++i) {
+                DAG_hash const &arg_hash = call->get_argument(i)->get_node_hash();
+                hasher.update(arg_hash.data(), arg_hash.size());
+            }
+
+            IDefinition::Semantics sema = call->get_semantic();
+            if (sema != IDefinition::DS_UNKNOWN &&
+                sema != IDefinition::DS_INTRINSIC_DAG_FIELD_ACCESS)
+            {
+                // semantic is enough
+                hasher.update(sema);
+                hash_type(hasher, call->get_type());
+            } else {
+                // name is needed
+                hasher.update(call->get_name());
+            }
+        }
+        break;
+    case DAG_node::EK_PARAMETER:
+        {
+            DAG_parameter const *param = cast<DAG_parameter>(node);
+
+            hasher.update('P');
+            hasher.update(param->get_index());
+            hash_type(hasher, param->get_type());
+        }
+        break;
+    }
+
+    unsigned char result[16];
+    hasher.final(result);
+    return DAG_hash(result);
+}
+
+// Constructor.
+Dag_hasher::Dag_hasher(
+    IAllocator *alloc,
+    MD5_hasher &hasher)
+: m_alloc(alloc)
+, m_node_counter(0)
+, m_marker(0, Visited_node_map::hasher(), Visited_node_map::key_equal(), m_alloc)
+, m_hasher(hasher)
+{
 }
 
 // Walk a DAG IR node.
@@ -608,222 +873,18 @@ void Dag_hasher::hash_parameter(char const *name, IType const *type)
 }
 
 // Hash a type.
-void Dag_hasher::hash(IType const *tp) {
-    IType::Kind kind = tp->get_kind();
-    m_hasher.update(kind);
-
-    switch (kind) {
-    case IType::TK_ALIAS:
-        {
-            IType_alias const *a_tp = cast<IType_alias>(tp);
-            m_hasher.update(a_tp->get_type_modifiers());
-            if (ISymbol const *sym = a_tp->get_symbol())
-                m_hasher.update(sym->get_name());
-            hash(a_tp->get_aliased_type());
-        }
-        break;
-    case IType::TK_BOOL:
-    case IType::TK_INT:
-        break;
-    case IType::TK_ENUM:
-        {
-            IType_enum const *et = cast<IType_enum>(tp);
-
-            m_hasher.update(et->get_symbol()->get_name());
-        }
-        break;
-    case IType::TK_FLOAT:
-    case IType::TK_DOUBLE:
-    case IType::TK_STRING:
-    case IType::TK_LIGHT_PROFILE:
-    case IType::TK_BSDF:
-    case IType::TK_HAIR_BSDF:
-    case IType::TK_EDF:
-    case IType::TK_VDF:
-        break;
-    case IType::TK_VECTOR:
-        {
-            IType_vector const *vt = cast<IType_vector>(tp);
-
-            m_hasher.update(vt->get_size());
-            hash(vt->get_element_type());
-        }
-        break;
-    case IType::TK_MATRIX:
-        {
-            IType_matrix const *mt = cast<IType_matrix>(tp);
-
-            m_hasher.update(mt->get_columns());
-            hash(mt->get_element_type());
-        }
-        break;
-    case IType::TK_ARRAY:
-        {
-            IType_array const *at = cast<IType_array>(tp);
-
-            if (at->is_immediate_sized()) {
-                m_hasher.update(at->get_size());
-            } else {
-                IType_array_size const *sz = at->get_deferred_size();
-
-                m_hasher.update(sz->get_name()->get_name());
-            }
-            hash(at->get_element_type());
-        }
-        break;
-    case IType::TK_COLOR:
-        break;
-    case IType::TK_FUNCTION:
-        {
-            IType_function const *ft = cast<IType_function>(tp);
-
-            if (IType const *ret_type = ft->get_return_type()) {
-                m_hasher.update('R');
-                hash(ret_type);
-            } else {
-                m_hasher.update('N');
-            }
-
-            int n_params = ft->get_parameter_count();
-            m_hasher.update(n_params);
-
-            for (int i = 0; i < n_params; ++i) {
-                IType const *p_tp;
-                ISymbol const *p_sym;
-
-                ft->get_parameter(i, p_tp, p_sym);
-
-                m_hasher.update(p_sym->get_name());
-                hash(p_tp);
-            }
-        }
-        break;
-    case IType::TK_STRUCT:
-        {
-            IType_struct const *st = cast<IType_struct>(tp);
-
-            m_hasher.update(st->get_symbol()->get_name());
-        }
-        break;
-    case IType::TK_TEXTURE:
-        {
-            IType_texture const *tt = cast<IType_texture>(tp);
-
-            m_hasher.update(tt->get_shape());
-        }
-        break;
-    case IType::TK_BSDF_MEASUREMENT:
-    case IType::TK_AUTO:
-    case IType::TK_ERROR:
-        break;
-    }
+void Dag_hasher::hash(IType const *tp)
+{
+    hash_type(m_hasher, tp);
 }
 
 // Hash a value.
-void Dag_hasher::hash(IValue const *v) {
-    IValue::Kind kind = v->get_kind();
-    m_hasher.update(kind);
-
-    switch (kind) {
-    case IValue::VK_BAD:
-        break;
-    case IValue::VK_BOOL:
-        {
-            IValue_bool const *bv = cast<IValue_bool>(v);
-            m_hasher.update(bv->get_value() ? 'T' : 'F');
-        }
-        break;
-    case IValue::VK_INT:
-        {
-            IValue_int const *iv = cast<IValue_int>(v);
-            m_hasher.update(iv->get_value());
-        }
-        break;
-    case IValue::VK_ENUM:
-        {
-            IValue_enum const *ev = cast<IValue_enum>(v);
-            IType_enum const  *et = ev->get_type();
-
-            m_hasher.update(et->get_symbol()->get_name());
-            m_hasher.update(ev->get_value());
-        }
-        break;
-    case IValue::VK_FLOAT:
-        {
-            IValue_float const *fv = cast<IValue_float>(v);
-            m_hasher.update(fv->get_value());
-        }
-        break;
-    case IValue::VK_DOUBLE:
-        {
-            IValue_double const *dv = cast<IValue_double>(v);
-            m_hasher.update(dv->get_value());
-        }
-        break;
-    case IValue::VK_STRING:
-        {
-            IValue_string const *sv = cast<IValue_string>(v);
-            m_hasher.update(sv->get_value());
-        }
-        break;
-    case IValue::VK_STRUCT:
-        {
-            IValue_struct const *sv = cast<IValue_struct>(v);
-            IType_struct const  *st = sv->get_type();
-
-            m_hasher.update(st->get_symbol()->get_name());
-        }
-        // fallthrough
-    case IValue::VK_VECTOR:
-    case IValue::VK_MATRIX:
-    case IValue::VK_ARRAY:
-    case IValue::VK_RGB_COLOR:
-        {
-            IValue_compound const *cv = cast<IValue_compound>(v);
-
-            for (int i = 0, n = cv->get_component_count(); i < n; ++i) {
-                IValue const *child = cv->get_value(i);
-                hash(child);
-            }
-        }
-        break;
-    case IValue::VK_INVALID_REF:
-        {
-            IValue_invalid_ref const *iv = cast<IValue_invalid_ref>(v);
-            IType_reference const    *it = iv->get_type();
-
-            int tkind = it->get_kind();
-            m_hasher.update(tkind);
-        }
-        break;
-    case IValue::VK_TEXTURE:
-        {
-            IValue_texture const *tv = cast<IValue_texture>(v);
-            m_hasher.update(tv->get_string_value());
-            m_hasher.update(tv->get_gamma_mode());
-            m_hasher.update(tv->get_tag_value());
-            m_hasher.update(tv->get_tag_version());
-        }
-        break;
-    case IValue::VK_LIGHT_PROFILE:
-        {
-            IValue_light_profile const *lv = cast<IValue_light_profile>(v);
-            m_hasher.update(lv->get_string_value());
-            m_hasher.update(lv->get_tag_value());
-            m_hasher.update(lv->get_tag_version());
-        }
-        break;
-    case IValue::VK_BSDF_MEASUREMENT:
-        {
-            IValue_bsdf_measurement const *lv = cast<IValue_bsdf_measurement>(v);
-            m_hasher.update(lv->get_string_value());
-            m_hasher.update(lv->get_tag_value());
-            m_hasher.update(lv->get_tag_version());
-        }
-        break;
-    }
+void Dag_hasher::hash(IValue const *v)
+{
+    hash_value(m_hasher, v);
 }
 
 
+
 } // mdl
 } // mi
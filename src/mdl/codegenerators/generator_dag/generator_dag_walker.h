@@ -156,20 +156,6 @@ public:
         IAllocator *alloc,
         MD5_hasher &hasher);
 
-    /// Hash the IR nodes of an instance.
-    ///
-    /// \param instance   the instance that will be visited
-    void hash_instance(
-        Generated_code_dag::Material_instance const *instance);
-
-    /// Hash the IR nodes of an instance material slot.
-    ///
-    /// \param instance   the instance that will be visited
-    /// \param slot       the material slot
-    void hash_instance_slot(
-        Generated_code_dag::Material_instance       *instance,
-        Generated_code_dag::Material_instance::Slot slot);
-
     /// Hash a DAG IR staring at a given node.
     ///
     /// \param node  the root node
@@ -228,6 +214,24 @@ private:
     MD5_hasher &m_hasher;
 };
 
+/// Get the root node of an instance material slot.
+///
+/// \param instance   the instance
+/// \param slot       the material slot
+///
+/// \return the node computing the slot, a temporary constant if the slot is folded into a value
+DAG_node const *get_instance_slot_node(
+    Generated_code_dag::Material_instance       *instance,
+    Generated_code_dag::Material_instance::Slot slot);
+
+/// Compute the node hash of a DAG IR node.
+///
+/// The node hash is a structural hash computed from the node itself and the node hashes of its
+/// arguments, so it must be computed bottom-up. Temporaries have the hash of their expression.
+///
+/// \param node  the node
+DAG_hash calc_node_hash(DAG_node const *node);
+
 } // mdl
 } // mi
 
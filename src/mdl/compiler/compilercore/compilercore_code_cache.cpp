@@ -29,12 +29,214 @@
 #include "pch.h"
 
 #include "compilercore_code_cache.h"
+#include "compilercore_file_utils.h"
+#include "compilercore_hash.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <cstdio>
+
+#ifdef MI_PLATFORM_WINDOWS
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
 
 namespace mi {
 namespace mdl {
 
+namespace {
+
+/// Magic number and version of the disk tier file format.
+unsigned char const disk_magic[8] = { 'M', 'D', 'L', 'C', 'C', 'E', 0, 2 };
+
+/// The size of the disk tier file header: magic, key, build key, payload size, payload checksum.
+size_t const disk_header_size = sizeof(disk_magic) + 16 + 16 + 8 + 8;
+
+/// Offset of the build key in the disk tier file header.
+size_t const disk_build_key_offset = sizeof(disk_magic) + 16;
+
+/// Offset of the payload size in the disk tier file header.
+size_t const disk_size_offset = disk_build_key_offset + 16;
+
+/// The extension of disk tier files.
+char const disk_ext[] = ".mcc";
+
+/// The extension of temporary disk tier files.
+char const disk_tmp_ext[] = ".tmp";
+
+/// Temporary files older than this (in seconds) are leftovers of crashed processes.
+time_t const disk_stale_tmp_age = 60 * 60;
+
+/// Compute the FNV-1a hash of a data block.
+uint64_t fnv1a_64(unsigned char const *data, size_t size)
+{
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; ++i) {
+        h ^= data[i];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+/// Store a 64bit value in little endian byte order.
+void store_u64(unsigned char *p, uint64_t v)
+{
+    for (int i = 0; i < 8; ++i) {
+        p[i] = (unsigned char)(v >> (8 * i));
+    }
+}
+
+/// Load a 64bit value in little endian byte order.
+uint64_t load_u64(unsigned char const *p)
+{
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; --i) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+/// Check if a string ends with the given suffix.
+bool has_suffix(string const &s, char const *suffix)
+{
+    size_t l = strlen(suffix);
+    return s.size() >= l && s.compare(s.size() - l, l, suffix) == 0;
+}
+
+/// Get the ID of the current process.
+unsigned get_process_id()
+{
+#ifdef MI_PLATFORM_WINDOWS
+    return unsigned(_getpid());
+#else
+    return unsigned(getpid());
+#endif
+}
+
+/// Serializes a cache entry into a byte buffer.
+class Entry_writer {
+public:
+    /// Constructor.
+    explicit Entry_writer(IAllocator *alloc)
+    : m_data(alloc)
+    {
+    }
+
+    /// Write a 64bit value.
+    void write(uint64_t v)
+    {
+        size_t pos = m_data.size();
+        m_data.resize(pos + 8);
+        store_u64(&m_data[pos], v);
+    }
+
+    /// Write a data block prefixed by its size.
+    void write_blob(char const *data, size_t size)
+    {
+        write(size);
+        m_data.insert(m_data.end(), data, data + size);
+    }
+
+    /// Write a string including its terminating zero, prefixed by its length.
+    void write_string(char const *s)
+    {
+        size_t len = strlen(s);
+        write(len);
+        m_data.insert(m_data.end(), s, s + len + 1);
+    }
+
+    /// Get the serialized data.
+    vector<unsigned char>::Type const &get_data() const { return m_data; }
+
+private:
+    vector<unsigned char>::Type m_data;
+};
+
+/// Deserializes a cache entry from a byte buffer. All returned pointers point into the buffer.
+class Entry_reader {
+public:
+    /// Constructor.
+    Entry_reader(unsigned char const *data, size_t size)
+    : m_data(data)
+    , m_size(size)
+    , m_pos(0)
+    {
+    }
+
+    /// Read a 64bit value.
+    bool read_u64(uint64_t &v)
+    {
+        if (m_size - m_pos < 8)
+            return false;
+        v = load_u64(m_data + m_pos);
+        m_pos += 8;
+        return true;
+    }
+
+    /// Read a size value.
+    bool read_size(size_t &v)
+    {
+        uint64_t t;
+        if (!read_u64(t) || t != uint64_t(size_t(t)))
+            return false;
+        v = size_t(t);
+        return true;
+    }
+
+    /// Read a data block prefixed by its size.
+    bool read_blob(char const *&data, size_t &size)
+    {
+        if (!read_size(size) || m_size - m_pos < size)
+            return false;
+        data = (char const *)(m_data + m_pos);
+        m_pos += size;
+        return true;
+    }
+
+    /// Read a zero terminated string prefixed by its length.
+    bool read_string(char const *&s)
+    {
+        size_t len;
+        if (!read_size(len) || m_size - m_pos <= len || m_data[m_pos + len] != 0)
+            return false;
+        s = (char const *)(m_data + m_pos);
+        m_pos += len + 1;
+        return true;
+    }
+
+    /// Returns true if all data was consumed.
+    bool at_end() const { return m_pos == m_size; }
+
+private:
+    unsigned char const *m_data;
+    size_t              m_size;
+    size_t              m_pos;
+};
+
+/// A file of the disk tier.
+struct Disk_file {
+    /// Constructor.
+    Disk_file(string const &path, size_t size, time_t mtime)
+    : path(path), size(size), mtime(mtime)
+    {
+    }
+
+    string path;
+    size_t size;
+    time_t mtime;
+};
+
+/// Orders disk tier files by the time of their last use.
+struct Disk_file_older {
+    bool operator()(Disk_file const &a, Disk_file const &b) const
+    {
+        return a.mtime < b.mtime;
+    }
+};
+
+}  // anonymous
+
 // Constructor.
 Code_cache::Cache_entry::Cache_entry(
     IAllocator          *alloc,
@@ -102,6 +304,7 @@ Code_cache::Cache_entry::Cache_entry(
             }
 
             cur_info->arg_block_index = entry.func_infos[i].arg_block_index;
+            cur_info->state_usage     = entry.func_infos[i].state_usage;
 
             cur_info->num_df_handles = entry.func_infos[i].num_df_handles;
             if (cur_info->num_df_handles == 0) {
@@ -143,34 +346,361 @@ Code_cache::Cache_entry::~Cache_entry()
 // Lookup a data blob.
 Code_cache::Entry const *Code_cache::lookup(unsigned char const key[16]) const
 {
-    mi::base::Lock::Block block(&m_cache_lock);
+    {
+        mi::base::Lock::Block block(&m_cache_lock);
+
+        Search_map::const_iterator it = m_search_map.find(Key(key));
+        if (it != m_search_map.end()) {
+            // found
+            Cache_entry *p = it->second;
+            to_front(*p);
+            return p;
+        }
+    }
+    if (m_disk_path.empty())
+        return NULL;
 
+    // the disk tier is logically part of the cache, so loading from it does not change
+    // the observable state
+    return const_cast<Code_cache *>(this)->load_from_disk(key);
+}
+
+// Enter a data blob.
+bool Code_cache::enter(unsigned char const key[16], Entry const &entry)
+{
+    {
+        mi::base::Lock::Block block(&m_cache_lock);
+
+        // don't try to enter it if it doesn't fit into the cache at all
+        if (entry.get_cache_data_size() > m_max_size)
+            return false;
+
+        enter_memory(key, entry);
+    }
+    if (!m_disk_path.empty())
+        store_to_disk(key, entry);
+    return true;
+}
+
+// Enter an entry into the memory tier.
+Code_cache::Cache_entry *Code_cache::enter_memory(
+    unsigned char const key[16],
+    Entry const         &entry)
+{
     Search_map::const_iterator it = m_search_map.find(Key(key));
     if (it != m_search_map.end()) {
-        // found
+        // already entered, possibly by another thread loading it from disk
         Cache_entry *p = it->second;
         to_front(*p);
         return p;
     }
-    return NULL;
+
+    m_curr_size += entry.get_cache_data_size();
+    strip_size();
+
+    Cache_entry *res = new_entry(entry, key);
+
+    m_search_map.insert(Search_map::value_type(res->m_key, res));
+    return res;
 }
 
-// Enter a data blob.
-bool Code_cache::enter(unsigned char const key[16], Entry const &entry)
+// Get the file name of the disk tier entry for the given key.
+string Code_cache::get_disk_file_name(unsigned char const key[16], string *subdir) const
 {
-    mi::base::Lock::Block block(&m_cache_lock);
+    static char const hex[] = "0123456789abcdef";
+
+    // different builds might produce different code for the same key, so they must not
+    // share files
+    unsigned char file_key[16];
+    MD5_hasher hasher;
+    hasher.update(key, 16);
+    hasher.update(m_build_key, 16);
+    hasher.final(file_key);
+
+    char name[2 * 16 + 1];
+    for (size_t i = 0; i < 16; ++i) {
+        name[2 * i]     = hex[file_key[i] >> 4];
+        name[2 * i + 1] = hex[file_key[i] & 15];
+    }
+    name[2 * 16] = '\0';
+
+    // spread the files over 256 sub-directories named after the first key byte
+    string dir(join_path(m_disk_path, string(name, 2, get_allocator())));
+    string fname(join_path(dir, string(name, get_allocator())));
+    fname += disk_ext;
+
+    if (subdir != NULL)
+        *subdir = dir;
+    return fname;
+}
+
+// Try to load an entry from the disk tier into the memory tier.
+Code_cache::Cache_entry *Code_cache::load_from_disk(unsigned char const key[16])
+{
+    IAllocator *alloc = get_allocator();
+    string     fname(get_disk_file_name(key, NULL));
+
+    FILE *f = fopen_utf8(alloc, fname.c_str(), "rb");
+    if (f == NULL)
+        return NULL;
+
+    unsigned char header[disk_header_size];
+    vector<unsigned char>::Type payload(alloc);
+
+    bool valid = fread(header, 1, disk_header_size, f) == disk_header_size &&
+        memcmp(header, disk_magic, sizeof(disk_magic)) == 0 &&
+        memcmp(header + sizeof(disk_magic), key, 16) == 0 &&
+        memcmp(header + disk_build_key_offset, m_build_key, 16) == 0;
+
+    uint64_t payload_size = valid ? load_u64(header + disk_size_offset) : 0;
+    uint64_t checksum     = valid ? load_u64(header + disk_size_offset + 8) : 0;
+
+    // the encoding adds a size to every string and block, but an entry much larger than the
+    // memory tier could not be used anyway
+    valid = valid && payload_size <= 2 * uint64_t(m_max_size) + (1u << 20);
+    if (valid) {
+        payload.resize(size_t(payload_size));
+        valid = payload_size == 0 ||
+            fread(&payload[0], 1, payload.size(), f) == payload.size();
+        valid = valid && fgetc(f) == EOF;
+    }
+    fclose(f);
+
+    unsigned char const *data = payload.empty() ? NULL : &payload[0];
+    valid = valid && fnv1a_64(data, payload.size()) == checksum;
+
+    // decode the entry
+    char const *code = NULL, *const_seg = NULL, *arg_layout = NULL;
+    size_t code_size = 0, const_seg_size = 0, arg_layout_size = 0;
+    uint64_t render_state_usage = 0;
+    size_t n_mapped = 0, n_infos = 0;
+
+    vector<char const *>::Type     mapped(alloc);
+    vector<Entry::Func_info>::Type infos(alloc);
+    vector<char const *>::Type     df_handles(alloc);
+    vector<size_t>::Type           df_handle_starts(alloc);
+
+    Entry_reader reader(data, payload.size());
+    valid = valid &&
+        reader.read_blob(code, code_size) &&
+        reader.read_blob(const_seg, const_seg_size) &&
+        reader.read_blob(arg_layout, arg_layout_size) &&
+        reader.read_u64(render_state_usage) &&
+        reader.read_size(n_mapped) &&
+        n_mapped <= payload.size();
+
+    for (size_t i = 0; valid && i < n_mapped; ++i) {
+        char const *s = NULL;
+        valid = reader.read_string(s);
+        mapped.push_back(s);
+    }
+
+    valid = valid && reader.read_size(n_infos) && n_infos <= payload.size();
+    for (size_t i = 0; valid && i < n_infos; ++i) {
+        Entry::Func_info info;
+        uint64_t dist_kind = 0, func_kind = 0, state_usage = 0;
+
+        valid = reader.read_string(info.name) &&
+            reader.read_u64(dist_kind) &&
+            reader.read_u64(func_kind);
+        for (int j = 0;
+            valid && j < int(mi::mdl::IGenerated_code_executable::PL_NUM_LANGUAGES);
+            ++j)
+        {
+            valid = reader.read_string(info.prototypes[j]);
+        }
+        valid = valid &&
+            reader.read_size(info.arg_block_index) &&
+            reader.read_size(info.num_df_handles) &&
+            info.num_df_handles <= payload.size();
+
+        df_handle_starts.push_back(df_handles.size());
+        for (size_t j = 0; valid && j < info.num_df_handles; ++j) {
+            char const *s = NULL;
+            valid = reader.read_string(s);
+            df_handles.push_back(s);
+        }
+        valid = valid && reader.read_u64(state_usage);
+
+        info.dist_kind   = IGenerated_code_executable::Distribution_kind(dist_kind);
+        info.func_kind   = IGenerated_code_executable::Function_kind(func_kind);
+        info.df_handles  = NULL;
+        info.state_usage = IGenerated_code_executable::State_usage(state_usage);
+        infos.push_back(info);
+    }
+    valid = valid && reader.at_end();
+
+    if (!valid) {
+        // corrupt or written by an incompatible build, drop it
+        remove_file_utf8(alloc, fname.c_str());
+        return NULL;
+    }
+
+    // df_handles might have been reallocated while reading, so set the pointers now
+    for (size_t i = 0; i < n_infos; ++i) {
+        if (infos[i].num_df_handles > 0)
+            infos[i].df_handles = &df_handles[df_handle_starts[i]];
+    }
+
+    Entry entry(
+        code, code_size,
+        const_seg, const_seg_size,
+        arg_layout, arg_layout_size,
+        mapped.empty() ? NULL : &mapped[0], n_mapped,
+        unsigned(render_state_usage),
+        infos.empty() ? NULL : &infos[0], n_infos);
 
-    // don't try to enter it if it doesn't fit into the cache at all
     if (entry.get_cache_data_size() > m_max_size)
-        return false;
+        return NULL;
 
-    m_curr_size += entry.get_cache_data_size();
-    strip_size();
+    // mark it as recently used for the disk tier LRU
+    touch_file_utf8(alloc, fname.c_str());
 
-    Cache_entry *res = new_entry(entry, key);
+    mi::base::Lock::Block block(&m_cache_lock);
+    return enter_memory(key, entry);
+}
 
-    m_search_map.insert(Search_map::value_type(res->m_key, res));
-    return true;
+// Serialize an entry into the disk tier.
+void Code_cache::store_to_disk(unsigned char const key[16], Entry const &entry)
+{
+    IAllocator *alloc = get_allocator();
+
+    string subdir(alloc);
+    string fname(get_disk_file_name(key, &subdir));
+
+    // the disk tier is content-addressed, so an existing file has the same content
+    if (is_file_utf8(alloc, fname.c_str())) {
+        touch_file_utf8(alloc, fname.c_str());
+        return;
+    }
+
+    Entry_writer writer(alloc);
+    writer.write_blob(entry.code, entry.code_size);
+    writer.write_blob(entry.const_seg, entry.const_seg_size);
+    writer.write_blob(entry.arg_layout, entry.arg_layout_size);
+    writer.write(entry.render_state_usage);
+
+    writer.write(entry.mapped_string_size);
+    for (size_t i = 0; i < entry.mapped_string_size; ++i)
+        writer.write_string(entry.mapped_strings[i]);
+
+    writer.write(entry.func_info_size);
+    for (size_t i = 0; i < entry.func_info_size; ++i) {
+        Entry::Func_info const &info = entry.func_infos[i];
+
+        writer.write_string(info.name);
+        writer.write(uint64_t(info.dist_kind));
+        writer.write(uint64_t(info.func_kind));
+        for (int j = 0; j < int(mi::mdl::IGenerated_code_executable::PL_NUM_LANGUAGES); ++j)
+            writer.write_string(info.prototypes[j]);
+        writer.write(info.arg_block_index);
+        writer.write(info.num_df_handles);
+        for (size_t j = 0; j < info.num_df_handles; ++j)
+            writer.write_string(info.df_handles[j]);
+        writer.write(info.state_usage);
+    }
+
+    vector<unsigned char>::Type const &payload = writer.get_data();
+    unsigned char const *data = payload.empty() ? NULL : &payload[0];
+
+    unsigned char header[disk_header_size];
+    memcpy(header, disk_magic, sizeof(disk_magic));
+    memcpy(header + sizeof(disk_magic), key, 16);
+    memcpy(header + disk_build_key_offset, m_build_key, 16);
+    store_u64(header + disk_size_offset, payload.size());
+    store_u64(header + disk_size_offset + 8, fnv1a_64(data, payload.size()));
+
+    unsigned counter;
+    {
+        mi::base::Lock::Block block(&m_disk_lock);
+        counter = m_tmp_counter++;
+    }
+
+    // write into a file private to this process and call and rename it into place, so
+    // readers never see a partially written file
+    char suffix[64];
+    snprintf(suffix, sizeof(suffix), ".%u.%u%s", get_process_id(), counter, disk_tmp_ext);
+    string tmp_name(fname);
+    tmp_name += suffix;
+
+    // the directory might already exist or might be created concurrently
+    mkdir_utf8(alloc, subdir.c_str());
+
+    FILE *f = fopen_utf8(alloc, tmp_name.c_str(), "wb");
+    if (f == NULL)
+        return;
+
+    bool ok = fwrite(header, 1, disk_header_size, f) == disk_header_size &&
+        (payload.empty() || fwrite(data, 1, payload.size(), f) == payload.size());
+    ok = fclose(f) == 0 && ok;
+
+    if (!ok || !rename_file_utf8(alloc, tmp_name.c_str(), fname.c_str())) {
+        remove_file_utf8(alloc, tmp_name.c_str());
+        return;
+    }
+
+    mi::base::Lock::Block block(&m_disk_lock);
+
+    m_disk_size += disk_header_size + payload.size();
+    if (m_disk_size > m_max_disk_size) {
+        // prune some more than necessary, so this does not happen on every store
+        prune_disk(m_max_disk_size - m_max_disk_size / 4);
+    }
+}
+
+// Scan the disk tier, update its current size and drop the least recently used files
+// if the size limit is exceeded.
+void Code_cache::prune_disk(size_t target_size)
+{
+    IAllocator *alloc = get_allocator();
+
+    vector<Disk_file>::Type files(alloc);
+    size_t total_size = 0;
+    time_t now = time(NULL);
+
+    Directory root(alloc);
+    if (!root.open(m_disk_path.c_str()))
+        return;
+
+    for (char const *name = root.read(); name != NULL; name = root.read()) {
+        if (name[0] == '.')
+            continue;
+
+        string subdir(join_path(m_disk_path, string(name, alloc)));
+
+        Directory dir(alloc);
+        if (!dir.open(subdir.c_str()))
+            continue;
+
+        for (char const *fname = dir.read(); fname != NULL; fname = dir.read()) {
+            string path(join_path(subdir, string(fname, alloc)));
+            size_t size  = 0;
+            time_t mtime = 0;
+
+            if (!get_file_info_utf8(alloc, path.c_str(), size, mtime))
+                continue;
+
+            if (has_suffix(path, disk_tmp_ext)) {
+                // might be in use by another process unless it is really old
+                if (now - mtime > disk_stale_tmp_age)
+                    remove_file_utf8(alloc, path.c_str());
+            } else if (has_suffix(path, disk_ext)) {
+                files.push_back(Disk_file(path, size, mtime));
+                total_size += size;
+            }
+        }
+    }
+
+    if (total_size > target_size) {
+        std::sort(files.begin(), files.end(), Disk_file_older());
+
+        for (size_t i = 0, n = files.size(); i < n && total_size > target_size; ++i) {
+            // ignore failures, the file might have been removed by another process
+            remove_file_utf8(alloc, files[i].path.c_str());
+            total_size -= files[i].size;
+        }
+    }
+    m_disk_size = total_size;
 }
 
 // Create a new entry and put it in front.
@@ -241,7 +771,10 @@ void Code_cache::strip_size()
 // Constructor.
 Code_cache::Code_cache(
     IAllocator *alloc,
-    size_t     max_size)
+    size_t     max_size,
+    char const *disk_path,
+    size_t     max_disk_size,
+    char const *build_id)
 : Base(alloc)
 , m_cache_lock()
 , m_head(NULL)
@@ -249,7 +782,25 @@ Code_cache::Code_cache(
 , m_search_map(Search_map::key_compare(), alloc)
 , m_max_size(max_size)
 , m_curr_size(0)
+, m_disk_lock()
+, m_disk_path(alloc)
+, m_max_disk_size(max_disk_size)
+, m_disk_size(0)
+, m_tmp_counter(0)
 {
+    MD5_hasher hasher;
+    hasher.update(build_id);
+    hasher.final(m_build_key);
+
+    if (disk_path != NULL && disk_path[0] != '\0' && max_disk_size > 0) {
+        if (is_directory_utf8(alloc, disk_path) || mkdir_utf8(alloc, disk_path)) {
+            m_disk_path = disk_path;
+
+            // determine the current size, another process might have left a too large tier
+            mi::base::Lock::Block block(&m_disk_lock);
+            prune_disk(m_max_disk_size);
+        }
+    }
 }
 
 // Destructor.
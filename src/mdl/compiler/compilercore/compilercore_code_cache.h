@@ -30,6 +30,7 @@
 #define MDL_COMPILERCORE_CODE_CACHE_H 1
 
 #include <cstring>
+#include <ctime>
 
 #include <mi/base/lock.h>
 #include <mi/mdl/mdl_code_generators.h>
@@ -41,6 +42,12 @@ namespace mi {
 namespace mdl {
 
 /// The code cache helper class.
+///
+/// Entries are held in an in-memory LRU. Optionally, a disk directory can be attached which
+/// acts as a second, persistent tier: every entered blob is serialized into a content-addressed
+/// file named after its key and the build identity, and memory misses are resolved from there.
+/// Files are written to a temporary name and renamed into place, so several processes (even of
+/// different builds) may share the same directory.
 class Code_cache : public Allocator_interface_implement<mi::mdl::ICode_cache>
 {
     typedef Allocator_interface_implement<mi::mdl::ICode_cache> Base;
@@ -126,11 +133,46 @@ private:
     // Drop entries from the end until size is reached.
     void strip_size();
 
+    /// Enter an entry into the memory tier.
+    /// Assumes that the cache lock is held.
+    Cache_entry *enter_memory(unsigned char const key[16], Entry const &entry);
+
+    /// Get the file name of the disk tier entry for the given key.
+    ///
+    /// \param key     the key
+    /// \param subdir  if non-NULL, receives the name of the containing directory
+    string get_disk_file_name(unsigned char const key[16], string *subdir) const;
+
+    /// Try to load an entry from the disk tier into the memory tier.
+    ///
+    /// \return the loaded entry or NULL if it is not on disk or the file is corrupt
+    Cache_entry *load_from_disk(unsigned char const key[16]);
+
+    /// Serialize an entry into the disk tier.
+    void store_to_disk(unsigned char const key[16], Entry const &entry);
+
+    /// Scan the disk tier, update its current size and drop the least recently used files
+    /// if the size limit is exceeded.
+    ///
+    /// \param target_size  drop files until the disk tier is not larger than this
+    void prune_disk(size_t target_size);
+
 public:
     /// Constructor.
+    ///
+    /// \param alloc          the allocator
+    /// \param max_size       the maximum size of the memory tier in bytes
+    /// \param disk_path      if non-NULL and non-empty, the UTF8 encoded directory of the disk
+    ///                       tier; it is created if it does not exist
+    /// \param max_disk_size  the maximum size of the disk tier in bytes
+    /// \param build_id       identifies the build of the code generators; disk tier files
+    ///                       written by a different build are ignored and removed
     Code_cache(
         IAllocator *alloc,
-        size_t     max_size);
+        size_t     max_size,
+        char const *disk_path = NULL,
+        size_t     max_disk_size = 0,
+        char const *build_id = NULL);
 
     /// Destructor.
     virtual ~Code_cache();
@@ -151,6 +193,24 @@ private:
 
     /// Current size.
     size_t m_curr_size;
+
+    /// Protects the disk tier bookkeeping.
+    mutable mi::base::Lock m_disk_lock;
+
+    /// The directory of the disk tier, empty if disabled.
+    string m_disk_path;
+
+    /// Maximum size of the disk tier.
+    size_t m_max_disk_size;
+
+    /// Current size of the disk tier as far as known to this process.
+    size_t m_disk_size;
+
+    /// Counter used to create unique temporary file names.
+    unsigned m_tmp_counter;
+
+    /// The MD5 hash of the build identity, stored in and mixed into the name of disk tier files.
+    unsigned char m_build_key[16];
 };
 
 }  // mdl
@@ -0,0 +1,152 @@
+/******************************************************************************
+ * Copyright (c) 2019-2024, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include "pch.h"
+
+#include "compilercore_file_index_cache.h"
+
+namespace mi {
+namespace mdl {
+
+namespace {
+
+/// Files modified within this many seconds before they were read might be modified again
+/// without changing their time stamp, which has a granularity of up to two seconds.
+time_t const mtime_granularity = 2;
+
+}  // anonymous
+
+// Constructor.
+File_index::File_index(IAllocator *alloc, size_t size, time_t mtime)
+: Base(alloc)
+, m_names(alloc)
+, m_keys(0, Name_set::hasher(), Name_set::key_equal(), alloc)
+, m_size(size)
+, m_mtime(mtime)
+, m_valid(false)
+, m_err(EC_OK)
+{
+}
+
+// Add a name.
+void File_index::add_name(char const *name, char const *key)
+{
+    IAllocator *alloc = get_allocator();
+
+    m_names.push_back(string(name, alloc));
+    m_keys.insert(string(key, alloc));
+}
+
+// Check if the index contains a name with the given lookup key.
+bool File_index::contains(char const *key) const
+{
+    return m_keys.find(string(key, get_allocator())) != m_keys.end();
+}
+
+// Constructor.
+File_index_cache::File_index_cache(IAllocator *alloc, size_t max_entries)
+: m_alloc(alloc)
+, m_lock()
+, m_lru(alloc)
+, m_indexes(0, Index_map::hasher(), Index_map::key_equal(), alloc)
+, m_max_entries(max_entries)
+{
+}
+
+// Lookup an index.
+mi::base::Handle<File_index const> File_index_cache::lookup(
+    char const *key,
+    size_t     size,
+    time_t     mtime)
+{
+    mi::base::Lock::Block block(&m_lock);
+
+    Index_map::iterator it(m_indexes.find(string(key, m_alloc)));
+    if (it == m_indexes.end()) {
+        return mi::base::Handle<File_index const>();
+    }
+
+    Entry &entry = it->second;
+    if (entry.m_index->get_size() != size || entry.m_index->get_mtime() != mtime) {
+        // stale
+        m_lru.erase(entry.m_lru_pos);
+        m_indexes.erase(it);
+        return mi::base::Handle<File_index const>();
+    }
+
+    m_lru.splice(m_lru.begin(), m_lru, entry.m_lru_pos);
+    return entry.m_index;
+}
+
+// Enter an index that was just read, unless its file was modified too recently.
+void File_index_cache::enter(char const *key, File_index const *index)
+{
+    if (m_max_entries == 0 || time(NULL) - index->get_mtime() <= mtime_granularity) {
+        return;
+    }
+
+    mi::base::Lock::Block block(&m_lock);
+
+    string k(key, m_alloc);
+
+    Index_map::iterator it(m_indexes.find(k));
+    if (it != m_indexes.end()) {
+        // entered concurrently or replaces a stale index
+        it->second.m_index = mi::base::make_handle_dup(index);
+        m_lru.splice(m_lru.begin(), m_lru, it->second.m_lru_pos);
+        return;
+    }
+
+    while (m_indexes.size() >= m_max_entries) {
+        m_indexes.erase(m_lru.back());
+        m_lru.pop_back();
+    }
+
+    m_lru.push_front(k);
+    m_indexes.insert(Index_map::value_type(k, Entry(index, m_lru.begin())));
+}
+
+// Drop all cached indexes.
+void File_index_cache::clear()
+{
+    mi::base::Lock::Block block(&m_lock);
+
+    m_indexes.clear();
+    m_lru.clear();
+}
+
+// Get the number of cached indexes.
+size_t File_index_cache::size() const
+{
+    mi::base::Lock::Block block(&m_lock);
+
+    return m_indexes.size();
+}
+
+}  // mdl
+}  // mi
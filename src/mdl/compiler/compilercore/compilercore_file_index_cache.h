@@ -0,0 +1,229 @@
+/******************************************************************************
+ * Copyright (c) 2019-2024, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef MDL_COMPILERCORE_FILE_INDEX_CACHE_H
+#define MDL_COMPILERCORE_FILE_INDEX_CACHE_H 1
+
+#include <ctime>
+
+#include <mi/base/handle.h>
+#include <mi/base/iinterface.h>
+#include <mi/base/lock.h>
+
+#include "compilercore_cc_conf.h"
+#include "compilercore_allocator.h"
+#include "compilercore_file_utils.h"
+#include "compilercore_zip_utils.h"
+
+namespace mi {
+namespace mdl {
+
+/// The names of the files inside a container (an MDL archive or an MDLE file) or a directory.
+class File_index : public Allocator_interface_implement<mi::base::IInterface>
+{
+    typedef Allocator_interface_implement<mi::base::IInterface> Base;
+    friend class Allocator_builder;
+public:
+    typedef vector<string>::Type Name_vector;
+
+    /// Add a name.
+    ///
+    /// \param name  the name
+    /// \param key   the lookup key of the name, for instance the case folded name
+    void add_name(char const *name, char const *key);
+
+    /// Check if the index contains a name with the given lookup key.
+    bool contains(char const *key) const;
+
+    /// Get all names in the order they were added.
+    Name_vector const &get_names() const { return m_names; }
+
+    /// Get the size of the file the index was read from.
+    size_t get_size() const { return m_size; }
+
+    /// Get the time of the last modification of the file the index was read from.
+    time_t get_mtime() const { return m_mtime; }
+
+    /// Returns true, if the container or directory could be read.
+    bool is_valid() const { return m_valid; }
+
+    /// Set whether the container or directory could be read.
+    void set_valid(bool valid) { m_valid = valid; }
+
+    /// Get the error code of opening a container.
+    MDL_zip_container_error_code get_error() const { return m_err; }
+
+    /// Set the error code of opening a container.
+    void set_error(MDL_zip_container_error_code err) { m_err = err; }
+
+private:
+    /// Constructor.
+    ///
+    /// \param alloc  the allocator
+    /// \param size   the size of the file the index is read from
+    /// \param mtime  the time of the last modification of the file the index is read from
+    File_index(IAllocator *alloc, size_t size, time_t mtime);
+
+private:
+    typedef hash_set<string, string_hash<string> >::Type Name_set;
+
+    /// The names in the order they were added.
+    Name_vector m_names;
+
+    /// The lookup keys of all names.
+    Name_set m_keys;
+
+    /// The size of the file the index was read from.
+    size_t m_size;
+
+    /// The time of the last modification of the file the index was read from.
+    time_t m_mtime;
+
+    /// True, if the container or directory could be read.
+    bool m_valid;
+
+    /// The error code of opening a container.
+    MDL_zip_container_error_code m_err;
+};
+
+/// A size-bounded cache of the indexes of containers and directories, shared by all file
+/// resolvers of a compiler.
+///
+/// Checking whether a container or a directory of the search paths contains a file would
+/// otherwise open the container and parse its central directory or list the directory, which is
+/// slow on network file systems. Cached indexes are validated by the size and the time of the
+/// last modification of the file they were read from. Indexes of files that were modified within
+/// the time stamp granularity before they were read are not entered, because a later
+/// modification might keep both size and time stamp. The least recently used indexes are dropped
+/// if the cache is full.
+class File_index_cache {
+public:
+    /// Constructor.
+    ///
+    /// \param alloc        the allocator
+    /// \param max_entries  the maximum number of cached indexes
+    File_index_cache(IAllocator *alloc, size_t max_entries);
+
+    /// Get the index of a container or directory, reading it if it is not cached or stale.
+    ///
+    /// \param key   the cache key, must distinguish different readers of the same path
+    /// \param path  the UTF8 encoded path of the container or directory
+    /// \param read  a functor filling a File_index from path
+    ///
+    /// \return the index or an invalid handle if path does not exist
+    template<typename Reader>
+    mi::base::Handle<File_index const> get(
+        char const   *key,
+        char const   *path,
+        Reader const &read)
+    {
+        size_t size  = 0;
+        time_t mtime = 0;
+        if (!get_file_info_utf8(m_alloc, path, size, mtime)) {
+            // not cached, the file might be created later
+            return mi::base::Handle<File_index const>();
+        }
+
+        mi::base::Handle<File_index const> index(lookup(key, size, mtime));
+        if (index) {
+            return index;
+        }
+
+        // read the index outside the lock, concurrent threads might do the same work, but do
+        // not block each other
+        Allocator_builder builder(m_alloc);
+        mi::base::Handle<File_index> new_index(
+            builder.create<File_index>(m_alloc, size, mtime));
+        read(*new_index.get(), path);
+
+        enter(key, new_index.get());
+        return mi::base::make_handle_dup<File_index const>(new_index.get());
+    }
+
+    /// Lookup an index.
+    ///
+    /// \param key    the cache key
+    /// \param size   the current size of the file of the index
+    /// \param mtime  the current time of the last modification of the file of the index
+    ///
+    /// \return the index or an invalid handle if it is not cached or stale
+    mi::base::Handle<File_index const> lookup(char const *key, size_t size, time_t mtime);
+
+    /// Enter an index that was just read, unless its file was modified too recently.
+    ///
+    /// \param key    the cache key
+    /// \param index  the index
+    void enter(char const *key, File_index const *index);
+
+    /// Drop all cached indexes.
+    void clear();
+
+    /// Get the number of cached indexes.
+    size_t size() const;
+
+private:
+    typedef list<string>::Type Lru_list;
+
+    /// A cached index.
+    struct Entry {
+        /// Constructor.
+        Entry(File_index const *index, Lru_list::iterator lru_pos)
+        : m_index(mi::base::make_handle_dup(index))
+        , m_lru_pos(lru_pos)
+        {
+        }
+
+        /// The index.
+        mi::base::Handle<File_index const> m_index;
+
+        /// The position of the key in the LRU list.
+        Lru_list::iterator m_lru_pos;
+    };
+
+    typedef hash_map<string, Entry, string_hash<string> >::Type Index_map;
+
+    /// The allocator.
+    IAllocator *m_alloc;
+
+    /// Protects the map and the LRU list.
+    mutable mi::base::Lock m_lock;
+
+    /// The keys of all cached indexes, most recently used first.
+    Lru_list m_lru;
+
+    /// The cached indexes.
+    Index_map m_indexes;
+
+    /// The maximum number of cached indexes.
+    size_t m_max_entries;
+};
+
+}  // mdl
+}  // mi
+
+#endif // MDL_COMPILERCORE_FILE_INDEX_CACHE_H
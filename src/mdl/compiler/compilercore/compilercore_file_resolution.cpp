@@ -32,11 +32,13 @@
 #include <algorithm>
 
 #include <mi/base/interface_implement.h>
+#include <mi/base/lock.h>
 
 #include "base/lib/libzip/zip.h"
 
 #include "compilercore_file_resolution.h"
 #include "compilercore_file_utils.h"
+#include "compilercore_file_index_cache.h"
 #include "compilercore_assert.h"
 #include "compilercore_mdl.h"
 #include "compilercore_messages.h"
@@ -56,6 +58,26 @@ namespace mdl {
 
 typedef Store<Position const *> Position_store;
 
+namespace {
+
+/// Get the lookup key of a file name inside a directory.
+string fold_name(IAllocator *alloc, char const *name)
+{
+    string res(name, alloc);
+#ifdef MI_PLATFORM_WINDOWS
+    // the file system is case insensitive
+    for (size_t i = 0, n = res.size(); i < n; ++i) {
+        char c = res[i];
+        if ('A' <= c && c <= 'Z') {
+            res[i] = c - 'A' + 'a';
+        }
+    }
+#endif
+    return res;
+}
+
+}  // anonymous
+
 // Get the FILE handle if this object represents an ordinary file.
 FILE *File_handle::get_file() { return u.fp; }
 
@@ -302,9 +324,9 @@ File_resource_reader::~File_resource_reader()
 namespace {
 
 /// Implementation of the IInput_stream interface using FILE I/O.
-class Simple_file_input_stream : public Allocator_interface_implement<IInput_stream>
+class Simple_file_input_stream : public Allocator_interface_implement<IInput_stream_view>
 {
-    typedef Allocator_interface_implement<IInput_stream> Base;
+    typedef Allocator_interface_implement<IInput_stream_view> Base;
 public:
     /// Constructor.
     ///
@@ -318,6 +340,7 @@ public:
     : Base(alloc)
     , m_file(f)
     , m_filename(filename, alloc)
+    , m_view(alloc)
     {}
 
     /// Destructor.
@@ -335,6 +358,21 @@ public:
         return fgetc(m_file->get_file());
     }
 
+    /// Get the remaining content of the stream and consume it.
+    ///
+    /// Reads the rest of the file into a buffer owned by this stream.
+    char const *get_view(size_t &length) MDL_FINAL
+    {
+        FILE *file = m_file->get_file();
+        char chunk[4096];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+            m_view.insert(m_view.end(), chunk, chunk + n);
+        }
+        length = m_view.size();
+        return m_view.data();
+    }
+
     /// Get the name of the file on which this input stream operates.
     /// \returns    The name of the file or null if the stream does not operate on a file.
     char const *get_filename() MDL_FINAL
@@ -348,6 +386,9 @@ private:
 
     /// The filename.
     string m_filename;
+
+    /// The rest of the file, read by get_view().
+    vector<char>::Type m_view;
 };
 
 /// Implementation of the IArchive_input_stream interface using archive I/O.
@@ -521,6 +562,8 @@ File_resolver::File_resolver(
 , m_last_msg_idx(0)
 , m_pathes_read(false)
 , m_resolving_resource(false)
+, m_use_search_path_index(
+    mdl.get_compiler_bool_option(NULL, MDL::option_search_path_index, false))
 {
 }
 
@@ -678,15 +721,11 @@ bool File_resolver::archive_contains(
     char const *archive_name,
     char const *file_name)
 {
-    bool res = false;
-
+    bool valid = false;
     MDL_zip_container_error_code err = EC_OK;
-    if (MDL_zip_container_archive *archive = MDL_zip_container_archive::open(
-        m_alloc, archive_name, err, false))
-    {
-        res = archive->contains(file_name);
-        archive->close();
-    } else {
+    bool res = container_contains(
+        archive_name, /*is_mdle=*/false, file_name, /*is_mask=*/false, valid, err);
+    if (!valid) {
         if (err == EC_OK) {
             warning(
                 INVALID_MDL_ARCHIVE_DETECTED,
@@ -702,15 +741,11 @@ bool File_resolver::archive_contains_mask(
     char const *archive_name,
     char const *file_mask)
 {
-    bool res = false;
-
+    bool valid = false;
     MDL_zip_container_error_code err = EC_OK;
-    if (MDL_zip_container_archive *archive = MDL_zip_container_archive::open(
-        m_alloc, archive_name, err, false))
-    {
-        res = archive->contains_mask(file_mask);
-        archive->close();
-    } else {
+    bool res = container_contains(
+        archive_name, /*is_mdle=*/false, file_mask, /*is_mask=*/true, valid, err);
+    if (!valid) {
         if (err == EC_OK) {
             warning(
                 INVALID_MDL_ARCHIVE_DETECTED,
@@ -721,6 +756,154 @@ bool File_resolver::archive_contains_mask(
     return res;
 }
 
+// Check if a container contains a file or a file matching a mask.
+bool File_resolver::container_contains(
+    char const                   *container_name,
+    bool                         is_mdle,
+    char const                   *name,
+    bool                         is_mask,
+    bool                         &valid,
+    MDL_zip_container_error_code &err) const
+{
+    IAllocator *alloc = m_alloc;
+
+    string key(container_name, alloc);
+    key += is_mdle ? "|mdle" : "|mdr";
+
+    mi::base::Handle<File_index const> index(m_mdl.get_file_index_cache().get(
+        key.c_str(),
+        container_name,
+        [alloc, is_mdle](File_index &index, char const *path) {
+            MDL_zip_container_error_code err = EC_OK;
+            MDL_zip_container *container = NULL;
+            if (is_mdle) {
+                container = MDL_zip_container_mdle::open(alloc, path, err);
+            } else {
+                container = MDL_zip_container_archive::open(
+                    alloc, path, err, /*with_manifest=*/false);
+            }
+            index.set_error(err);
+
+            if (container != NULL) {
+                index.set_valid(true);
+                for (int i = 0, n = container->get_num_entries(); i < n; ++i) {
+                    if (char const *file_name = container->get_entry_name(i)) {
+                        index.add_name(file_name, file_name);
+                    }
+                }
+                container->close();
+            }
+        }));
+
+    if (!index) {
+        valid = false;
+        err   = EC_CONTAINER_NOT_EXIST;
+        return false;
+    }
+
+    valid = index->is_valid();
+    err   = index->get_error();
+    if (!valid) {
+        return false;
+    }
+
+    // ZIP uses '/'
+    string forward(convert_os_separators_to_slashes(string(name, alloc)));
+
+    if (!is_mask) {
+        return index->contains(forward.c_str());
+    }
+
+    File_index::Name_vector const &names = index->get_names();
+    for (size_t i = 0, n = names.size(); i < n; ++i) {
+        if (utf8_match(forward.c_str(), names[i].c_str())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Get the (possibly cached) index of the files inside a directory.
+mi::base::Handle<File_index const> File_resolver::get_directory_index(char const *dname) const
+{
+    IAllocator *alloc = m_alloc;
+
+    string key(dname, alloc);
+    key += "|dir";
+
+    mi::base::Handle<File_index const> index(m_mdl.get_file_index_cache().get(
+        key.c_str(),
+        dname,
+        [alloc](File_index &index, char const *path) {
+            Directory dir(alloc);
+            if (!dir.open(path)) {
+                return;
+            }
+            index.set_valid(true);
+
+            string dir_name(path, alloc);
+            for (char const *name = dir.read(); name != NULL; name = dir.read()) {
+                string fname = join_path(dir_name, string(name, alloc));
+                if (is_file_utf8(alloc, fname.c_str())) {
+                    index.add_name(name, fold_name(alloc, name).c_str());
+                }
+            }
+            dir.close();
+        }));
+
+    if (index && !index->is_valid()) {
+        return mi::base::Handle<File_index const>();
+    }
+    return index;
+}
+
+// Check if the given name (UTF8 encoded) names a directory, using the directory index.
+bool File_resolver::is_indexed_directory(char const *dname) const
+{
+    return get_directory_index(dname).is_valid_interface();
+}
+
+// Check if the given name (UTF8 encoded) names a file, using the directory index.
+bool File_resolver::is_indexed_file(char const *fname) const
+{
+    char const *p = strrchr(fname, os_separator());
+    if (p == NULL) {
+        return is_file_utf8(m_alloc, fname);
+    }
+
+    string dname(fname, p - fname, m_alloc);
+    mi::base::Handle<File_index const> index(get_directory_index(dname.c_str()));
+    return index && index->contains(fold_name(m_alloc, p + 1).c_str());
+}
+
+// Check if a directory contains a file matching the given mask, using the directory index.
+bool File_resolver::has_indexed_file(
+    char const *directory,
+    char const *mask) const
+{
+    string dname(directory, m_alloc);
+
+    char const *p = strrchr(mask, os_separator());
+    if (p != NULL) {
+        dname += os_separator();
+        dname += string(mask, p - mask, m_alloc);
+        mask = p + 1;
+    }
+
+    mi::base::Handle<File_index const> index(get_directory_index(dname.c_str()));
+    if (!index) {
+        return false;
+    }
+
+    File_index::Name_vector const &names = index->get_names();
+    for (size_t i = 0, n = names.size(); i < n; ++i) {
+        if (utf8_match(mask, names[i].c_str())) {
+            return true;
+        }
+    }
+    return false;
+}
+
 // Returns the nesting level of a module, i.e., the number of "::" substrings in the
 // fully-qualified module name minus 1.
 size_t File_resolver::get_module_nesting_level(char const *module_name) const
@@ -1278,7 +1461,10 @@ bool File_resolver::is_killed(
     dir_path.append(os_separator());
     dir_path.append(package);
 
-    if (is_directory_utf8(m_alloc, dir_path.c_str())) {
+    bool is_dir = m_use_search_path_index
+        ? is_indexed_directory(dir_path.c_str())
+        : is_directory_utf8(m_alloc, dir_path.c_str());
+    if (is_dir) {
         error(
             ARCHIVE_CONFLICT,
             *m_pos,
@@ -1448,28 +1634,44 @@ string File_resolver::search_mdl_path(
         m_killed_packages.clear();
 
         if (!in_resource_path) {
-            Directory dir(m_alloc);
-            if (!dir.open(path, "*.mdr")) {
-                // directory does not exist
-                continue;
-            }
-
             String_map archives(String_map::key_compare(), get_allocator());
 
             // collect all archives first for the KILL test
-            for (char const *entry = dir.read(); entry != NULL; entry = dir.read()) {
+            auto add_archive = [&archives, this](char const *entry) {
                 string e(entry, m_alloc);
                 size_t l = e.size();
 
                 if (l < 5) {
-                    continue;
+                    return;
                 }
                 if (e[l - 4] != '.' || e[l - 3] != 'm' || e[l - 2] != 'd' || e[l - 1] != 'r') {
-                    continue;
+                    return;
                 }
 
                 // remove .mdr
                 archives.insert(String_map::value_type(e.substr(0, l - 4), true));
+            };
+
+            if (m_use_search_path_index) {
+                mi::base::Handle<File_index const> index(get_directory_index(path));
+                if (!index) {
+                    // directory does not exist
+                    continue;
+                }
+                File_index::Name_vector const &names = index->get_names();
+                for (size_t i = 0, n = names.size(); i < n; ++i) {
+                    add_archive(names[i].c_str());
+                }
+            } else {
+                Directory dir(m_alloc);
+                if (!dir.open(path, "*.mdr")) {
+                    // directory does not exist
+                    continue;
+                }
+                for (char const *entry = dir.read(); entry != NULL; entry = dir.read()) {
+                    add_archive(entry);
+                }
+                dir.close();
             }
 
             // search for archives
@@ -1517,7 +1719,6 @@ string File_resolver::search_mdl_path(
                     }
                 }
             }
-            dir.close();
         }
 
         // no archives
@@ -1525,14 +1726,20 @@ string File_resolver::search_mdl_path(
         if (!file_mask_is_regex) {
             string joined_file_name = join_path(string(path, m_alloc), string(file_mask, m_alloc));
             if (!is_killed(file_mask)) {
-                if (is_file_utf8(m_alloc, joined_file_name.c_str())) {
+                bool found = m_use_search_path_index
+                    ? is_indexed_file(joined_file_name.c_str())
+                    : is_file_utf8(m_alloc, joined_file_name.c_str());
+                if (found) {
                     places.push_back(convert_slashes_to_os_separators(joined_file_name));
                     ++n_places;
                 }
             }
         } else {
             if (!is_killed(file_mask)) {
-                if (has_file_utf8(m_alloc, path, file_mask)) {
+                bool found = m_use_search_path_index
+                    ? has_indexed_file(path, file_mask)
+                    : has_file_utf8(m_alloc, path, file_mask);
+                if (found) {
                     string joined_file_mask = join_path(
                         string(path, m_alloc), string(file_mask, m_alloc));
 
@@ -1596,37 +1803,30 @@ bool File_resolver::file_exists(
                 fname = p + 1;
             }
 
+            if (m_use_search_path_index) {
+                return has_indexed_file(dname.c_str(), fname);
+            }
             return has_file_utf8(m_alloc, dname.c_str(), fname);
         }
+        if (m_use_search_path_index) {
+            return is_indexed_file(fname);
+        }
         return is_file_utf8(m_alloc, fname);
     }
 
-    // open container, mdr or mdle
-    char const *container_file_name = NULL;
-    MDL_zip_container *container = NULL;
+    // check the index of the container, mdr or mdle
+    bool valid = false;
     MDL_zip_container_error_code err = EC_OK;
 
     if (p_archive != NULL) {
         string container_name = string(fname, p_archive + 4, m_alloc);
-        container_file_name = p_archive + 5;
-        container = MDL_zip_container_archive::open(m_alloc, container_name.c_str(), err, false);
+        return container_contains(
+            container_name.c_str(), /*is_mdle=*/false, p_archive + 5, is_regex, valid, err);
     }
 
-    if (p_mdle != NULL) {
-        string container_name = string(fname, p_mdle + 5, m_alloc);
-        container_file_name = p_mdle + 6;
-        container = MDL_zip_container_mdle::open(m_alloc, container_name.c_str(), err);
-    }
-
-    // check if there is a corresponding file
-    if (container != NULL) {
-        bool res = is_regex ?
-            container->contains_mask(container_file_name) :
-            container->contains(container_file_name);
-        container->close();
-        return res;
-    }
-    return false;
+    string container_name = string(fname, p_mdle + 5, m_alloc);
+    return container_contains(
+        container_name.c_str(), /*is_mdle=*/true, p_mdle + 6, is_regex, valid, err);
 }
 
 #ifdef MI_PLATFORM_WINDOWS
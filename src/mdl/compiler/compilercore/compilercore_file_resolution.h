@@ -41,6 +41,7 @@
 namespace mi {
 namespace mdl {
 
+class File_index;
 class Manifest;
 class MDL;
 class Messages_impl;
@@ -288,6 +289,44 @@ private:
         char const *archive_name,
         char const *file_mask);
 
+    /// Check if a container contains a file or a file matching a mask, using the container
+    /// index.
+    ///
+    /// \param[in]  container_name  the UTF8 encoded container path
+    /// \param[in]  is_mdle         true, if the container is an MDLE file, else an archive
+    /// \param[in]  name            the file name or mask inside the container
+    /// \param[in]  is_mask         true, if name is a mask
+    /// \param[out] valid           false, if the container could not be opened
+    /// \param[out] err             the error code of opening the container
+    bool container_contains(
+        char const                   *container_name,
+        bool                         is_mdle,
+        char const                   *name,
+        bool                         is_mask,
+        bool                         &valid,
+        MDL_zip_container_error_code &err) const;
+
+    /// Get the (possibly cached) index of the files inside a directory.
+    ///
+    /// \param dname  the UTF8 encoded directory path
+    ///
+    /// \return the index or an invalid handle if the directory does not exist
+    mi::base::Handle<File_index const> get_directory_index(char const *dname) const;
+
+    /// Check if the given name (UTF8 encoded) names a directory, using the directory index.
+    bool is_indexed_directory(char const *dname) const;
+
+    /// Check if the given name (UTF8 encoded) names a file, using the directory index.
+    bool is_indexed_file(char const *fname) const;
+
+    /// Check if a directory contains a file matching the given mask, using the directory index.
+    ///
+    /// \param directory  the UTF8 encoded directory path
+    /// \param mask       the file mask, might contain a relative directory path
+    bool has_indexed_file(
+        char const *directory,
+        char const *mask) const;
+
     /// Returns the nesting level of a module, i.e., the number of "::" substrings in the
     /// fully-qualified module name minus 1.
     ///
@@ -581,6 +620,9 @@ private:
 
     /// True if we are resolving a resource, false if we are resolving a module.
     bool m_resolving_resource;
+
+    /// True, if search path lookups are answered from the directory index.
+    bool m_use_search_path_index;
 };
 
 
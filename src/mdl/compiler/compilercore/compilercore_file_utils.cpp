@@ -39,7 +39,10 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
-#ifndef MI_PLATFORM_WINDOWS
+#ifdef MI_PLATFORM_WINDOWS
+#include <sys/utime.h>
+#else
+#include <utime.h>
 #include <unistd.h>
 #include <dirent.h>
 #include <errno.h>
@@ -277,6 +280,87 @@ bool mkdir_utf8(
     return true;
 }
 
+// Removes a file from the file system.
+bool remove_file_utf8(
+    IAllocator *alloc,
+    char const *fname)
+{
+#ifdef MI_PLATFORM_WINDOWS
+    wstring path(alloc);
+    utf8_to_utf16(path, fname);
+
+    return ::_wremove(path.c_str()) == 0;
+#else
+    // assume native UTF8-support
+    return ::remove(fname) == 0;
+#endif
+}
+
+// Renames a file, replacing the destination if it already exists.
+bool rename_file_utf8(
+    IAllocator *alloc,
+    char const *from,
+    char const *to)
+{
+#ifdef MI_PLATFORM_WINDOWS
+    wstring wfrom(alloc);
+    utf8_to_utf16(wfrom, from);
+
+    wstring wto(alloc);
+    utf8_to_utf16(wto, to);
+
+    return ::MoveFileExW(wfrom.c_str(), wto.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    // assume native UTF8-support
+    return ::rename(from, to) == 0;
+#endif
+}
+
+// Retrieve the size and the time of the last modification of a file.
+bool get_file_info_utf8(
+    IAllocator *alloc,
+    char const *fname,
+    size_t     &size,
+    time_t     &mtime)
+{
+#ifdef MI_PLATFORM_WINDOWS
+    struct _stat st;
+
+    wstring path(alloc);
+    utf8_to_utf16(path, fname);
+
+    if (::_wstat(path.c_str(), &st) != 0) {
+        return false;
+    }
+#else
+    struct stat st;
+
+    // assume native UTF8-support
+    if (::stat(fname, &st) != 0) {
+        return false;
+    }
+#endif
+    size  = size_t(st.st_size);
+    mtime = st.st_mtime;
+    return true;
+}
+
+// Sets the time of the last modification of a file to the current time.
+bool touch_file_utf8(
+    IAllocator *alloc,
+    char const *fname)
+{
+#ifdef MI_PLATFORM_WINDOWS
+    wstring path(alloc);
+    utf8_to_utf16(path, fname);
+
+    return ::_wutime(path.c_str(), NULL) == 0;
+#else
+    // assume native UTF8-support
+    return ::utime(fname, NULL) == 0;
+#endif
+}
+
 // Get the current working directory
 string get_cwd(IAllocator *alloc)
 {
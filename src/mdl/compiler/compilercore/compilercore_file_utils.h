@@ -30,6 +30,7 @@
 #define MDL_COMPILERCORE_FILE_UTILS_H 1
 
 #include <cstdio>
+#include <ctime>
 
 #include "compilercore_allocator.h"
 
@@ -112,6 +113,47 @@ bool mkdir_utf8(
     IAllocator *alloc,
     char const *path);
 
+/// Removes a file from the file system.
+///
+/// \param alloc  an allocator
+/// \param path   an UTF8 encoded file path
+bool remove_file_utf8(
+    IAllocator *alloc,
+    char const *path);
+
+/// Renames a file, replacing the destination if it already exists.
+///
+/// \param alloc  an allocator
+/// \param from   an UTF8 encoded source file path
+/// \param to     an UTF8 encoded destination file path
+///
+/// \note On POSIX systems this is an atomic operation as long as both paths are on the same
+///       file system.
+bool rename_file_utf8(
+    IAllocator *alloc,
+    char const *from,
+    char const *to);
+
+/// Retrieve the size and the time of the last modification of a file.
+///
+/// \param alloc  an allocator
+/// \param path   an UTF8 encoded file path
+/// \param size   will be set to the file size in bytes
+/// \param mtime  will be set to the time of the last modification
+bool get_file_info_utf8(
+    IAllocator *alloc,
+    char const *path,
+    size_t     &size,
+    time_t     &mtime);
+
+/// Sets the time of the last modification of a file to the current time.
+///
+/// \param alloc  an allocator
+/// \param path   an UTF8 encoded file path
+bool touch_file_utf8(
+    IAllocator *alloc,
+    char const *path);
+
 /// Retrieve the current working directory.
 ///
 /// \param alloc  an allocator
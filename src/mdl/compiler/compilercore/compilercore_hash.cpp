@@ -245,5 +245,111 @@ void MD5_hasher::final(unsigned char result[16])
     restart();
 }
 
+namespace {
+
+/// Rotate a 64bit value left.
+inline mi::Uint64 rotl64(mi::Uint64 x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+/// Read a 64bit little endian value.
+inline mi::Uint64 read64(unsigned char const *p)
+{
+    return  mi::Uint64(p[0])        | (mi::Uint64(p[1]) << 8)  |
+           (mi::Uint64(p[2]) << 16) | (mi::Uint64(p[3]) << 24) |
+           (mi::Uint64(p[4]) << 32) | (mi::Uint64(p[5]) << 40) |
+           (mi::Uint64(p[6]) << 48) | (mi::Uint64(p[7]) << 56);
+}
+
+/// The MurmurHash3 finalization mix.
+inline mi::Uint64 fmix64(mi::Uint64 k)
+{
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdull;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ull;
+    k ^= k >> 33;
+    return k;
+}
+
+mi::Uint64 const c1 = 0x87c37b91114253d5ull;
+mi::Uint64 const c2 = 0x4cf5ad432745937full;
+
+}  // anonymous
+
+void Fast_hasher::mix(unsigned char const *block)
+{
+    mi::Uint64 k1 = read64(block);
+    mi::Uint64 k2 = read64(block + 8);
+
+    k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; m_h1 ^= k1;
+    m_h1 = rotl64(m_h1, 27); m_h1 += m_h2; m_h1 = m_h1 * 5 + 0x52dce729;
+
+    k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; m_h2 ^= k2;
+    m_h2 = rotl64(m_h2, 31); m_h2 += m_h1; m_h2 = m_h2 * 5 + 0x38495ab5;
+}
+
+void Fast_hasher::update(unsigned char const *data, size_t size)
+{
+    size_t used = size_t(m_count) & 0xf;
+    m_count += size;
+
+    if (used != 0) {
+        size_t free = 16 - used;
+        if (size < free) {
+            memcpy(&m_buffer[used], data, size);
+            return;
+        }
+        memcpy(&m_buffer[used], data, free);
+        mix(m_buffer);
+        data += free;
+        size -= free;
+    }
+
+    for (; size >= 16; data += 16, size -= 16) {
+        mix(data);
+    }
+
+    if (size > 0) {
+        memcpy(m_buffer, data, size);
+    }
+}
+
+void Fast_hasher::final(unsigned char result[16])
+{
+    size_t used = size_t(m_count) & 0xf;
+
+    if (used != 0) {
+        // the tail is mixed in without the rotation of the remaining state
+        memset(&m_buffer[used], 0, 16 - used);
+
+        mi::Uint64 k1 = read64(m_buffer);
+        mi::Uint64 k2 = read64(m_buffer + 8);
+
+        k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; m_h2 ^= k2;
+        k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; m_h1 ^= k1;
+    }
+
+    m_h1 ^= m_count;
+    m_h2 ^= m_count;
+
+    m_h1 += m_h2;
+    m_h2 += m_h1;
+
+    m_h1 = fmix64(m_h1);
+    m_h2 = fmix64(m_h2);
+
+    m_h1 += m_h2;
+    m_h2 += m_h1;
+
+    for (int i = 0; i < 8; ++i) {
+        result[i]     = static_cast<unsigned char>(m_h1 >> (8 * i));
+        result[i + 8] = static_cast<unsigned char>(m_h2 >> (8 * i));
+    }
+
+    restart();
+}
+
 }  // mdl
 }  // mi
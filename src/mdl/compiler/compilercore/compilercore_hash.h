@@ -158,6 +158,104 @@ private:
     unsigned char m_buffer[64]; // PVS: -V730_NOINIT
 };
 
+/// A fast non-cryptographic 128bit stream hasher, based on MurmurHash3 (x64, 128bit variant).
+///
+/// Provides the same interface as MD5_hasher, but is considerably faster. Use it for hashes that
+/// identify data structures inside one process or cache, not where resistance against
+/// deliberately constructed collisions is required.
+class Fast_hasher {
+public:
+    Fast_hasher()
+    : m_h1(0)
+    , m_h2(0)
+    , m_count(0)
+    {
+    }
+
+    /// Update the hash by a data block.
+    ///
+    /// \param data  points to a data block
+    /// \param size  the size of the block
+    void update(unsigned char const *data, size_t size);
+
+    /// Update the hash by a character.
+    void update(char c) { update((unsigned char const *)&c, 1); }
+
+    /// Update the hash by a string.
+    void update(char const *s) {
+        if (s == NULL)
+            update(char(0));
+        else
+            update((unsigned char const *)s, strlen(s));
+    }
+
+    /// Update the hash by an unsigned 32bit.
+    void update(mi::Uint32 v) {
+        unsigned char buf[4] = {
+                static_cast<unsigned char>(v),
+                static_cast<unsigned char>(v >> 8),
+                static_cast<unsigned char>(v >> 16),
+                static_cast<unsigned char>(v >> 24) };
+        update(buf, 4);
+    }
+
+    /// Update the hash by an unsigned 64bit.
+    void update(mi::Uint64 v) {
+        unsigned char buf[8] = {
+            static_cast<unsigned char>(v),
+            static_cast<unsigned char>(v >> 8),
+            static_cast<unsigned char>(v >> 16),
+            static_cast<unsigned char>(v >> 24),
+            static_cast<unsigned char>(v >> 32),
+            static_cast<unsigned char>(v >> 40),
+            static_cast<unsigned char>(v >> 48),
+            static_cast<unsigned char>(v >> 56) };
+        update(buf, 8);
+    }
+
+    /// Update the hash by a signed 32bit.
+    void update(mi::Sint32 v) {
+        update(mi::Uint32(v));
+    }
+
+    /// Update the hash by an 32bit float.
+    ///
+    /// The bit pattern is hashed like an unsigned 32bit, i.e., independent of the byte order.
+    void update(mi::Float32 f) {
+        mi::Uint32 bits;
+        memcpy(&bits, &f, sizeof(bits));
+        update(bits);
+    }
+
+    /// Update the hash by an 64bit float.
+    ///
+    /// The bit pattern is hashed like an unsigned 64bit, i.e., independent of the byte order.
+    void update(mi::Float64 f) {
+        mi::Uint64 bits;
+        memcpy(&bits, &f, sizeof(bits));
+        update(bits);
+    }
+
+    /// Finishes the calculation and returns the 128bit hash.
+    void final(unsigned char result[16]);
+
+    /// Restart the hasher.
+    void restart() {
+        m_h1 = 0;
+        m_h2 = 0;
+        m_count = 0;
+    }
+
+private:
+    /// Mix one 16 byte block into the state.
+    void mix(unsigned char const *block);
+
+private:
+    mi::Uint64    m_h1, m_h2;
+    mi::Uint64    m_count;
+    unsigned char m_buffer[16]; // PVS: -V730_NOINIT
+};
+
 } // mdl
 } // mi
 
@@ -45,6 +45,7 @@
 #include "compilercore_malloc_allocator.h"
 #include "compilercore_modules.h"
 #include "compilercore_options.h"
+#include "compilercore_file_index_cache.h"
 #include "compilercore_file_resolution.h"
 #include "compilercore_printers.h"
 #include "compilercore_wchar_support.h"
@@ -89,6 +90,7 @@ char const *MDL::option_state_wavelength_base_max     = MDL_OPTION_STATE_WAVELEN
 char const *MDL::option_user_data                     = MDL_OPTION_USER_DATA;
 char const *MDL::option_keep_original_resource_file_paths
                                                   = MDL_OPTION_KEEP_ORIGINAL_RESOURCE_FILE_PATHS;
+char const *MDL::option_search_path_index             = MDL_OPTION_SEARCH_PATH_INDEX;
 
 // forward
 class Jitted_code;
@@ -348,6 +350,9 @@ void Scanner::set_mdl_version(int major, int minor)
 
 namespace {
 
+/// The maximum number of container and directory indexes cached by the file resolvers.
+size_t const max_file_indexes = 4096;
+
 /// Helper class to avoid NULL checks.
 class Empty_search_path MDL_FINAL : public Allocator_interface_implement<IMDL_search_path> {
     typedef Allocator_interface_implement<IMDL_search_path> Base;
@@ -405,6 +410,7 @@ MDL::MDL(IAllocator *alloc)
 , m_weak_module_lock()
 , m_predefined_types_build(false)
 , m_jitted_code(NULL)
+, m_file_index_cache(m_builder.create<File_index_cache>(alloc, max_file_indexes))
 , m_translator_list(alloc)
 {
     create_options();
@@ -563,6 +569,7 @@ MDL::MDL(IAllocator *alloc)
 // Destructor.
 MDL::~MDL()
 {
+    m_builder.destroy(m_file_index_cache);
     terminate_jitted_code_singleton(m_jitted_code);
 }
 
@@ -1096,6 +1103,8 @@ void MDL::create_options()
 
     m_options.add_option(option_keep_original_resource_file_paths, "false",
         "Keep original resource file paths as is.");
+    m_options.add_option(option_search_path_index, "false",
+        "Answer search path lookups from a cached index of the search path directories.");
     m_options.add_interface_option(option_user_data,
         "User data interface passed to callbacks.");
 
@@ -1103,9 +1112,8 @@ void MDL::create_options()
 #undef STR
 }
 
-// Load a module from a stream.
-Module *MDL::load_module(
-    IModule_cache   *cache,
+// Parse a module from a stream without analyzing it.
+Module *MDL::parse_module(
     IThread_context *context,
     char const      *module_name,
     IInput_stream   *s,
@@ -1114,15 +1122,6 @@ Module *MDL::load_module(
 {
     Thread_context *ctx = impl_cast<Thread_context>(context);
 
-    // make sure there is a waiting table entry in case the module needs loading
-    if (cache != NULL) {
-        mi::base::Handle<const mi::mdl::IModule> existing_module(cache->lookup(module_name, NULL));
-        if (existing_module) {
-            // the module is cached and we load it anyway
-            MDL_ASSERT(!"tried to load an already cached module");
-        }
-    }
-
     Module *mod =
         create_module(module_name, s->get_filename(), IMDL::MDL_DEFAULT_VERSION, flags);
     if (mod == NULL) {
@@ -1152,6 +1151,34 @@ Module *MDL::load_module(
     parser.set_module(mod, enable_mdl_next, enable_experimental);
     parser.Parse();
 
+    return mod;
+}
+
+// Load a module from a stream.
+Module *MDL::load_module(
+    IModule_cache   *cache,
+    IThread_context *context,
+    char const      *module_name,
+    IInput_stream   *s,
+    unsigned        flags,
+    char const      *msg_name)
+{
+    Thread_context *ctx = impl_cast<Thread_context>(context);
+
+    // make sure there is a waiting table entry in case the module needs loading
+    if (cache != NULL) {
+        mi::base::Handle<const mi::mdl::IModule> existing_module(cache->lookup(module_name, NULL));
+        if (existing_module) {
+            // the module is cached and we load it anyway
+            MDL_ASSERT(!"tried to load an already cached module");
+        }
+    }
+
+    Module *mod = parse_module(ctx, module_name, s, flags, msg_name);
+    if (mod == NULL) {
+        return NULL;
+    }
+
     mi::base::Handle<IArchive_input_stream> iarchvice_s(s->get_interface<IArchive_input_stream>());
     if (iarchvice_s.is_valid_interface()) {
         // this module was loaded from an archive, mark it
@@ -47,6 +47,7 @@ namespace mdl {
 
 class Analysis;
 class IMDL_import_result;
+class File_index_cache;
 class File_resolver;
 class Jitted_code;
 class Messages_impl;
@@ -212,6 +213,9 @@ public:
     /// The name of the option to keep resource file paths as is.
     static char const *option_keep_original_resource_file_paths;
 
+    /// The name of the option that enables the in-memory index of the MDL search paths.
+    static char const *option_search_path_index;
+
     /// Get the type factory.
     Type_factory *get_type_factory() const MDL_FINAL;
 
@@ -735,6 +739,9 @@ public:
     /// Get the search path lock.
     mi::base::Lock &get_search_path_lock() const;
 
+    /// Get the cache of container and directory indexes used by the file resolvers.
+    File_index_cache &get_file_index_cache() const { return *m_file_index_cache; }
+
     /// Get the Jitted code singleton.
     ///
     /// \note Does NOT increase the reference count of the returned
@@ -770,6 +777,23 @@ public:
         bool          enable_experimental,
         Messages_impl &msgs);
 
+    /// Parse a module from a stream without analyzing it.
+    ///
+    /// The returned module contains only the syntax tree and any syntax errors; its
+    /// imports are neither resolved nor loaded.
+    ///
+    /// \param ctx          the thread context or NULL
+    /// \param module_name  the absolute module name
+    /// \param s            the input stream of the module
+    /// \param flags        module property flags
+    /// \param msg_name     if non-NULL, use this name for reporting compiler messages
+    Module *parse_module(
+        IThread_context *ctx,
+        char const      *module_name,
+        IInput_stream   *s,
+        unsigned        flags,
+        char const      *msg_name = NULL);
+
     /// Creates a new thread context from current analysis settings.
     ///
     /// \param analysis    the current analysis
@@ -895,6 +919,9 @@ private:
     /// The Jitted code singleton if any.
     Jitted_code *m_jitted_code;
 
+    /// The cache of container and directory indexes.
+    File_index_cache *m_file_index_cache;
+
     typedef list<mi::base::Handle<IMDL_foreign_module_translator> >::Type Translator_list;
 
     /// The list of registered translators.
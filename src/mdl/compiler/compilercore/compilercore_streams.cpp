@@ -281,6 +281,18 @@ int File_Input_stream::read_char()
     return fgetc(m_file);
 }
 
+// Get the remaining content of the stream and consume it.
+char const *File_Input_stream::get_view(size_t &length)
+{
+    char chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), m_file)) > 0) {
+        m_view.insert(m_view.end(), chunk, chunk + n);
+    }
+    length = m_view.size();
+    return m_view.data();
+}
+
 // Get the name of the file on which this input stream operates.
 char const *File_Input_stream::get_filename()
 {
@@ -297,6 +309,7 @@ File_Input_stream::File_Input_stream(
 , m_file(f)
 , m_close_at_destroy(close_at_destroy)
 , m_filename(filename, alloc)
+, m_view(alloc)
 {
 }
 
@@ -313,6 +326,15 @@ int Buffer_Input_stream::read_char()
     return m_curr_pos < m_end_pos ? (unsigned char)*m_curr_pos++ : -1;
 }
 
+// Get the remaining content of the stream and consume it.
+char const *Buffer_Input_stream::get_view(size_t &length)
+{
+    char const *view = m_curr_pos;
+    length = size_t(m_end_pos - m_curr_pos);
+    m_curr_pos = m_end_pos;
+    return view;
+}
+
 // Get the name of the file on which this input stream operates.
 char const *Buffer_Input_stream::get_filename()
 {
@@ -347,6 +369,7 @@ Encoded_buffer_Input_stream::Encoded_buffer_Input_stream(
 : Base(alloc, (char const *)buffer, length, filename)
 , m_key(key, alloc)
 , m_index(0)
+, m_view(alloc)
 {
 }
 
@@ -369,6 +392,16 @@ int Encoded_buffer_Input_stream::read_char()
     return -1;
 }
 
+// Get the remaining content of the stream and consume it.
+char const *Encoded_buffer_Input_stream::get_view(size_t &length)
+{
+    for (int c = read_char(); c != -1; c = read_char()) {
+        m_view.push_back(char(c));
+    }
+    length = m_view.size();
+    return m_view.data();
+}
+
 // Write a char to the stream.
 void File_Output_stream::write_char(char c)
 {
@@ -39,14 +39,19 @@ namespace mi {
 namespace mdl {
 
 /// Implementation of the IInput_stream interface using FILE I/O.
-class File_Input_stream : public Allocator_interface_implement<IInput_stream>
+class File_Input_stream : public Allocator_interface_implement<IInput_stream_view>
 {
-    typedef Allocator_interface_implement<IInput_stream> Base;
+    typedef Allocator_interface_implement<IInput_stream_view> Base;
 public:
     /// Read a character from the input stream.
     /// \returns    The code of the character read, or -1 on the end of the stream.
     int read_char() MDL_FINAL;
 
+    /// Get the remaining content of the stream and consume it.
+    ///
+    /// Reads the rest of the file into a buffer owned by this stream.
+    char const *get_view(size_t &length) MDL_FINAL;
+
     /// Get the name of the file on which this input stream operates.
     /// \returns    The name of the file or null if the stream does not operate on a file.
     char const *get_filename() MDL_FINAL;
@@ -80,17 +85,25 @@ private:
 
     /// The filename.
     string m_filename;
+
+    /// The rest of the file, read by get_view().
+    vector<char>::Type m_view;
 };
 
 /// Implementation of the IInput_stream interface using a buffer.
-class Buffer_Input_stream : public Allocator_interface_implement<IInput_stream>
+class Buffer_Input_stream : public Allocator_interface_implement<IInput_stream_view>
 {
-    typedef Allocator_interface_implement<IInput_stream> Base;
+    typedef Allocator_interface_implement<IInput_stream_view> Base;
 public:
     /// Read a character from the input stream.
     /// \returns    The code of the character read, or -1 on the end of the stream.
     int read_char() MDL_OVERRIDE;
 
+    /// Get the remaining content of the stream and consume it.
+    ///
+    /// Returns the unread part of the buffer without copying it.
+    char const *get_view(size_t &length) MDL_OVERRIDE;
+
     /// Get the name of the file on which this input stream operates.
     /// \returns    The name of the file or null if the stream does not operate on a file.
     char const *get_filename() MDL_FINAL;
@@ -137,6 +150,11 @@ public:
     /// \returns    The code of the character read, or -1 on the end of the stream.
     int read_char() MDL_FINAL;
 
+    /// Get the remaining content of the stream and consume it.
+    ///
+    /// Decodes the unread part of the buffer into a buffer owned by this stream.
+    char const *get_view(size_t &length) MDL_FINAL;
+
     /// Construct an input stream from a character buffer.
     /// Does NOT copy the buffer, so it must stay until the lifetime of the
     /// Input stream object!
@@ -161,6 +179,9 @@ private:
 
     /// The current read index.
     size_t m_index;
+
+    /// The decoded rest of the buffer, filled by get_view().
+    vector<char>::Type m_view;
 };
 
 /// Implementation of the IOutput_stream_colored interface using FILE I/O.
@@ -43,7 +43,7 @@ namespace mi {
 
 namespace MI {
 
-namespace MDL { class IType; class Mdl_module_wait_queue; }
+namespace MDL { class IType; class Mdl_module_wait_queue; class Precompiled_module_store; }
 namespace SYSTEM { class Module_registration_entry; }
 namespace SERIAL { class Deserializer; class Serializer; }
 
@@ -109,6 +109,9 @@ public:
 
     /// Returns the module wait queue.
     virtual MDL::Mdl_module_wait_queue* get_module_wait_queue() const = 0;
+
+    /// Returns the precompiled module store, or \c NULL if disabled.
+    virtual MDL::Precompiled_module_store* get_precompiled_module_store() const = 0;
 };
 
 } // namespace MDLC
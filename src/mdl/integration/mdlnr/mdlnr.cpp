@@ -34,6 +34,7 @@
 #include <mi/base/plugin.h>
 #include <mi/mdl/mdl_code_generators.h>
 #include <mi/neuraylib/iplugin_api.h>
+#include <mi/neuraylib/version.h>
 
 #include <base/system/main/access_module.h>
 #include <base/system/main/module_registration.h>
@@ -44,6 +45,7 @@
 #include <base/util/registry/i_config_registry.h>
 #include <base/data/serial/i_serializer.h>
 #include <base/system/stlext/i_stlext_no_unused_variable_warning.h>
+#include <base/system/version/i_version.h>
 
 #include "mdlnr.h"
 #include "mdlnr_search_path.h"
@@ -199,6 +201,7 @@ Mdlc_module_impl::Mdlc_module_impl()
   , m_implicit_cast_enabled(true)
   , m_expose_names_of_let_expressions(true)
   , m_module_wait_queue(0)
+  , m_precompiled_module_store(0)
 {
 }
 
@@ -240,6 +243,12 @@ bool Mdlc_module_impl::init()
     MDL_ASSERT(mi::mdl::DEPRECATED_ENTITY == 275);
     options.set_option(mi::mdl::MDL::option_warn, "275=off");
 
+    bool search_path_index = false;
+    if (registry.get_value("mdl_search_path_index", search_path_index)) {
+        options.set_option(
+            mi::mdl::MDL::option_search_path_index, search_path_index ? "true" : "false");
+    }
+
 
     {
         // register nvidia/distilling_support.mdl
@@ -262,10 +271,31 @@ bool Mdlc_module_impl::init()
         cache_size = v;
     }
 
-    m_code_cache = builder.create<mi::mdl::Code_cache>(m_allocator.get(), cache_size);
+    // the persistent disk tier is disabled unless a directory is given, 256MB by default
+    std::string cache_path;
+    registry.get_value("mdl_target_code_cache_path", cache_path);
+
+    size_t disk_cache_size = 256*1024*1024;
+    if (registry.get_value("mdl_target_code_cache_disk_size", v)) {
+        disk_cache_size = v;
+    }
+
+    // code generated by other builds must not be picked up from the disk tier
+    std::string build_id = MI_NEURAYLIB_PRODUCT_VERSION_STRING;
+    build_id += '|';
+    build_id += VERSION::get_platform_version();
+
+    m_code_cache = builder.create<mi::mdl::Code_cache>(
+        m_allocator.get(), cache_size, cache_path.c_str(), disk_cache_size, build_id.c_str());
 
     m_module_wait_queue = new MDL::Mdl_module_wait_queue();
 
+    // the precompiled module store is disabled unless a directory is given
+    std::string precompiled_module_path;
+    registry.get_value("mdl_precompiled_module_path", precompiled_module_path);
+    if (!precompiled_module_path.empty())
+        m_precompiled_module_store = new MDL::Precompiled_module_store(precompiled_module_path);
+
 
     return true;
 }
@@ -286,6 +316,10 @@ void Mdlc_module_impl::exit()
         delete m_module_wait_queue;
         m_module_wait_queue = nullptr;
     }
+    if (m_precompiled_module_store) {
+        delete m_precompiled_module_store;
+        m_precompiled_module_store = nullptr;
+    }
 
 #ifdef USE_MDL_DEBUG_ALLOCATOR
     mi::mdl::dbg::DebugMallocAllocator* dbg_allocator = static_cast<mi::mdl::dbg::DebugMallocAllocator*>( m_allocator.get());
@@ -380,6 +414,11 @@ MDL::Mdl_module_wait_queue* Mdlc_module_impl::get_module_wait_queue() const
     return m_module_wait_queue;
 }
 
+MDL::Precompiled_module_store* Mdlc_module_impl::get_precompiled_module_store() const
+{
+    return m_precompiled_module_store;
+}
+
 bool Mdlc_module_impl::is_valid_mdl_core_plugin(
     const char* type, const char* name, const char* filename)
 {
@@ -87,6 +87,8 @@ public:
 
     MDL::Mdl_module_wait_queue* get_module_wait_queue() const;
 
+    MDL::Precompiled_module_store* get_precompiled_module_store() const;
+
 private:
 
     /// Helper function to detect valid MDL core plugin type names.
@@ -122,6 +124,9 @@ private:
     /// The module wait queue.
     MDL::Mdl_module_wait_queue *m_module_wait_queue;
 
+    /// The precompiled module store, or \c NULL if disabled.
+    MDL::Precompiled_module_store *m_precompiled_module_store;
+
     /// Access to the PLUG module
     SYSTEM::Access_module<PLUG::Plug_module> m_plug_module;
 
@@ -34,6 +34,8 @@
 
 #include <mi/base/handle.h>
 
+#include <base/system/version/i_version.h>
+
 #include <llvm/IR/Module.h>
 
 #include "mdl/compiler/compilercore/compilercore_errors.h"
@@ -105,6 +107,10 @@ static void fill_default_cg_options(
         MDL_JIT_OPTION_LINK_LIBDEVICE,
         "true",
         "Link libdevice into PTX module");
+    options.add_option(
+        MDL_JIT_OPTION_OPT_PARTITIONS,
+        "1",
+        "Number of partitions optimized concurrently");
     options.add_option(
         MDL_JIT_OPTION_LINK_LIBBSDF_DF_HANDLE_SLOT_MODE,
         "none",
@@ -639,8 +645,26 @@ IGenerated_code_lambda_function *Code_generator_jit::compile_into_environment(
     IModule_cache                  *module_cache,
     ICall_name_resolver const      *resolver,
     ICode_generator_thread_context *ctx)
+{
+    return compile_into_environment(
+        /*code_cache=*/NULL,
+        ilambda,
+        module_cache,
+        resolver,
+        ctx);
+}
+
+// Compile a lambda function using the JIT into an environment (shader) of a scene using a
+// code cache.
+IGenerated_code_lambda_function *Code_generator_jit::compile_into_environment(
+    ICode_cache                    *code_cache,
+    ILambda_function const         *ilambda,
+    IModule_cache                  *module_cache,
+    ICall_name_resolver const      *resolver,
+    ICode_generator_thread_context *ctx)
 {
     return compile_into_generic_function(
+        code_cache,
         ilambda,
         module_cache,
         resolver,
@@ -787,6 +811,34 @@ private:
     size_t m_bm_idx;
 };
 
+/// Hash all code generator options.
+///
+/// \param hasher   the hasher to update
+/// \param options  the options
+///
+/// \return false if the options contain values that cannot be hashed
+bool hash_cg_options(
+    MD5_hasher         &hasher,
+    Options_impl const &options)
+{
+    for (int i = 0, n = options.get_option_count(); i < n; ++i) {
+        hasher.update(options.get_option_name(i));
+        hasher.update(options.get_option_value(i));
+
+        BinaryOptionData data = options.get_binary_option(i);
+        if (data.data != NULL) {
+            hasher.update((unsigned char const *)data.data, data.size);
+        }
+
+        // interface options like a user defined resource handler cannot be hashed
+        mi::base::Handle<mi::base::IInterface const> iface(options.get_interface_option(i));
+        if (iface) {
+            return false;
+        }
+    }
+    return true;
+}
+
 } // anonymous
 
 // Compile a lambda function using the JIT into a constant function.
@@ -1098,7 +1150,7 @@ IGenerated_code_executable *Code_generator_jit::compile_into_switch_function_for
 
         if (entry != NULL) {
             // found a hit
-            fill_code_from_cache(*ctx, code, entry);
+            fill_code_from_cache(*ctx, code, entry, /*unit=*/NULL);
             return code;
         }
     }
@@ -1184,6 +1236,28 @@ IGenerated_code_lambda_function *Code_generator_jit::compile_into_generic_functi
     unsigned                       num_texture_spaces,
     unsigned                       num_texture_results,
     ILambda_call_transformer       *transformer)
+{
+    return compile_into_generic_function(
+        /*code_cache=*/NULL,
+        ilambda,
+        cache,
+        resolver,
+        ctx,
+        num_texture_spaces,
+        num_texture_results,
+        transformer);
+}
+
+// Compile a lambda function into a generic function using the JIT using a code cache.
+IGenerated_code_lambda_function *Code_generator_jit::compile_into_generic_function(
+    ICode_cache                    *code_cache,
+    ILambda_function const         *ilambda,
+    IModule_cache                  *cache,
+    ICall_name_resolver const      *resolver,
+    ICode_generator_thread_context *ctx,
+    unsigned                       num_texture_spaces,
+    unsigned                       num_texture_results,
+    ILambda_call_transformer       *transformer)
 {
     Lambda_function const *lambda = impl_cast<Lambda_function>(ilambda);
     if (lambda == NULL) {
@@ -1245,6 +1319,15 @@ IGenerated_code_lambda_function *Code_generator_jit::compile_into_generic_functi
 
     code_gen.set_resource_tag_map(&lambda->get_resource_tag_map());
 
+    // a transformer can change the generated code arbitrarily, so do not cache it
+    unsigned char cache_key[16];
+    if (code_cache != NULL && transformer == NULL &&
+        compute_native_cache_key(
+            lambda, options, num_texture_spaces, num_texture_results, cache_key))
+    {
+        code_gen.set_native_code_cache(code_cache, cache_key);
+    }
+
     llvm::Function *func = code_gen.compile_lambda(
         /*incremental=*/false, *lambda, resolver, transformer, /*next_arg_block_index=*/0);
     if (func != NULL) {
@@ -1664,7 +1747,8 @@ IGenerated_code_executable *Code_generator_jit::compile_distribution_function_gp
 void Code_generator_jit::fill_code_from_cache(
     ICode_generator_thread_context &ctx,
     Generated_code_source          *code,
-    ICode_cache::Entry const       *entry)
+    ICode_cache::Entry const       *entry,
+    Link_unit_jit const            *unit)
 {
     IAllocator        *alloc = get_allocator();
     Allocator_builder builder(alloc);
@@ -1675,8 +1759,14 @@ void Code_generator_jit::fill_code_from_cache(
         code->add_data_segment("RO", (unsigned char *)entry->const_seg, entry->const_seg_size);
     }
 
-    // only add a captured arguments layout, if it's non-empty
-    if (entry->arg_layout_size != 0) {
+    if (unit != NULL) {
+        // the layouts of a link unit are already known when its functions are added
+        for (size_t i = 0, n = unit->get_arg_block_layout_count(); i < n; ++i) {
+            code->add_captured_arguments_layout(
+                mi::base::make_handle(unit->get_arg_block_layout(i)).get());
+        }
+    } else if (entry->arg_layout_size != 0) {
+        // only add a captured arguments layout, if it's non-empty
         Options_impl &options = impl_cast<Options_impl>(ctx.access_options());
 
         mi::base::Handle<Generated_code_value_layout> layout(
@@ -1708,9 +1798,79 @@ void Code_generator_jit::fill_code_from_cache(
                     index, IGenerated_code_executable::Prototype_language(j), prototype);
             }
         }
+
+        for (size_t j = 0; j < info.num_df_handles; ++j) {
+            code->add_function_df_handle(index, info.df_handles[j]);
+        }
     }
 }
 
+// Compute the code cache key for the native object code of a lambda function.
+bool Code_generator_jit::compute_native_cache_key(
+    Lambda_function const *lambda,
+    Options_impl const    &options,
+    unsigned              num_texture_spaces,
+    unsigned              num_texture_results,
+    unsigned char         cache_key[16]) const
+{
+    MD5_hasher hasher;
+
+    DAG_hash const *hash = lambda->get_hash();
+
+    // set the generators name, the object code is only valid for the current build and JIT
+    // target (triple, host CPU and its features)
+    hasher.update("JIT");
+    hasher.update("native");
+    hasher.update(MI::VERSION::get_platform_version());
+    hasher.update(m_jitted_code->get_target_id());
+
+    hasher.update(lambda->get_name());
+    hasher.update(hash->data(), hash->size());
+    hasher.update(lambda->get_execution_context() == ILambda_function::LEC_ENVIRONMENT ?
+        Type_mapper::SSM_ENVIRONMENT : Type_mapper::SSM_CORE);
+
+    hasher.update(num_texture_spaces);
+    hasher.update(num_texture_results);
+
+    // Beware: the selected options change the generated code, hence we must include them into
+    // the key. As the native code generator depends on many of them, simply use all.
+    if (!hash_cg_options(hasher, options)) {
+        return false;
+    }
+
+    hasher.final(cache_key);
+    return true;
+}
+
+// Compute the code cache key for the source code of a link unit.
+bool Code_generator_jit::compute_unit_cache_key(
+    Link_unit_jit const &unit,
+    Options_impl const  &options,
+    bool                llvm_ir_output,
+    unsigned char       cache_key[16]) const
+{
+    MD5_hasher hasher;
+
+    // the content hash covers the unit setup and everything added to the unit
+    if (!unit.get_content_hasher(hasher)) {
+        return false;
+    }
+
+    // the source code is only valid for the current build
+    hasher.update("JIT");
+    hasher.update("unit");
+    hasher.update(MI::VERSION::get_platform_version());
+    hasher.update(llvm_ir_output);
+
+    // options of the compile call may differ from the ones used when the unit was created
+    if (!hash_cg_options(hasher, options)) {
+        return false;
+    }
+
+    hasher.final(cache_key);
+    return true;
+}
+
 // Enter a code object into the code cache.
 void Code_generator_jit::enter_code_into_cache(
     Generated_code_source *code,
@@ -1904,7 +2064,7 @@ IGenerated_code_executable *Code_generator_jit::compile_into_source(
 
         if (entry != NULL) {
             // found a hit
-            fill_code_from_cache(*ctx, code, entry);
+            fill_code_from_cache(*ctx, code, entry, /*unit=*/NULL);
             return code;
         }
     }
@@ -2117,6 +2277,7 @@ Link_unit_jit *Code_generator_jit::create_link_unit(
 
 // Compile a link unit into a LLVM-IR using the JIT.
 IGenerated_code_executable *Code_generator_jit::compile_unit(
+    ICode_cache                    *code_cache,
     ICode_generator_thread_context *ctx,
     IModule_cache                  *module_cache,
     ILink_unit const               *iunit,
@@ -2143,6 +2304,27 @@ IGenerated_code_executable *Code_generator_jit::compile_unit(
     IAllocator        *alloc = get_allocator();
     Allocator_builder builder(alloc);
 
+    // native code is cached per lambda function, source code only for the whole unit: all
+    // functions and options must be identical to reuse it
+    unsigned char cache_key[16];
+    bool use_cache = code_cache != NULL &&
+        unit.get_target_language() != ICode_generator::TL_NATIVE &&
+        compute_unit_cache_key(unit, options, llvm_ir_output, cache_key);
+
+    if (use_cache) {
+        if (ICode_cache::Entry const *entry = code_cache->lookup(cache_key)) {
+            // found a hit, the unit does not need to be finalized
+            mi::base::Handle<IGenerated_code_executable> code_obj(unit.get_code_object());
+            mi::base::Handle<Generated_code_source> code(
+                code_obj->get_interface<mi::mdl::Generated_code_source>());
+
+            fill_code_from_cache(*ctx, code.get(), entry, &unit);
+
+            code_obj->retain();
+            return code_obj.get();
+        }
+    }
+
     // pass the resource to tag map to the code generator
     unit->set_resource_tag_map(unit.get_resource_tag_map());
 
@@ -2259,6 +2441,10 @@ IGenerated_code_executable *Code_generator_jit::compile_unit(
 
         // it's now safe to drop this module
         delete llvm_module;
+
+        if (use_cache && code->is_valid()) {
+            enter_code_into_cache(code.get(), code_cache, cache_key);
+        }
     }
 
 #ifdef PRINT_TIMINGS
@@ -2361,7 +2547,19 @@ Link_unit_jit::Link_unit_jit(
 , m_lambdas(alloc)
 , m_dist_funcs(alloc)
 , m_resource_tag_map(alloc)
+, m_content_hasher()
+, m_content_hashable(true)
 {
+    // the generated code depends on the unit setup
+    m_content_hasher.update(m_target_lang);
+    m_content_hasher.update(tm_mode);
+    m_content_hasher.update(sm_version);
+    m_content_hasher.update(num_texture_spaces);
+    m_content_hasher.update(num_texture_results);
+    m_content_hasher.update(state_mapping);
+    m_content_hasher.update(enable_debug);
+    m_content_hashable = hash_cg_options(m_content_hasher, *options);
+
     // For native code, we don't need mangling and read-only data segments
     if (m_target_lang != ICode_generator::TL_NATIVE) {
         // enable name mangling
@@ -2599,6 +2797,22 @@ llvm::LLVMContext *Link_unit_jit::get_llvm_context()
     return &m_source_only_llvm_context;
 }
 
+// Update the content hash by a lambda function added to this unit.
+void Link_unit_jit::hash_lambda(
+    Lambda_function const *lambda)
+{
+    if (lambda == NULL) {
+        m_content_hasher.update(0);
+        return;
+    }
+
+    // the lambda hash does neither cover its name nor its execution context
+    DAG_hash const *hash = lambda->get_hash();
+    m_content_hasher.update(hash->data(), hash->size());
+    m_content_hasher.update(lambda->get_name());
+    m_content_hasher.update(lambda->get_execution_context());
+}
+
 // Add a lambda function to this link unit.
 bool Link_unit_jit::add(
     ILambda_function const                    *ilambda,
@@ -2636,6 +2850,11 @@ bool Link_unit_jit::add(
     llvm::Function *func = NULL;
     size_t next_arg_block_index =
         *arg_block_index != ~0 ? *arg_block_index : m_arg_block_layouts.size();
+
+    m_content_hasher.update('L');
+    hash_lambda(lambda);
+    m_content_hasher.update(kind);
+    m_content_hasher.update(mi::Uint64(next_arg_block_index));
     if (body != NULL) {
         func = m_code_gen.compile_lambda(
             /*incremental=*/true, *lambda, resolver, /*transformer=*/NULL, next_arg_block_index);
@@ -2662,6 +2881,7 @@ bool Link_unit_jit::add(
 
         return true;
     }
+    m_content_hashable = false;
     return false;
 }
 
@@ -2700,6 +2920,22 @@ bool Link_unit_jit::add(
 
     size_t next_arg_block_index =
         *arg_block_index != ~0 ? *arg_block_index : m_arg_block_layouts.size();
+
+    m_content_hasher.update('D');
+    hash_lambda(root_lambda);
+    for (size_t i = 0, n = dist_func->get_main_function_count(); i < n; ++i) {
+        mi::base::Handle<ILambda_function> main_func(dist_func->get_main_function(i));
+        hash_lambda(impl_cast<Lambda_function>(main_func.get()));
+    }
+    for (size_t i = 0, n = dist_func->get_expr_lambda_count(); i < n; ++i) {
+        mi::base::Handle<ILambda_function> expr_lambda(dist_func->get_expr_lambda(i));
+        hash_lambda(impl_cast<Lambda_function>(expr_lambda.get()));
+    }
+    for (size_t i = 0, n = dist_func->get_df_handle_count(); i < n; ++i) {
+        m_content_hasher.update(dist_func->get_df_handle(i));
+    }
+    m_content_hasher.update(mi::Uint64(next_arg_block_index));
+
     LLVM_code_generator::Function_vector llvm_funcs(get_allocator());
     llvm::Module *module = m_code_gen.compile_distribution_function(
         /*incremental=*/ true,
@@ -2710,6 +2946,7 @@ bool Link_unit_jit::add(
         main_function_indices);
 
     if (module == NULL) {
+        m_content_hashable = false;
         return false;
     }
 
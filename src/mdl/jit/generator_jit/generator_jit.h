@@ -31,6 +31,7 @@
 
 #include <mdl/compiler/compilercore/compilercore_cc_conf.h>
 #include <mdl/compiler/compilercore/compilercore_allocator.h>
+#include <mdl/compiler/compilercore/compilercore_hash.h>
 #include <mdl/compiler/compilercore/compilercore_options.h>
 #include <mdl/codegenerators/generator_code/generator_code.h>
 
@@ -221,6 +222,17 @@ public:
     /// Set a new module cache.
     void set_module_cache(mi::mdl::IModule_cache *cache) { m_code_gen.set_module_cache(cache); }
 
+    /// Get a copy of the hasher over the unit setup and all functions added so far.
+    ///
+    /// \param hasher  receives the hasher
+    ///
+    /// \return false if the content of this unit cannot be hashed
+    bool get_content_hasher(MD5_hasher &hasher) const
+    {
+        hasher = m_content_hasher;
+        return m_content_hashable;
+    }
+
     /// Finalize compilation of the current module that was created by create_module().
     ///
     /// \param module_cache         the module cache if any
@@ -318,6 +330,12 @@ private:
     /// Get the LLVM context to use with this link unit.
     llvm::LLVMContext *get_llvm_context();
 
+    /// Update the content hash by a lambda function added to this unit.
+    ///
+    /// \param lambda  the lambda function
+    void hash_lambda(
+        Lambda_function const *lambda);
+
 private:
     /// Memory arena for storing strings.
     Memory_arena m_arena;
@@ -359,6 +377,12 @@ private:
 
     /// The resource to tag map for this link unit, mapping resource values to tags.
     Resource_tag_map m_resource_tag_map;
+
+    /// Hashes the unit setup and all added functions, used to build code cache keys.
+    MD5_hasher m_content_hasher;
+
+    /// False, if the content of this unit cannot be hashed.
+    bool m_content_hashable;
 };
 
 /// Implementation of the ICode_genenator_thread_context interface.
@@ -477,6 +501,23 @@ public:
         ICall_name_resolver const      *name_resolver,
         ICode_generator_thread_context *ctx) MDL_FINAL;
 
+    /// Compile a lambda function using the JIT into an environment (shader) of a scene and
+    /// reuse or store its native object code in a code cache.
+    ///
+    /// \param code_cache     If non-NULL, a code cache for the native object code
+    /// \param lambda         the lambda function to compile
+    /// \param module_cache   the module cache if any
+    /// \param name_resolver  the call name resolver
+    /// \param ctx            the code generator thread context
+    ///
+    /// \return the compiled function or NULL on compilation errors
+    IGenerated_code_lambda_function *compile_into_environment(
+        ICode_cache                    *code_cache,
+        ILambda_function const         *lambda,
+        IModule_cache                  *module_cache,
+        ICall_name_resolver const      *name_resolver,
+        ICode_generator_thread_context *ctx) MDL_FINAL;
+
     /// Compile a lambda function using the JIT into a constant function.
     ///
     /// \param lambda           the lambda function to compile
@@ -563,6 +604,31 @@ public:
         unsigned                       num_texture_results,
         ILambda_call_transformer       *transformer) MDL_FINAL;
 
+    /// Compile a lambda function into a generic function using the JIT and reuse or store its
+    /// native object code in a code cache.
+    ///
+    /// \param code_cache           If non-NULL, a code cache for the native object code
+    /// \param lambda               the lambda function to compile
+    /// \param module_cache         the module cache if any
+    /// \param name_resolver        the call name resolver
+    /// \param ctx                  the code generator thread context
+    /// \param num_texture_spaces   the number of supported texture spaces
+    /// \param num_texture_results  the number of texture result entries
+    /// \param transformer          an optional transformer for calls in the lambda expression
+    ///
+    /// \return the compiled function or NULL on compilation errors
+    ///
+    /// \note the lambda function must have only one root expression.
+    IGenerated_code_lambda_function *compile_into_generic_function(
+        ICode_cache                    *code_cache,
+        ILambda_function const         *lambda,
+        IModule_cache                  *module_cache,
+        ICall_name_resolver const      *name_resolver,
+        ICode_generator_thread_context *ctx,
+        unsigned                       num_texture_spaces,
+        unsigned                       num_texture_results,
+        ILambda_call_transformer       *transformer) MDL_FINAL;
+
     /// Compile a lambda function into a LLVM-IR using the JIT.
     ///
     /// \param lambda               the lambda function to compile
@@ -620,10 +686,42 @@ public:
     /// \param ctx    the code generator thread context
     /// \param code   the code object to fill
     /// \param entry  the code cache entry
+    /// \param unit   if non-NULL, the link unit the code object belongs to
     void fill_code_from_cache(
         ICode_generator_thread_context &ctx,
         Generated_code_source          *code,
-        ICode_cache::Entry const       *entry);
+        ICode_cache::Entry const       *entry,
+        Link_unit_jit const            *unit);
+
+    /// Compute the code cache key for the native object code of a lambda function.
+    ///
+    /// \param lambda               the lambda function
+    /// \param options              the code generator options used to compile the lambda
+    /// \param num_texture_spaces   the number of supported texture spaces
+    /// \param num_texture_results  the number of texture result entries
+    /// \param cache_key            receives the key
+    ///
+    /// \return false if the native code of this lambda cannot be cached
+    bool compute_native_cache_key(
+        Lambda_function const *lambda,
+        Options_impl const    &options,
+        unsigned              num_texture_spaces,
+        unsigned              num_texture_results,
+        unsigned char         cache_key[16]) const;
+
+    /// Compute the code cache key for the source code of a link unit.
+    ///
+    /// \param unit            the link unit
+    /// \param options         the code generator options used to compile the unit
+    /// \param llvm_ir_output  true, if LLVM-IR is generated instead of the target language
+    /// \param cache_key       receives the key
+    ///
+    /// \return false if the code of this link unit cannot be cached
+    bool compute_unit_cache_key(
+        Link_unit_jit const &unit,
+        Options_impl const  &options,
+        bool                llvm_ir_output,
+        unsigned char       cache_key[16]) const;
 
     /// Enter a code object into the code cache.
     ///
@@ -766,8 +864,12 @@ public:
         unsigned                       num_texture_spaces,
         unsigned                       num_texture_results) MDL_FINAL;
 
+    using ICode_generator_jit::compile_unit;
+
     /// Compile a link unit into a LLVM-IR, PTX or native code using the JIT.
     ///
+    /// \param code_cache           If non-NULL, a code cache for the source code of the whole
+    ///                             unit, only reused if all functions and options are identical
     /// \param ctx                  the code generator thread context
     /// \param module_cache         the module cache if any
     /// \param unit                 the link unit to compile
@@ -777,6 +879,7 @@ public:
     ///
     /// \note the thread context should have the same value as in create_link_unit()
     IGenerated_code_executable *compile_unit(
+        ICode_cache                    *code_cache,
         ICode_generator_thread_context *ctx,
         IModule_cache                  *module_cache,
         ILink_unit const               *unit,
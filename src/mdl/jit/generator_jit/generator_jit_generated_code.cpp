@@ -1521,6 +1521,60 @@ bool Generated_code_lambda_function::run_init(
     return false;
 }
 
+// Run a compiled lambda function for several states in a row.
+bool Generated_code_lambda_function::run_generic_batch(
+    size_t                       index,
+    size_t                       count,
+    void                         *results,
+    size_t                       result_size,
+    Shading_state_material const *states,
+    void                         *tex_data,
+    void const                   *cap_args)
+{
+    if (!m_aborted && index < m_jitted_funcs.size()) {
+        Exc_state     exc(m_exc_handler, m_aborted);
+        Res_data_pair pair(m_res_data, tex_data);
+
+        if (setjmp(exc.env) == 0) {
+            Gen_func *gen_func = reinterpret_cast<Gen_func *>(m_jitted_funcs[index]);
+            char     *result   = static_cast<char *>(results);
+            for (size_t i = 0; i < count; ++i, result += result_size) {
+                gen_func(result, &states[i], pair, exc, cap_args);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+// Run a compiled environment function for several states in a row.
+bool Generated_code_lambda_function::run_environment_batch(
+    size_t                          index,
+    size_t                          count,
+    RGB_color                       *results,
+    Shading_state_environment const *states,
+    void                            *tex_data)
+{
+    if (!m_aborted && index < m_jitted_funcs.size()) {
+        Exc_state     exc(m_exc_handler, m_aborted);
+        Res_data_pair pair(m_res_data, tex_data);
+
+        if (setjmp(exc.env) == 0) {
+            Env_func *env_func = reinterpret_cast<Env_func *>(m_jitted_funcs[index]);
+            for (size_t i = 0; i < count; ++i) {
+                env_func(&results[i], &states[i], pair, exc, NULL);
+            }
+            return true;
+        }
+    }
+
+    // black for now
+    for (size_t i = 0; i < count; ++i) {
+        results[i].r = results[i].g = results[i].b = 0.0f;
+    }
+    return false;
+}
+
 // Get the used state properties of  the generated lambda function code.
 IGenerated_code_lambda_function::State_usage
     Generated_code_lambda_function::get_state_usage() const
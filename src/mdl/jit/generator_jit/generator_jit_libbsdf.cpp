@@ -49,7 +49,7 @@
 namespace mi {
 namespace mdl {
 
-// Load the libbsdf LLVM module.
+// Lazily load the libbsdf LLVM module.
 std::unique_ptr<llvm::Module> LLVM_code_generator::load_libbsdf(
     llvm::LLVMContext &llvm_context, mdl::Df_handle_slot_mode hsm)
 {
@@ -91,12 +91,12 @@ std::unique_ptr<llvm::Module> LLVM_code_generator::load_libbsdf(
         return nullptr;
     }
 
-    std::unique_ptr<llvm::MemoryBuffer> mem(llvm::MemoryBuffer::getMemBuffer(
+    // the bitcode is static data, so the lazily loaded module can reference it without copying
+    llvm::MemoryBufferRef mem(
         llvm::StringRef((char const *) bitcode, bitcode_size),
-        "libbsdf",
-        /*RequiresNullTerminator=*/ false));
+        "libbsdf");
 
-    auto mod = llvm::parseBitcodeFile(*mem.get(), llvm_context);
+    auto mod = llvm::getLazyBitcodeModule(mem, llvm_context);
     if (!mod) {
         error(PARSING_LIBBSDF_MODULE_FAILED, Error_params(get_allocator()));
         MDL_ASSERT(!"Parsing libbsdf failed");
@@ -88,7 +88,7 @@ unsigned char const *LLVM_code_generator::get_libdevice(
 #endif
 }
 
-// Load libdevice.
+// Lazily load libdevice.
 std::unique_ptr<llvm::Module> LLVM_code_generator::load_libdevice(
     llvm::LLVMContext &llvm_context,
     unsigned          &min_ptx_version)
@@ -97,11 +97,12 @@ std::unique_ptr<llvm::Module> LLVM_code_generator::load_libdevice(
 
     unsigned char const *data = get_libdevice(size, min_ptx_version);
 
-    std::unique_ptr<llvm::MemoryBuffer> mem(llvm::MemoryBuffer::getMemBuffer(
+    // the bitcode is static data, so the lazily loaded module can reference it without copying,
+    // only the functions really used get materialized when linking
+    llvm::MemoryBufferRef mem(
         llvm::StringRef((char const *)data, size),
-        "libdevice",
-        /*RequiresNullTerminator=*/ false));
-    auto module = llvm::parseBitcodeFile(*mem.get(), llvm_context);
+        "libdevice");
+    auto module = llvm::getLazyBitcodeModule(mem, llvm_context);
     if (!module) {
         error(PARSING_LIBDEVICE_MODULE_FAILED, Error_params(get_allocator()));
         MDL_ASSERT(!"Parsing libdevice failed");
@@ -37,8 +37,10 @@
 #include <vector>
 #include <algorithm>
 
+#include <llvm/ADT/SmallString.h>
 #include <llvm/ADT/StringMap.h>
 #include <llvm/ADT/Triple.h>
+#include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/Bitcode/BitcodeWriter.h>
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/ExecutionEngine/JITEventListener.h>
@@ -64,16 +66,19 @@
 #include <llvm/Support/DynamicLibrary.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/FormattedStream.h>
+#include <llvm/Support/Host.h>
 #include <llvm/Support/ManagedStatic.h>
 #include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/PrettyStackTrace.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Support/TargetRegistry.h>
+#include <llvm/Support/ThreadPool.h>
 #include <llvm/Support/CommandLine.h>
 #include <llvm/Transforms/IPO.h>
 #include <llvm/Transforms/IPO/AlwaysInliner.h>
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
+#include <llvm/Transforms/Utils/Cloning.h>
 #include <llvm/Linker/Linker.h>
 
 #include <mi/mdl/mdl_generated_dag.h>
@@ -193,6 +198,11 @@ public:
     MDL_JIT(llvm::orc::JITTargetMachineBuilder jtm_builder, llvm::DataLayout data_layout)
     : m_next_module_id(0)
     , m_uses_coff(jtm_builder.getTargetTriple().isOSBinFormatCOFF())
+    , m_target_id(
+        jtm_builder.getTargetTriple().str() + ";" +
+        llvm::sys::getHostCPUName().str() + ";" +
+        jtm_builder.getFeatures().getString())
+    , m_object_compiler(jtm_builder)
     , m_object_layer(m_execution_session,
         // GetMemoryManager
         [this]() { return std::make_unique<llvm::SectionMemoryManager>(&m_memory_mapper); })
@@ -240,6 +250,33 @@ public:
         return rt;
     }
 
+    /// Add relocatable object code to the JIT and get its module key.
+    MDL_JIT_module_key add_object(std::unique_ptr<llvm::MemoryBuffer> object) {
+        std::string module_name = std::to_string(m_next_module_id++);
+        llvm::orc::JITDylibSP dylib = &m_execution_session.createBareJITDylib(module_name);
+        dylib->addToLinkOrder(m_mdl_runtime_dylib);
+        llvm::orc::ResourceTrackerSP rt = dylib->createResourceTracker();
+        if (auto error = m_object_layer.add(rt, std::move(object))) {
+            llvm::consumeError(std::move(error));
+            llvm::cantFail(rt->remove());
+            return nullptr;
+        }
+        return rt;
+    }
+
+    /// Compile an LLVM module into relocatable object code, exactly as the compile layer does.
+    std::unique_ptr<llvm::MemoryBuffer> compile_to_object(llvm::Module &module) {
+        llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> obj = m_object_compiler(module);
+        if (!obj) {
+            llvm::consumeError(obj.takeError());
+            return nullptr;
+        }
+        return std::move(*obj);
+    }
+
+    /// Get a string identifying the target machine of the generated object code.
+    std::string const &get_target_id() const { return m_target_id; }
+
     /// Search for a symbol name in the given module.
     llvm::Expected<llvm::JITEvaluatedSymbol> find_symbol_in(
         MDL_JIT_module_key key,
@@ -288,6 +325,12 @@ private:
     /// True, if the binary object format is COFF.
     bool m_uses_coff;
 
+    /// Identifies the target triple, CPU and features of the generated code.
+    std::string m_target_id;
+
+    /// The compiler used to create object code outside the compile layer.
+    llvm::orc::ConcurrentIRCompiler m_object_compiler;
+
     /// Execution session used to identify modules.
     llvm::orc::ExecutionSession m_execution_session;
 
@@ -448,6 +491,30 @@ MDL_JIT_module_key Jitted_code::add_llvm_module(llvm::Module *llvm_module)
     return m_mdl_jit->add_module(std::unique_ptr<llvm::Module>(llvm_module));
 }
 
+// Add relocatable object code to the execution engine.
+MDL_JIT_module_key Jitted_code::add_object_code(char const *data, size_t size)
+{
+    return m_mdl_jit->add_object(llvm::MemoryBuffer::getMemBufferCopy(
+        llvm::StringRef(data, size), "MDL cached object"));
+}
+
+// Compile the given LLVM module into relocatable object code.
+bool Jitted_code::compile_to_object_code(llvm::Module *llvm_module, string &object_code)
+{
+    std::unique_ptr<llvm::MemoryBuffer> obj = m_mdl_jit->compile_to_object(*llvm_module);
+    if (!obj) {
+        return false;
+    }
+    object_code.assign(obj->getBufferStart(), obj->getBufferSize());
+    return true;
+}
+
+// Get a string identifying the target machine of the generated object code.
+char const *Jitted_code::get_target_id() const
+{
+    return m_mdl_jit->get_target_id().c_str();
+}
+
 // Helper: remove this module from the execution engine and delete it.
 void Jitted_code::delete_llvm_module(MDL_JIT_module_key module_key)
 {
@@ -1307,6 +1374,10 @@ LLVM_code_generator::LLVM_code_generator(
 , m_bsdf_measurement_table(jitted_code->get_allocator())
 , m_string_table(jitted_code->get_allocator())
 , m_jitted_code(mi::base::make_handle_dup(jitted_code))
+, m_native_code_cache(NULL)
+, m_native_code_cache_key()
+, m_cached_native_code(jitted_code->get_allocator())
+, m_has_cached_native_code(false)
 , m_compiler(mi::base::make_handle_dup(compiler))
 , m_module_cache(module_cache)
 , m_messages(messages)
@@ -1360,6 +1431,10 @@ LLVM_code_generator::LLVM_code_generator(
 , m_opt_level(get_opt_level_from_options(target_lang, options))
 , m_sm_version(target_lang == ICode_generator::TL_PTX ? sm_version : 0)
 , m_min_ptx_version(40)
+, m_opt_partitions(std::max(
+    1, target_lang != ICode_generator::TL_HLSL && target_lang != ICode_generator::TL_GLSL
+        ? options.get_int_option(MDL_JIT_OPTION_OPT_PARTITIONS)
+        : 1))
 , m_ptx_target_machine(
     target_lang == ICode_generator::TL_PTX
         ? create_ptx_target_machine()
@@ -1444,6 +1519,8 @@ LLVM_code_generator::LLVM_code_generator(
     Instantiated_dfs(get_allocator()),
     get_allocator())
 , m_libbsdf_template_funcs(get_allocator())
+, m_libbsdf_df_semantics(Df_semantics_set::key_compare(), get_allocator())
+, m_libbsdf_linked_funcs(Libbsdf_func_set::key_compare(), get_allocator())
 , m_enable_auxiliary(options.get_bool_option(MDL_JIT_OPTION_ENABLE_AUXILIARY))
 , m_enable_pdf(options.get_bool_option(MDL_JIT_OPTION_ENABLE_PDF))
 , m_warn_spectrum_conversion(options.get_bool_option(MDL_JIT_WARN_SPECTRUM_CONVERSION))
@@ -1924,6 +2001,205 @@ bool LLVM_code_generator::optimize(llvm::Module *module)
         }
     }
 
+    // debug info cannot be distributed over several modules
+    if (m_opt_partitions > 1 && module->debug_compile_units().empty()) {
+        return optimize_partitioned(module);
+    }
+
+    llvm::legacy::PassManager mpm;
+    add_module_optimization_passes(mpm);
+    return mpm.run(*module);
+}
+
+// Optimize LLVM code in several partitions concurrently and link them back into one module.
+bool LLVM_code_generator::optimize_partitioned(llvm::Module *module)
+{
+    // distribute the non-local function definitions over the partitions, biggest first,
+    // always into the currently smallest partition
+    std::vector<std::pair<size_t, llvm::Function *> > roots;
+    for (llvm::Function &func : module->functions()) {
+        if (!func.isDeclaration() && !func.hasLocalLinkage()) {
+            roots.push_back(std::make_pair(size_t(func.getInstructionCount()), &func));
+        }
+    }
+    std::stable_sort(
+        roots.begin(), roots.end(),
+        [](std::pair<size_t, llvm::Function *> const &a,
+           std::pair<size_t, llvm::Function *> const &b) { return a.first > b.first; });
+
+    size_t n_parts = std::min(size_t(m_opt_partitions), roots.size());
+    if (n_parts < 2 || !module->alias_empty() || !module->ifunc_empty()) {
+        llvm::legacy::PassManager mpm;
+        add_module_optimization_passes(mpm);
+        return mpm.run(*module);
+    }
+
+    llvm::DenseMap<llvm::GlobalValue const *, size_t> owner;
+    std::vector<size_t> part_sizes(n_parts, 0);
+    for (std::pair<size_t, llvm::Function *> const &root : roots) {
+        size_t part = std::min_element(part_sizes.begin(), part_sizes.end()) - part_sizes.begin();
+        part_sizes[part] += root.first + 1;
+        owner[root.second] = part;
+    }
+
+    // Local symbols are shared by all partitions as linkonce_odr definitions with unique names,
+    // so the linker keeps one copy of them. Remember their linkage to restore it afterwards.
+    std::vector<std::pair<std::string, llvm::GlobalValue::LinkageTypes> > locals;
+    std::vector<std::string> defined;
+    for (llvm::GlobalValue &gv : module->global_values()) {
+        if (gv.isDeclaration()) {
+            continue;
+        }
+        if (gv.hasLocalLinkage()) {
+            if (!gv.hasName()) {
+                gv.setName("mdl_local");
+            }
+            locals.push_back(std::make_pair(gv.getName().str(), gv.getLinkage()));
+            gv.setLinkage(llvm::GlobalValue::LinkOnceODRLinkage);
+        }
+        defined.push_back(gv.getName().str());
+    }
+
+    // serialize the partitions, the LLVM context must only be used by the current thread
+    std::vector<llvm::SmallString<0> > bitcode(n_parts);
+    for (size_t part = 0; part < n_parts; ++part) {
+        llvm::ValueToValueMapTy vmap;
+        std::unique_ptr<llvm::Module> part_module(llvm::CloneModule(
+            *module, vmap, [&owner, part](llvm::GlobalValue const *gv) {
+                if (gv->hasLinkOnceODRLinkage()) {
+                    return true;
+                }
+                auto it = owner.find(gv);
+                return it != owner.end() ? it->second == part : part == 0;
+            }));
+
+        if (part != 0) {
+            // module level metadata and appending variables are taken from the first partition
+            llvm::Module *m = part_module.get();
+            for (llvm::NamedMDNode &md : llvm::make_early_inc_range(m->named_metadata())) {
+                if (md.getName() != "llvm.module.flags") {
+                    m->eraseNamedMetadata(&md);
+                }
+            }
+            for (llvm::GlobalVariable &gv : llvm::make_early_inc_range(part_module->globals())) {
+                if (gv.hasAppendingLinkage()) {
+                    gv.eraseFromParent();
+                }
+            }
+        }
+
+        llvm::raw_svector_ostream os(bitcode[part]);
+        llvm::WriteBitcodeToFile(*part_module, os);
+    }
+
+    // optimize all partitions in their own LLVM contexts
+    std::vector<char> failed(n_parts, 0);
+    {
+        llvm::ThreadPool pool(llvm::hardware_concurrency(unsigned(n_parts)));
+        for (size_t part = 0; part < n_parts; ++part) {
+            pool.async([this, part, &bitcode, &failed]() {
+                llvm::LLVMContext context;
+                llvm::Expected<std::unique_ptr<llvm::Module> > part_module =
+                    llvm::parseBitcodeFile(
+                        llvm::MemoryBufferRef(bitcode[part].str(), "<mdl-partition>"), context);
+                if (!part_module) {
+                    llvm::consumeError(part_module.takeError());
+                    failed[part] = 1;
+                    return;
+                }
+
+                llvm::legacy::PassManager mpm;
+                add_module_optimization_passes(mpm);
+                mpm.run(**part_module);
+
+                bitcode[part].clear();
+                llvm::raw_svector_ostream os(bitcode[part]);
+                llvm::WriteBitcodeToFile(**part_module, os);
+            });
+        }
+    }
+
+    std::vector<std::unique_ptr<llvm::Module> > optimized;
+    for (size_t part = 0; part < n_parts && !failed[part]; ++part) {
+        llvm::Expected<std::unique_ptr<llvm::Module> > part_module = llvm::parseBitcodeFile(
+            llvm::MemoryBufferRef(bitcode[part].str(), "<mdl-partition>"), m_llvm_context);
+        if (!part_module) {
+            llvm::consumeError(part_module.takeError());
+            break;
+        }
+        optimized.push_back(std::move(*part_module));
+    }
+    if (optimized.size() != n_parts) {
+        MDL_ASSERT(!"Optimizing module partitions failed");
+
+        // the module is still intact, optimize it serially
+        for (std::pair<std::string, llvm::GlobalValue::LinkageTypes> const &local : locals) {
+            module->getNamedValue(local.first)->setLinkage(local.second);
+        }
+        llvm::legacy::PassManager mpm;
+        add_module_optimization_passes(mpm);
+        return mpm.run(*module);
+    }
+
+    // replace all definitions of the module by the optimized ones in partition order
+    for (llvm::Function &func : module->functions()) {
+        if (!func.isDeclaration()) {
+            func.deleteBody();
+            func.setComdat(NULL);
+        }
+    }
+    for (llvm::GlobalVariable &gv : llvm::make_early_inc_range(module->globals())) {
+        if (gv.hasAppendingLinkage()) {
+            gv.eraseFromParent();
+        } else if (gv.hasInitializer()) {
+            gv.setInitializer(NULL);
+            gv.setComdat(NULL);
+            gv.setLinkage(llvm::GlobalValue::ExternalLinkage);
+        }
+    }
+    for (llvm::NamedMDNode &md : llvm::make_early_inc_range(module->named_metadata())) {
+        if (md.getName() != "llvm.module.flags") {
+            module->eraseNamedMetadata(&md);
+        }
+    }
+
+    llvm::Linker linker(*module);
+    for (std::unique_ptr<llvm::Module> &part_module : optimized) {
+        if (linker.linkInModule(std::move(part_module))) {
+            // cannot happen, all partitions are derived from the same module
+            MDL_ASSERT(!"Linking module partitions failed");
+        }
+    }
+
+    // remove what was optimized away everywhere and make the shared symbols local again
+    for (std::string const &name : defined) {
+        llvm::GlobalValue *gv = module->getNamedValue(name);
+        if (gv != NULL && gv->isDeclaration() && gv->use_empty()) {
+            gv->eraseFromParent();
+        }
+    }
+    for (std::pair<std::string, llvm::GlobalValue::LinkageTypes> const &local : locals) {
+        llvm::GlobalValue *gv = module->getNamedValue(local.first);
+        if (gv != NULL && !gv->isDeclaration()) {
+            gv->setLinkage(local.second);
+        }
+    }
+    {
+        llvm::legacy::PassManager mpm;
+        mpm.add(llvm::createGlobalDCEPass());
+        mpm.run(*module);
+    }
+
+    // linking replaced the function objects
+    for (Exported_function &exp_func : m_exported_func_list) {
+        exp_func.func = module->getFunction(exp_func.name.c_str());
+    }
+    return true;
+}
+
+// Add the module optimization passes to the given pass manager.
+void LLVM_code_generator::add_module_optimization_passes(llvm::legacy::PassManager &mpm) const
+{
     llvm::PassManagerBuilder builder;
     builder.OptLevel         = m_opt_level;
     builder.AvoidPointerPHIs = target_is_structured_language();
@@ -1956,9 +2232,7 @@ bool LLVM_code_generator::optimize(llvm::Module *module)
             AddFunctionInstCounterExtension);
     }
 
-    llvm::legacy::PassManager mpm;
     builder.populateModulePassManager(mpm);
-    return mpm.run(*module);
 }
 
 // Get an LLVM type for an MDL type.
@@ -9925,7 +10199,11 @@ llvm::Module *LLVM_code_generator::finalize_module()
                 set_llvm_function_attributes(&func, /*mark_noinline=*/false);
             }
 
-            if (llvm::Linker::linkModules(*llvm_module, std::move(libdevice))) {
+            // only link the libdevice functions referenced by the module, all references are
+            // known at this point
+            if (llvm::Linker::linkModules(
+                    *llvm_module, std::move(libdevice), llvm::Linker::Flags::LinkOnlyNeeded))
+            {
                 // true means linking has failed
                 error(LINKING_LIBDEVICE_FAILED, "unknown linking error");
                 MDL_ASSERT(!"Linking libdevice failed");
@@ -9975,7 +10253,19 @@ llvm::Module *LLVM_code_generator::finalize_module()
         }
 #endif
 
-        optimize(llvm_module);
+        if (m_native_code_cache != NULL) {
+            ICode_cache::Entry const *entry = m_native_code_cache->lookup(m_native_code_cache_key);
+            if (entry != NULL) {
+                // copy it, the entry might be dropped from the cache before jit_compile()
+                m_cached_native_code.assign(entry->code, entry->code_size);
+                m_has_cached_native_code = true;
+            }
+        }
+
+        // the cached object code was created from the optimized module
+        if (!m_has_cached_native_code) {
+            optimize(llvm_module);
+        }
 
 #if 0
         {
@@ -10002,11 +10292,55 @@ MDL_JIT_module_key LLVM_code_generator::jit_compile(llvm::Module *module)
         }
     }
 
+    if (m_has_cached_native_code) {
+        m_has_cached_native_code = false;
+
+        MDL_JIT_module_key module_key = m_jitted_code->add_object_code(
+            m_cached_native_code.data(), m_cached_native_code.size());
+        if (module_key) {
+            drop_llvm_module(module);
+            return module_key;
+        }
+
+        // the cached object code is unusable, recompile the unoptimized module
+        optimize(module);
+    } else if (m_native_code_cache != NULL) {
+        string object_code(get_allocator());
+        if (m_jitted_code->compile_to_object_code(module, object_code)) {
+            MDL_JIT_module_key module_key = m_jitted_code->add_object_code(
+                object_code.data(), object_code.size());
+            if (module_key) {
+                ICode_cache::Entry entry(
+                    object_code.data(), object_code.size(),
+                    /*const_seg=*/NULL, 0,
+                    /*arg_layout=*/NULL, 0,
+                    /*mapped_strings=*/NULL, 0,
+                    /*render_state_usage=*/0,
+                    /*func_infos=*/NULL, 0);
+                m_native_code_cache->enter(m_native_code_cache_key, entry);
+
+                drop_llvm_module(module);
+                return module_key;
+            }
+        }
+    }
+
     // the jitted code takes ownership of the module
     MDL_JIT_module_key module_key = m_jitted_code->add_llvm_module(module);
     return module_key;
 }
 
+// Enable caching of the native object code of the module compiled by this code generator.
+void LLVM_code_generator::set_native_code_cache(
+    ICode_cache         *code_cache,
+    unsigned char const key[16])
+{
+    MDL_ASSERT(m_target_lang == ICode_generator::TL_NATIVE);
+
+    m_native_code_cache = code_cache;
+    memcpy(m_native_code_cache_key, key, sizeof(m_native_code_cache_key));
+}
+
 /// Create the target machine for PTX code generation.
 std::unique_ptr<llvm::TargetMachine> LLVM_code_generator::create_ptx_target_machine()
 {
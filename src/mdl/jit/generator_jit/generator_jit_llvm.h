@@ -56,6 +56,7 @@ namespace llvm {
     class TargetMachine;
     namespace legacy {
         class FunctionPassManager;
+        class PassManager;
     }
 }  // llvm
 
@@ -115,6 +116,27 @@ public:
     /// \param llvm_module  the LLVM module
     void delete_llvm_module(MDL_JIT_module_key module_key);
 
+    /// Add relocatable object code to the execution engine.
+    ///
+    /// \param data  the object code, will be copied
+    /// \param size  the size of the object code
+    ///
+    /// \return the module key or NULL if the object code could not be loaded
+    MDL_JIT_module_key add_object_code(char const *data, size_t size);
+
+    /// Compile the given LLVM module into relocatable object code for the JIT target, without
+    /// adding it to the execution engine.
+    ///
+    /// \param llvm_module  the LLVM module
+    /// \param object_code  receives the object code
+    ///
+    /// \return true on success
+    bool compile_to_object_code(llvm::Module *llvm_module, string &object_code);
+
+    /// Get a string identifying the target machine of the object code, i.e. the target triple,
+    /// the CPU and its features.
+    char const *get_target_id() const;
+
     /// JIT compile the given LLVM function.
     ///
     /// \param module_key  the module key returned by add_llvm_module() for the module containing
@@ -1448,6 +1470,16 @@ public:
     /// Enable the generation of the RO segment if allowed.
     void enable_ro_data_segment() { m_use_ro_data_segment = m_enable_ro_segment; }
 
+    /// Enable caching of the native object code of the module compiled by this code generator.
+    ///
+    /// If the cache contains object code for the given key, finalize_module() skips the
+    /// optimization and jit_compile() loads the cached object code instead of compiling the
+    /// module. Otherwise the object code is entered into the cache by jit_compile().
+    ///
+    /// \param code_cache  the code cache
+    /// \param key        the cache key, must identify the generated LLVM module
+    void set_native_code_cache(ICode_cache *code_cache, unsigned char const key[16]);
+
     /// Mark all exported functions as entry points.
     void mark_exported_funcs_as_entries() { m_exported_funcs_are_entries = true; }
 
@@ -2255,6 +2287,25 @@ private:
     /// \return true if module was modified, false otherwise
     bool optimize(llvm::Module *module);
 
+    /// Optimize LLVM code in several partitions concurrently and link them back into one module.
+    ///
+    /// Every non-local definition is placed into exactly one partition, local definitions are
+    /// shared by all partitions, so they can still be inlined everywhere. The linker keeps only
+    /// one copy of them.
+    ///
+    /// \param module  The LLVM module to optimize, its definitions are replaced.
+    ///
+    /// \return true if module was modified, false otherwise
+    bool optimize_partitioned(llvm::Module *module);
+
+    /// Add the module optimization passes to the given pass manager.
+    ///
+    /// Does not access any LLVM state of this code generator, so it may be used for modules
+    /// of other LLVM contexts from other threads.
+    ///
+    /// \param mpm  the pass manager
+    void add_module_optimization_passes(llvm::legacy::PassManager &mpm) const;
+
     /// Check if a given type needs reference return calling convention.
     ///
     /// \param type  the type to check
@@ -3720,6 +3771,8 @@ private:
 
     /// Load the libbsdf LLVM module.
     ///
+    /// The module is loaded lazily, i.e., function bodies are only materialized on demand.
+    ///
     /// \param llvm_context  the context for the loader
     /// \param hsm           df handle type to use, which will be used to select the libbsdf version
     std::unique_ptr<llvm::Module> load_libbsdf(
@@ -3772,13 +3825,76 @@ private:
         int            df_param_idx,
         IType::Kind    kind);
 
+    /// A set of DF semantics.
+    typedef set<IDefinition::Semantics>::Type Df_semantics_set;
+
+    /// A set of libbsdf function names.
+    typedef set<string>::Type Libbsdf_func_set;
+
+    /// Collect the semantics of all DAG calls used by the main functions of a distribution
+    /// function.
+    ///
+    /// \param dist_func     the distribution function
+    /// \param semantics     the set receiving the semantics
+    void collect_df_semantics(
+        Distribution_function const &dist_func,
+        Df_semantics_set            &semantics);
+
+    /// Checks whether the given libbsdf DF API function is needed for the given DF semantics.
+    ///
+    /// \param name       the name of the libbsdf function
+    /// \param sema       the semantics of the libbsdf function
+    /// \param semantics  the set of DF semantics in use
+    static bool is_libbsdf_function_needed(
+        llvm::StringRef          name,
+        IDefinition::Semantics   sema,
+        Df_semantics_set const   &semantics);
+
+    /// Check whether the given libbsdf function is contained in the given set of linked functions.
+    ///
+    /// \param f             the libbsdf function
+    /// \param linked_funcs  the names of the linked functions, may be NULL
+    static bool is_libbsdf_function_linked(
+        llvm::Function const   &f,
+        Libbsdf_func_set const *linked_funcs);
+
+    /// Restrict a lazily loaded libbsdf module to the functions needed for the given DF semantics.
+    ///
+    /// Materializes the needed functions and everything they reference, and turns all other
+    /// functions into declarations without ever materializing them.
+    ///
+    /// \param libbsdf            the lazily loaded libbsdf module
+    /// \param df_semantics       the DF semantics that need to be available after linking
+    /// \param linked_semantics   if non-NULL, the DF semantics already linked into the current
+    ///                           module. In this case, only the missing DF API functions and
+    ///                           their dependencies are kept.
+    /// \param linked_funcs       if non-NULL, the names of the libbsdf functions already linked
+    ///                           into the current module. These functions are kept as
+    ///                           declarations only, so they resolve to the existing definitions.
+    ///
+    /// \returns false if materializing a function failed.
+    bool restrict_libbsdf(
+        llvm::Module           &libbsdf,
+        Df_semantics_set const &df_semantics,
+        Df_semantics_set const *linked_semantics,
+        Libbsdf_func_set const *linked_funcs);
+
     /// Load and link libbsdf into the current LLVM module.
     /// It maps the types from libbsdf to our types and resolves referenced API functions
     /// to our intrinsics.
-    /// \param hsm       df handle type to use, which will be used to select the libbsdf version
+    ///
+    /// Only the DF API functions for the given DF semantics are linked. If libbsdf was already
+    /// linked, the DF API functions missing for the given DF semantics are added, and their
+    /// references to already linked libbsdf functions are resolved to the existing definitions.
+    ///
+    /// \param hsm           df handle type to use, which will be used to select the libbsdf
+    ///                      version
+    /// \param df_semantics  the DF semantics used by the distribution function to compile
     ///
     /// \returns false if there was any error.
-    bool load_and_link_libbsdf(mdl::Df_handle_slot_mode hsm);
+    bool load_and_link_libbsdf(
+        mdl::Df_handle_slot_mode hsm,
+        Df_semantics_set const   &df_semantics);
 
     /// Returns the set of context data flags to use for functions used with distribution functions.
     LLVM_context_data::Flags get_df_function_flags(const llvm::Function *func);
@@ -3915,6 +4031,18 @@ private:
     /// The jitted code singleton.
     mi::base::Handle<Jitted_code> m_jitted_code;
 
+    /// The code cache for native object code if any.
+    ICode_cache *m_native_code_cache;
+
+    /// The key of the native object code in the code cache.
+    unsigned char m_native_code_cache_key[16];
+
+    /// The native object code found in the code cache.
+    string m_cached_native_code;
+
+    /// True, if m_cached_native_code holds the object code of the finalized module.
+    bool m_has_cached_native_code;
+
     /// The MDL compiler.
     mi::base::Handle<MDL> m_compiler;
 
@@ -4042,6 +4170,9 @@ private:
     /// If non-zero, the minimum PTX version required.
     unsigned m_min_ptx_version;
 
+    /// Number of partitions optimized concurrently, 1 for serial optimization.
+    unsigned m_opt_partitions;
+
     /// The target machine used with this code generator in PTX mode.
     std::unique_ptr<llvm::TargetMachine> m_ptx_target_machine;
 
@@ -4310,6 +4441,13 @@ private:
     /// List of all libbsdf template functions which should be removed before optimizing.
     mi::mdl::vector<llvm::Function *>::Type m_libbsdf_template_funcs;
 
+    /// The DF semantics whose libbsdf DF API functions have been linked into the current module.
+    Df_semantics_set m_libbsdf_df_semantics;
+
+    /// The names of the libbsdf functions linked into the current module which are still
+    /// available under their original name, i.e. all except the DF API functions.
+    Libbsdf_func_set m_libbsdf_linked_funcs;
+
 
     /// If true, auxiliary functions are generated for DFs.
     bool m_enable_auxiliary;
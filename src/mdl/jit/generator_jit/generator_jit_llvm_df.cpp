@@ -239,6 +239,45 @@ private:
     int m_cost;
 };
 
+/// Helper class to collect the semantics of all calls of a DAG.
+class Df_semantics_collector : public IDAG_ir_visitor
+{
+public:
+    typedef set<IDefinition::Semantics>::Type Semantics_set;
+
+    /// The constructor.
+    ///
+    /// \param semantics  the set receiving the semantics
+    Df_semantics_collector(Semantics_set &semantics)
+    : m_semantics(semantics)
+    {
+    }
+
+    /// Post-visit a Constant.
+    void visit(DAG_constant *cnst) MDL_FINAL {}
+
+    /// Post-visit a Temporary.
+    void visit(DAG_temporary *tmp) MDL_FINAL {}
+
+    /// Post-visit a call.
+    ///
+    /// \param call  the call that is visited
+    void visit(DAG_call *call) MDL_FINAL
+    {
+        m_semantics.insert(call->get_semantic());
+    }
+
+    /// Post-visit a Parameter.
+    void visit(DAG_parameter *param) MDL_FINAL {}
+
+    /// Post-visit a temporary initializer.
+    void visit(int index, DAG_node *init) MDL_FINAL {}
+
+private:
+    /// The set receiving the semantics.
+    Semantics_set &m_semantics;
+};
+
 /// Helper class to assign expression lambdas to slots in the texture and lambda results
 /// and determine the order of evaluation.
 class Expr_lambda_scheduler
@@ -1182,10 +1221,11 @@ llvm::Module *LLVM_code_generator::compile_distribution_function(
         }
     }
 
-    // load libbsdf into the current module, if it was not initialized, yet
-    if (m_type_bsdf_sample_data == NULL &&
-        !load_and_link_libbsdf(m_link_libbsdf_df_handle_slot_mode))
-    {
+    // load the libbsdf functions needed by this distribution function into the current module,
+    // if they were not loaded, yet
+    Df_semantics_set df_semantics(Df_semantics_set::key_compare(), alloc);
+    collect_df_semantics(dist_func, df_semantics);
+    if (!load_and_link_libbsdf(m_link_libbsdf_df_handle_slot_mode, df_semantics)) {
         // drop the module and give up
         drop_llvm_module(m_module);
         m_dist_func = NULL;
@@ -2227,11 +2267,162 @@ LLVM_context_data::Flags LLVM_code_generator::get_df_function_flags(const llvm::
     return flags;
 }
 
+// Collect the semantics of all DAG calls used by the main functions of a distribution function.
+void LLVM_code_generator::collect_df_semantics(
+    Distribution_function const &dist_func,
+    Df_semantics_set            &semantics)
+{
+    DAG_ir_walker walker(get_allocator());
+    Df_semantics_collector collector(semantics);
+
+    for (size_t i = 0, n = dist_func.get_main_function_count(); i < n; ++i) {
+        mi::base::Handle<mi::mdl::ILambda_function> main_func(dist_func.get_main_function(i));
+        Lambda_function &lambda = *impl_cast<Lambda_function>(main_func.get());
+        walker.walk_node(const_cast<DAG_node *>(lambda.get_body()), &collector);
+    }
+}
+
+// Checks whether the given libbsdf DF API function is needed for the given DF semantics.
+bool LLVM_code_generator::is_libbsdf_function_needed(
+    llvm::StringRef        name,
+    IDefinition::Semantics sema,
+    Df_semantics_set const &semantics)
+{
+    if (semantics.count(sema) == 0) {
+        return false;
+    }
+
+    // combined implementations of thin_film and its argument
+    if (name.startswith("thin_film_")) {
+        return semantics.count(IDefinition::DS_INTRINSIC_DF_THIN_FILM) != 0;
+    }
+    return true;
+}
+
+// Check whether the given libbsdf function is contained in the given set of linked functions.
+bool LLVM_code_generator::is_libbsdf_function_linked(
+    llvm::Function const   &f,
+    Libbsdf_func_set const *linked_funcs)
+{
+    if (linked_funcs == NULL) {
+        return false;
+    }
+    llvm::StringRef name = f.getName();
+    return linked_funcs->count(
+        string(name.begin(), name.end(), linked_funcs->get_allocator())) != 0;
+}
+
+// Restrict a lazily loaded libbsdf module to the functions needed for the given DF semantics.
+bool LLVM_code_generator::restrict_libbsdf(
+    llvm::Module           &libbsdf,
+    Df_semantics_set const &df_semantics,
+    Df_semantics_set const *linked_semantics,
+    Libbsdf_func_set const *linked_funcs)
+{
+    ptr_hash_set<llvm::Function>::Type needed_funcs(get_allocator());
+    vector<llvm::Function *>::Type     worklist(get_allocator());
+
+    for (llvm::Function &f : libbsdf.functions()) {
+        // note: functions which are not materialized, yet, are no declarations
+        if (f.isDeclaration() || is_libbsdf_function_linked(f, linked_funcs)) {
+            continue;
+        }
+
+        bool needed;
+        IDefinition::Semantics sema = get_libbsdf_function_semantics(f.getName());
+        if (is_df_semantics(sema)) {
+            // DF API functions are only needed for DFs used by the distribution function
+            // which have not been linked, yet
+            needed = is_libbsdf_function_needed(f.getName(), sema, df_semantics) &&
+                (linked_semantics == NULL ||
+                    !is_libbsdf_function_needed(f.getName(), sema, *linked_semantics));
+        } else {
+            // all other functions (like the black DFs and the interpreter functions) are linked
+            // initially, later they are only linked, if referenced by new DF API functions
+            needed = linked_semantics == NULL;
+        }
+
+        if (needed) {
+            needed_funcs.insert(&f);
+            worklist.push_back(&f);
+        }
+    }
+
+    // materialize the needed functions and everything they reference
+    while (!worklist.empty()) {
+        llvm::Function *func = worklist.back();
+        worklist.pop_back();
+
+        if (llvm::Error err = func->materialize()) {
+            llvm::consumeError(std::move(err));
+            return false;
+        }
+
+        for (llvm::BasicBlock &bb : *func) {
+            for (llvm::Instruction &inst : bb) {
+                for (llvm::Value *op : inst.operands()) {
+                    llvm::Function *callee =
+                        llvm::dyn_cast<llvm::Function>(op->stripPointerCasts());
+                    if (callee != NULL &&
+                            !callee->isDeclaration() &&
+                            !is_libbsdf_function_linked(*callee, linked_funcs) &&
+                            needed_funcs.insert(callee).second) {
+                        worklist.push_back(callee);
+                    }
+                }
+            }
+        }
+    }
+
+    // drop all other function bodies without materializing them, the linker will not
+    // link unreferenced declarations and resolves the referenced declarations of already
+    // linked functions to the existing definitions
+    for (llvm::Function &f : libbsdf.functions()) {
+        if (!f.isDeclaration() && needed_funcs.count(&f) == 0) {
+            f.deleteBody();
+        }
+    }
+    return true;
+}
+
 // Load and link libbsdf into the current LLVM module.
-bool LLVM_code_generator::load_and_link_libbsdf(mdl::Df_handle_slot_mode hsm)
+bool LLVM_code_generator::load_and_link_libbsdf(
+    mdl::Df_handle_slot_mode hsm,
+    Df_semantics_set const   &df_semantics)
 {
+    // was libbsdf already linked into the current module?
+    bool is_initial_link = m_type_bsdf_sample_data == NULL;
+
+    if (!is_initial_link) {
+        bool missing_df = false;
+        for (IDefinition::Semantics sema : df_semantics) {
+            if (is_df_semantics(sema) && m_libbsdf_df_semantics.count(sema) == 0) {
+                missing_df = true;
+                break;
+            }
+        }
+        if (!missing_df) {
+            // all needed DF API functions are available
+            return true;
+        }
+    }
+
     std::unique_ptr<llvm::Module> libbsdf(load_libbsdf(m_llvm_context, hsm));
     MDL_ASSERT(libbsdf != NULL);
+    if (!libbsdf) {
+        return false;
+    }
+
+    if (!restrict_libbsdf(
+            *libbsdf,
+            df_semantics,
+            is_initial_link ? NULL : &m_libbsdf_df_semantics,
+            is_initial_link ? NULL : &m_libbsdf_linked_funcs)) {
+        error(PARSING_LIBBSDF_MODULE_FAILED, Error_params(get_allocator()));
+        MDL_ASSERT(!"Materializing libbsdf failed");
+        return false;
+    }
+    m_libbsdf_df_semantics.insert(df_semantics.begin(), df_semantics.end());
 
     // clear target triple to avoid LLVM warning on console about mixing different targets
     // when linking libbsdf ("x86_x64-pc-win32") with libdevice ("nvptx-unknown-unknown").
@@ -2252,6 +2443,21 @@ bool LLVM_code_generator::load_and_link_libbsdf(mdl::Df_handle_slot_mode hsm)
         }
     }
 
+    // the linker only resolves declarations to definitions with external linkage, so temporarily
+    // make the already linked libbsdf functions referenced by the new functions external again
+    vector<llvm::Function *>::Type relinked_funcs(get_allocator());
+    for (llvm::Function &f : libbsdf->functions()) {
+        if (!f.isDeclaration() || !is_libbsdf_function_linked(f, &m_libbsdf_linked_funcs)) {
+            continue;
+        }
+        llvm::Function *linked_func = m_module->getFunction(f.getName());
+        if (linked_func != NULL && !linked_func->isDeclaration() &&
+                linked_func->hasInternalLinkage()) {
+            linked_func->setLinkage(llvm::GlobalValue::ExternalLinkage);
+            relinked_funcs.push_back(linked_func);
+        }
+    }
+
     if (llvm::Linker::linkModules(*m_module, std::move(libbsdf))) {
         // true means linking has failed
         error(LINKING_LIBBSDF_FAILED, "unknown linker error");
@@ -2259,30 +2465,37 @@ bool LLVM_code_generator::load_and_link_libbsdf(mdl::Df_handle_slot_mode hsm)
         return false;
     }
 
-    m_float3_struct_type = llvm::StructType::getTypeByName(
-        m_llvm_context, "struct.float3");
-    if (m_float3_struct_type == NULL) {
-        // name was lost during linking? get it from
-        //    void @black_bsdf_sample(
-        //        %struct.BSDF_sample_data* nocapture %data,
-        //        %class.State* nocapture readnone %state,
-        //        %struct.float3* nocapture readnone %inherited_normal)
-
-        llvm::Function *func = m_module->getFunction("black_bsdf_sample");
-        MDL_ASSERT(func != NULL);
-        llvm::FunctionType *func_type = func->getFunctionType();
-        m_float3_struct_type = llvm::cast<llvm::StructType>(
-            func_type->getParamType(2)->getPointerElementType());
-        MDL_ASSERT(m_float3_struct_type != NULL);
+    for (llvm::Function *func : relinked_funcs) {
+        func->setLinkage(llvm::GlobalValue::InternalLinkage);
     }
 
+    // the data and function types are only initialized on the first link, later links reuse
+    // the already linked types
+    if (is_initial_link) {
+        m_float3_struct_type = llvm::StructType::getTypeByName(
+            m_llvm_context, "struct.float3");
+        if (m_float3_struct_type == NULL) {
+            // name was lost during linking? get it from
+            //    void @black_bsdf_sample(
+            //        %struct.BSDF_sample_data* nocapture %data,
+            //        %class.State* nocapture readnone %state,
+            //        %struct.float3* nocapture readnone %inherited_normal)
+
+            llvm::Function *func = m_module->getFunction("black_bsdf_sample");
+            MDL_ASSERT(func != NULL);
+            llvm::FunctionType *func_type = func->getFunctionType();
+            m_float3_struct_type = llvm::cast<llvm::StructType>(
+                func_type->getParamType(2)->getPointerElementType());
+            MDL_ASSERT(m_float3_struct_type != NULL);
+        }
 
-    create_bsdf_function_types();
-    create_edf_function_types();
+        create_bsdf_function_types();
+        create_edf_function_types();
 
-    // get the unique IDs for two metadata we will use
-    m_bsdf_param_metadata_id = m_llvm_context.getMDKindID("libbsdf.bsdf_param");
-    m_edf_param_metadata_id  = m_llvm_context.getMDKindID("libbsdf.edf_param");
+        // get the unique IDs for two metadata we will use
+        m_bsdf_param_metadata_id = m_llvm_context.getMDKindID("libbsdf.bsdf_param");
+        m_edf_param_metadata_id  = m_llvm_context.getMDKindID("libbsdf.edf_param");
+    }
 
     llvm::Type *int_type = m_type_mapper.get_int_type();
     unsigned alloca_addr_space = m_module->getDataLayout().getAllocaAddrSpace();
@@ -2290,16 +2503,17 @@ bool LLVM_code_generator::load_and_link_libbsdf(mdl::Df_handle_slot_mode hsm)
     // find all functions which were added by linking the libbsdf module,
     // collect in vector as module functions will be modified, later
     vector<llvm::Function *>::Type libbsdf_funcs(get_allocator());
+    vector<string>::Type libbsdf_func_names(get_allocator());
     for (llvm::Function &f : m_module->functions()) {
         // just a declaration or did already exist before linking? -> skip
-        if (f.isDeclaration() || old_func_names.count(
-                string(f.getName().begin(), f.getName().end(), get_allocator())) != 0)
-        {
+        string name(f.getName().begin(), f.getName().end(), get_allocator());
+        if (f.isDeclaration() || old_func_names.count(name) != 0) {
             continue;
         }
 
         // Found a libbsdf function
         libbsdf_funcs.push_back(&f);
+        libbsdf_func_names.push_back(name);
     }
 
     // iterate over all functions added from the libbsdf module
@@ -2639,6 +2853,15 @@ bool LLVM_code_generator::load_and_link_libbsdf(mdl::Df_handle_slot_mode hsm)
         }
     }
 
+    // remember the linked functions which are still available under their libbsdf name, i.e.
+    // all except the DF API functions which were replaced by "gen_" templates
+    for (string const &name : libbsdf_func_names) {
+        llvm::Function *func = m_module->getFunction(llvm::StringRef(name.c_str(), name.size()));
+        if (func != NULL && !func->isDeclaration()) {
+            m_libbsdf_linked_funcs.insert(name);
+        }
+    }
+
     return true;
 }
 
@@ -0,0 +1,245 @@
+/******************************************************************************
+ * Copyright (c) 2020-2024, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+/** \file
+ ** \brief
+ **/
+
+
+#include "pch.h"
+
+#define MI_TEST_AUTO_SUITE_NAME "Regression Test Suite for prod/lib/neuray"
+#define MI_TEST_IMPLEMENT_TEST_MAIN_INSTEAD_OF_MAIN
+
+#include <base/system/test/i_test_auto_driver.h>
+#include <base/system/test/i_test_auto_case.h>
+
+#include <mi/base/handle.h>
+
+#include <mi/neuraylib/imdl_configuration.h>
+#include <mi/neuraylib/imdl_discovery_api.h>
+#include <mi/neuraylib/ineuray.h>
+#include <mi/neuraylib/istring.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "test_shared.h"
+
+#define DIR_PREFIX "output_test_imdl_discovery_api"
+
+namespace fs = std::filesystem;
+
+// Replaces the search path prefix of \p path by the index of the search path, such that the
+// results for copies of the search paths can be compared.
+std::string relative_path( const std::string& path, const char* search_path, mi::Size index)
+{
+    std::string sp( search_path);
+    std::string result = path;
+    if( result.compare( 0, sp.size(), sp) == 0)
+        result = "<" + std::to_string( index) + ">" + result.substr( sp.size());
+    return result;
+}
+
+// Dumps the discovery graph below \p info.
+void dump( const mi::neuraylib::IMdl_info* info, std::ostream& s)
+{
+    s << info->get_kind() << " " << info->get_qualified_name() << " " << info->get_simple_name();
+
+    switch( info->get_kind()) {
+
+        case mi::neuraylib::IMdl_info::DK_PACKAGE:
+        case mi::neuraylib::IMdl_info::DK_DIRECTORY: {
+            mi::base::Handle<const mi::neuraylib::IMdl_package_info> package(
+                info->get_interface<mi::neuraylib::IMdl_package_info>());
+            for( mi::Size i = 0, n = package->get_search_path_index_count(); i < n; ++i) {
+                mi::base::Handle<const mi::IString> resolved_path(
+                    package->get_resolved_path( i));
+                s << " [" << package->get_search_path_index( i) << " "
+                  << relative_path( resolved_path->get_c_str(),
+                         package->get_search_path( i), package->get_search_path_index( i))
+                  << " " << package->in_archive( i) << "]";
+            }
+            s << "\n";
+            for( mi::Size i = 0, n = package->get_child_count(); i < n; ++i) {
+                mi::base::Handle<const mi::neuraylib::IMdl_info> child( package->get_child( i));
+                dump( child.get(), s);
+            }
+            break;
+        }
+
+        case mi::neuraylib::IMdl_info::DK_MODULE: {
+            mi::base::Handle<const mi::neuraylib::IMdl_module_info> module(
+                info->get_interface<mi::neuraylib::IMdl_module_info>());
+            mi::base::Handle<const mi::IString> resolved_path( module->get_resolved_path());
+            s << " " << module->get_search_path_index() << " "
+              << relative_path( resolved_path->get_c_str(),
+                     module->get_search_path(), module->get_search_path_index())
+              << " " << module->in_archive() << " " << module->get_shadows_count() << "\n";
+            for( mi::Size i = 0, n = module->get_shadows_count(); i < n; ++i) {
+                mi::base::Handle<const mi::neuraylib::IMdl_info> shadow( module->get_shadow( i));
+                dump( shadow.get(), s);
+            }
+            break;
+        }
+
+        default: {
+            mi::base::Handle<const mi::neuraylib::IMdl_resource_info> resource(
+                info->get_interface<mi::neuraylib::IMdl_resource_info>());
+            MI_CHECK( resource);
+            s << " " << resource->get_search_path_index() << " "
+              << relative_path( resource->get_resolved_path(),
+                     resource->get_search_path(), resource->get_search_path_index())
+              << " " << resource->in_archive() << " " << resource->get_shadows_count() << "\n";
+            break;
+        }
+    }
+}
+
+std::string discover( mi::neuraylib::IMdl_discovery_api* discovery_api)
+{
+    mi::base::Handle<const mi::neuraylib::IMdl_discovery_result> result(
+        discovery_api->discover());
+    MI_CHECK( result);
+    mi::base::Handle<const mi::neuraylib::IMdl_package_info> graph( result->get_graph());
+    MI_CHECK( graph);
+
+    std::ostringstream s;
+    dump( graph.get(), s);
+    return s.str();
+}
+
+void write_module( const std::string& filename)
+{
+    std::ofstream( fs::u8path( filename)) << "mdl 1.0;\nexport int f() { return 42; }\n";
+}
+
+// Sets the modification time of all directories below \p path (including \p path itself), such
+// that their listings are no longer considered to be racy.
+void set_directory_age( const std::string& path, int minutes)
+{
+    fs::file_time_type time = fs::file_time_type::clock::now() - std::chrono::minutes( minutes);
+    for( const auto& entry: fs::recursive_directory_iterator( fs::u8path( path)))
+        if( entry.is_directory())
+            fs::last_write_time( entry.path(), time);
+    fs::last_write_time( fs::u8path( path), time);
+}
+
+void set_mdl_paths(
+    mi::neuraylib::IMdl_configuration* mdl_configuration,
+    const std::string& sp1,
+    const std::string& sp2)
+{
+    mdl_configuration->clear_mdl_paths();
+    MI_CHECK_EQUAL( 0, mdl_configuration->add_mdl_path( sp1.c_str()));
+    MI_CHECK_EQUAL( 0, mdl_configuration->add_mdl_path( sp2.c_str()));
+}
+
+MI_TEST_AUTO_FUNCTION( test_imdl_discovery_api )
+{
+    mi::base::Handle<mi::neuraylib::INeuray> neuray( load_and_get_ineuray());
+    MI_CHECK( neuray.is_valid_interface());
+
+    {
+        MI_CHECK_EQUAL( 0, neuray->start());
+
+        mi::base::Handle<mi::neuraylib::IMdl_configuration> mdl_configuration(
+            neuray->get_api_component<mi::neuraylib::IMdl_configuration>());
+        mi::base::Handle<mi::neuraylib::IMdl_discovery_api> discovery_api(
+            neuray->get_api_component<mi::neuraylib::IMdl_discovery_api>());
+
+        // The first search path contains an archive that conflicts with a directory of the same
+        // name, both are skipped. The second search path contains the same archive without
+        // conflict. Directories with invalid names are reported as DK_DIRECTORY.
+        std::string archive = MI::TEST::mi_src_path( "prod/lib/neuray/test_archives.mdr");
+        std::string sp1 = fs::absolute( DIR_PREFIX "/sp1").lexically_normal().u8string();
+        std::string sp2 = fs::absolute( DIR_PREFIX "/sp2").lexically_normal().u8string();
+        fs::remove_all( DIR_PREFIX);
+        fs::create_directories( fs::u8path( sp1 + "/pkg/sub"));
+        fs::create_directories( fs::u8path( sp1 + "/test_archives"));
+        fs::create_directories( fs::u8path( sp1 + "/invalid name"));
+        fs::create_directories( fs::u8path( sp2 + "/pkg"));
+        fs::copy_file( fs::u8path( archive), fs::u8path( sp1 + "/test_archives.mdr"));
+        fs::copy_file( fs::u8path( archive), fs::u8path( sp2 + "/test_archives.mdr"));
+        write_module( sp1 + "/pkg/a.mdl");
+        write_module( sp1 + "/pkg/sub/b.mdl");
+        write_module( sp1 + "/test_archives/shadowed.mdl");
+        write_module( sp1 + "/invalid name/c.mdl");
+        write_module( sp2 + "/pkg/a.mdl");
+        set_directory_age( sp1, 60);
+        set_directory_age( sp2, 60);
+
+        set_mdl_paths( mdl_configuration.get(), sp1, sp2);
+
+        // cold and warm listing cache
+        std::string cold = discover( discovery_api.get());
+        std::string warm = discover( discovery_api.get());
+        MI_CHECK_EQUAL( cold, warm);
+        MI_CHECK( cold.find( "::pkg::sub::b") != std::string::npos);
+        MI_CHECK( cold.find( "::test_archives::shadowed") == std::string::npos);
+        MI_CHECK( cold.find( "::test_archives") != std::string::npos);
+
+        // modify a directory with a recent modification time and one with an old modification
+        // time, compare against the results for a copy of the search paths
+        write_module( sp1 + "/pkg/sub/d.mdl");
+        fs::create_directories( fs::u8path( sp1 + "/pkg/new"));
+        write_module( sp1 + "/pkg/new/e.mdl");
+        fs::remove( fs::u8path( sp2 + "/pkg/a.mdl"));
+        set_directory_age( sp2, 30);
+
+        std::string modified = discover( discovery_api.get());
+        MI_CHECK_NOT_EQUAL( cold, modified);
+        MI_CHECK( modified.find( "::pkg::sub::d") != std::string::npos);
+        MI_CHECK( modified.find( "::pkg::new::e") != std::string::npos);
+
+        std::string sp1_copy = fs::absolute( DIR_PREFIX "/sp1_copy").lexically_normal().u8string();
+        std::string sp2_copy = fs::absolute( DIR_PREFIX "/sp2_copy").lexically_normal().u8string();
+        fs::copy( fs::u8path( sp1), fs::u8path( sp1_copy), fs::copy_options::recursive);
+        fs::copy( fs::u8path( sp2), fs::u8path( sp2_copy), fs::copy_options::recursive);
+        set_mdl_paths( mdl_configuration.get(), sp1_copy, sp2_copy);
+        std::string copy = discover( discovery_api.get());
+        MI_CHECK_EQUAL( modified, copy);
+
+        // the original search paths are still cached
+        set_mdl_paths( mdl_configuration.get(), sp1, sp2);
+        MI_CHECK_EQUAL( modified, discover( discovery_api.get()));
+
+        mdl_configuration->clear_mdl_paths();
+    }
+
+    MI_CHECK_EQUAL( 0, neuray->shutdown());
+
+    neuray = 0;
+    MI_CHECK( unload());
+}
+
+MI_TEST_MAIN_CALLING_TEST_MAIN();
+
@@ -49,12 +49,14 @@
 #include <mdl/integration/mdlnr/i_mdlnr.h>
 #include <io/image/image/i_image.h>
 #include <io/image/image/i_image_mipmap.h>
+#include <io/image/image/i_image_pixel_conversion.h>
 #include <io/image/image/i_image_utilities.h>
 #include <io/scene/mdl_elements/i_mdl_elements_compiled_material.h>
 #include <io/scene/mdl_elements/i_mdl_elements_utilities.h>
 #include <io/scene/dbimage/i_dbimage.h>
 #include <io/scene/texture/i_texture.h>
 #include <render/mdl/backends/backends_backends.h>
+#include <render/mdl/backends/backends_target_code.h>
 #include <base/hal/time/i_time.h>
 
 
@@ -84,14 +86,22 @@ inline Vector3 from_polar(
 
 MI_FORCE_INLINE float radinv2(const unsigned int i/*, const unsigned int scramble = 0*/);
 
+MI_FORCE_INLINE float fractf(const float x)
+{
+    return x - floorf(x);
+}
+
 // ----------------------------------------------------------------------------
 // Baker_fragmented_job
 
 class Baker_fragmented_job : public DB::Fragmented_job
 {
 public:
+    /// Edge length of the square pixel blocks handled by one fragment.
+    static const mi::Uint32 s_block_size = 32;
+
     Baker_fragmented_job(
-        const mi::neuraylib::ITarget_code* target_code,
+        const BACKENDS::Target_code* target_code,
         mi::neuraylib::ICanvas* texture,
         mi::Uint32 samples,
         mi::Uint32 state_flags,
@@ -108,8 +118,9 @@ public:
     mi::Size get_fragment_count() { return m_num_fragments; }
 
 protected:
-    mi::base::Handle<const mi::neuraylib::ITarget_code> m_target_code;
+    mi::base::Handle<const BACKENDS::Target_code>       m_target_code;
     mi::base::Handle<mi::neuraylib::ICanvas>            m_texture;
+    mi::base::Handle<mi::neuraylib::ITile>              m_tile;
 
     mi::Uint32  m_tex_width;
     mi::Uint32  m_tex_height;
@@ -118,21 +129,28 @@ protected:
     bool        m_is_environment;
     mi::Float32 m_du;
     mi::Float32 m_dv;
+    mi::Uint32  m_num_blocks_x;
+    mi::Uint32  m_num_blocks_y;
     mi::Size    m_num_fragments;
-    mi::Size    m_num_rows_per_frag;
-    mi::Size    m_num_frags_with_extra_row;
+
+    /// Pixel type of m_tile.
+    IMAGE::Pixel_type m_pixel_type;
+
+    /// Per-sample sub-pixel offsets in x and y, shared by all pixels.
+    std::vector<mi::Float32_2> m_sample_offsets;
 
     std::atomic_uint32_t m_failure;
 };
 
 Baker_fragmented_job::Baker_fragmented_job(
-    const mi::neuraylib::ITarget_code* target_code,
+    const BACKENDS::Target_code* target_code,
     mi::neuraylib::ICanvas* texture,
     const mi::Uint32 samples,
     const mi::Uint32 state_flags,
     const bool is_environment)
     : m_target_code(target_code, mi::base::DUP_INTERFACE)
     , m_texture(texture, mi::base::DUP_INTERFACE)
+    , m_tile(texture->get_tile())
     , m_num_samples(samples)
     , m_state_flags(state_flags)
     , m_is_environment(is_environment)
@@ -144,9 +162,19 @@ Baker_fragmented_job::Baker_fragmented_job(
     m_du = (mi::Float32)(1.0 / (mi::Float64)m_tex_width);
     m_dv = (mi::Float32)(1.0 / (mi::Float64)m_tex_height);
 
-    m_num_fragments = m_tex_height;
-    m_num_rows_per_frag = m_tex_height / m_num_fragments;
-    m_num_frags_with_extra_row = m_tex_height - m_num_rows_per_frag * m_num_fragments;
+    m_num_blocks_x  = (m_tex_width  + s_block_size - 1) / s_block_size;
+    m_num_blocks_y  = (m_tex_height + s_block_size - 1) / s_block_size;
+    m_num_fragments = mi::Size(m_num_blocks_x) * m_num_blocks_y;
+
+    m_pixel_type = IMAGE::convert_pixel_type_string_to_enum(m_tile->get_type());
+
+    // The sample pattern does not depend on the pixel, compute it only once.
+    const float inv_spp = (float)(1.0 / (double)m_num_samples);
+    m_sample_offsets.resize(m_num_samples);
+    for (mi::Uint32 k = 0; k < m_num_samples; ++k) {
+        m_sample_offsets[k].x = fractf((float)k * inv_spp + 0.5f);
+        m_sample_offsets[k].y = fractf(radinv2(k) + 0.5f);
+    }
 }
 
 static mi::Float32_4_4 s_unity(1.0f);
@@ -199,86 +227,125 @@ static void prepare_cpu_state(
     }
 }
 
-MI_FORCE_INLINE float fractf(const float x)
-{
-    return x - floorf(x);
-}
-
 void Baker_fragmented_job::execute_fragment(
     DB::Transaction* transaction,
     size_t           index,
     size_t           count,
     const mi::neuraylib::IJob_execution_context* context)
 {
-    mi::Uint32 start_row = mi::Uint32(
-        index * m_num_rows_per_frag +
-        ((index < m_num_frags_with_extra_row) ? index : m_num_frags_with_extra_row));
-
-    mi::Uint32 end_row = mi::Uint32(
-        start_row + m_num_rows_per_frag - 1 +
-        ((index < m_num_frags_with_extra_row) ? 1 : 0));
-
-    mi::Uint32 start_col = 0;
-    mi::Uint32 end_col   = m_tex_width - 1;
-
-    union {
-        mi::neuraylib::Shading_state_environment state_env;
-        mi::neuraylib::Shading_state_material state;
-    };
-
-    mi::Float32_3 tex_coords;
+    const mi::Uint32 start_col = mi::Uint32(index % m_num_blocks_x) * s_block_size;
+    const mi::Uint32 start_row = mi::Uint32(index / m_num_blocks_x) * s_block_size;
+    const mi::Uint32 width     = std::min(s_block_size, m_tex_width  - start_col);
+    const mi::Uint32 height    = std::min(s_block_size, m_tex_height - start_row);
+
+    // The states of one row of the block are evaluated with one call per sample.
+    mi::neuraylib::Shading_state_environment states_env[s_block_size];
+    mi::neuraylib::Shading_state_material    states[s_block_size];
+    mi::Float32_3 tex_coords[s_block_size];
     mi::Float32_3 tangent_u;
     mi::Float32_3 tangent_v;
-    prepare_cpu_state(
-        state_env, state, tex_coords, tangent_u, tangent_v, m_state_flags, m_is_environment);
+    for (mi::Uint32 j = 0; j < width; j++)
+        prepare_cpu_state(
+            states_env[j], states[j], tex_coords[j], tangent_u, tangent_v,
+            m_state_flags, m_is_environment);
 
-    mi::base::Handle<mi::neuraylib::ITile> tile(m_texture->get_tile());
+    // Accumulate all samples of the block in RGBA, such that the result can be converted into
+    // the pixel type of the tile with one call per block instead of one set_pixel() per pixel.
+    mi::Float32_4 block[s_block_size * s_block_size];
+    mi::Float32_4 results[s_block_size];
 
-    const float inv_spp = (float)(1.0 / (double)m_num_samples);
-    for (mi::Uint32 i = start_row; i <= end_row; i++)
+    for (mi::Uint32 i = 0; i < height; i++)
     {
-        for (mi::Uint32 j = start_col; j <= end_col; j++)
-        {
-            mi::Float32_3 pixel(0.0f);
-            mi::Float32_3 pixel_data = pixel;
+        const mi::Float32 y0 = (float)(start_row + i);
+
+        mi::Float32_4* row = &block[i * width];
+        for (mi::Uint32 j = 0; j < width; j++)
+            row[j] = mi::Float32_4(0.0f, 0.0f, 0.0f, 1.0f);
 
-            for (mi::Uint32 k = 0; k < m_num_samples; k++) {
+        for (mi::Uint32 k = 0; k < m_num_samples; k++) {
 
-                const mi::Float32 y = ((float)i + fractf(radinv2(k) + 0.5f)) * m_dv;
-                const mi::Float32 x = ((float)j + fractf((float)k * inv_spp + 0.5f)) * m_du;
+            const mi::Float32 y = (y0 + m_sample_offsets[k].y) * m_dv;
 
-                if (m_is_environment) {
+            if (m_is_environment) {
+                for (mi::Uint32 j = 0; j < width; j++) {
+                    const mi::Float32 x = ((float)(start_col + j) + m_sample_offsets[k].x) * m_du;
                     const float phi = x * (float)(2.0 * M_PI);
                     const float theta = y * (float)(M_PI);
-                    state_env.direction = from_polar(Vector2(theta, phi));
+                    states_env[j].direction = from_polar(Vector2(theta, phi));
+                }
 
-                    if (m_target_code->execute_environment(
-                            0, state_env, nullptr, (mi::Spectrum_struct*)&pixel.x) != 0) {
-                        m_failure = 1;
-                        return;
-                    }
-                } else {
+                mi::Spectrum_struct env_results[s_block_size];
+                if (m_target_code->execute_environment_batch(
+                        0, width, states_env, nullptr, env_results) != 0) {
+                    m_failure = 1;
+                    return;
+                }
+                for (mi::Uint32 j = 0; j < width; j++)
+                    results[j] = mi::Float32_4(
+                        env_results[j].c[0], env_results[j].c[1], env_results[j].c[2], 1.0f);
+            } else {
+                for (mi::Uint32 j = 0; j < width; j++) {
+                    const mi::Float32 x = ((float)(start_col + j) + m_sample_offsets[k].x) * m_du;
                     if (m_state_flags & BAKER_STATE_POSITION_DIRECTION) {
                         const float phi = x * (float)(2.0 * M_PI);
                         const float theta = y * (float)(M_PI);
-                        state.position = from_polar(Vector2(theta, phi));
+                        states[j].position = from_polar(Vector2(theta, phi));
                     } else {
-                        state.position = mi::Float32_3(x, y, 0.0f);
-                        tex_coords = mi::Float32_3(x, y, 0.0f);
+                        states[j].position = mi::Float32_3(x, y, 0.0f);
+                        tex_coords[j] = mi::Float32_3(x, y, 0.0f);
                     }
+                }
 
-                    if (m_target_code->execute(
-                            0, state, nullptr, nullptr, (mi::Float32*)&pixel.x) != 0) {
-                        m_failure = 1;
-                        return;
-                    }
+                if (m_target_code->execute_batch(
+                        0, width, states, nullptr, nullptr,
+                        results, sizeof(mi::Float32_4)) != 0) {
+                    m_failure = 1;
+                    return;
                 }
-                pixel_data += pixel;
             }
-            pixel_data /= m_num_samples;
-            tile->set_pixel(j, i, (mi::Float32*)&pixel_data.x);
+
+            for (mi::Uint32 j = 0; j < width; j++) {
+                row[j].x += results[j].x;
+                row[j].y += results[j].y;
+                row[j].z += results[j].z;
+            }
+        }
+
+        const mi::Float32 inv_num_samples = 1.0f / (mi::Float32)m_num_samples;
+        for (mi::Uint32 j = 0; j < width; j++) {
+            row[j].x *= inv_num_samples;
+            row[j].y *= inv_num_samples;
+            row[j].z *= inv_num_samples;
         }
     }
+
+    // Single-channel float results are stored in x only. Copy them as they are, a conversion
+    // from PT_COLOR would store their luminance instead.
+    if (m_pixel_type == IMAGE::PT_FLOAT32) {
+        mi::Float32* dest = static_cast<mi::Float32*>(m_tile->get_data())
+            + mi::Size(start_row) * m_tex_width + start_col;
+        for (mi::Uint32 i = 0; i < height; i++, dest += m_tex_width)
+            for (mi::Uint32 j = 0; j < width; j++)
+                dest[j] = block[i * width + j].x;
+        return;
+    }
+
+    // Write the block directly into the raw tile data if possible.
+    if (m_pixel_type != IMAGE::PT_UNDEF) {
+        const mi::Uint32 bpp = IMAGE::get_bytes_per_pixel(m_pixel_type);
+        char* dest = static_cast<char*>(m_tile->get_data())
+            + (mi::Size(start_row) * m_tex_width + start_col) * bpp;
+        IMAGE::convert(
+            &block[0].x, dest, IMAGE::PT_COLOR, m_pixel_type,
+            width, height,
+            mi::Difference(width * sizeof(mi::Float32_4)),
+            mi::Difference(mi::Size(m_tex_width) * bpp));
+        return;
+    }
+
+    for (mi::Uint32 i = 0; i < height; i++)
+        for (mi::Uint32 j = 0; j < width; j++)
+            m_tile->set_pixel(start_col + j, start_row + i, &block[i * width + j].x);
 }
 
 
@@ -709,8 +776,11 @@ mi::Sint32 Baker_module_impl::bake_texture(
 
     if (cpu_code) {
         const bool is_env = static_cast<Baker_code_impl const *>(baker_code)->is_environment();
-        Baker_fragmented_job job(cpu_code.get(), texture, samples, state_flags, is_env);
-        transaction->execute_fragmented(&job, texture->get_resolution_y());
+        // The CPU code is always created by the native backend, see create_baker_code_internal().
+        Baker_fragmented_job job(
+            static_cast<const BACKENDS::Target_code*>(cpu_code.get()),
+            texture, samples, state_flags, is_env);
+        transaction->execute_fragmented(&job, job.get_fragment_count());
         if (job.successful()) {
             // success
             return 0;
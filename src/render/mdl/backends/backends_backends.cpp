@@ -2138,6 +2138,136 @@ mi::Sint32 Target_value_layout::set_value(
     return -5;
 }
 
+// Flattens the argument / element at the given layout state into its atomic elements.
+mi::Size Target_value_layout::get_patch_plan(
+    mi::neuraylib::Target_value_layout_patch *patches,
+    mi::Size                                 max_patches,
+    mi::neuraylib::Target_value_layout_state state) const
+{
+    if (patches == NULL)
+        max_patches = 0;
+
+    mi::Size count = 0;
+    if (!collect_patches(patches, max_patches, count, state))
+        return ~mi::Size(0);
+    return count;
+}
+
+// Collect the atomic elements of the argument / element at the given layout state.
+bool Target_value_layout::collect_patches(
+    mi::neuraylib::Target_value_layout_patch *patches,
+    mi::Size                                 max_patches,
+    mi::Size                                 &count,
+    mi::neuraylib::Target_value_layout_state state) const
+{
+    mi::neuraylib::IValue::Kind kind;
+    mi::Size arg_size = 0;
+    mi::Size offs = get_layout(kind, arg_size, state);
+    if (offs == ~mi::Size(0))
+        return false;
+
+    switch (kind) {
+        case mi::neuraylib::IValue::VK_VECTOR:
+        case mi::neuraylib::IValue::VK_MATRIX:
+        case mi::neuraylib::IValue::VK_ARRAY:
+        case mi::neuraylib::IValue::VK_COLOR:
+        case mi::neuraylib::IValue::VK_STRUCT:
+        {
+            for (mi::Size i = 0, num = get_num_elements(state); i < num; ++i) {
+                if (!collect_patches(patches, max_patches, count, get_nested_state(i, state)))
+                    return false;
+            }
+            return true;
+        }
+
+        case mi::neuraylib::IValue::VK_INVALID_DF:
+        case mi::neuraylib::IValue::VK_FORCE_32_BIT:
+            return false;
+
+        default:
+            if (count < max_patches) {
+                mi::neuraylib::Target_value_layout_patch &patch = patches[count];
+                patch.m_offset = mi::Uint32(offs);
+                patch.m_size   = mi::Uint32(arg_size);
+                patch.m_kind   = kind;
+            }
+            ++count;
+            return true;
+    }
+}
+
+// Check that all patches of a patch plan lie inside a block of the given size.
+bool Target_value_layout::patches_fit(
+    mi::neuraylib::Target_value_layout_patch const *patches,
+    mi::Size                                       num_patches,
+    mi::Size                                       block_size)
+{
+    for (mi::Size i = 0; i < num_patches; ++i) {
+        if (mi::Size(patches[i].m_offset) + patches[i].m_size > block_size)
+            return false;
+    }
+    return true;
+}
+
+// Applies a patch plan to several argument blocks.
+mi::Sint32 Target_value_layout::set_values(
+    mi::neuraylib::ITarget_argument_block * const  *blocks,
+    mi::Size                                       num_blocks,
+    mi::neuraylib::Target_value_layout_patch const *patches,
+    mi::Size                                       num_patches,
+    void const                                     *data,
+    mi::Size                                       data_stride) const
+{
+    if (blocks == NULL || patches == NULL || data == NULL)
+        return -1;
+
+    char const *src = static_cast<char const *>(data);
+    for (mi::Size i = 0; i < num_blocks; ++i, src += data_stride) {
+        mi::neuraylib::ITarget_argument_block *block = blocks[i];
+        if (block == NULL)
+            return -1;
+        if (!patches_fit(patches, num_patches, block->get_size()))
+            return -2;
+
+        char       *dst = block->get_data();
+        char const *p   = src;
+        for (mi::Size j = 0; j < num_patches; ++j) {
+            memcpy(dst + patches[j].m_offset, p, patches[j].m_size);
+            p += patches[j].m_size;
+        }
+    }
+    return 0;
+}
+
+// Gathers the values of a patch plan from several argument blocks into a contiguous
+// structure-of-arrays buffer.
+mi::Sint32 Target_value_layout::get_values_soa(
+    mi::neuraylib::ITarget_argument_block const * const *blocks,
+    mi::Size                                            num_blocks,
+    mi::neuraylib::Target_value_layout_patch const      *patches,
+    mi::Size                                            num_patches,
+    void                                                *buffer) const
+{
+    if (blocks == NULL || patches == NULL || buffer == NULL)
+        return -1;
+
+    for (mi::Size i = 0; i < num_blocks; ++i) {
+        if (blocks[i] == NULL)
+            return -1;
+        if (!patches_fit(patches, num_patches, blocks[i]->get_size()))
+            return -2;
+    }
+
+    char *dst = static_cast<char *>(buffer);
+    for (mi::Size j = 0; j < num_patches; ++j) {
+        mi::Uint32 offs = patches[j].m_offset;
+        mi::Uint32 size = patches[j].m_size;
+        for (mi::Size i = 0; i < num_blocks; ++i, dst += size)
+            memcpy(dst, blocks[i]->get_data() + offs, size);
+    }
+    return 0;
+}
+
 // Set the value inside the given block at the given layout state.
 mi::Sint32 Target_value_layout::set_value(
     char                                     *block,
@@ -3315,7 +3445,8 @@ Mdl_llvm_backend::Mdl_llvm_backend(
     m_output_target_lang(true),
     m_strings_mapped_to_ids(string_ids),
     m_calc_derivatives(false),
-    m_use_builtin_resource_handler(true)
+    m_use_builtin_resource_handler(true),
+    m_texture_filter(MDLRT::TEXTURE_FILTER_BIQUINTIC)
 {
     mi::mdl::Options &options = m_jit->access_options();
 
@@ -3653,6 +3784,21 @@ mi::Sint32 Mdl_llvm_backend::set_option(
         return 0;
     }
 
+    if (strcmp(name, "opt_partitions") == 0) {
+        // only supported for CUDA_PTX, LLVM_IR and NATIVE
+        if (m_kind != mi::neuraylib::IMdl_backend_api::MB_CUDA_PTX &&
+                m_kind != mi::neuraylib::IMdl_backend_api::MB_LLVM_IR &&
+                m_kind != mi::neuraylib::IMdl_backend_api::MB_NATIVE)
+            return -1;
+
+        unsigned v = 0;
+        if (sscanf(value, "%u", &v) != 1 || v == 0) {
+            return -2;
+        }
+        jit_options.set_option(MDL_JIT_OPTION_OPT_PARTITIONS, value);
+        return 0;
+    }
+
     // specific options
     switch (m_kind) {
     case mi::neuraylib::IMdl_backend_api::MB_CUDA_PTX:
@@ -3894,6 +4040,18 @@ mi::Sint32 Mdl_llvm_backend::set_option(
             jit_options.set_option(MDL_JIT_USE_BUILTIN_RESOURCE_HANDLER_CPU, value);
             return 0;
         }
+        if (strcmp(name, "texture_runtime_filter") == 0) {
+            if (strcmp(value, "nearest") == 0) {
+                m_texture_filter = MDLRT::TEXTURE_FILTER_NEAREST;
+            } else if (strcmp(value, "bilinear") == 0) {
+                m_texture_filter = MDLRT::TEXTURE_FILTER_BILINEAR;
+            } else if (strcmp(value, "biquintic") == 0) {
+                m_texture_filter = MDLRT::TEXTURE_FILTER_BIQUINTIC;
+            } else {
+                return -2;
+            }
+            return 0;
+        }
         break;
 
     case mi::neuraylib::IMdl_backend_api::MB_HLSL:
@@ -4059,6 +4217,7 @@ mi::neuraylib::ITarget_code const *Mdl_llvm_backend::translate_environment(
     case mi::neuraylib::IMdl_backend_api::MB_NATIVE:
         code = mi::base::make_handle(
             m_jit->compile_into_environment(
+                m_code_cache.get(),
                 lambda.get(),
                 &module_cache,
                 &resolver,
@@ -4088,6 +4247,7 @@ mi::neuraylib::ITarget_code const *Mdl_llvm_backend::translate_environment(
         m_strings_mapped_to_ids,
         m_calc_derivatives,
         m_use_builtin_resource_handler,
+        m_texture_filter,
         m_kind);
 
     // Enter the resource-table here
@@ -4203,6 +4363,7 @@ mi::neuraylib::ITarget_code const *Mdl_llvm_backend::translate_material_expressi
     case mi::neuraylib::IMdl_backend_api::MB_NATIVE:
         code = mi::base::make_handle(
             m_jit->compile_into_generic_function(
+                m_code_cache.get(),
                 lambda.get(),
                 &module_cache,
                 &resolver,
@@ -4235,6 +4396,7 @@ mi::neuraylib::ITarget_code const *Mdl_llvm_backend::translate_material_expressi
         m_strings_mapped_to_ids,
         m_calc_derivatives,
         m_use_builtin_resource_handler,
+        m_texture_filter,
         m_kind);
 
     // Enter the resource-table here
@@ -4396,6 +4558,7 @@ const mi::neuraylib::ITarget_code* Mdl_llvm_backend::translate_material_df(
         m_strings_mapped_to_ids,
         m_calc_derivatives,
         m_use_builtin_resource_handler,
+        m_texture_filter,
         m_kind);
 
     // Enter the resource-table here
@@ -4477,6 +4640,7 @@ mi::neuraylib::ITarget_code const *Mdl_llvm_backend::translate_link_unit(
 #endif
 
     mi::base::Handle<mi::mdl::IGenerated_code_executable> code(m_jit->compile_unit(
+        m_code_cache.get(),
         cg_ctx.get(),
         &module_cache,
         mi::base::make_handle(lu->get_compilation_unit()).get(),
@@ -4501,7 +4665,7 @@ mi::neuraylib::ITarget_code const *Mdl_llvm_backend::translate_link_unit(
 #endif
 
     mi::base::Handle<Target_code> tc(lu->get_target_code());
-    tc->finalize(code.get(), lu->get_transaction(), m_calc_derivatives);
+    tc->finalize(code.get(), lu->get_transaction(), m_calc_derivatives, m_texture_filter);
 
 #ifdef ADD_EXTRA_TIMERS
     std::chrono::steady_clock::time_point t3 = std::chrono::steady_clock::now();
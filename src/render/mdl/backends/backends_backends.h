@@ -45,6 +45,7 @@
 #include <mi/neuraylib/itile.h>
 
 #include <io/scene/dbimage/i_dbimage.h>
+#include <render/mdl/runtime/i_mdlrt_resource_handler.h>
 
 namespace mi {
 namespace mdl { class IType_struct; class IType; class Code_genenator_thread_context; }
@@ -222,6 +223,9 @@ private:
 
     /// If true, use the builtin resource handler when running native code
     bool m_use_builtin_resource_handler;
+
+    /// The filter used by the builtin resource handler for 2D textures.
+    MDLRT::Texture_filter m_texture_filter;
 };
 
 /// Implementation of #mi::neuraylib::ITarget_argument_block.
@@ -292,10 +296,10 @@ public:
     virtual mi::Uint32 get_string_index(MI::MDL::IValue_string const *s) = 0;
 };
 
-/// Implementation of #mi::neuraylib::ITarget_value_layout.
+/// Implementation of #mi::neuraylib::ITarget_value_layout2.
 /// Wraps an mi::mdl::IGenerated_code_value_layout.
 class Target_value_layout : public
-    mi::base::Interface_implement<mi::neuraylib::ITarget_value_layout>
+    mi::base::Interface_implement<mi::neuraylib::ITarget_value_layout2>
 {
 public:
     /// Constructor.
@@ -370,6 +374,56 @@ public:
         mi::neuraylib::Target_value_layout_state state =
             mi::neuraylib::Target_value_layout_state()) const override;
 
+    /// Flattens the argument / element at the given layout state into its atomic elements.
+    ///
+    /// \param[out] patches      Receives up to \p max_patches atomic elements.
+    /// \param      max_patches  The number of entries available in \p patches.
+    /// \param      state        The layout state representing the current nesting within the
+    ///                          argument value block. The default value is used for the
+    ///                          top-level.
+    ///
+    /// \returns the number of atomic elements or ~0 if the state is invalid.
+    mi::Size get_patch_plan(
+        mi::neuraylib::Target_value_layout_patch *patches,
+        mi::Size max_patches,
+        mi::neuraylib::Target_value_layout_state state =
+            mi::neuraylib::Target_value_layout_state()) const override;
+
+    /// Applies a patch plan to several argument blocks.
+    ///
+    /// \param[inout] blocks       The argument blocks to be modified.
+    /// \param num_blocks          The number of argument blocks.
+    /// \param patches             The patch plan.
+    /// \param num_patches         The number of entries in \p patches.
+    /// \param data                The raw values, tightly packed in patch order per block.
+    /// \param data_stride         The distance in bytes between the values of two blocks.
+    ///
+    /// \return 0 on success, -1 on invalid parameters, -2 if a patch lies outside of a block.
+    mi::Sint32 set_values(
+        mi::neuraylib::ITarget_argument_block * const *blocks,
+        mi::Size num_blocks,
+        mi::neuraylib::Target_value_layout_patch const *patches,
+        mi::Size num_patches,
+        void const *data,
+        mi::Size data_stride) const override;
+
+    /// Gathers the values of a patch plan from several argument blocks into a contiguous
+    /// structure-of-arrays buffer.
+    ///
+    /// \param blocks              The argument blocks to read.
+    /// \param num_blocks          The number of argument blocks.
+    /// \param patches             The patch plan.
+    /// \param num_patches         The number of entries in \p patches.
+    /// \param[out] buffer         The buffer receiving the values.
+    ///
+    /// \return 0 on success, -1 on invalid parameters, -2 if a patch lies outside of a block.
+    mi::Sint32 get_values_soa(
+        mi::neuraylib::ITarget_argument_block const * const *blocks,
+        mi::Size num_blocks,
+        mi::neuraylib::Target_value_layout_patch const *patches,
+        mi::Size num_patches,
+        void *buffer) const override;
+
     // Non-API methods
 
     /// Set the value inside the given block at the given layout state.
@@ -405,6 +459,31 @@ public:
     /// If true, string argument values are mapped to string identifiers.
     bool strings_mapped_to_ids() const { return m_strings_mapped_to_ids; }
 
+private:
+    /// Collect the atomic elements of the argument / element at the given layout state.
+    ///
+    /// \param[out] patches      Receives up to \p max_patches atomic elements.
+    /// \param      max_patches  The number of entries available in \p patches.
+    /// \param[inout] count      The number of atomic elements found so far.
+    /// \param      state        The layout state.
+    ///
+    /// \returns false if the state is invalid.
+    bool collect_patches(
+        mi::neuraylib::Target_value_layout_patch *patches,
+        mi::Size max_patches,
+        mi::Size &count,
+        mi::neuraylib::Target_value_layout_state state) const;
+
+    /// Check that all patches of a patch plan lie inside a block of the given size.
+    ///
+    /// \param patches      The patch plan.
+    /// \param num_patches  The number of entries in \p patches.
+    /// \param block_size   The size of the argument block.
+    static bool patches_fit(
+        mi::neuraylib::Target_value_layout_patch const *patches,
+        mi::Size num_patches,
+        mi::Size block_size);
+
 private:
     /// The MDL argument block.
     mi::base::Handle<mi::mdl::IGenerated_code_value_layout const> m_layout;
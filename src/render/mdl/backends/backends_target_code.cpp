@@ -140,13 +140,14 @@ Target_code::Target_code(
     bool string_ids,
     bool use_derivatives,
     bool use_builtin_resource_handler,
+    MDLRT::Texture_filter texture_filter,
     mi::neuraylib::IMdl_backend_api::Mdl_backend_kind be_kind)
   : Target_code()
 {
     m_backend_kind = be_kind;
     m_string_args_mapped_to_ids = string_ids;
     m_use_builtin_resource_handler = use_builtin_resource_handler;
-    finalize(code, transaction, use_derivatives);
+    finalize(code, transaction, use_derivatives, texture_filter);
 
     size_t num_layouts = code->get_captured_argument_layouts_count();
     m_cap_arg_blocks.resize(num_layouts); // already prepare the empty argument block slots
@@ -185,7 +186,8 @@ Target_code::~Target_code()
 void Target_code::finalize(
     mi::mdl::IGenerated_code_executable* code,
     DB::Transaction* transaction,
-    bool use_derivatives)
+    bool use_derivatives,
+    MDLRT::Texture_filter texture_filter)
 {
     m_native_code = mi::base::make_handle(
         code->get_interface<mi::mdl::IGenerated_code_lambda_function>());
@@ -193,7 +195,7 @@ void Target_code::finalize(
 
     if (m_native_code.is_valid_interface()) {
         if(m_use_builtin_resource_handler)
-            m_rh = new MDLRT::Resource_handler(use_derivatives);
+            m_rh = new MDLRT::Resource_handler(use_derivatives, texture_filter);
 
         m_native_code->init(transaction, NULL, m_rh);
     } else {
@@ -686,6 +688,68 @@ mi::Sint32 Target_code::execute_environment(
         tex_handler) ? 0 : -1;
 }
 
+mi::Sint32 Target_code::execute_batch(
+    mi::Size index,
+    mi::Size count,
+    const mi::neuraylib::Shading_state_material* states,
+    mi::neuraylib::Texture_handler_base* tex_handler,
+    const mi::neuraylib::ITarget_argument_block *cap_args,
+    void* results,
+    mi::Size result_size) const
+{
+    if (!m_native_code.is_valid_interface()) return -2;
+    if (index >= m_callable_function_infos.size()) return -2;
+    if (m_callable_function_infos[index].m_dist_kind != mi::neuraylib::ITarget_code::DK_NONE)
+        return -2;
+    if (m_callable_function_infos[index].m_kind != mi::neuraylib::ITarget_code::FK_LAMBDA)
+        return -2;
+
+    const char *args_data = NULL;
+    if (cap_args != NULL)
+        args_data = cap_args->get_data();
+    else
+    {
+        mi::Size block_index = get_callable_function_argument_block_index(index);
+        if (block_index != mi::Size(~0) &&
+            block_index < m_cap_arg_blocks.size() &&
+            m_cap_arg_blocks[block_index])
+        {
+            args_data = m_cap_arg_blocks[block_index]->get_data();
+        }
+    }
+
+    return m_native_code->run_generic_batch(
+        index,
+        count,
+        results,
+        result_size,
+        // ugly cast necessary because the C++ I/F cannot handle the layout options
+        reinterpret_cast<const mi::mdl::Shading_state_material*>(states),
+        tex_handler,
+        args_data) ? 0 : -1;
+}
+
+mi::Sint32 Target_code::execute_environment_batch(
+    mi::Size index,
+    mi::Size count,
+    const mi::neuraylib::Shading_state_environment* states,
+    mi::neuraylib::Texture_handler_base* tex_handler,
+    mi::Spectrum_struct* results) const
+{
+    if (!m_native_code.is_valid_interface()) return -2;
+    if (index >= m_callable_function_infos.size()) return -2;
+    if (m_callable_function_infos[index].m_kind != FK_ENVIRONMENT) return -2;
+
+    return m_native_code->run_environment_batch(
+        index,
+        count,
+        // ugly cast necessary because the libmdl I/F uses RGB_color*
+        reinterpret_cast<mi::mdl::RGB_color*>(results),
+        // ugly cast necessary because the C++ I/F cannot handle the layout options
+        reinterpret_cast<const mi::mdl::Shading_state_environment*>(states),
+        tex_handler) ? 0 : -1;
+}
+
 mi::Sint32 Target_code::execute_bsdf_init(
     mi::Size index,
     mi::neuraylib::Shading_state_material& state,
@@ -44,6 +44,7 @@
 #include <mi/neuraylib/imdl_backend.h>
 #include <mi/neuraylib/imdl_backend_api.h>
 #include <io/scene/mdl_elements/i_mdl_elements_compiled_material.h>
+#include <render/mdl/runtime/i_mdlrt_resource_handler.h>
 
 namespace mi { namespace mdl {
 class IGenerated_code_executable;
@@ -59,7 +60,6 @@ namespace MI {
 namespace SERIAL { class Buffer_serializer; }
 namespace DB { class Transaction; }
 namespace NEURAY { class Mdl_llvm_backend; }
-namespace MDLRT { class Resource_handler; }
 
 namespace BACKENDS {
 
@@ -147,6 +147,7 @@ public:
     /// \param use_derivatives  True if derivative support is enabled for the generated code
     /// \param use_builtin_resource_handler True, if the builtin texture runtime is supposed to be
     ///                         used when running x86 code.
+    /// \param texture_filter   The filter used by the builtin texture runtime for 2D textures.
     /// \param be_kind     Kind of back-end that created this target code object.
     Target_code(
         mi::mdl::IGenerated_code_executable* code,
@@ -154,6 +155,7 @@ public:
         bool string_ids,
         bool use_derivatives,
         bool use_builtin_resource_handler,
+        MDLRT::Texture_filter texture_filter,
         mi::neuraylib::IMdl_backend_api::Mdl_backend_kind be_kind);
 
     /// Constructor for link mode.
@@ -168,7 +170,8 @@ public:
     /// Finalization method for link mode for executable code.
     void finalize( mi::mdl::IGenerated_code_executable* code,
         MI::DB::Transaction* transaction,
-        bool use_derivatives);
+        bool use_derivatives,
+        MDLRT::Texture_filter texture_filter);
 
     // API methods
 
@@ -567,6 +570,59 @@ public:
         const mi::neuraylib::ITarget_argument_block *cap_args,
         void* result) const override;
 
+    /// Run this code on the native CPU for several states in a row.
+    ///
+    /// Has the same effect as calling #execute() for each state, but validates the arguments
+    /// and enters the generated code only once.
+    ///
+    /// \param[in]  index       The index of the callable function.
+    /// \param[in]  count       The number of states.
+    /// \param[in]  states      An array of \p count core states.
+    /// \param[in]  tex_handler Texture handler containing the vtable for the user-defined
+    ///                         texture lookup functions. Can be NULL if the built-in resource
+    ///                         handler is used.
+    /// \param[in]  cap_args    The captured arguments to use for the execution.
+    ///                         If \p cap_args is \c NULL, the captured arguments of this
+    ///                         \c ITarget_code object will be used, if any.
+    /// \param[out] results     The results will be written to, one every \p result_size bytes.
+    /// \param      result_size The distance between two results in bytes.
+    ///
+    /// \returns
+    ///    - 0  on success
+    ///    - -1 if execution was aborted by runtime error
+    ///    - -2 cannot execute: not native code or the given index does not refer to
+    ///         a material expression
+    mi::Sint32 execute_batch(
+        mi::Size index,
+        mi::Size count,
+        const mi::neuraylib::Shading_state_material* states,
+        mi::neuraylib::Texture_handler_base* tex_handler,
+        const mi::neuraylib::ITarget_argument_block *cap_args,
+        void* results,
+        mi::Size result_size) const;
+
+    /// Run this code on the native CPU for several environment states in a row.
+    ///
+    /// \param[in]  index       The index of the callable function.
+    /// \param[in]  count       The number of states.
+    /// \param[in]  states      An array of \p count environment states.
+    /// \param[in]  tex_handler Texture handler containing the vtable for the user-defined
+    ///                         texture lookup functions. Can be NULL if the built-in resource
+    ///                         handler is used.
+    /// \param[out] results     An array of \p count results.
+    ///
+    /// \returns
+    ///    - 0  on success
+    ///    - -1 if execution was aborted by runtime error
+    ///    - -2 cannot execute: not native code or the given index does not
+    ///         refer to an environment function.
+    mi::Sint32 execute_environment_batch(
+        mi::Size index,
+        mi::Size count,
+        const mi::neuraylib::Shading_state_environment* states,
+        mi::neuraylib::Texture_handler_base* tex_handler,
+        mi::Spectrum_struct* results) const;
+
     /// Run the BSDF init function for this code on the native CPU.
     ///
     /// \param[in]  index       The index of the callable function.
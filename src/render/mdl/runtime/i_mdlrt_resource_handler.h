@@ -39,6 +39,13 @@
 namespace MI {
 namespace MDLRT {
 
+/// The filter used by the builtin texture runtime for lookups in 2D textures.
+enum Texture_filter {
+    TEXTURE_FILTER_NEAREST,   ///< Nearest texel, nearest mipmap level with derivatives.
+    TEXTURE_FILTER_BILINEAR,  ///< Bilinear interpolation, trilinear with derivatives.
+    TEXTURE_FILTER_BIQUINTIC  ///< Bilinear interpolation with smootherstep weights (default).
+};
+
 /** \brief Resource handler helper.
 
  See \c mi::mdl::IResource_handler.
@@ -48,8 +55,12 @@ public:
     /// Constructor.
     ///
     /// \param use_derivatives  true if derivative texturing functions will be used
-    Resource_handler(bool use_derivatives=false)
+    /// \param filter           the filter used for lookups in 2D textures
+    Resource_handler(
+        bool use_derivatives=false,
+        Texture_filter filter=TEXTURE_FILTER_BIQUINTIC)
         : m_use_derivatives(use_derivatives)
+        , m_filter(filter)
     {
     }
 
@@ -611,6 +622,9 @@ public:
 private:
     /// Specifies, whether derivative texture functions will be used.
     bool m_use_derivatives;
+
+    /// The filter used for lookups in 2D textures.
+    Texture_filter m_filter;
 };
 
 }  // MDLRT
@@ -32,14 +32,22 @@
 #ifndef RENDER_MDL_RUNTIME_I_MDLRT_TEXTURE_H
 #define RENDER_MDL_RUNTIME_I_MDLRT_TEXTURE_H
 
+#include <mi/base/handle.h>
+#include <mi/base/lock.h>
 #include <mi/neuraylib/typedefs.h>
 #include <mi/mdl/mdl_stdlib_types.h>
+#include <mi/mdl/mdl_types.h>
+#include <mi/mdl/mdl_values.h>
 
+#include <render/mdl/runtime/i_mdlrt_resource_handler.h>
 #include <io/scene/texture/i_texture.h>
 #include <io/scene/dbimage/i_dbimage.h>
 #include <io/image/image/i_image_access_canvas.h>
+#include <io/image/image/i_image_mipmap.h>
 
+#include <atomic>
 #include <map>
+#include <memory>
 #include <vector>
 
 namespace MI {
@@ -82,6 +90,7 @@ public:
     Texture_2d(
         const DB::Typed_tag<TEXTURE::Texture>& tag,
         bool use_derivatives,
+        Texture_filter filter,
         DB::Transaction* transaction);
 
     mi::Uint32_2 get_resolution(const mi::Sint32_2& uv_tile, mi::Float32 frame) const;
@@ -176,16 +185,65 @@ private:
 
     bool m_use_derivatives;
     bool m_is_uvtile;
+    Texture_filter m_filter;
 
-    struct Uvtile {
-        // Vector of mipmap levels. Only one element if \c m_use_derivatives is \c false.
-        std::vector<IMAGE::Access_canvas> m_canvas;
-        std::vector<mi::Uint32_3> m_resolution;
+    // A uvtile keeps the typed canvases of its mipmap levels as stored in the DB, texels are
+    // converted to RGBA floats (and linearized) per lookup. The canvases are obtained lazily: the
+    // base level on the first lookup, and the higher levels from IMAGE::IMipmap::get_level() on
+    // the first lookup that needs them. All methods are thread-safe.
+    class Uvtile
+    {
+    public:
+        // A mipmap level.
+        struct Level {
+            IMAGE::Access_canvas m_canvas;
+            mi::Uint32_3 m_resolution;
+        };
+
+        Uvtile(const IMAGE::IMipmap* mipmap, float gamma, bool use_derivatives);
+
+        // Returns the number of mipmap levels. Only one level if derivatives are not used.
+        mi::Uint32 get_nlevels() const { return static_cast<mi::Uint32>(m_levels.size()); }
+
+        // Returns the resolution of the base level (does not obtain its canvas).
+        const mi::Uint32_3& get_base_resolution() const { return m_base_resolution; }
+
+        // Returns the gamma value of the texels.
+        float get_gamma() const { return m_gamma; }
+
+        // Returns the given level, obtaining its canvas (and the ones of all lower levels) if
+        // needed.
+        const Level& get_level(mi::Uint32 level) const;
+
+        // Returns the texel at \p coord of the base level (without gamma correction), or zero if
+        // \p coord is outside of it.
+        mi::Float32_4 get_texel(const mi::Sint32_2& coord) const;
+
+    private:
+        // Obtains the canvases of all levels up to and including \p level.
+        void materialize(mi::Uint32 level) const;
+
+        // The mipmap from the DB.
+        mi::base::Handle<const IMAGE::IMipmap> m_mipmap;
+
+        // The gamma value of the texels.
         float m_gamma;
+
+        // The resolution of the base level.
+        mi::Uint32_3 m_base_resolution;
+
+        // Protects the materialization of the levels.
+        mutable mi::base::Lock m_lock;
+
+        // The number of materialized levels. Levels below this number are immutable.
+        mutable std::atomic<mi::Uint32> m_nr_of_ready_levels;
+
+        // The levels (sized upfront, filled under m_lock).
+        mutable std::vector<Level> m_levels;
     };
 
     struct Frame {
-        std::vector<Uvtile> m_uvtiles;
+        std::vector<std::unique_ptr<Uvtile>> m_uvtiles;
         DBIMAGE::Uv_to_id m_uv_to_id;
     };
 
@@ -304,6 +362,58 @@ public:
     mi::Spectrum lookup_color(int channel) const;
 };
 
+// Returns the runtime texture for the given texture tag.
+//
+// Runtime textures are immutable after construction (uvtile levels are materialized lazily, but
+// thread-safe), hence they are shared process-wide between all native target codes. They are
+// keyed by the DB versions of the texture, its image and the image implementation, the shape,
+// the derivative mode, and the filter. A runtime texture and its cache entry are destroyed as
+// soon as the last target code referencing it terminates its texture data.
+std::shared_ptr<const Texture> get_shared_texture(
+    const DB::Typed_tag<TEXTURE::Texture>& tag,
+    mi::mdl::IType_texture::Shape shape,
+    bool use_derivatives,
+    Texture_filter filter,
+    DB::Transaction* transaction);
+
+// Returns the number of runtime textures currently shared (exposed for unit tests).
+size_t get_shared_texture_count();
+
+// Filtering kernels of the runtime textures (exposed for unit tests).
+
+// Filters a 2D or 3D texture given as canvas with bilinear (or trilinear for 3D) interpolation.
+// With \p smootherstep, the weights are adjusted by a quintic smootherstep function (biquintic
+// interpolation). The result is raised to the power of \p gamma_val.
+mi::Float32_4 interpolate_biquintic(
+    const IMAGE::Access_canvas& canvas,
+    const mi::Uint32_3& texture_res,
+    mi::mdl::stdlib::Tex_wrap_mode wrap_u,
+    mi::mdl::stdlib::Tex_wrap_mode wrap_v,
+    mi::mdl::stdlib::Tex_wrap_mode wrap_w,
+    const mi::Float32_4& crop_uv,
+    const mi::Float32_2& crop_w,
+    const mi::Float32_3& texo,
+    bool smootherstep,
+    float gamma_val,
+    unsigned int layer_offset = 0);
+
+// Filters a 2D texture given as canvas with the given filter. Only the texels of the footprint are
+// converted to RGBA floats. With \p linearize, these texels are raised to the power of
+// \p gamma_val before filtering, otherwise the result is. The z coordinate of \p texo is ignored.
+//
+// Computes the same result as interpolate_biquintic() for TEXTURE_FILTER_BIQUINTIC (with
+// smootherstep) and TEXTURE_FILTER_BILINEAR (without smootherstep) if \p linearize is false.
+mi::Float32_4 filter_texels_2d(
+    const IMAGE::Access_canvas& canvas,
+    const mi::Uint32_3& texture_res,
+    mi::mdl::stdlib::Tex_wrap_mode wrap_u,
+    mi::mdl::stdlib::Tex_wrap_mode wrap_v,
+    const mi::Float32_4& crop_uv,
+    const mi::Float32_3& texo,
+    Texture_filter filter,
+    float gamma_val,
+    bool linearize);
+
 }
 }
 
@@ -40,15 +40,26 @@
 namespace MI {
 namespace MDLRT {
 
+namespace {
+
+// The texture data of a target code only references the shared runtime texture.
+struct Texture_slot
+{
+    std::shared_ptr<const Texture> m_texture;
+};
+
+template <typename T>
+T const *get_texture(void const *tex_data)
+{
+    return static_cast<T const *>(
+        reinterpret_cast<Texture_slot const *>(tex_data)->m_texture.get());
+}
+
+} // namespace
+
 size_t Resource_handler::get_data_size() const
 {
-    size_t size = sizeof(Texture_2d);
-    if (size < sizeof(Texture_3d))
-        size = sizeof(Texture_3d);
-    if (size < sizeof(Texture_cube))
-        size = sizeof(Texture_cube);
-    if (size < sizeof(Texture_ptex))
-        size = sizeof(Texture_ptex);
+    size_t size = sizeof(Texture_slot);
     if (size < sizeof(Light_profile))
         size = sizeof(Light_profile);
     if (size < sizeof(Bsdf_measurement))
@@ -66,63 +77,19 @@ void Resource_handler::tex_init(
     DB::Tag                         tag(tag_v);
     DB::Typed_tag<TEXTURE::Texture> typed_tag(tag);
 
-    switch (shape) {
-    case mi::mdl::IType_texture::TS_2D:
-        new (data) Texture_2d(typed_tag, m_use_derivatives, (DB::Transaction *)ctx);
-        break;
-    case mi::mdl::IType_texture::TS_3D:
-        new (data) Texture_3d(typed_tag, (DB::Transaction *)ctx);
-        break;
-    case mi::mdl::IType_texture::TS_CUBE:
-        new (data) Texture_cube(typed_tag, (DB::Transaction *)ctx);
-        break;
-    case mi::mdl::IType_texture::TS_PTEX:
-        new (data) Texture_ptex(typed_tag, (DB::Transaction *)ctx);
-        break;
-    case mi::mdl::IType_texture::TS_BSDF_DATA:
-        // handle like 3D texture
-        new (data) Texture_3d(typed_tag, (DB::Transaction *)ctx);
-        break;
-    }
+    Texture_slot *slot = new (data) Texture_slot;
+    // the declared gamma mode is already reflected in the effective gamma of the texture
+    slot->m_texture = get_shared_texture(
+        typed_tag, shape, m_use_derivatives, m_filter, (DB::Transaction *)ctx);
 }
 
 void Resource_handler::tex_term(
     void                          *data,
     mi::mdl::IType_texture::Shape shape)
 {
-    switch (shape) {
-    case mi::mdl::IType_texture::TS_2D:
-        {
-            Texture_2d *o = reinterpret_cast<Texture_2d *>(data);
-            o->~Texture_2d();
-            break;
-        }
-    case mi::mdl::IType_texture::TS_3D:
-        {
-            Texture_3d *o = reinterpret_cast<Texture_3d *>(data);
-            o->~Texture_3d();
-            break;
-        }
-    case mi::mdl::IType_texture::TS_CUBE:
-        {
-            Texture_cube *o = reinterpret_cast<Texture_cube *>(data);
-            o->~Texture_cube();
-            break;
-        }
-    case mi::mdl::IType_texture::TS_PTEX:
-        {
-            Texture_ptex *o = reinterpret_cast<Texture_ptex *>(data);
-            o->~Texture_ptex();
-            break;
-        }
-    case mi::mdl::IType_texture::TS_BSDF_DATA:
-        {
-            // handle like 3D texture
-            Texture_3d *o = reinterpret_cast<Texture_3d *>(data);
-            o->~Texture_3d();
-            break;
-        }
-    }
+    // releases the reference to the shared runtime texture
+    Texture_slot *slot = reinterpret_cast<Texture_slot *>(data);
+    slot->~Texture_slot();
 }
 
 void Resource_handler::tex_resolution_2d(
@@ -131,7 +98,7 @@ void Resource_handler::tex_resolution_2d(
     int const     uv_tile[2],
     float         frame) const
 {
-    Texture_2d const *o = reinterpret_cast<Texture_2d const *>(tex_data);
+    Texture_2d const *o = get_texture<Texture_2d>(tex_data);
     mi::Uint32_2 res = o->get_resolution(*reinterpret_cast<mi::Sint32_2 const *>(uv_tile), frame);
     result[0] = res.x;
     result[1] = res.y;
@@ -142,7 +109,7 @@ void Resource_handler::tex_resolution_3d(
     void const    *tex_data,
     float         frame) const
 {
-    Texture_3d const *o = reinterpret_cast<Texture_3d const *>(tex_data);
+    Texture_3d const *o = get_texture<Texture_3d>(tex_data);
     mi::Uint32_3 res = o->get_resolution(frame);
     result[0] = res.x;
     result[1] = res.y;
@@ -159,7 +126,7 @@ float Resource_handler::tex_lookup_float_2d(
     float const   crop_v[2],
     float         frame) const
 {
-    Texture_2d const *o = reinterpret_cast<Texture_2d const *>(tex_data);
+    Texture_2d const *o = get_texture<Texture_2d>(tex_data);
 
     return o->lookup_float(
         *reinterpret_cast<mi::Float32_2 const *>(coord),
@@ -180,7 +147,7 @@ float Resource_handler::tex_lookup_deriv_float_2d(
     float const        crop_v[2],
     float              frame) const
 {
-    Texture_2d const *o = reinterpret_cast<Texture_2d const *>(tex_data);
+    Texture_2d const *o = get_texture<Texture_2d>(tex_data);
 
     return o->lookup_deriv_float4(
         *reinterpret_cast<mi::Float32_2 const *>(coord->val),
@@ -205,7 +172,7 @@ float Resource_handler::tex_lookup_float_3d(
     float const   crop_w[2],
     float         frame) const
 {
-    Texture_3d const *o = reinterpret_cast<Texture_3d const *>(tex_data);
+    Texture_3d const *o = get_texture<Texture_3d>(tex_data);
 
     return o->lookup_float(
         *reinterpret_cast<mi::Float32_3 const *>(coord),
@@ -223,7 +190,7 @@ float Resource_handler::tex_lookup_float_cube(
     void          * /*thread_data*/,
     float const   coord[3]) const
 {
-    Texture_cube const *o = reinterpret_cast<Texture_cube const *>(tex_data);
+    Texture_cube const *o = get_texture<Texture_cube>(tex_data);
 
     return o->lookup_float(*reinterpret_cast<mi::Float32_3 const *>(coord));
 }
@@ -233,7 +200,7 @@ float Resource_handler::tex_lookup_float_ptex(
     void          * /*thread_data*/,
     int           channel) const
 {
-    Texture_ptex const *o = reinterpret_cast<Texture_ptex const *>(tex_data);
+    Texture_ptex const *o = get_texture<Texture_ptex>(tex_data);
 
     return o->lookup_float(channel);
 }
@@ -249,7 +216,7 @@ void Resource_handler::tex_lookup_float2_2d(
     float const   crop_v[2],
     float         frame) const
 {
-    Texture_2d const *o = reinterpret_cast<Texture_2d const *>(tex_data);
+    Texture_2d const *o = get_texture<Texture_2d>(tex_data);
 
     *reinterpret_cast<mi::Float32_2_struct*>(result) =
         o->lookup_float2(
@@ -272,7 +239,7 @@ void Resource_handler::tex_lookup_deriv_float2_2d(
     float const        crop_v[2],
     float              frame) const
 {
-    Texture_2d const *o = reinterpret_cast<Texture_2d const *>(tex_data);
+    Texture_2d const *o = get_texture<Texture_2d>(tex_data);
 
     mi::Float32_4 res = o->lookup_deriv_float4(
         *reinterpret_cast<mi::Float32_2 const *>(coord->val),
@@ -301,7 +268,7 @@ void Resource_handler::tex_lookup_float2_3d(
     float const   crop_w[2],
     float         frame) const
 {
-    Texture_3d const *o = reinterpret_cast<Texture_3d const *>(tex_data);
+    Texture_3d const *o = get_texture<Texture_3d>(tex_data);
 
     *reinterpret_cast<mi::Float32_2_struct*>(result) =
         o->lookup_float2(
@@ -321,7 +288,7 @@ void Resource_handler::tex_lookup_float2_cube(
     void          * /*thread_data*/,
     float const   coord[3]) const
 {
-    Texture_cube const *o = reinterpret_cast<Texture_cube const *>(tex_data);
+    Texture_cube const *o = get_texture<Texture_cube>(tex_data);
 
     *reinterpret_cast<mi::Float32_2_struct*>(result) =
         o->lookup_float2(*reinterpret_cast<mi::Float32_3 const *>(coord));
@@ -333,7 +300,7 @@ void Resource_handler::tex_lookup_float2_ptex(
     void          * /*thread_data*/,
     int           channel) const
 {
-    Texture_ptex const *o = reinterpret_cast<Texture_ptex const *>(tex_data);
+    Texture_ptex const *o = get_texture<Texture_ptex>(tex_data);
 
     *reinterpret_cast<mi::Float32_2_struct*>(result) = o->lookup_float2(channel);
 }
@@ -349,7 +316,7 @@ void Resource_handler::tex_lookup_float3_2d(
     float const   crop_v[2],
     float         frame) const
 {
-    Texture_2d const *o = reinterpret_cast<Texture_2d const *>(tex_data);
+    Texture_2d const *o = get_texture<Texture_2d>(tex_data);
 
     *reinterpret_cast<mi::Float32_3_struct*>(result) =
         o->lookup_float3(
@@ -372,7 +339,7 @@ void Resource_handler::tex_lookup_deriv_float3_2d(
     float const        crop_v[2],
     float         frame) const
 {
-    Texture_2d const *o = reinterpret_cast<Texture_2d const *>(tex_data);
+    Texture_2d const *o = get_texture<Texture_2d>(tex_data);
 
     mi::Float32_4 res = o->lookup_deriv_float4(
         *reinterpret_cast<mi::Float32_2 const *>(coord->val),
@@ -401,7 +368,7 @@ void Resource_handler::tex_lookup_float3_3d(
     float const   crop_w[2],
     float         frame) const
 {
-    Texture_3d const *o = reinterpret_cast<Texture_3d const *>(tex_data);
+    Texture_3d const *o = get_texture<Texture_3d>(tex_data);
 
     *reinterpret_cast<mi::Float32_3_struct*>(result) =
         o->lookup_float3(
@@ -421,7 +388,7 @@ void Resource_handler::tex_lookup_float3_cube(
     void          * /*thread_data*/,
     float const   coord[3]) const
 {
-    Texture_cube const *o = reinterpret_cast<Texture_cube const *>(tex_data);
+    Texture_cube const *o = get_texture<Texture_cube>(tex_data);
 
     *reinterpret_cast<mi::Float32_3_struct*>(result) =
         o->lookup_float3(*reinterpret_cast<mi::Float32_3 const *>(coord));
@@ -433,7 +400,7 @@ void Resource_handler::tex_lookup_float3_ptex(
     void          * /*thread_data*/,
     int           channel) const
 {
-    Texture_ptex const *o = reinterpret_cast<Texture_ptex const *>(tex_data);
+    Texture_ptex const *o = get_texture<Texture_ptex>(tex_data);
 
     *reinterpret_cast<mi::Float32_3_struct*>(result) = o->lookup_float3(channel);
 }
@@ -450,7 +417,7 @@ void Resource_handler::tex_lookup_float4_2d(
     float const   crop_v[2],
     float         frame) const
 {
-    Texture_2d const *o = reinterpret_cast<Texture_2d const *>(tex_data);
+    Texture_2d const *o = get_texture<Texture_2d>(tex_data);
 
     *reinterpret_cast<mi::Float32_4_struct*>(result) =
         o->lookup_float4(
@@ -473,7 +440,7 @@ void Resource_handler::tex_lookup_deriv_float4_2d(
     float const        crop_v[2],
     float         frame) const
 {
-    Texture_2d const *o = reinterpret_cast<Texture_2d const *>(tex_data);
+    Texture_2d const *o = get_texture<Texture_2d>(tex_data);
 
     *reinterpret_cast<mi::Float32_4_struct*>(result) =
         o->lookup_deriv_float4(
@@ -500,7 +467,7 @@ void Resource_handler::tex_lookup_float4_3d(
     float const   crop_w[2],
     float         frame) const
 {
-    Texture_3d const *o = reinterpret_cast<Texture_3d const *>(tex_data);
+    Texture_3d const *o = get_texture<Texture_3d>(tex_data);
 
     *reinterpret_cast<mi::Float32_4_struct*>(result) =
         o->lookup_float4(
@@ -520,7 +487,7 @@ void Resource_handler::tex_lookup_float4_cube(
     void          * /*thread_data*/,
     float const   coord[3]) const
 {
-    Texture_cube const *o = reinterpret_cast<Texture_cube const *>(tex_data);
+    Texture_cube const *o = get_texture<Texture_cube>(tex_data);
 
     *reinterpret_cast<mi::Float32_4_struct*>(result) =
         o->lookup_float4(*reinterpret_cast<mi::Float32_3 const *>(coord));
@@ -532,7 +499,7 @@ void Resource_handler::tex_lookup_float4_ptex(
     void          * /*thread_data*/,
     int           channel) const
 {
-    Texture_ptex const *o = reinterpret_cast<Texture_ptex const *>(tex_data);
+    Texture_ptex const *o = get_texture<Texture_ptex>(tex_data);
 
     *reinterpret_cast<mi::Float32_4_struct*>(result) = o->lookup_float4(channel);
 }
@@ -548,7 +515,7 @@ void Resource_handler::tex_lookup_color_2d(
     float const   crop_v[2],
     float         frame) const
 {
-    Texture_2d const *o = reinterpret_cast<Texture_2d const *>(tex_data);
+    Texture_2d const *o = get_texture<Texture_2d>(tex_data);
 
     *reinterpret_cast<mi::Float32_3*>(rgb) =
         o->lookup_color(
@@ -571,7 +538,7 @@ void Resource_handler::tex_lookup_deriv_color_2d(
     float const        crop_v[2],
     float              frame) const
 {
-    Texture_2d const *o = reinterpret_cast<Texture_2d const *>(tex_data);
+    Texture_2d const *o = get_texture<Texture_2d>(tex_data);
 
     mi::Float32_4 res = o->lookup_deriv_float4(
         *reinterpret_cast<mi::Float32_2 const *>(coord->val),
@@ -600,7 +567,7 @@ void Resource_handler::tex_lookup_color_3d(
     float const   crop_w[2],
     float         frame) const
 {
-    Texture_3d const *o = reinterpret_cast<Texture_3d const *>(tex_data);
+    Texture_3d const *o = get_texture<Texture_3d>(tex_data);
 
     *reinterpret_cast<mi::Float32_3*>(rgb) =
         o->lookup_color(
@@ -620,7 +587,7 @@ void Resource_handler::tex_lookup_color_cube(
     void          * /*thread_data*/,
     float const   coord[3]) const
 {
-    Texture_cube const *o = reinterpret_cast<Texture_cube const *>(tex_data);
+    Texture_cube const *o = get_texture<Texture_cube>(tex_data);
 
     *reinterpret_cast<mi::Float32_3*>(rgb) =
         o->lookup_color(*reinterpret_cast<mi::Float32_3 const *>(coord)).to_vector3();
@@ -632,7 +599,7 @@ void Resource_handler::tex_lookup_color_ptex(
     void          * /*thread_data*/,
     int           channel) const
 {
-    Texture_ptex const*o = reinterpret_cast<Texture_ptex const*>(tex_data);
+    Texture_ptex const*o = get_texture<Texture_ptex>(tex_data);
 
     *reinterpret_cast<mi::Float32_3*>(rgb) = o->lookup_color(channel).to_vector3();
 }
@@ -644,7 +611,7 @@ float Resource_handler::tex_texel_float_2d(
     int const     uv_tile[2],
     float         frame) const
 {
-    Texture_2d const*o = reinterpret_cast<Texture_2d const*>(tex_data);
+    Texture_2d const*o = get_texture<Texture_2d>(tex_data);
 
     return o->texel_float(
         *reinterpret_cast<mi::Sint32_2 const *>(coord),
@@ -660,7 +627,7 @@ void Resource_handler::tex_texel_float2_2d(
     int const     uv_tile[2],
     float         frame) const
 {
-    Texture_2d const*o = reinterpret_cast<Texture_2d const *>(tex_data);
+    Texture_2d const*o = get_texture<Texture_2d>(tex_data);
 
     *reinterpret_cast<mi::Float32_2_struct*>(result) =
         o->texel_float2(
@@ -677,7 +644,7 @@ void Resource_handler::tex_texel_float3_2d(
     int const     uv_tile[2],
     float         frame) const
 {
-    Texture_2d const*o = reinterpret_cast<Texture_2d const *>(tex_data);
+    Texture_2d const*o = get_texture<Texture_2d>(tex_data);
 
     *reinterpret_cast<mi::Float32_3_struct*>(result) =
         o->texel_float3(
@@ -694,7 +661,7 @@ void Resource_handler::tex_texel_float4_2d(
     int const     uv_tile[2],
     float         frame) const
 {
-    Texture_2d const *o = reinterpret_cast<Texture_2d const *>(tex_data);
+    Texture_2d const *o = get_texture<Texture_2d>(tex_data);
 
     *reinterpret_cast<mi::Float32_4_struct*>(result) =
         o->texel_float4(
@@ -711,7 +678,7 @@ void Resource_handler::tex_texel_color_2d(
     int const     uv_tile[2],
     float         frame) const
 {
-    Texture_2d const *o = reinterpret_cast<Texture_2d const *>(tex_data);
+    Texture_2d const *o = get_texture<Texture_2d>(tex_data);
 
     *reinterpret_cast<mi::Float32_3*>(rgb) =
         o->texel_color(
@@ -726,7 +693,7 @@ float Resource_handler::tex_texel_float_3d(
     int const     coord[3],
     float         frame) const
 {
-    Texture_3d const*o = reinterpret_cast<Texture_3d const*>(tex_data);
+    Texture_3d const*o = get_texture<Texture_3d>(tex_data);
 
     return o->texel_float(*reinterpret_cast<mi::Sint32_3 const *>(coord), frame);
 }
@@ -738,7 +705,7 @@ void Resource_handler::tex_texel_float2_3d(
     int const     coord[3],
     float         frame) const
 {
-    Texture_3d const*o = reinterpret_cast<Texture_3d const *>(tex_data);
+    Texture_3d const*o = get_texture<Texture_3d>(tex_data);
 
     *reinterpret_cast<mi::Float32_2_struct*>(result) =
         o->texel_float2(*reinterpret_cast<mi::Sint32_3 const *>(coord), frame);
@@ -751,7 +718,7 @@ void Resource_handler::tex_texel_float3_3d(
     int const     coord[3],
     float         frame) const
 {
-    Texture_3d const*o = reinterpret_cast<Texture_3d const *>(tex_data);
+    Texture_3d const*o = get_texture<Texture_3d>(tex_data);
 
     *reinterpret_cast<mi::Float32_3_struct*>(result) =
         o->texel_float3(*reinterpret_cast<mi::Sint32_3 const *>(coord), frame);
@@ -764,7 +731,7 @@ void Resource_handler::tex_texel_float4_3d(
     int const     coord[3],
     float         frame) const
 {
-    Texture_3d const *o = reinterpret_cast<Texture_3d const *>(tex_data);
+    Texture_3d const *o = get_texture<Texture_3d>(tex_data);
 
     *reinterpret_cast<mi::Float32_4_struct*>(result) =
         o->texel_float4(*reinterpret_cast<mi::Sint32_3 const *>(coord), frame);
@@ -777,7 +744,7 @@ void Resource_handler::tex_texel_color_3d(
     int const     coord[3],
     float         frame) const
 {
-    Texture_3d const *o = reinterpret_cast<Texture_3d const *>(tex_data);
+    Texture_3d const *o = get_texture<Texture_3d>(tex_data);
 
     *reinterpret_cast<mi::Float32_3*>(rgb) =
         o->texel_color(*reinterpret_cast<mi::Sint32_3 const *>(coord), frame).to_vector3();
@@ -786,7 +753,7 @@ void Resource_handler::tex_texel_color_3d(
 bool Resource_handler::tex_isvalid(
     void const *tex_data) const
 {
-    Texture const *o = reinterpret_cast<Texture const *>(tex_data);
+    Texture const *o = get_texture<Texture>(tex_data);
     return o->is_valid();
 }
 
@@ -794,7 +761,7 @@ void Resource_handler::tex_frame(
     int        result[2],
     void const *tex_data) const
 {
-    Texture const *o = reinterpret_cast<Texture const *>(tex_data);
+    Texture const *o = get_texture<Texture>(tex_data);
     const mi::Uint32_2& res = o->get_first_last_frame();
     result[0] = res.x;
     result[1] = res.y;
@@ -43,6 +43,19 @@
 #include <io/scene/texture/i_texture.h>
 #include <io/scene/dbimage/i_dbimage.h>
 #include <base/data/db/i_db_access.h>
+#include <base/data/db/i_db_transaction.h>
+
+#include <tuple>
+
+#if defined(HAS_SSE) || defined(SSE_INTRINSICS)
+#ifdef MI_ARCH_X86_64
+#include <xmmintrin.h>
+#elif defined(MI_ARCH_ARM_64)
+#define SIMDE_ENABLE_NATIVE_ALIASES
+#include <base/lib/simde/x86/sse2.h>
+#endif
+#define MDLRT_TEXTURE_SSE
+#endif
 
 namespace MI {
 namespace MDLRT {
@@ -89,6 +102,16 @@ void apply_gamma4(mi::math::Color &c, const float gamma_val)
     }
 }
 
+void apply_gamma_float4(mi::Float32_4 &rgba, const float gamma_val)
+{
+    if (gamma_val != 1.0f) {
+        rgba.x = gamma_func(rgba.x, gamma_val);
+        rgba.y = gamma_func(rgba.y, gamma_val);
+        rgba.z = gamma_func(rgba.z, gamma_val);
+        rgba.w = gamma_func(rgba.w, gamma_val);
+    }
+}
+
 float saturate(const float f)
 {
     return std::max(0.0f, std::min(1.0f, f));
@@ -218,27 +241,25 @@ unsigned int texremapzll(
     return texi;
 }
 
-mi::Float32_4 interpolate_biquintic(
-    const IMAGE::Access_canvas &canvas,
+// Computes the (wrapped and cropped) coordinates of the four texels around \p texo in the x/y
+// plane, and the fractional position between them. Returns false if the lookup yields zero.
+bool compute_texel_coords_2d(
     const mi::Uint32_3 &texture_res,
     const mi::mdl::stdlib::Tex_wrap_mode wrap_u,
     const mi::mdl::stdlib::Tex_wrap_mode wrap_v,
-    const mi::mdl::stdlib::Tex_wrap_mode wrap_w,
     const mi::Float32_4 &crop_uv,
-    const mi::Float32_2 &crop_w,
     const mi::Float32_3 &texo,
-    const bool smootherstep,
-    const float gamma_val,
-    const unsigned int layer_offset = 0)
+    mi::Uint32_4 &texi,
+    mi::Float32_2 &lerp)
 {
     if (texture_res.x == 0 || texture_res.y == 0)
-        return mi::Float32_4(0.0f, 0.0f , 0.0f, 0.0f);
+        return false;
 
     if(((wrap_u == mi::mdl::stdlib::wrap_clip) && (texo.x < 0.0f || texo.x > 1.0f))
         ||
        ((wrap_v == mi::mdl::stdlib::wrap_clip) && (texo.y < 0.0f || texo.y > 1.0f)))
 
-        return mi::Float32_4(0.0f, 0.0f, 0.0f, 0.0f);
+        return false;
 
     const mi::Uint32_2 full_texres(texture_res.x, texture_res.y);
     const mi::Sint32_2 crop_ofs(
@@ -257,18 +278,77 @@ mi::Float32_4 interpolate_biquintic(
     // check for LLONG_MAX as texremapll overflows otherwise
     if((texres.x == 0) || (texres.y == 0) || (((float_as_uint(tex.x))&0x7FFFFFFF) >= 0x5f000000) ||
        (((float_as_uint(tex.y))&0x7FFFFFFF) >= 0x5f000000))
-        return mi::Float32_4(0.0f, 0.0f, 0.0f, 0.0f);
+        return false;
 
     const mi::Uint32_2 texi0 = texremapll(wrap_u, wrap_v, texres, crop_ofs, tex);
     //!! +1 in float can screw-up bilerp
     const mi::Uint32_2 texi1 = texremapll(
         wrap_u, wrap_v, texres, crop_ofs, mi::Float32_2(tex.x+1.0f, tex.y+1.0f));
-    const mi::Uint32_4 texi(texi0.x, texi0.y, texi1.x, texi1.y);
+    texi = mi::Uint32_4(texi0.x, texi0.y, texi1.x, texi1.y);
 
     ASSERT(M_BACKENDS, texi.x < full_texres.x && texi.y < full_texres.y);
     ASSERT(M_BACKENDS, texi.z < full_texres.x && texi.w < full_texres.y);
 
-    mi::Float32_2 lerp(tex.x - floorf(tex.x), tex.y - floorf(tex.y));
+    lerp = mi::Float32_2(tex.x - floorf(tex.x), tex.y - floorf(tex.y));
+    return true;
+}
+
+// Returns the weighted sum c0 * w.x + c1 * w.y + c2 * w.z + c3 * w.w of four RGBA texels.
+mi::Float32_4 blend_texels(
+    const mi::Float32_4 &c0,
+    const mi::Float32_4 &c1,
+    const mi::Float32_4 &c2,
+    const mi::Float32_4 &c3,
+    const mi::Float32_4 &w)
+{
+#ifdef MDLRT_TEXTURE_SSE
+    __m128 rgba = _mm_mul_ps(_mm_loadu_ps(&c0.x), _mm_set1_ps(w.x));
+    rgba = _mm_add_ps(rgba, _mm_mul_ps(_mm_loadu_ps(&c1.x), _mm_set1_ps(w.y)));
+    rgba = _mm_add_ps(rgba, _mm_mul_ps(_mm_loadu_ps(&c2.x), _mm_set1_ps(w.z)));
+    rgba = _mm_add_ps(rgba, _mm_mul_ps(_mm_loadu_ps(&c3.x), _mm_set1_ps(w.w)));
+    mi::Float32_4 result;
+    _mm_storeu_ps(&result.x, rgba);
+    return result;
+#else
+    return c0 * w.x + c1 * w.y + c2 * w.z + c3 * w.w;
+#endif
+}
+
+// Reads a texel of the canvas as RGBA floats and raises it to the power of \p gamma_val.
+mi::Float32_4 fetch_texel(
+    const IMAGE::Access_canvas &canvas,
+    const mi::Uint32 x,
+    const mi::Uint32 y,
+    const float gamma_val)
+{
+    mi::math::Color c(0.0f, 0.0f, 0.0f, 0.0f);
+    canvas.lookup(c, x, y);
+    mi::Float32_4 rgba(c.r, c.g, c.b, c.a);
+    apply_gamma_float4(rgba, gamma_val);
+    return rgba;
+}
+
+} // namespace
+
+//-------------------------------------------------------------------------------------------------
+
+mi::Float32_4 interpolate_biquintic(
+    const IMAGE::Access_canvas &canvas,
+    const mi::Uint32_3 &texture_res,
+    const mi::mdl::stdlib::Tex_wrap_mode wrap_u,
+    const mi::mdl::stdlib::Tex_wrap_mode wrap_v,
+    const mi::mdl::stdlib::Tex_wrap_mode wrap_w,
+    const mi::Float32_4 &crop_uv,
+    const mi::Float32_2 &crop_w,
+    const mi::Float32_3 &texo,
+    const bool smootherstep,
+    const float gamma_val,
+    const unsigned int layer_offset)
+{
+    mi::Uint32_4 texi;
+    mi::Float32_2 lerp;
+    if (!compute_texel_coords_2d(texture_res, wrap_u, wrap_v, crop_uv, texo, texi, lerp))
+        return mi::Float32_4(0.0f, 0.0f, 0.0f, 0.0f);
 
     // 3D texture?
     unsigned int texi0_z = 0;
@@ -338,62 +418,55 @@ mi::Float32_4 interpolate_biquintic(
     if(lerp_z != 0.f)
         rgba += (rgba2-rgba)*lerp_z;
 
-    if(gamma_val != 1.0f) {
-        rgba.x = gamma_func(rgba.x, gamma_val);
-        rgba.y = gamma_func(rgba.y, gamma_val);
-        rgba.z = gamma_func(rgba.z, gamma_val);
-        rgba.w = gamma_func(rgba.w, gamma_val);
-    }
+    apply_gamma_float4(rgba, gamma_val);
     return rgba;
 }
 
-// Converts \p input to a floating-point pixel type with gamma 1.0.
-//
-// \param gamma   The gamma value of \p input (might be different from input->get_gamma() if
-//                overridden on the texture).
-mi::neuraylib::ICanvas* convert_to_fp_type_with_linear_gamma(
-    IMAGE::Image_module* image_module, const mi::neuraylib::ICanvas* input, mi::Float32 gamma)
-{
-    // Choose floating-point pixel type.
-    IMAGE::Pixel_type pixel_type = IMAGE::convert_pixel_type_string_to_enum(input->get_type());
-    switch (pixel_type) {
-        case IMAGE::PT_RGB:
-        case IMAGE::PT_RGBE:
-        case IMAGE::PT_RGB_16:
-        case IMAGE::PT_FLOAT32_2:
-        case IMAGE::PT_FLOAT32_3:
-            pixel_type = IMAGE::PT_RGB_FP;
-            break;
-        case IMAGE::PT_RGBA:
-        case IMAGE::PT_RGBEA:
-        case IMAGE::PT_RGBA_16:
-        case IMAGE::PT_FLOAT32_4:
-            pixel_type = IMAGE::PT_COLOR;
-            break;
-        case IMAGE::PT_SINT8:
-        case IMAGE::PT_SINT32:
-            pixel_type = IMAGE::PT_FLOAT32;
-            break;
-        case IMAGE::PT_RGB_FP:
-        case IMAGE::PT_COLOR:
-        case IMAGE::PT_FLOAT32:
-            // no change necessary
-            break;
-        case IMAGE::PT_UNDEF:
-            ASSERT(M_BACKENDS, false);
-            break;
+mi::Float32_4 filter_texels_2d(
+    const IMAGE::Access_canvas &canvas,
+    const mi::Uint32_3 &texture_res,
+    const mi::mdl::stdlib::Tex_wrap_mode wrap_u,
+    const mi::mdl::stdlib::Tex_wrap_mode wrap_v,
+    const mi::Float32_4 &crop_uv,
+    const mi::Float32_3 &texo,
+    const Texture_filter filter,
+    const float gamma_val,
+    const bool linearize)
+{
+    mi::Uint32_4 texi;
+    mi::Float32_2 lerp;
+    if (!compute_texel_coords_2d(texture_res, wrap_u, wrap_v, crop_uv, texo, texi, lerp))
+        return mi::Float32_4(0.0f, 0.0f, 0.0f, 0.0f);
+
+    // Only the texels of the footprint are converted (and linearized).
+    const float texel_gamma = linearize ? gamma_val : 1.0f;
+
+    mi::Float32_4 rgba;
+    if (filter == TEXTURE_FILTER_NEAREST) {
+        rgba = fetch_texel(
+            canvas, lerp.x < 0.5f ? texi.x : texi.z, lerp.y < 0.5f ? texi.y : texi.w, texel_gamma);
+    } else {
+        if (filter == TEXTURE_FILTER_BIQUINTIC) {
+            lerp.x *= lerp.x*lerp.x*(lerp.x*(lerp.x*6.0f-15.0f)+10.0f); // smootherstep
+            lerp.y *= lerp.y*lerp.y*(lerp.y*(lerp.y*6.0f-15.0f)+10.0f);
+        }
+
+        const mi::Float32_4 st(
+            (1.0f-lerp.x)*(1.0f-lerp.y), lerp.x*(1.0f-lerp.y), (1.0f-lerp.x)*lerp.y, lerp.x*lerp.y);
+
+        rgba = blend_texels(
+            fetch_texel(canvas, texi.x, texi.y, texel_gamma),
+            fetch_texel(canvas, texi.z, texi.y, texel_gamma),
+            fetch_texel(canvas, texi.x, texi.w, texel_gamma),
+            fetch_texel(canvas, texi.z, texi.w, texel_gamma),
+            st);
     }
 
-    mi::base::Handle<mi::neuraylib::ICanvas> result(
-        image_module->convert_canvas(input, pixel_type));
-    result->set_gamma(gamma);
-    image_module->adjust_gamma(result.get(), 1.0f);
-    result->retain();
-    return result.get();
+    if (!linearize)
+        apply_gamma_float4(rgba, gamma_val);
+    return rgba;
 }
 
-} // namespace
-
 //-------------------------------------------------------------------------------------------------
 
 mi::Size Texture::get_frame_id(mi::Float32 frame) const
@@ -435,11 +508,12 @@ std::pair<mi::Size, mi::Size> Texture::get_frame_ids(mi::Float32 frame) const
 Texture_2d::Texture_2d(
     const DB::Typed_tag<TEXTURE::Texture>& tag,
     bool use_derivatives,
+    Texture_filter filter,
     DB::Transaction* transaction)
   : m_use_derivatives(use_derivatives)
+  , m_is_uvtile(false)
+  , m_filter(filter)
 {
-    SYSTEM::Access_module<IMAGE::Image_module> image_module(false);
-
     if (!tag)
         return;
 
@@ -478,48 +552,13 @@ Texture_2d::Texture_2d(
 
         for (mi::Size j = 0; j < n_uvtiles; ++j) {
 
-            Uvtile& uvtile = frame.m_uvtiles[j];
-
-            uvtile.m_gamma = texture->get_effective_gamma(transaction, i, j);
-            if (uvtile.m_gamma <= 0.0f)
-                uvtile.m_gamma = 0.0f;
-
-            uvtile.m_canvas.resize(1);
-            uvtile.m_resolution.resize(1);
+            float gamma = texture->get_effective_gamma(transaction, i, j);
+            if (gamma <= 0.0f)
+                gamma = 0.0f;
 
+            // The canvases are only materialized on the first lookup of this uvtile.
             mi::base::Handle<const IMAGE::IMipmap> mipmap(image_impl->get_mipmap(i, j));
-            mi::base::Handle<const mi::neuraylib::ICanvas> canvas(mipmap->get_level(/*level*/ 0));
-
-            // Convert to linear gamma first if derivatives are enabled. For non-derivative mode,
-            // the gamma is still (incorrectly) applied after filtering.
-            if (use_derivatives && uvtile.m_gamma != 1.0f) {
-                canvas = convert_to_fp_type_with_linear_gamma(
-                    image_module.get(), canvas.get(), uvtile.m_gamma);
-                uvtile.m_gamma = 1.0f;
-            }
-
-            uvtile.m_canvas[0] = IMAGE::Access_canvas(canvas.get(), true);
-            uvtile.m_resolution[0] = mi::Uint32_3(
-                canvas->get_resolution_x(), canvas->get_resolution_y(), 0);
-
-            if (!use_derivatives)
-                continue;
-
-            std::vector<mi::base::Handle<mi::neuraylib::ICanvas>> mipmaps;
-            image_module->create_mipmap(mipmaps, canvas.get(), 1.0f);
-
-            mi::Uint32 n_levels = 1 + mipmaps.size();
-            uvtile.m_canvas.resize(n_levels);
-            uvtile.m_resolution.resize(n_levels);
-
-            for (mi::Uint32 k = 1; k < n_levels; ++k) {
-                const auto& level = mipmaps[k-1];
-                uvtile.m_canvas[k] = IMAGE::Access_canvas(level.get(), true);
-                uvtile.m_resolution[k] = mi::Uint32_3(
-                    level->get_resolution_x(),
-                    level->get_resolution_y(),
-                    0);
-            }
+            frame.m_uvtiles[j].reset(new Uvtile(mipmap.get(), gamma, use_derivatives));
         }
 
         mi::Size frame_number = image->get_frame_number(i);
@@ -527,6 +566,55 @@ Texture_2d::Texture_2d(
     }
 }
 
+Texture_2d::Uvtile::Uvtile(const IMAGE::IMipmap* mipmap, float gamma, bool use_derivatives)
+  : m_mipmap(mipmap, mi::base::DUP_INTERFACE)
+  , m_gamma(gamma)
+  , m_nr_of_ready_levels(0)
+{
+    // Obtaining the base level does not load its pixel data for file-based mipmaps.
+    mi::base::Handle<const mi::neuraylib::ICanvas> canvas(m_mipmap->get_level(/*level*/ 0));
+    m_base_resolution = mi::Uint32_3(canvas->get_resolution_x(), canvas->get_resolution_y(), 0);
+
+    m_levels.resize(use_derivatives ? m_mipmap->get_nlevels() : 1);
+}
+
+const Texture_2d::Uvtile::Level& Texture_2d::Uvtile::get_level(mi::Uint32 level) const
+{
+    ASSERT(M_BACKENDS, level < m_levels.size());
+    if (level >= m_nr_of_ready_levels.load(std::memory_order_acquire))
+        materialize(level);
+    return m_levels[level];
+}
+
+mi::Float32_4 Texture_2d::Uvtile::get_texel(const mi::Sint32_2& coord) const
+{
+    if (coord.x < 0 || coord.y < 0
+        || static_cast<mi::Uint32>(coord.x) >= m_base_resolution.x
+        || static_cast<mi::Uint32>(coord.y) >= m_base_resolution.y)
+        return mi::Float32_4(0.0f, 0.0f, 0.0f, 0.0f);
+    return fetch_texel(get_level(0).m_canvas, coord.x, coord.y, 1.0f);
+}
+
+void Texture_2d::Uvtile::materialize(mi::Uint32 level) const
+{
+    mi::base::Lock::Block block(&m_lock);
+
+    mi::Uint32 n_ready = m_nr_of_ready_levels.load(std::memory_order_relaxed);
+    if (level < n_ready)
+        return;
+
+    for (mi::Uint32 k = n_ready; k <= level; ++k) {
+        // Higher levels are computed (and cached) by the mipmap itself, from the typed canvas of
+        // the previous level.
+        mi::base::Handle<const mi::neuraylib::ICanvas> canvas(m_mipmap->get_level(k));
+        Level& l = m_levels[k];
+        l.m_canvas = IMAGE::Access_canvas(canvas.get(), true);
+        l.m_resolution = mi::Uint32_3(canvas->get_resolution_x(), canvas->get_resolution_y(), 0);
+    }
+
+    m_nr_of_ready_levels.store(level + 1, std::memory_order_release);
+}
+
 mi::Uint32_2 Texture_2d::get_resolution(const mi::Sint32_2& uv_tile, mi::Float32 frame_param) const
 {
     mi::Size frame_id = get_frame_id(frame_param);
@@ -538,8 +626,9 @@ mi::Uint32_2 Texture_2d::get_resolution(const mi::Sint32_2& uv_tile, mi::Float32
     if (uvtile_id == ~0u)
         return mi::Uint32_2(0, 0);
 
-    const Uvtile& uvtile = frame.m_uvtiles[uvtile_id];
-    return mi::Uint32_2(uvtile.m_resolution[0].x, uvtile.m_resolution[0].y);
+    const Uvtile& uvtile = *frame.m_uvtiles[uvtile_id];
+    const mi::Uint32_3& resolution = uvtile.get_base_resolution();
+    return mi::Uint32_2(resolution.x, resolution.y);
 }
 
 float Texture_2d::lookup_float(
@@ -659,14 +748,17 @@ mi::Float32_4 Texture_2d::lookup_float4_frame(
             return mi::Float32_4(0.0f);
     }
 
-    const Uvtile& uvtile = frame.m_uvtiles[uvtile_id];
-
-    return interpolate_biquintic(
-        uvtile.m_canvas[0],
-        uvtile.m_resolution[0],
-        wrap_u, wrap_v, mi::mdl::stdlib::wrap_repeat,
-        crop_uv, crop_w,
-        coords, /*smootherstep*/ true, uvtile.m_gamma);
+    const Uvtile& uvtile = *frame.m_uvtiles[uvtile_id];
+    const Uvtile::Level& base = uvtile.get_level(0);
+
+    // With derivatives, the texels are linearized before filtering. Otherwise, the gamma is
+    // still (incorrectly) applied after filtering.
+    return filter_texels_2d(
+        base.m_canvas,
+        base.m_resolution,
+        wrap_u, wrap_v,
+        crop_uv,
+        coords, m_filter, uvtile.get_gamma(), /*linearize*/ m_use_derivatives);
 }
 
 mi::Float32_4 Texture_2d::lookup_deriv_float4(
@@ -759,48 +851,61 @@ mi::Float32_4 Texture_2d::lookup_deriv_float4_frame(
             return mi::Float32_4(0.0f);
     }
 
-    const Uvtile& uvtile = frame.m_uvtiles[uvtile_id];
+    const Uvtile& uvtile = *frame.m_uvtiles[uvtile_id];
 
     // isotropic filtering
-    mi::Size n_levels = uvtile.m_canvas.size();
+    mi::Uint32 n_levels = uvtile.get_nlevels();
     float dx_len_sqr  = coord_dx.x * coord_dx.x + coord_dx.y * coord_dx.y;
     float dy_len_sqr  = coord_dy.x * coord_dy.x + coord_dy.y * coord_dy.y;
     float max_len_sqr = std::max(dx_len_sqr, dy_len_sqr);
     float level       = n_levels - 1 + 0.5f * std::log2f(std::max(max_len_sqr, 1e-8f));
 
     if (level < 0) {
-        return interpolate_biquintic(
-            uvtile.m_canvas[0],
-            uvtile.m_resolution[0],
-            wrap_u, wrap_v, mi::mdl::stdlib::wrap_repeat,
-            crop_uv, crop_w,
-            coords, /*smootherstep*/ true, 1.0f);
+        const Uvtile::Level& base = uvtile.get_level(0);
+        return filter_texels_2d(
+            base.m_canvas,
+            base.m_resolution,
+            wrap_u, wrap_v,
+            crop_uv,
+            coords, m_filter, uvtile.get_gamma(), /*linearize*/ true);
     }
 
     if (level >= n_levels - 1) {
         // just read the single pixel of the smallest mipmap
-        mi::math::Color col;
-        uvtile.m_canvas[n_levels-1].lookup(col, 0, 0);
-        return mi::Float32_4(col.r, col.g, col.b, col.a);
+        return fetch_texel(uvtile.get_level(n_levels-1).m_canvas, 0, 0, uvtile.get_gamma());
+    }
+
+    if (m_filter == TEXTURE_FILTER_NEAREST) {
+        // just use the nearest mipmap level
+        unsigned int level_uint = static_cast<unsigned int>(level + 0.5f);
+        const Uvtile::Level& nearest = uvtile.get_level(level_uint);
+        return filter_texels_2d(
+            nearest.m_canvas,
+            nearest.m_resolution,
+            wrap_u, wrap_v,
+            crop_uv,
+            coords, m_filter, uvtile.get_gamma(), /*linearize*/ true);
     }
 
     // do trilinear filtering between the two mipmap levels
     unsigned int level_uint = static_cast<unsigned int>(floorf(level));
     float lerp = level - level_uint;
 
-    mi::Float32_4 rgba_0 = interpolate_biquintic(
-        uvtile.m_canvas[level_uint],
-        uvtile.m_resolution[level_uint],
-        wrap_u, wrap_v, mi::mdl::stdlib::wrap_repeat,
-        crop_uv, crop_w,
-        coords, /*smootherstep*/ true, 1.0f);
-
-    mi::Float32_4 rgba_1 = interpolate_biquintic(
-        uvtile.m_canvas[level_uint + 1],
-        uvtile.m_resolution[level_uint + 1],
-        wrap_u, wrap_v, mi::mdl::stdlib::wrap_repeat,
-        crop_uv, crop_w,
-        coords, /*smootherstep*/ true, 1.0f);
+    const Uvtile::Level& level_0 = uvtile.get_level(level_uint);
+    mi::Float32_4 rgba_0 = filter_texels_2d(
+        level_0.m_canvas,
+        level_0.m_resolution,
+        wrap_u, wrap_v,
+        crop_uv,
+        coords, m_filter, uvtile.get_gamma(), /*linearize*/ true);
+
+    const Uvtile::Level& level_1 = uvtile.get_level(level_uint + 1);
+    mi::Float32_4 rgba_1 = filter_texels_2d(
+        level_1.m_canvas,
+        level_1.m_resolution,
+        wrap_u, wrap_v,
+        crop_uv,
+        coords, m_filter, uvtile.get_gamma(), /*linearize*/ true);
 
     return (1 - lerp) * rgba_0 + lerp * rgba_1;
 }
@@ -832,10 +937,10 @@ float Texture_2d::texel_float(
     if (uvtile_id == ~0u)
         return 0.0f;
 
-    const Uvtile& uvtile = frame.m_uvtiles[uvtile_id];
-    mi::math::Color res(0.0f);
-    uvtile.m_canvas[0].lookup(res, coord.x, coord.y, 0);
-    apply_gamma1(res, uvtile.m_gamma);
+    const Uvtile& uvtile = *frame.m_uvtiles[uvtile_id];
+    const mi::Float32_4 texel = uvtile.get_texel(coord);
+    mi::math::Color res(texel.x, texel.y, texel.z, texel.w);
+    apply_gamma1(res, uvtile.get_gamma());
     return res.r;
 }
 
@@ -856,10 +961,10 @@ mi::Float32_2 Texture_2d::texel_float2(
     if (uvtile_id == ~0u)
         return mi::Float32_2(0.0f);
 
-    const Uvtile& uvtile = frame.m_uvtiles[uvtile_id];
-    mi::math::Color res(0.0f);
-    uvtile.m_canvas[0].lookup(res, coord.x, coord.y, 0);
-    apply_gamma2(res, uvtile.m_gamma);
+    const Uvtile& uvtile = *frame.m_uvtiles[uvtile_id];
+    const mi::Float32_4 texel = uvtile.get_texel(coord);
+    mi::math::Color res(texel.x, texel.y, texel.z, texel.w);
+    apply_gamma2(res, uvtile.get_gamma());
     return mi::Float32_2(res.r, res.g);
 }
 
@@ -880,10 +985,10 @@ mi::Float32_3 Texture_2d::texel_float3(
     if (uvtile_id == ~0u)
         return mi::Float32_3(0.0f);
 
-    const Uvtile& uvtile = frame.m_uvtiles[uvtile_id];
-    mi::math::Color res(0.0f);
-    uvtile.m_canvas[0].lookup(res, coord.x, coord.y, 0);
-    apply_gamma3(res, uvtile.m_gamma);
+    const Uvtile& uvtile = *frame.m_uvtiles[uvtile_id];
+    const mi::Float32_4 texel = uvtile.get_texel(coord);
+    mi::math::Color res(texel.x, texel.y, texel.z, texel.w);
+    apply_gamma3(res, uvtile.get_gamma());
     return mi::Float32_3(res.r, res.g, res.b);
 }
 
@@ -904,10 +1009,10 @@ mi::Float32_4 Texture_2d::texel_float4(
     if (uvtile_id == ~0u)
         return mi::Float32_4(0.0f);
 
-    const Uvtile& uvtile = frame.m_uvtiles[uvtile_id];
-    mi::math::Color res(0.0f);
-    uvtile.m_canvas[0].lookup(res, coord.x, coord.y, 0);
-    apply_gamma4(res, uvtile.m_gamma);
+    const Uvtile& uvtile = *frame.m_uvtiles[uvtile_id];
+    const mi::Float32_4 texel = uvtile.get_texel(coord);
+    mi::math::Color res(texel.x, texel.y, texel.z, texel.w);
+    apply_gamma4(res, uvtile.get_gamma());
     return mi::Float32_4(res.r, res.g, res.b, res.a);
 }
 
@@ -928,10 +1033,10 @@ mi::Spectrum Texture_2d::texel_color(
     if (uvtile_id == ~0u)
         return mi::Spectrum(0.0f);
 
-    const Uvtile& uvtile = frame.m_uvtiles[uvtile_id];
-    mi::math::Color res(0.0f);
-    uvtile.m_canvas[0].lookup(res, coord.x, coord.y, 0);
-    apply_gamma3(res, uvtile.m_gamma);
+    const Uvtile& uvtile = *frame.m_uvtiles[uvtile_id];
+    const mi::Float32_4 texel = uvtile.get_texel(coord);
+    mi::math::Color res(texel.x, texel.y, texel.z, texel.w);
+    apply_gamma3(res, uvtile.get_gamma());
     return mi::Spectrum(res.r, res.g, res.b);
 }
 
@@ -1323,5 +1428,134 @@ mi::Spectrum Texture_ptex::lookup_color(int channel) const
     return mi::Spectrum(0.f);
 }
 
+//-------------------------------------------------------------------------------------------------
+
+namespace {
+
+// DB versions of texture, image, and image implementation, shape, derivative mode, filter.
+using Texture_cache_key = std::tuple<
+    DB::Tag_version, DB::Tag_version, DB::Tag_version, int, bool, int>;
+
+// The entries are removed by the deleters of the textures, see make_texture().
+mi::base::Lock g_texture_cache_lock;
+std::map<Texture_cache_key, std::weak_ptr<const Texture>> g_texture_cache;
+
+// Removes the entry of a texture that was just destroyed, unless it has been replaced already.
+void drop_texture_cache_entry(const Texture_cache_key& key)
+{
+    mi::base::Lock::Block block(&g_texture_cache_lock);
+    auto it = g_texture_cache.find(key);
+    if (it != g_texture_cache.end() && it->second.expired())
+        g_texture_cache.erase(it);
+}
+
+// Texture has no virtual destructor, hence the shared pointers are created from the concrete
+// types. Textures created for the cache (\p key is not \c nullptr) drop their entry when they are
+// destroyed.
+template<typename T>
+std::shared_ptr<const Texture> make_texture(T* texture, const Texture_cache_key* key)
+{
+    if (!key)
+        return std::shared_ptr<const Texture>(texture);
+
+    return std::shared_ptr<const Texture>(texture, [key = *key](const T* t) {
+        delete t;
+        drop_texture_cache_entry(key);
+    });
+}
+
+std::shared_ptr<const Texture> create_texture(
+    const DB::Typed_tag<TEXTURE::Texture>& tag,
+    mi::mdl::IType_texture::Shape shape,
+    bool use_derivatives,
+    Texture_filter filter,
+    DB::Transaction* transaction,
+    const Texture_cache_key* key)
+{
+    switch (shape) {
+    case mi::mdl::IType_texture::TS_2D:
+        return make_texture(new Texture_2d(tag, use_derivatives, filter, transaction), key);
+    case mi::mdl::IType_texture::TS_3D:
+    case mi::mdl::IType_texture::TS_BSDF_DATA: // handle like 3D texture
+        return make_texture(new Texture_3d(tag, transaction), key);
+    case mi::mdl::IType_texture::TS_CUBE:
+        return make_texture(new Texture_cube(tag, transaction), key);
+    case mi::mdl::IType_texture::TS_PTEX:
+        return make_texture(new Texture_ptex(tag, transaction), key);
+    }
+    ASSERT(M_BACKENDS, false);
+    return make_texture(new Texture_ptex(tag, transaction), key);
+}
+
+} // namespace
+
+std::shared_ptr<const Texture> get_shared_texture(
+    const DB::Typed_tag<TEXTURE::Texture>& tag,
+    mi::mdl::IType_texture::Shape shape,
+    bool use_derivatives,
+    Texture_filter filter,
+    DB::Transaction* transaction)
+{
+    // Derivatives and filters only change 2D textures.
+    if (shape != mi::mdl::IType_texture::TS_2D) {
+        use_derivatives = false;
+        filter = TEXTURE_FILTER_BIQUINTIC;
+    }
+
+    DB::Tag image_tag;
+    DB::Tag impl_tag;
+    if (tag) {
+        DB::Access<TEXTURE::Texture> texture(tag, transaction);
+        image_tag = texture->get_image();
+        if (image_tag) {
+            DB::Access<DBIMAGE::Image> image(image_tag, transaction);
+            impl_tag = image->get_impl_tag();
+        }
+    }
+
+    // Invalid textures are cheap, do not cache them.
+    if (!impl_tag)
+        return create_texture(tag, shape, use_derivatives, filter, transaction, nullptr);
+
+    Texture_cache_key key(
+        transaction->get_tag_version(tag),
+        transaction->get_tag_version(image_tag),
+        transaction->get_tag_version(impl_tag),
+        int(shape),
+        use_derivatives,
+        int(filter));
+
+    {
+        mi::base::Lock::Block block(&g_texture_cache_lock);
+        auto it = g_texture_cache.find(key);
+        if (it != g_texture_cache.end()) {
+            std::shared_ptr<const Texture> texture = it->second.lock();
+            if (texture)
+                return texture;
+        }
+    }
+
+    // Construct the texture outside of the lock, this is the expensive part. If another thread
+    // created the same texture in the meantime, this one is destroyed after the lock is released
+    // below, and its deleter leaves the entry of the other one alone.
+    std::shared_ptr<const Texture> texture =
+        create_texture(tag, shape, use_derivatives, filter, transaction, &key);
+
+    mi::base::Lock::Block block(&g_texture_cache_lock);
+
+    std::weak_ptr<const Texture>& entry = g_texture_cache[key];
+    std::shared_ptr<const Texture> existing = entry.lock();
+    if (existing)
+        return existing;
+    entry = texture;
+    return texture;
+}
+
+size_t get_shared_texture_count()
+{
+    mi::base::Lock::Block block(&g_texture_cache_lock);
+    return g_texture_cache.size();
+}
+
 }
 }
@@ -0,0 +1,118 @@
+/******************************************************************************
+ * Copyright (c) 2024, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include "pch.h"
+
+#define MI_TEST_AUTO_SUITE_NAME "Regression Test Suite for render/mdl/runtime"
+#define MI_TEST_IMPLEMENT_TEST_MAIN_INSTEAD_OF_MAIN
+
+#include <base/system/test/i_test_auto_driver.h>
+#include <base/system/test/i_test_auto_case.h>
+
+#include "i_mdlrt_texture.h"
+
+#include <mi/base/handle.h>
+
+#include <memory>
+
+#include <base/system/main/access_module.h>
+#include <base/data/db/i_db_access.h>
+#include <base/data/db/i_db_database.h>
+#include <base/data/db/i_db_scope.h>
+#include <base/data/db/i_db_transaction.h>
+#include <io/image/image/i_image.h>
+#include <io/image/image/i_image_mipmap.h>
+#include <io/scene/dbimage/i_dbimage.h>
+#include <io/scene/texture/i_texture.h>
+
+#include <io/scene/mdl_elements/test_shared.h>
+
+using namespace MI;
+
+// Checks that get_shared_texture() returns the same runtime texture to all its users, and that
+// the cache entry is dropped when the last user releases the texture.
+
+MI_TEST_AUTO_FUNCTION( test_texture_cache )
+{
+    Unified_database_access db_access;
+    SYSTEM::Access_module<IMAGE::Image_module> image_module( false);
+
+    DB::Database* database = db_access.get_database();
+    DB::Scope* scope = database->get_global_scope();
+    DB::Transaction* transaction = scope->start_transaction();
+
+    mi::base::Handle<IMAGE::IMipmap> mipmap( image_module->create_mipmap( IMAGE::PT_RGBA, 4, 4));
+    DBIMAGE::Image* image = new DBIMAGE::Image;
+    image->set_mipmap( transaction, mipmap.get(), /*selector*/ nullptr, mi::base::Uuid{0,0,0,0});
+    DB::Tag image_tag = transaction->store( image, "test_texture_cache_image");
+
+    TEXTURE::Texture* texture = new TEXTURE::Texture;
+    texture->set_image( image_tag);
+    DB::Typed_tag<TEXTURE::Texture> tag(
+        transaction->store( texture, "test_texture_cache_texture"));
+
+    const mi::mdl::IType_texture::Shape shape = mi::mdl::IType_texture::TS_2D;
+    const size_t count = MDLRT::get_shared_texture_count();
+
+    {
+        // two users share one instance
+        std::shared_ptr<const MDLRT::Texture> user1 = MDLRT::get_shared_texture(
+            tag, shape, /*use_derivatives*/ false, MDLRT::TEXTURE_FILTER_BIQUINTIC, transaction);
+        std::shared_ptr<const MDLRT::Texture> user2 = MDLRT::get_shared_texture(
+            tag, shape, /*use_derivatives*/ false, MDLRT::TEXTURE_FILTER_BIQUINTIC, transaction);
+        MI_CHECK( user1);
+        MI_CHECK( user1->is_valid());
+        MI_CHECK( user1.get() == user2.get());
+        MI_CHECK_EQUAL( MDLRT::get_shared_texture_count(), count + 1);
+
+        // a different filter is a different instance
+        std::shared_ptr<const MDLRT::Texture> user3 = MDLRT::get_shared_texture(
+            tag, shape, /*use_derivatives*/ false, MDLRT::TEXTURE_FILTER_NEAREST, transaction);
+        MI_CHECK( user3.get() != user1.get());
+        MI_CHECK_EQUAL( MDLRT::get_shared_texture_count(), count + 2);
+
+        // releasing the only user drops the entry
+        user3.reset();
+        MI_CHECK_EQUAL( MDLRT::get_shared_texture_count(), count + 1);
+
+        // releasing one of two users keeps the entry and the instance
+        const MDLRT::Texture* shared = user1.get();
+        user1.reset();
+        MI_CHECK_EQUAL( MDLRT::get_shared_texture_count(), count + 1);
+        std::shared_ptr<const MDLRT::Texture> user4 = MDLRT::get_shared_texture(
+            tag, shape, /*use_derivatives*/ false, MDLRT::TEXTURE_FILTER_BIQUINTIC, transaction);
+        MI_CHECK( user4.get() == shared);
+    }
+
+    // the last users are gone
+    MI_CHECK_EQUAL( MDLRT::get_shared_texture_count(), count);
+
+    transaction->commit();
+}
+
+MI_TEST_MAIN_CALLING_TEST_MAIN();
@@ -0,0 +1,233 @@
+/******************************************************************************
+ * Copyright (c) 2024, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include "pch.h"
+
+#define MI_TEST_AUTO_SUITE_NAME "Regression Test Suite for render/mdl/runtime"
+#define MI_TEST_IMPLEMENT_TEST_MAIN_INSTEAD_OF_MAIN
+
+#include <base/system/test/i_test_auto_driver.h>
+#include <base/system/test/i_test_auto_case.h>
+
+#include "i_mdlrt_texture.h"
+
+#include <mi/base/handle.h>
+#include <mi/math/color.h>
+#include <mi/neuraylib/icanvas.h>
+#include <mi/neuraylib/itile.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <base/system/main/access_module.h>
+#include <base/lib/mem/mem.h>
+#include <base/lib/log/i_log_module.h>
+#include <io/image/image/i_image.h>
+#include <io/image/image/i_image_access_canvas.h>
+
+using namespace MI;
+
+// Checks that filter_texels_2d() matches interpolate_biquintic(), and that its per-texel
+// linearization matches filtering a canvas that was converted to linear gamma upfront.
+
+std::mt19937 g_prng;
+
+// Fills the canvas with random pixel data (including alpha).
+void fill_random( mi::neuraylib::ICanvas* canvas)
+{
+    std::uniform_real_distribution<mi::Float32> dist( 0.0f, 1.0f);
+    mi::base::Handle<mi::neuraylib::ITile> tile( canvas->get_tile());
+    for( mi::Uint32 y = 0; y < tile->get_resolution_y(); ++y)
+        for( mi::Uint32 x = 0; x < tile->get_resolution_x(); ++x) {
+            mi::math::Color color( dist( g_prng), dist( g_prng), dist( g_prng), dist( g_prng));
+            tile->set_pixel( x, y, &color.r);
+        }
+}
+
+void check_close( const mi::Float32_4& lhs, const mi::Float32_4& rhs, mi::Float32 eps)
+{
+    MI_CHECK_CLOSE( lhs.x, rhs.x, eps);
+    MI_CHECK_CLOSE( lhs.y, rhs.y, eps);
+    MI_CHECK_CLOSE( lhs.z, rhs.z, eps);
+    MI_CHECK_CLOSE( lhs.w, rhs.w, eps);
+}
+
+void check_filter(
+    const IMAGE::Image_module* image_module,
+    mi::Uint32 width,
+    mi::Uint32 height,
+    mi::mdl::stdlib::Tex_wrap_mode wrap_u,
+    mi::mdl::stdlib::Tex_wrap_mode wrap_v,
+    const mi::Float32_4& crop_uv,
+    mi::Float32 gamma)
+{
+    mi::base::Handle<mi::neuraylib::ICanvas> canvas(
+        image_module->create_canvas( IMAGE::PT_COLOR, width, height, 1, false, 1.0f));
+    fill_random( canvas.get());
+    IMAGE::Access_canvas access_canvas( canvas.get(), true);
+
+    const mi::Uint32_3 res( width, height, 0);
+    const mi::Float32_2 crop_w( 0.0f, 1.0f);
+
+    // coordinates inside and outside of [0,1], including texel centers and borders
+    std::uniform_real_distribution<mi::Float32> dist( -1.5f, 2.5f);
+    std::vector<mi::Float32_3> coords;
+    for( mi::Uint32 i = 0; i < 200; ++i)
+        coords.push_back( mi::Float32_3( dist( g_prng), dist( g_prng), 0.0f));
+    coords.push_back( mi::Float32_3( 0.0f, 0.0f, 0.0f));
+    coords.push_back( mi::Float32_3( 1.0f, 1.0f, 0.0f));
+    coords.push_back( mi::Float32_3( 0.5f / width, 0.5f / height, 0.0f));
+
+    for( const mi::Float32_3& texo: coords) {
+        mi::Float32_4 expected = MDLRT::interpolate_biquintic( access_canvas, res,
+            wrap_u, wrap_v, mi::mdl::stdlib::wrap_clamp, crop_uv, crop_w, texo,
+            /*smootherstep*/ true, gamma);
+        mi::Float32_4 result = MDLRT::filter_texels_2d( access_canvas, res,
+            wrap_u, wrap_v, crop_uv, texo, MDLRT::TEXTURE_FILTER_BIQUINTIC, gamma,
+            /*linearize*/ false);
+        check_close( result, expected, 1e-5f);
+
+        expected = MDLRT::interpolate_biquintic( access_canvas, res,
+            wrap_u, wrap_v, mi::mdl::stdlib::wrap_clamp, crop_uv, crop_w, texo,
+            /*smootherstep*/ false, gamma);
+        result = MDLRT::filter_texels_2d( access_canvas, res,
+            wrap_u, wrap_v, crop_uv, texo, MDLRT::TEXTURE_FILTER_BILINEAR, gamma,
+            /*linearize*/ false);
+        check_close( result, expected, 1e-5f);
+    }
+}
+
+// Nearest filtering without crop returns the texel containing the coordinate.
+void check_nearest( const IMAGE::Image_module* image_module, mi::Uint32 width, mi::Uint32 height)
+{
+    mi::base::Handle<mi::neuraylib::ICanvas> canvas(
+        image_module->create_canvas( IMAGE::PT_COLOR, width, height, 1, false, 1.0f));
+    fill_random( canvas.get());
+    IMAGE::Access_canvas access_canvas( canvas.get(), true);
+
+    const mi::Uint32_3 res( width, height, 0);
+    const mi::Float32_4 crop_uv( 0.0f, 1.0f, 0.0f, 1.0f);
+
+    std::uniform_real_distribution<mi::Float32> dist( 0.0f, 1.0f);
+    for( mi::Uint32 i = 0; i < 200; ++i) {
+        const mi::Float32_3 texo( dist( g_prng), dist( g_prng), 0.0f);
+        const mi::Uint32 x = std::min( static_cast<mi::Uint32>( texo.x * width), width - 1);
+        const mi::Uint32 y = std::min( static_cast<mi::Uint32>( texo.y * height), height - 1);
+
+        mi::math::Color expected;
+        MI_CHECK( access_canvas.lookup( expected, x, y));
+        mi::Float32_4 result = MDLRT::filter_texels_2d( access_canvas, res,
+            mi::mdl::stdlib::wrap_clamp, mi::mdl::stdlib::wrap_clamp, crop_uv, texo,
+            MDLRT::TEXTURE_FILTER_NEAREST, 1.0f, /*linearize*/ false);
+        check_close( result, mi::Float32_4( expected.r, expected.g, expected.b, expected.a), 1e-6f);
+    }
+
+    // outside of [0,1] with wrap_clip
+    const mi::Float32_4 zero( 0.0f, 0.0f, 0.0f, 0.0f);
+    mi::Float32_4 result = MDLRT::filter_texels_2d( access_canvas, res,
+        mi::mdl::stdlib::wrap_clip, mi::mdl::stdlib::wrap_clip, crop_uv,
+        mi::Float32_3( 1.5f, 0.5f, 0.0f), MDLRT::TEXTURE_FILTER_NEAREST, 1.0f,
+        /*linearize*/ false);
+    check_close( result, zero, 1e-6f);
+}
+
+// Linearizing the texels of the footprint matches filtering a linearized copy of an 8-bit canvas.
+void check_linearize( const IMAGE::Image_module* image_module, mi::Uint32 width, mi::Uint32 height)
+{
+    const mi::Float32 gamma = 2.2f;
+    mi::base::Handle<mi::neuraylib::ICanvas> canvas(
+        image_module->create_canvas( IMAGE::PT_RGBA, width, height, 1, false, gamma));
+    fill_random( canvas.get());
+    IMAGE::Access_canvas access_canvas( canvas.get(), true);
+
+    mi::base::Handle<mi::neuraylib::ICanvas> linear(
+        image_module->create_canvas( IMAGE::PT_COLOR, width, height, 1, false, 1.0f));
+    {
+        mi::base::Handle<const mi::neuraylib::ITile> tile( canvas->get_tile());
+        mi::base::Handle<mi::neuraylib::ITile> linear_tile( linear->get_tile());
+        for( mi::Uint32 y = 0; y < height; ++y)
+            for( mi::Uint32 x = 0; x < width; ++x) {
+                mi::math::Color color;
+                tile->get_pixel( x, y, &color.r);
+                for( mi::Uint32 c = 0; c < 4; ++c)
+                    (&color.r)[c] = powf( (&color.r)[c], gamma);
+                linear_tile->set_pixel( x, y, &color.r);
+            }
+    }
+    IMAGE::Access_canvas access_linear( linear.get(), true);
+
+    const mi::Uint32_3 res( width, height, 0);
+    const mi::Float32_4 crop_uv( 0.0f, 1.0f, 0.0f, 1.0f);
+    const mi::Float32_2 crop_w( 0.0f, 1.0f);
+
+    std::uniform_real_distribution<mi::Float32> dist( -0.5f, 1.5f);
+    for( mi::Uint32 i = 0; i < 200; ++i) {
+        const mi::Float32_3 texo( dist( g_prng), dist( g_prng), 0.0f);
+        mi::Float32_4 expected = MDLRT::interpolate_biquintic( access_linear, res,
+            mi::mdl::stdlib::wrap_repeat, mi::mdl::stdlib::wrap_repeat,
+            mi::mdl::stdlib::wrap_clamp, crop_uv, crop_w, texo, /*smootherstep*/ false, 1.0f);
+        mi::Float32_4 result = MDLRT::filter_texels_2d( access_canvas, res,
+            mi::mdl::stdlib::wrap_repeat, mi::mdl::stdlib::wrap_repeat, crop_uv, texo,
+            MDLRT::TEXTURE_FILTER_BILINEAR, gamma, /*linearize*/ true);
+        check_close( result, expected, 1e-5f);
+    }
+}
+
+MI_TEST_AUTO_FUNCTION( test_texture_filter )
+{
+    SYSTEM::Access_module<MEM::Mem_module> mem_module( false);
+    SYSTEM::Access_module<LOG::Log_module> log_module( false);
+    SYSTEM::Access_module<IMAGE::Image_module> image_module( false);
+
+    const mi::mdl::stdlib::Tex_wrap_mode wrap_modes[] = {
+        mi::mdl::stdlib::wrap_clamp, mi::mdl::stdlib::wrap_repeat,
+        mi::mdl::stdlib::wrap_mirrored_repeat, mi::mdl::stdlib::wrap_clip };
+
+    // full texture and a cropped part of it
+    const mi::Float32_4 crops[] = {
+        mi::Float32_4( 0.0f, 1.0f, 0.0f, 1.0f), mi::Float32_4( 0.25f, 0.5f, 0.1f, 0.75f) };
+
+    // even and odd sizes, including degenerate ones
+    const mi::Uint32 sizes[][2] = { { 16, 8}, { 37, 21}, { 1, 9}, { 8, 1} };
+
+    for( const auto& size: sizes) {
+        for( auto wrap_u: wrap_modes)
+            for( auto wrap_v: wrap_modes)
+                for( const auto& crop_uv: crops)
+                    check_filter(
+                        image_module.get(), size[0], size[1], wrap_u, wrap_v, crop_uv, 1.0f);
+        check_filter( image_module.get(), size[0], size[1], mi::mdl::stdlib::wrap_repeat,
+            mi::mdl::stdlib::wrap_repeat, crops[0], 2.2f);
+
+        check_nearest( image_module.get(), size[0], size[1]);
+        check_linearize( image_module.get(), size[0], size[1]);
+    }
+}
+
+MI_TEST_MAIN_CALLING_TEST_MAIN();
@@ -53,8 +53,8 @@ void Dxt_decompressor::set_source_format(
     mi::Uint32 height)
 {
     m_source_format = format;
-    m_blocks_x = width  / BLOCK_PIXEL_DIM;
-    m_blocks_y = height / BLOCK_PIXEL_DIM;
+    m_blocks_x = (width  + BLOCK_PIXEL_DIM - 1) / BLOCK_PIXEL_DIM;
+    m_blocks_y = (height + BLOCK_PIXEL_DIM - 1) / BLOCK_PIXEL_DIM;
 
     switch( m_source_format) {
         case DXTC1:
@@ -76,7 +76,9 @@ void Dxt_decompressor::set_target_format(
     assert( component_count == 3 || component_count == 4);
 
     m_target_component_count = component_count;
-    m_target_width = component_count * width;
+    const mi::Uint32 padded_width
+        = (width + BLOCK_PIXEL_DIM - 1) / BLOCK_PIXEL_DIM * BLOCK_PIXEL_DIM;
+    m_target_width = component_count * padded_width;
     m_buffer.resize( BLOCK_PIXEL_DIM * m_target_width);
 }
 
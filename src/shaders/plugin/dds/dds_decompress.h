@@ -62,6 +62,9 @@ public:
 
     /// Sets the format of the source data.
     ///
+    /// Partial blocks at the end of each block line and in the last block line (as in miplevels
+    /// whose resolution is not a multiple of BLOCK_PIXEL_DIM) are decompressed as full blocks.
+    ///
     /// \param format   The format of the compressed data.
     /// \param width    The width of the compressed data (in pixels).
     /// \param height   The height of the compressed data (in pixels).
@@ -76,7 +79,8 @@ public:
     ///
     /// \param component_count   The number of components per pixel: 3 implies pixel type "Rgb",
     ///                          4 implies pixel type "
-    /// \param width             The width of the uncompressed data (in pixels)
+    /// \param width             The width of the uncompressed data (in pixels), rounded up
+    ///                          internally to a multiple of BLOCK_PIXEL_DIM.
     ///
     void set_target_format(
         mi::Uint32 component_count,
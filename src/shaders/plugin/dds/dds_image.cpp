@@ -628,8 +628,8 @@ void Image::flip_surface( Surface& surface)
                 return;
         }
 
-        mi::Uint32 blocks_x   = surface.get_width()  / 4;
-        mi::Uint32 blocks_y   = surface.get_height() / 4;
+        mi::Uint32 blocks_x   = (surface.get_width()  + 3) / 4;
+        mi::Uint32 blocks_y   = (surface.get_height() + 3) / 4;
         mi::Uint32 row_size   = blocks_x * block_size;
         mi::Uint32 layer_size = row_size * blocks_y;
 
@@ -41,6 +41,8 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <vector>
 
 namespace MI {
 
@@ -142,19 +144,28 @@ mi::neuraylib::ITile* Image_file_reader_impl::read(
         decompressor.set_target_format( get_components_per_pixel( m_pixel_type), image_width);
 
         mi::Uint32 block_height = decompressor.get_block_dimension();
-        size_t bytes_per_block = (size_t)image_width * block_height * bytes_per_pixel;
+        size_t bytes_per_row = (size_t)image_width * bytes_per_pixel;
+
+        // Miplevels whose height is not a multiple of the block height have padding rows in the
+        // last block line of the file, which ends up as the first one for flipped surfaces.
+        mi::Uint32 padded_height = decompressor.get_block_count_y() * block_height;
+        mi::Uint32 skipped_rows = m_image.is_cubemap() ? 0 : padded_height - image_height;
 
         const mi::Uint8* const src = surface.get_pixels() + z * surface.get_size() / 6;
-        const mi::Uint8* const buffer1 = decompressor.get_buffer();
-        mi::Uint8* const buffer2 = new mi::Uint8[bytes_per_layer];
+        std::vector<mi::Uint8> buffer2( bytes_per_layer);
 
         for( mi::Uint32 block = 0; block < decompressor.get_block_count_y(); ++block) {
             decompressor.decompress_blockline( src, block);
-            memcpy( buffer2 + block * bytes_per_block, buffer1, bytes_per_block);
+            for( mi::Uint32 i = 0; i < block_height; ++i) {
+                mi::Uint32 row = block * block_height + i;
+                if( row < skipped_rows || row - skipped_rows >= image_height)
+                    continue;
+                memcpy( buffer2.data() + (row - skipped_rows) * bytes_per_row,
+                    decompressor.get_scanline( i), bytes_per_row);
+            }
         }
 
-        copy_from_dds_to_tile( buffer2, image_width, image_height, tile.get());
-        delete[] buffer2;
+        copy_from_dds_to_tile( buffer2.data(), image_width, image_height, tile.get());
     }
 
     tile->retain();
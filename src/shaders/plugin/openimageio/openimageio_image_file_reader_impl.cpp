@@ -35,6 +35,7 @@
 #include <mi/neuraylib/ireader.h>
 #include <mi/neuraylib/itile.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 
@@ -90,6 +91,20 @@ Image_file_reader_impl::Image_file_reader_impl(
     }
 
     assert( m_resolution_z == 1); // see comment in read()
+
+    // Count the miplevels stored in the file. OpenImageIO does not support retrieving this number
+    // without looping through the miplevels. Stop at the first miplevel that does not match the
+    // resolution expected by IMAGE::Mipmap_impl, such that the caller computes the remaining
+    // miplevels itself.
+    for( mi::Uint32 level = 1; level < 32; ++level) {
+        const OIIO::ImageSpec spec = m_image_input->spec_dimensions( m_subimage, level);
+        if(    spec.undefined()
+            || static_cast<mi::Uint32>( spec.width)  != std::max( m_resolution_x >> level, 1u)
+            || static_cast<mi::Uint32>( spec.height) != std::max( m_resolution_y >> level, 1u)
+            || spec.depth != 1)
+            break;
+        m_miplevels = level + 1;
+    }
 }
 
 const char* Image_file_reader_impl::get_type() const
@@ -99,30 +114,28 @@ const char* Image_file_reader_impl::get_type() const
 
 mi::Uint32 Image_file_reader_impl::get_resolution_x( mi::Uint32 level) const
 {
-    if( level > 0)
+    if( level >= m_miplevels && level > 0)
         return 0;
-    return m_resolution_x;
+    return std::max( m_resolution_x >> level, 1u);
 }
 
 mi::Uint32 Image_file_reader_impl::get_resolution_y( mi::Uint32 level) const
 {
-    if( level > 0)
+    if( level >= m_miplevels && level > 0)
         return 0;
-    return m_resolution_y;
+    return std::max( m_resolution_y >> level, 1u);
 }
 
 mi::Uint32 Image_file_reader_impl::get_layers_size( mi::Uint32 level) const
 {
-    if( level > 0)
+    if( level >= m_miplevels)
         return 0;
     return m_resolution_z;
 }
 
 mi::Uint32 Image_file_reader_impl::get_miplevels() const
 {
-    // Support only one miplevel for now. OpenImageIO does not support retrieving this number
-    // without looping through the miplevels.
-    return 1;
+    return m_miplevels;
 }
 
 bool Image_file_reader_impl::get_is_cubemap() const
@@ -137,18 +150,24 @@ mi::Float32 Image_file_reader_impl::get_gamma() const
 
 mi::neuraylib::ITile* Image_file_reader_impl::read( mi::Uint32 z, mi::Uint32 level) const
 {
+    if( level >= m_miplevels)
+        return nullptr;
+
     if( !setup_image_input( /*from_constructor*/ false))
         return nullptr;
 
+    const mi::Uint32 resolution_x = get_resolution_x( level);
+    const mi::Uint32 resolution_y = get_resolution_y( level);
+
     const char* pixel_type = convert_pixel_type_enum_to_string( m_pixel_type);
     mi::base::Handle<mi::neuraylib::ITile> tile(
-        m_image_api->create_tile( pixel_type, m_resolution_x, m_resolution_y));
+        m_image_api->create_tile( pixel_type, resolution_x, resolution_y));
     if( !tile)
         return nullptr;
 
     int cpp = m_channel_end - m_channel_start;
     int bpc = IMAGE::get_bytes_per_component( m_pixel_type);
-    int bytes_per_row = m_resolution_x * cpp * bpc;
+    int bytes_per_row = resolution_x * cpp * bpc;
 
     OIIO::TypeDesc format( get_base_type( m_pixel_type));
     mi::Uint8* data = static_cast<mi::Uint8*>( tile->get_data());
@@ -167,7 +186,7 @@ mi::neuraylib::ITile* Image_file_reader_impl::read( mi::Uint32 z, mi::Uint32 lev
             m_channel_start,
             m_channel_end,
             format,
-            data + (m_resolution_y - 1) * static_cast<size_t>( bytes_per_row),
+            data + (resolution_y - 1) * static_cast<size_t>( bytes_per_row),
             /*xstride*/ OIIO::AutoStride,
             /*ystride*/ -bytes_per_row,
             /*zstride*/ OIIO::AutoStride);
@@ -177,10 +196,146 @@ mi::neuraylib::ITile* Image_file_reader_impl::read( mi::Uint32 z, mi::Uint32 lev
         return nullptr;
     }
 
+    return postprocess( tile.get(), resolution_x, resolution_y);
+}
+
+mi::neuraylib::ITile* Image_file_reader_impl::read_region(
+    mi::Uint32 x,
+    mi::Uint32 y,
+    mi::Uint32 width,
+    mi::Uint32 height,
+    mi::Uint32 z,
+    mi::Uint32 level) const
+{
+    // See read() for the restriction to one layer.
+    const mi::Uint32 resolution_x = get_resolution_x( level);
+    const mi::Uint32 resolution_y = get_resolution_y( level);
+    if(    level >= m_miplevels
+        || z > 0
+        || width == 0
+        || height == 0
+        || x >= resolution_x
+        || y >= resolution_y
+        || width > resolution_x - x
+        || height > resolution_y - y)
+        return nullptr;
+
+    if( !setup_image_input( /*from_constructor*/ false))
+        return nullptr;
+
+    const char* pixel_type = convert_pixel_type_enum_to_string( m_pixel_type);
+    mi::base::Handle<mi::neuraylib::ITile> tile(
+        m_image_api->create_tile( pixel_type, width, height));
+    if( !tile)
+        return nullptr;
+
+    int cpp = m_channel_end - m_channel_start;
+    int bpc = IMAGE::get_bytes_per_component( m_pixel_type);
+    size_t bytes_per_pixel = static_cast<size_t>( cpp) * bpc;
+    size_t bytes_per_row = width * bytes_per_pixel;
+
+    OIIO::TypeDesc format( get_base_type( m_pixel_type));
+    mi::Uint8* data = static_cast<mi::Uint8*>( tile->get_data());
+
+    // The rows of the region in the file (top-down) relative to the data window.
+    const OIIO::ImageSpec spec = m_image_input->spec( m_subimage, level);
+    int x_begin = spec.x + static_cast<int>( x);
+    int y_begin = spec.y + static_cast<int>( resolution_y - y - height);
+    int y_end   = y_begin + static_cast<int>( height);
+
+    try {
+        // Read the rows (or the tiles) covering the region into a temporary buffer, and copy the
+        // requested columns in bottom-up row order into the tile.
+        int buffer_x = spec.x;
+        int buffer_y = y_begin;
+        int buffer_width = spec.width;
+        std::vector<mi::Uint8> buffer;
+        bool success = false;
+
+        if( spec.tile_width > 0 && spec.tile_height > 0) {
+            // read_tiles() requires bounds aligned to the tile grid or the image edges.
+            int tx_begin = spec.x + (x_begin - spec.x) / spec.tile_width * spec.tile_width;
+            int tx_end = spec.x + (x_begin - spec.x + static_cast<int>( width)
+                + spec.tile_width - 1) / spec.tile_width * spec.tile_width;
+            int ty_begin = spec.y + (y_begin - spec.y) / spec.tile_height * spec.tile_height;
+            int ty_end = spec.y + (y_end - spec.y
+                + spec.tile_height - 1) / spec.tile_height * spec.tile_height;
+            tx_end = std::min( tx_end, spec.x + spec.width);
+            ty_end = std::min( ty_end, spec.y + spec.height);
+
+            buffer_x = tx_begin;
+            buffer_y = ty_begin;
+            buffer_width = tx_end - tx_begin;
+            buffer.resize( static_cast<size_t>( buffer_width) * (ty_end - ty_begin)
+                * bytes_per_pixel);
+            success = m_image_input->read_tiles(
+                m_subimage,
+                level,
+                tx_begin,
+                tx_end,
+                ty_begin,
+                ty_end,
+                spec.z,
+                spec.z + 1,
+                m_channel_start,
+                m_channel_end,
+                format,
+                buffer.data());
+        } else {
+            buffer.resize( static_cast<size_t>( buffer_width) * height * bytes_per_pixel);
+            success = m_image_input->read_scanlines(
+                m_subimage,
+                level,
+                y_begin,
+                y_end,
+                spec.z,
+                m_channel_start,
+                m_channel_end,
+                format,
+                buffer.data());
+        }
+        if( !success)
+            return nullptr;
+
+        for( mi::Uint32 row = 0; row < height; ++row) {
+            const mi::Uint8* src = buffer.data()
+                + (static_cast<size_t>( y_begin - buffer_y + row) * buffer_width
+                    + (x_begin - buffer_x)) * bytes_per_pixel;
+            memcpy( data + (height - 1 - row) * bytes_per_row, src, bytes_per_row);
+        }
+    } catch( const std::bad_alloc&) {
+        return nullptr;
+    }
+
+    return postprocess( tile.get(), width, height);
+}
+
+bool Image_file_reader_impl::is_tiled( mi::Uint32 z, mi::Uint32 level) const
+{
+    if( !setup_image_input( /*from_constructor*/ false))
+        return false;
+
+    const OIIO::ImageSpec spec = m_image_input->spec( m_subimage, level);
+    return spec.tile_width > 0 && spec.tile_height > 0;
+}
+
+bool Image_file_reader_impl::write(
+    const mi::neuraylib::ITile* tile, mi::Uint32 z, mi::Uint32 level)
+{
+    assert( false);
+    return false;
+}
+
+mi::neuraylib::ITile* Image_file_reader_impl::postprocess(
+    mi::neuraylib::ITile* tile, mi::Uint32 width, mi::Uint32 height) const
+{
+    int bpc = IMAGE::get_bytes_per_component( m_pixel_type);
+    mi::Uint8* data = static_cast<mi::Uint8*>( tile->get_data());
+
     if( (m_channel_names.size() == 2)
         && (m_channel_names[0] == "Y")
         && ((m_channel_names[1] == "A") || (m_channel_names[1] == "Alpha")))
-        expand_ya_to_rgba( bpc, m_resolution_x, m_resolution_y, data);
+        expand_ya_to_rgba( bpc, width, height, data);
 
 #if defined(DUMP_PIXEL_X) && defined(DUMP_PIXEL_Y)
     mi::math::Color c;
@@ -189,6 +344,8 @@ mi::neuraylib::ITile* Image_file_reader_impl::read( mi::Uint32 z, mi::Uint32 lev
               << c.r << " " << c.g << " " << c.b << " " << c.a << std::endl;
 #endif
 
+    mi::base::Handle<mi::neuraylib::ITile> result( tile, mi::base::DUP_INTERFACE);
+
     const OIIO::ImageSpec& spec = m_image_input->spec();
     if( m_plugin_name == "oiio_bmp") {
         // It is unclear whether BMP uses associated or unassociated alpha. We use unassociated
@@ -199,26 +356,19 @@ mi::neuraylib::ITile* Image_file_reader_impl::read( mi::Uint32 z, mi::Uint32 lev
         // actual gamma value, whereas FreeImage and GIMP seem to ignore gamma for this and always
         // assume gamma == 1.0f.
         // OIIO documentation mentions that alpha and depth should be assumed linear.
-        tile = unassociate_alpha( m_image_api.get(), tile.get(), 1.0f);
+        result = unassociate_alpha( m_image_api.get(), tile, 1.0f);
     } else {
         // Avoid redundant conversions and resulting quantization errors
     }
 
 #if defined(DUMP_PIXEL_X) && defined(DUMP_PIXEL_Y)
-    tile->get_pixel( DUMP_PIXEL_X, DUMP_PIXEL_Y, &c.r);
+    result->get_pixel( DUMP_PIXEL_X, DUMP_PIXEL_Y, &c.r);
     std::cout << "OIIO plugin reader (after unassociate_alpha()): "
               << c.r << " " << c.g << " " << c.b << " " << c.a << std::endl;
 #endif
 
-    tile->retain();
-    return tile.get();
-}
-
-bool Image_file_reader_impl::write(
-    const mi::neuraylib::ITile* tile, mi::Uint32 z, mi::Uint32 level)
-{
-    assert( false);
-    return false;
+    result->retain();
+    return result.get();
 }
 
 bool Image_file_reader_impl::is_valid() const
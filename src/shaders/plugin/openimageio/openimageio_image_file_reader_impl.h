@@ -47,7 +47,8 @@ namespace MI {
 
 namespace MI_OIIO {
 
-class Image_file_reader_impl : public mi::base::Interface_implement<mi::neuraylib::IImage_file>
+class Image_file_reader_impl : public mi::base::Interface_implement_2<
+    mi::neuraylib::IImage_file, mi::neuraylib::IImage_file_region_reader>
 {
 public:
     /// Constructor.
@@ -79,6 +80,19 @@ public:
     /// Does nothing and returns always \false.
     bool write( const mi::neuraylib::ITile* tile, mi::Uint32 z, mi::Uint32 level) override;
 
+    // methods of mi::neuraylib::IImage_file_region_reader
+
+    /// Uses read_tiles() for tiled images and read_scanlines() otherwise.
+    mi::neuraylib::ITile* read_region(
+        mi::Uint32 x,
+        mi::Uint32 y,
+        mi::Uint32 width,
+        mi::Uint32 height,
+        mi::Uint32 z,
+        mi::Uint32 level) const override;
+
+    bool is_tiled( mi::Uint32 z, mi::Uint32 level) const override;
+
     // internal methods
 
     /// Indicates whether the constructor succeeded.
@@ -94,6 +108,13 @@ private:
     /// (and the constructor).
     bool setup_image_input( bool from_constructor) const;
 
+    /// Expands Y/A data and converts associated alpha after reading a tile or region.
+    ///
+    /// \param tile   The tile with the read data of size \p width x \p height.
+    /// \return       The post-processed tile (which might be \p tile itself).
+    mi::neuraylib::ITile* postprocess(
+        mi::neuraylib::ITile* tile, mi::Uint32 width, mi::Uint32 height) const;
+
     /// The OIIO format handled by this plugin.
     std::string m_oiio_format;
 
@@ -133,6 +154,9 @@ private:
     /// Resolution of the subimage in z-direction.
     mi::Uint32 m_resolution_z = 1;
 
+    /// The number of miplevels of the subimage (only those with the expected resolution).
+    mi::Uint32 m_miplevels = 1;
+
     /// The pixel type of the subimage (after applying the selector).
     IMAGE::Pixel_type m_pixel_type = IMAGE::PT_UNDEF;
 